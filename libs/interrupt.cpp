@@ -1,8 +1,98 @@
 #include "interrupt.h"
 #include <ugba/ugba.h>
 
+#define INTERRUPT_CODE_IWRAM \
+  __attribute__((section(".iwram"), target("arm"), noinline))
+#define LOWEST_PRIORITY 0xff
+#define TICKS_TO_MICROSECONDS(TICKS) ((TICKS) * 15625 / 4096)  // (64 cycles)
+
+// (timer 0 runs freely to measure latencies; it wraps every ~250ms)
+static interrupt_vector handlers[INTR_NUMBER];
+static uint8_t priorities[INTR_NUMBER];
+static uint16_t preemptors[INTR_NUMBER];  // (sources that can preempt each)
+static uint16_t worstLatencies[INTR_NUMBER];  // (in timer ticks)
+static uint16_t waiting = 0;  // (sources seen pending, waiting for a dispatch)
+static uint16_t waitingSince[INTR_NUMBER];  // (in timer ticks)
+static volatile uint16_t touched = 0;  // (IE bits changed by the handler)
+
+INTERRUPT_CODE_IWRAM static void markWaiting(uint16_t pending,
+                                             uint16_t since) {
+  pending &= ~waiting;
+  if (pending == 0)
+    return;
+
+  for (uint32_t i = 0; i < INTR_NUMBER; i++) {
+    if (pending & (1 << i))
+      waitingSince[i] = since;
+  }
+  waiting |= pending;
+}
+
+INTERRUPT_CODE_IWRAM static void dispatch(uint32_t index) {
+  uint16_t start = REG_TM0CNT_L;
+  uint16_t bit = 1 << index;
+  if (waiting & bit) {
+    uint16_t latency = start - waitingSince[index];
+    if (latency > worstLatencies[index])
+      worstLatencies[index] = latency;
+  }
+  waiting &= REG_IF & ~bit;  // (sources acknowledged elsewhere stop waiting)
+
+  uint16_t ie = REG_IE;
+  uint16_t allowed = preemptors[index];
+  uint16_t masked = ie & ~allowed;
+  uint16_t outerTouched = touched;
+  markWaiting(REG_IF & masked & ~bit, start);  // (raised before the handler)
+
+  touched = 0;
+  REG_IE = ie & allowed;
+  if (allowed != 0)
+    REG_IME = 1;
+  handlers[index]();
+  REG_IME = 0;
+
+  markWaiting(REG_IF & masked, start);  // (raised during the handler)
+
+  // (masked bits come back, unless the handler enabled or disabled them)
+  REG_IE = REG_IE | (masked & ~touched);
+  touched |= outerTouched;
+}
+
+template <uint32_t INDEX>
+INTERRUPT_CODE_IWRAM void trampoline() {
+  dispatch(INDEX);
+}
+
+static const interrupt_vector trampolines[INTR_NUMBER] = {
+    trampoline<0>,  trampoline<1>,  trampoline<2>,  trampoline<3>,
+    trampoline<4>,  trampoline<5>,  trampoline<6>,  trampoline<7>,
+    trampoline<8>,  trampoline<9>,  trampoline<10>, trampoline<11>,
+    trampoline<12>, trampoline<13>};
+
+static void updatePreemptors() {
+  for (uint32_t i = 0; i < INTR_NUMBER; i++) {
+    preemptors[i] = 0;
+    for (uint32_t j = 0; j < INTR_NUMBER; j++) {
+      if (priorities[j] < priorities[i])
+        preemptors[i] |= 1 << j;
+    }
+  }
+}
+
 void interrupt_init(void) {
   IRQ_Init();
+
+  for (uint32_t i = 0; i < INTR_NUMBER; i++) {
+    handlers[i] = NULL;
+    priorities[i] = LOWEST_PRIORITY;
+    worstLatencies[i] = 0;
+  }
+  waiting = 0;
+  updatePreemptors();
+
+  REG_TM0CNT_H = 0;
+  REG_TM0CNT_L = 0;
+  REG_TM0CNT_H = TMCNT_START | TMCNT_PRESCALER_F_DIV_64;
 }
 
 void interrupt_add(interrupt_index index, interrupt_vector function) {
@@ -11,17 +101,30 @@ void interrupt_add(interrupt_index index, interrupt_vector function) {
 }
 
 void interrupt_set_handler(interrupt_index index, interrupt_vector function) {
-  IRQ_SetHandler((irq_index)index, function);
+  handlers[index] = function;
+  IRQ_SetHandler((irq_index)index,
+                 function != NULL ? trampolines[index] : NULL);
 }
 
 void interrupt_enable(interrupt_index index) {
+  touched |= 1 << index;
   IRQ_Enable((irq_index)index);
 }
 
 void interrupt_disable(interrupt_index index) {
+  touched |= 1 << index;
   IRQ_Disable((irq_index)index);
 }
 
 void interrupt_set_reference_vcount(unsigned long y) {
   IRQ_SetReferenceVCOUNT(y);
 }
+
+void interrupt_set_priority(interrupt_index index, unsigned int priority) {
+  priorities[index] = priority;
+  updatePreemptors();
+}
+
+unsigned int interrupt_get_worst_latency(interrupt_index index) {
+  return TICKS_TO_MICROSECONDS((unsigned int)worstLatencies[index]);
+}
@@ -28,4 +28,18 @@ void interrupt_enable(interrupt_index index);
 void interrupt_disable(interrupt_index index);
 void interrupt_set_reference_vcount(unsigned long y);
 
+// Handlers run with interrupts enabled, but only sources with a higher
+// priority (a lower number) can preempt them. The rest wait until they
+// return. By default, all sources have the same priority (no nesting).
+// (handlers should use `interrupt_enable`/`interrupt_disable`, so the
+// sources they change aren't restored when they return)
+void interrupt_set_priority(interrupt_index index, unsigned int priority);
+
+// Longest time (in microseconds) that a source waited for its handler while
+// other handlers were running. It's measured from when a dispatch first saw
+// it pending: when that handler started, or for sources raised during it,
+// from the start of the handler (an upper bound). Waits that no handler saw
+// (like IME=0 sections in the main loop) aren't counted.
+unsigned int interrupt_get_worst_latency(interrupt_index index);
+
 #endif  // INTERRUPT_H
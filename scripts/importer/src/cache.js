@@ -0,0 +1,71 @@
+const fs = require("fs");
+const $path = require("path");
+const crypto = require("crypto");
+const mkdirp = require("mkdirp");
+
+// Content-addressed cache for the slow importers (ffmpeg, ImageMagick, grit).
+// Entries are keyed by the hash of the input files, the importer options and
+// the importer's own source files, and they store the output files by
+// extension. Delete the cache directory after updating the external tools.
+
+const stats = { hits: 0, misses: 0 };
+const fileHashes = new Map(); // (path => hash, inputs like black.bmp repeat)
+let tempId = 0;
+
+const hashFile = (path) => {
+  if (!fileHashes.has(path)) {
+    const hash = crypto.createHash("sha1");
+    hash.update(fs.readFileSync(path));
+    fileHashes.set(path, hash.digest("hex"));
+  }
+  return fileHashes.get(path);
+};
+
+const keyOf = ({ inputs, options = {}, sources }) => {
+  const hash = crypto.createHash("sha1");
+  inputs.forEach((it) => hash.update(it != null ? hashFile(it) : "-"));
+  sources.forEach((it) => hash.update(hashFile(it)));
+  hash.update(JSON.stringify(options));
+  return hash.digest("hex");
+};
+
+module.exports = {
+  stats,
+
+  async run(name, outputPath, extensions, key, action) {
+    const outputFile = (it) => $path.join(outputPath, `${name}.${it}`);
+    if (!GLOBAL_OPTIONS.cache) return await action();
+
+    const entryPath = $path.join(GLOBAL_OPTIONS.cachedir, keyOf(key));
+    if (fs.existsSync(entryPath)) {
+      extensions.forEach((it) => {
+        const cachedFile = $path.join(entryPath, it);
+        if (fs.existsSync(cachedFile))
+          fs.copyFileSync(cachedFile, outputFile(it));
+        else fs.rmSync(outputFile(it), { force: true });
+      });
+      stats.hits++;
+      return;
+    }
+
+    // (importers may omit outputs, so leftovers from other runs are removed)
+    extensions.forEach((it) => fs.rmSync(outputFile(it), { force: true }));
+    await action();
+    stats.misses++;
+
+    // (written to a temporary directory first, so interrupted imports don't
+    // leave incomplete entries)
+    const tempPath = `${entryPath}.${process.pid}.${tempId++}.tmp`;
+    mkdirp.sync(tempPath);
+    extensions.forEach((it) => {
+      if (fs.existsSync(outputFile(it)))
+        fs.copyFileSync(outputFile(it), $path.join(tempPath, it));
+    });
+    try {
+      fs.renameSync(tempPath, entryPath);
+    } catch (e) {
+      // (another job with the same key finished first)
+      fs.rmSync(tempPath, { recursive: true, force: true });
+    }
+  },
+};
@@ -1,5 +1,6 @@
 const Channels = require("./parser/Channels");
 const importers = require("./importers");
+const cache = require("./cache");
 const {
   getOffsetCorrections,
 } = require("./importers/transformations/applyOffsets");
@@ -32,6 +33,7 @@ const DEFAULT_OUTPUT_PATH = $path.resolve(CONTENT_PATH, "_compiled_files");
 const DEFAULT_ASSETS_PATH = $path.resolve(DATA_PATH, "assets");
 const DEFAULT_VIDEOLIB_PATH = $path.resolve(CONTENT_PATH, "piuGBA_videos");
 const DEFAULT_HQAUDIOLIB_PATH = $path.resolve(CONTENT_PATH, "piuGBA_audios");
+const DEFAULT_CACHE_PATH = $path.resolve(CONTENT_PATH, "_importer_cache");
 
 const ID_SIZE = 3;
 const MAX_FILE_LENGTH = 15;
@@ -66,7 +68,9 @@ const expectedMajor = (() => {
   }
 })();
 const [major] = process.versions.node.split(".");
-if (expectedMajor != null && major != expectedMajor) {
+// (tests can run the importer with any version, see `tests/importer`)
+const checkNodeVersion = process.env.IMPORTER_NODE_CHECK !== "false";
+if (checkNodeVersion && expectedMajor != null && major != expectedMajor) {
   throw new Error(
     `invalid_node_version: expected ${expectedMajor} but found ${major}`
   );
@@ -116,6 +120,26 @@ const opt = getopt
       "fast=FAST",
       "fast mode (uses async I/O, may disrupt stdout order) (one of: *false*|true)",
     ],
+    [
+      "p",
+      "poolcheck=POOLCHECK",
+      "arrow pool overflow check (one of: off|*warn*|fail)",
+    ],
+    [
+      "z",
+      "compress=COMPRESS",
+      "compress chart events and video frames with LZ77 (one of: false|*true*)",
+    ],
+    [
+      "c",
+      "cache=CACHE",
+      "reuse converted audio, images and videos from previous imports (one of: false|*true*)",
+    ],
+    [
+      "k",
+      "cachedir=CACHEDIR",
+      "cache directory (defaults to: ../../../src/data/content/_importer_cache)",
+    ],
     ["j", "json", "generate JSON debug files"],
   ])
   .bindHelp()
@@ -142,6 +166,11 @@ GLOBAL_OPTIONS.hqaudioenable = GLOBAL_OPTIONS.hqaudioenable === "true";
 GLOBAL_OPTIONS.boss = GLOBAL_OPTIONS.boss !== "false";
 GLOBAL_OPTIONS.arcade = GLOBAL_OPTIONS.arcade === "true";
 GLOBAL_OPTIONS.fast = GLOBAL_OPTIONS.fast === "true";
+GLOBAL_OPTIONS.compress = GLOBAL_OPTIONS.compress !== "false";
+GLOBAL_OPTIONS.cache = GLOBAL_OPTIONS.cache !== "false";
+GLOBAL_OPTIONS.cachedir = $path.resolve(
+  GLOBAL_OPTIONS.cachedir || DEFAULT_CACHE_PATH
+);
 
 const AUDIO_PATH = $path.resolve(GLOBAL_OPTIONS.assets, "audio");
 const IMAGES_PATH = $path.resolve(GLOBAL_OPTIONS.assets, "images");
@@ -232,6 +261,7 @@ async function run() {
   mkdirp.sync(GLOBAL_OPTIONS.output);
   if (GLOBAL_OPTIONS.videoenable) mkdirp.sync(GLOBAL_OPTIONS.videolib);
   if (GLOBAL_OPTIONS.hqaudioenable) mkdirp.sync(GLOBAL_OPTIONS.hqaudiolib);
+  if (GLOBAL_OPTIONS.cache) mkdirp.sync(GLOBAL_OPTIONS.cachedir);
 
   // ------------
   // AUDIO ASSETS
@@ -458,6 +488,15 @@ async function run() {
     );
   }
 
+  // -------------
+  // LIBRARY STATS
+  // -------------
+
+  importers.libraryStats(
+    processedSongs.concat(processedBonusSongs),
+    GLOBAL_OPTIONS.output
+  );
+
   // ------------
   // SONG SORTING
   // ------------
@@ -642,6 +681,12 @@ BOUNCE=ALL;`
   } catch (e) {}
   fs.writeFileSync($path.join(GLOBAL_OPTIONS.output, ROM_NAME_FILE), name);
 
+  // -------------
+  // LIBRARY INDEX
+  // -------------
+
+  importers.libraryIndex(sortedSongsByLevel, GLOBAL_OPTIONS.output);
+
   // ----------
   // SONG LISTS
   // ----------
@@ -698,6 +743,13 @@ BOUNCE=ALL;`
     console.log(`${k}: `.bold + count.toString().cyan);
   });
   console.log("TOTAL: ".bold + processedSongs.length.toString().cyan);
+  if (GLOBAL_OPTIONS.cache) {
+    console.log(
+      "CACHE: ".bold +
+        `${cache.stats.hits.toString().cyan} reused, ` +
+        `${cache.stats.misses.toString().cyan} converted`
+    );
+  }
 
   // --------------------
   // UNUSED OFFSETS CHECK
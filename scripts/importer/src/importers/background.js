@@ -1,4 +1,5 @@
 const utils = require("../utils");
+const cache = require("../cache");
 const $path = require("path");
 const _ = require("lodash");
 
@@ -19,6 +20,7 @@ const COMMAND_FIX = (input) => `pngfix -f "${input}"`;
 const RESOLUTION = "240x160!";
 const COLORS = "253";
 const EXTENSIONS_TMP = ["pal.bmp", "bmp", "h"];
+const EXTENSIONS_OUTPUT = ["img.bin", "pal.bin", "map.bin"];
 const EXTENSION_FIXED = "-fixed.png";
 const UNIQUE_MAP_MD5SUM = "f4eda4328302c379fd68847b35e9d8a8";
 
@@ -33,6 +35,18 @@ module.exports = async (
   transparentColor = null,
   colors = 254
 ) => {
+  const key = {
+    inputs: [filePath, transparentColor],
+    options: { colors },
+    sources: [__filename],
+  };
+
+  await cache.run(name, outputPath, EXTENSIONS_OUTPUT, key, () =>
+    build(name, filePath, outputPath, transparentColor, colors)
+  );
+};
+
+const build = async (name, filePath, outputPath, transparentColor, colors) => {
   const tempFiles = EXTENSIONS_TMP.map((it) =>
     $path.join(outputPath, `${name}.${it}`)
   );
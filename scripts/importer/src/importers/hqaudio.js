@@ -1,4 +1,5 @@
 const utils = require("../utils");
+const cache = require("../cache");
 const $path = require("path");
 
 const COMMAND = (input, output) =>
@@ -6,7 +7,9 @@ const COMMAND = (input, output) =>
 const EXTENSION = "aud.bin";
 
 module.exports = async (name, filePath, outputPath) => {
-  await utils.run(
-    COMMAND(filePath, $path.join(outputPath, `${name}.${EXTENSION}`))
+  const key = { inputs: [filePath], sources: [__filename] };
+
+  await cache.run(name, outputPath, [EXTENSION], key, () =>
+    utils.run(COMMAND(filePath, $path.join(outputPath, `${name}.${EXTENSION}`)))
   );
 };
@@ -4,5 +4,16 @@ const hqaudio = require("./hqaudio");
 const background = require("./background");
 const video = require("./video");
 const selector = require("./selector");
+const libraryIndex = require("./libraryIndex");
+const libraryStats = require("./libraryStats");
 
-module.exports = { metadata, audio, hqaudio, background, video, selector };
+module.exports = {
+  metadata,
+  audio,
+  hqaudio,
+  background,
+  video,
+  selector,
+  libraryIndex,
+  libraryStats,
+};
@@ -0,0 +1,68 @@
+const fs = require("fs");
+const $path = require("path");
+const _ = require("lodash");
+
+const FILE_NAME = "_library.idx";
+const LEVELS = ["NORMAL", "HARD", "CRAZY", "BONUS"];
+const GBFS_NAME_LENGTH = 24;
+const SONG_NAME_LENGTH = 16;
+const HEADER_SIZE = LEVELS.length * 4;
+const ROW_SIZE = 20;
+const NO_ENTRY = 0xffff;
+const METADATA_EXTENSION = ".pius";
+
+// `gbfs` sorts its directory by the nul-padded file name (like `memcmp`),
+// so entry indexes can be precomputed as long as this runs after every
+// other file has been written. `make import` packs `*`, which skips hidden
+// files and folders. (the game checks each entry's name anyway)
+const paddedName = (name) => {
+  const buffer = Buffer.alloc(GBFS_NAME_LENGTH);
+  buffer.write(name.substring(0, GBFS_NAME_LENGTH), "ascii");
+  return buffer;
+};
+
+module.exports = (sortedSongsByLevel, outputPath) => {
+  const fileNames = _.uniq(
+    fs
+      .readdirSync(outputPath, { withFileTypes: true })
+      .filter((it) => it.isFile() && !it.name.startsWith("."))
+      .map((it) => it.name)
+      .concat(FILE_NAME)
+  );
+  const directory = fileNames
+    .map((name) => ({ name, key: paddedName(name) }))
+    .sort((a, b) => Buffer.compare(a.key, b.key))
+    .map(({ name }) => name);
+  const entryOf = (name) => {
+    const entry = directory.indexOf(name);
+    return entry >= 0 ? entry : NO_ENTRY;
+  };
+
+  const lists = LEVELS.map((level) => {
+    const list = _.find(sortedSongsByLevel, { difficultyLevel: level });
+    return list != null ? list.songs.map(({ song }) => song) : [];
+  });
+  const rowCount = _.sumBy(lists, "length");
+  const buffer = Buffer.alloc(HEADER_SIZE + rowCount * ROW_SIZE);
+
+  let row = HEADER_SIZE;
+  lists.forEach((songs, i) => {
+    buffer.writeUInt32LE(songs.length, i * 4);
+
+    songs.forEach(({ id, outputName }) => {
+      buffer.write(
+        outputName.substring(0, SONG_NAME_LENGTH - 1),
+        row,
+        "ascii"
+      );
+      buffer.writeUInt16LE(
+        entryOf(outputName + METADATA_EXTENSION),
+        row + SONG_NAME_LENGTH
+      );
+      buffer.writeUInt8(id, row + SONG_NAME_LENGTH + 2);
+      row += ROW_SIZE;
+    });
+  });
+
+  fs.writeFileSync($path.join(outputPath, FILE_NAME), buffer);
+};
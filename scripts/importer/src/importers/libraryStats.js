@@ -0,0 +1,43 @@
+const fs = require("fs");
+const $path = require("path");
+
+const FILE_NAME = "_library_stats.bin";
+const HEADER_SIZE = 4;
+const SONG_NAME_LENGTH = 16;
+const ROW_SIZE = 32; // (sizeof(SongStats))
+const MAX_LEVEL = 103; // (13 bytes of level bitmask)
+
+// A u32 count followed by one row per song id (see `LibraryStats.h`):
+// name (SONG_NAME_LENGTH), singleCount (u8), doubleCount (u8), singleLevels
+// (bitmask), reserved. Names are there for libraries without ids, like the
+// SD card's text lists.
+module.exports = (songs, outputPath) => {
+  const count = Math.max(0, ...songs.map(({ song }) => song.id + 1));
+  const buffer = Buffer.alloc(HEADER_SIZE + count * ROW_SIZE);
+  buffer.writeUInt32LE(count, 0);
+
+  songs.forEach(({ song, simfile }) => {
+    const row = HEADER_SIZE + song.id * ROW_SIZE;
+    const counts = row + SONG_NAME_LENGTH;
+    const levels = counts + 2;
+    buffer.write(
+      song.outputName.substring(0, SONG_NAME_LENGTH - 1),
+      row,
+      "ascii"
+    );
+
+    simfile.charts.forEach(({ header }) => {
+      const isDouble = header.isMultiplayer || header.isDouble;
+      if (isDouble) {
+        buffer[counts + 1] = Math.min(buffer[counts + 1] + 1, 0xff);
+        return;
+      }
+
+      buffer[counts] = Math.min(buffer[counts] + 1, 0xff);
+      const level = Math.min(header.level, MAX_LEVEL);
+      buffer[levels + Math.floor(level / 8)] |= 1 << level % 8;
+    });
+  });
+
+  fs.writeFileSync($path.join(outputPath, FILE_NAME), buffer);
+};
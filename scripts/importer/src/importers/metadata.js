@@ -1,6 +1,7 @@
 const Simfile = require("../parser/Simfile");
 const SongSerializer = require("../serializer/SongSerializer");
 const checkIntegrity = require("./transformations/checkIntegrity");
+const checkArrowPool = require("./transformations/checkArrowPool");
 const { applyOffsets } = require("./transformations/applyOffsets");
 const completeMissingData = require("./transformations/completeMissingData");
 const fs = require("fs");
@@ -52,6 +53,26 @@ module.exports = (
   const simfile = completeMissingData(metadata, charts, isBonus);
   simfile.id = id;
 
+  if (GLOBAL_OPTIONS.poolcheck !== "off") {
+    const reports = checkArrowPool(charts);
+    reports.forEach(({ chart, worst, overflows, poolSize }) => {
+      if (_.isEmpty(overflows)) return;
+
+      const multipliers = overflows.map((it) => `${it.multiplier}x`).join(" ");
+      const message = `arrow_pool_overflow: ${chart.header.levelStr} needs ${worst.total}/${poolSize} sprites (${worst.fills} hold fills) at ${multipliers}`;
+      if (GLOBAL_OPTIONS.poolcheck === "fail")
+        throw new Error(`${message} \`${filePath}\``);
+      console.log(`  ⚠️  ${message}`.yellow);
+    });
+
+    if (GLOBAL_OPTIONS.json) {
+      simfile.arrowPool = reports.map(({ chart, results }) => ({
+        chart: chart.header.levelStr,
+        results,
+      }));
+    }
+  }
+
   if (GLOBAL_OPTIONS.json) {
     fs.writeFileSync(
       $path.join(outputPath, `${name}.${JSON_EXTENSION}`),
@@ -59,7 +80,9 @@ module.exports = (
     );
   }
 
-  const output = new SongSerializer(simfile).serialize();
+  const output = new SongSerializer(simfile, {
+    compressEvents: GLOBAL_OPTIONS.compress,
+  }).serialize();
   fs.writeFileSync($path.join(outputPath, `${name}.${EXTENSION}`), output);
 
   return simfile;
@@ -1,6 +1,7 @@
 const buildSelector = require("./selector/buildSelector");
 const { FIX_FILE_PATH } = require("./background");
 const utils = require("../utils");
+const cache = require("../cache");
 const $path = require("path");
 const $tmp = require("tmp");
 const fs = require("fs");
@@ -15,11 +16,31 @@ const COMMAND_ENCODE = (input) =>
 const COMMAND_CLEANUP = (tmpDir, tmpFile) =>
   `rm -rf "${tmpDir}" && rm "${tmpFile}"`;
 const EXTENSION_TMP = "h";
+const EXTENSIONS_OUTPUT = ["img.bin", "pal.bin", "map.bin"];
+
+const getBackgroundFile = ({ backgroundFile }) =>
+  fs.existsSync(FIX_FILE_PATH(backgroundFile))
+    ? FIX_FILE_PATH(backgroundFile)
+    : backgroundFile;
 
 module.exports = async (name, options, outputPath, selectorDir, isBonus) => {
+  const bmp = isBonus ? SELECTOR_BNS_BMP : SELECTOR_BMP;
+  const key = {
+    inputs: [
+      $path.join(selectorDir, bmp),
+      ...options.map(({ files }) => getBackgroundFile(files)),
+    ],
+    sources: [__filename, require.resolve("./selector/buildSelector")],
+  };
+
+  await cache.run(name, outputPath, EXTENSIONS_OUTPUT, key, () =>
+    build(name, options, outputPath, selectorDir, bmp)
+  );
+};
+
+const build = async (name, options, outputPath, selectorDir, bmp) => {
   const tempDir = $tmp.dirSync();
   const tempFile = $path.join(outputPath, `${name}.${EXTENSION_TMP}`);
-  const bmp = isBonus ? SELECTOR_BNS_BMP : SELECTOR_BMP;
 
   fs.writeFileSync(
     $path.join(tempDir.name, SELECTOR_MSL),
@@ -30,17 +51,10 @@ module.exports = async (name, options, outputPath, selectorDir, isBonus) => {
     $path.join(tempDir.name, SELECTOR_BMP)
   );
   options.forEach(({ files }, i) => {
-    try {
-      fs.copyFileSync(
-        FIX_FILE_PATH(files.backgroundFile),
-        $path.join(tempDir.name, `song${i + 1}.png`)
-      );
-    } catch (e) {
-      fs.copyFileSync(
-        files.backgroundFile,
-        $path.join(tempDir.name, `song${i + 1}.png`)
-      );
-    }
+    fs.copyFileSync(
+      getBackgroundFile(files),
+      $path.join(tempDir.name, `song${i + 1}.png`)
+    );
   });
 
   const outputImage = $path.join(tempDir.name, `${name}.bmp`);
@@ -0,0 +1,125 @@
+const Events = require("../../parser/Events");
+const _ = require("lodash");
+
+// Mirrors the constants used by the game's `ChartReader`/`SongScene`:
+const ARROW_POOL_SIZE = 78;
+const ARROW_SIZE = 16;
+const ARROW_INITIAL_Y = 160;
+const ARROW_FINAL_Y = 15;
+const ARROW_OFFSCREEN_LIMIT = -13;
+const ARROW_DISTANCE = ARROW_INITIAL_Y - ARROW_FINAL_Y;
+const MULTIPLIERS = [1, 2, 3, 4, 5, 6];
+const MAX_ARROW_TIME = 2426;
+const MINUTE = 60000;
+const ARROW_SCROLL_LENGTH_BEATS = 8;
+const FRAME_MS = 16.7427;
+
+/**
+ * Simulates every chart at every speed multiplier and reports the peak
+ * number of live arrow sprites (taps, hold heads and tails), hold fills, and
+ * their total, which must fit in the game's arrow pool.
+ * Assumptions:
+ * - Worst case: no arrow is hit, so every sprite lives until it scrolls out.
+ * - Rate mods are not simulated, because arrow lifetimes are measured in song
+ *   time and the game doesn't change them with the rate.
+ * - Stops and scroll speed easing are ignored.
+ */
+module.exports = (charts) => {
+  return charts.map((chart) => {
+    const events = chart.events;
+    const tempos = events.filter((it) => it.type === Events.SET_TEMPO);
+    const taps = events
+      .filter((it) => it.type === Events.NOTE)
+      .map((it) => ({
+        timestamp: it.timestamp,
+        count: countArrows(it),
+      }));
+    const holds = _.sortBy(
+      events
+        .filter((it) => it.type === Events.HOLD_START)
+        .map((it) => ({
+          start: it.timestamp,
+          end: it.timestamp + (it.length || 0),
+          count: countArrows(it),
+        })),
+      "start"
+    );
+    const lastTimestamp = Math.max(
+      _.maxBy(taps, "timestamp")?.timestamp || 0,
+      _.maxBy(holds, "end")?.end || 0
+    );
+
+    const results = MULTIPLIERS.map((multiplier) =>
+      simulate(tempos, taps, holds, lastTimestamp, multiplier)
+    );
+    const worst = _.maxBy(results, "total");
+    const overflows = results.filter((it) => it.total > ARROW_POOL_SIZE);
+
+    return { chart, results, worst, overflows, poolSize: ARROW_POOL_SIZE };
+  });
+};
+
+const simulate = (tempos, taps, holds, lastTimestamp, multiplier) => {
+  const tapPrefix = [0];
+  taps.forEach((it, i) => tapPrefix.push(tapPrefix[i] + it.count));
+  const tapTimestamps = taps.map((it) => it.timestamp);
+
+  let peak = { arrows: 0, fills: 0, total: 0, timestamp: 0 };
+  let tempoIndex = -1;
+  let holdIndex = 0;
+  let activeHolds = [];
+
+  for (let now = 0; now <= lastTimestamp + MAX_ARROW_TIME; now += FRAME_MS) {
+    while (
+      tempoIndex + 1 < tempos.length &&
+      tempos[tempoIndex + 1].timestamp <= now
+    )
+      tempoIndex++;
+    const scrollBpm = tempoIndex >= 0 ? tempos[tempoIndex].scrollBpm : 0;
+    const arrowTime = getArrowTime(scrollBpm, multiplier);
+    const yFor = (timestamp) =>
+      ARROW_FINAL_Y + ((timestamp - now) * ARROW_DISTANCE) / arrowTime;
+    const exitTime =
+      (-(ARROW_OFFSCREEN_LIMIT - ARROW_FINAL_Y) * arrowTime) / ARROW_DISTANCE;
+    const from = now - exitTime;
+    const to = now + arrowTime;
+
+    let arrows =
+      tapPrefix[_.sortedLastIndex(tapTimestamps, to)] -
+      tapPrefix[_.sortedIndex(tapTimestamps, from)];
+    let fills = 0;
+
+    while (holdIndex < holds.length && holds[holdIndex].start <= to)
+      activeHolds.push(holds[holdIndex++]);
+    activeHolds = activeHolds.filter((it) => it.end >= from);
+
+    activeHolds.forEach((hold) => {
+      const top = Math.max(yFor(hold.start), ARROW_OFFSCREEN_LIMIT);
+      const bottom = Math.min(yFor(hold.end), ARROW_INITIAL_Y);
+      const isHeadVisible = hold.start >= from;
+      const isTailVisible = hold.end <= to;
+      arrows += hold.count * (isHeadVisible + isTailVisible);
+      fills += hold.count * Math.ceil(Math.max(bottom - top, 0) / ARROW_SIZE);
+    });
+
+    if (arrows + fills > peak.total)
+      peak = { arrows, fills, total: arrows + fills, timestamp: now };
+  }
+
+  return { multiplier, ...peak };
+};
+
+const getArrowTime = (scrollBpm, multiplier) => {
+  if (!(scrollBpm > 0)) return MAX_ARROW_TIME;
+
+  return Math.max(
+    Math.min(
+      (MINUTE * ARROW_SCROLL_LENGTH_BEATS) / (scrollBpm * multiplier),
+      MAX_ARROW_TIME
+    ),
+    1
+  );
+};
+
+const countArrows = (event) =>
+  _.sumBy([...event.arrows, ...(event.arrows2 || [])], (it) => (it ? 1 : 0));
@@ -1,4 +1,6 @@
+const VideoSerializer = require("../serializer/VideoSerializer");
 const utils = require("../utils");
+const cache = require("../cache");
 const $path = require("path");
 const fs = require("fs");
 
@@ -33,11 +35,25 @@ const RESOLUTION = "240x160!";
 const COLORS = "253";
 const EXTENSIONS_TMP = ["pal.bmp", "bmp", "h"];
 
-const COMMAND_APPEND = (input1, input2, input3, output) =>
-  `cat "${input1}" "${input2}" "${input3}" >> "${output}"`;
-
 module.exports = async (outputName, filePath, outputPath, transparentColor) => {
+  const key = {
+    inputs: [filePath, transparentColor],
+    options: { compress: GLOBAL_OPTIONS.compress },
+    sources: [
+      __filename,
+      require.resolve("../serializer/VideoSerializer"),
+      require.resolve("../serializer/lz77"),
+    ],
+  };
+
+  await cache.run(outputName, outputPath, [EXTENSION], key, () =>
+    build(outputName, filePath, outputPath, transparentColor)
+  );
+};
+
+const build = async (outputName, filePath, outputPath, transparentColor) => {
   let fastSetting = GLOBAL_OPTIONS.fast;
+  const compressSetting = GLOBAL_OPTIONS.compress;
   try {
     GLOBAL_OPTIONS.fast = true;
     const tempPath = `${filePath}_tmp`;
@@ -80,19 +96,28 @@ module.exports = async (outputName, filePath, outputPath, transparentColor) => {
     console.log(`  ⏳  Adding video frames ${outputName}...`);
     const outputFilePath = $path.join(outputPath, `${outputName}.${EXTENSION}`);
     await utils.run(COMMAND_RM_F(outputFilePath));
+    const serializer = new VideoSerializer(frames.length, {
+      compress: compressSetting,
+    });
     for (let frame of frames) {
       const name = $path.parse(frame).name;
       const baseFile = $path.join(tempPath, name);
 
-      await utils.run(
-        COMMAND_APPEND(
-          `${baseFile}.pal.bin`,
-          `${baseFile}.map.bin`,
-          `${baseFile}.img.bin`,
-          outputFilePath
-        )
+      serializer.addFrame(
+        fs.readFileSync(`${baseFile}.pal.bin`),
+        fs.readFileSync(`${baseFile}.map.bin`),
+        fs.readFileSync(`${baseFile}.img.bin`)
       );
     }
+    fs.writeFileSync(outputFilePath, serializer.serialize());
+
+    const stats = serializer.stats();
+    console.log(
+      `  📢  (${outputName}) | ${stats.frames} frames, ` +
+        `${stats.averageBytes} bytes/frame (max: ${stats.maxBytes}), ` +
+        `${stats.averageTiles} new tiles/frame, ` +
+        `${stats.tornFrames} frames that may tear`
+    );
 
     await utils.run(COMMAND_RM_RF(tempPath));
   } finally {
@@ -1,7 +1,6 @@
 const Chart = require("./Chart");
 const Channels = require("./Channels");
 const DifficultyLevels = require("./DifficultyLevels");
-const Events = require("./Events");
 const Mods = require("./Mods");
 const utils = require("../utils");
 const _ = require("lodash");
@@ -157,18 +156,7 @@ module.exports = class Simfile {
           const chart = new Chart(this.metadata, header, rawNotes);
           chart.index = i;
 
-          const events = chart.events; // (ensure it can be parsed correctly)
-
-          // check limits
-          const [rhythmEvents, normalEvents] = _.partition(
-            events,
-            (it) =>
-              it.type === Events.SET_TEMPO || it.type === Events.SET_TICKCOUNT
-          );
-          if (rhythmEvents.length + normalEvents.length > MAX_EVENTS)
-            throw new Error(
-              `too_big: (${rhythmEvents.length} rhythm + ${normalEvents.length} normal) events`
-            );
+          chart.events; // (ensure it can be parsed correctly)
 
           return chart;
         } catch (e) {
@@ -345,6 +333,5 @@ const REGEXPS = {
   },
 };
 
-const MAX_EVENTS = 3250;
 const SECOND = 1000;
 const MINUTE = 60 * SECOND;
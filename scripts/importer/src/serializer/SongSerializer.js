@@ -3,20 +3,25 @@ const Events = require("../parser/Events");
 const DifficultyLevels = require("../parser/DifficultyLevels");
 const Channels = require("../parser/Channels");
 const Mods = require("../parser/Mods");
+const lz77 = require("./lz77");
 const _ = require("lodash");
 
 let TMP = {};
 
 module.exports = class SongSerializer {
-  constructor(simfile) {
+  constructor(simfile, options = {}) {
     this.simfile = simfile;
+    this.options = options;
     this.protocol = new Protocol();
 
     this._defineTypes();
   }
 
   serialize() {
-    TMP = {};
+    TMP = {
+      protocol: this.protocol,
+      compressEvents: !!this.options.compressEvents,
+    };
 
     const buffer = this.protocol.write();
     const { id, metadata, charts } = this.simfile;
@@ -74,18 +79,35 @@ module.exports = class SongSerializer {
             it.type === Events.SET_TEMPO || it.type === Events.SET_TICKCOUNT
         );
 
-        const eventChunkSize = _.sumBy(events, (it) =>
-          EVENT_SERIALIZERS.get(it).size(it)
-        );
-
+        const type =
+          chart.header.isMultiplayer ? 2 : chart.header.isDouble ? 1 : 0;
         this.UInt8(DifficultyLevels[chart.header.difficulty])
           .UInt8(chart.header.level)
           .UInt8(chart.header.variant.charCodeAt(0))
-          .UInt8(chart.header.offsetLabel.charCodeAt(0))
-          .UInt8(chart.header.isMultiplayer ? 2 : chart.header.isDouble ? 1 : 0)
-          .UInt32LE(4 * 2 /* (eventCounts) */ + eventChunkSize)
-          .EventArray(rhythmEvents)
-          .EventArray(normalEvents);
+          .UInt8(chart.header.offsetLabel.charCodeAt(0));
+
+        if (TMP.compressEvents) {
+          const rhythmBlocks = compressEvents(rhythmEvents);
+          const normalBlocks = compressEvents(normalEvents);
+
+          this.UInt8(type | COMPRESSED_EVENTS_FLAG)
+            .UInt32LE(
+              4 * 2 * 2 /* (eventCounts + compressedSizes) */ +
+                rhythmBlocks.length +
+                normalBlocks.length
+            )
+            .CompressedEventArray(rhythmEvents.length, rhythmBlocks)
+            .CompressedEventArray(normalEvents.length, normalBlocks);
+        } else {
+          const eventChunkSize = _.sumBy(events, (it) =>
+            EVENT_SERIALIZERS.get(it).size(it)
+          );
+
+          this.UInt8(type)
+            .UInt32LE(4 * 2 /* (eventCounts) */ + eventChunkSize)
+            .EventArray(rhythmEvents)
+            .EventArray(normalEvents);
+        }
       },
     });
 
@@ -107,9 +129,28 @@ module.exports = class SongSerializer {
         this.UInt32LE(events.length).loop(events, this.Event);
       },
     });
+
+    this.protocol.define("CompressedEventArray", {
+      write: function (count, blocks) {
+        this.UInt32LE(count)
+          .UInt32LE(blocks.length)
+          .loop(Array.from(blocks), this.UInt8);
+      },
+    });
   }
 };
 
+// Events are compressed in independent blocks, so the game can decompress
+// them as the song advances (see `EventStream`)
+const compressEvents = (events) =>
+  Buffer.concat(
+    _.chunk(events, EVENTS_PER_BLOCK).map((block) => {
+      const writer = TMP.protocol.write();
+      writer.loop(block, writer.Event);
+      return lz77(writer.result);
+    })
+  );
+
 const SERIALIZE_ARROWS = (arrows) =>
   _.range(0, 5).reduce(
     (accum, elem) => accum | (arrows[elem] ? ARROW_MASKS[elem] : 0),
@@ -251,6 +292,8 @@ const normalizeInt = (number) => {
   return array[0];
 };
 
+const COMPRESSED_EVENTS_FLAG = 0x80;
+const EVENTS_PER_BLOCK = 128; // (EVENT_STREAM_BLOCK_EVENTS)
 const TITLE_LEN = 30 + 1; // +1 = \0;
 const ARTIST_LEN = 26 + 1; // +1 = \0;
 const MESSAGE_LEN = 25 + 2 + 25 + 2 + 25 + 2 + 25 + 1; // +2 = \r\n ; +1 = \0
@@ -0,0 +1,291 @@
+const lz77 = require("./lz77");
+
+// Mirrors the format read by the game's `VideoStore`:
+// - Header (1 sector): magic, frame count, keyframe interval, keyframe count.
+// - Keyframe table: (first sector, sector count) of each keyframe.
+// - Records, each one padded to a sector:
+//   - Size of the next frame in sectors (u16), number of tile runs (u16),
+//     sectors to skip before the next frame (u16), reserved (u16).
+//   - Palette (512 bytes).
+//   - Map (a block, 2048 bytes).
+//   - Tile runs: first slot (u16), tile count (u16), tiles (a block).
+// - Blocks: stored size (u24) and flags (u8, 1 = LZ77), then the data
+//   padded to 4 bytes.
+// Tiles live in fixed VRAM slots. Frames only send the tiles that aren't
+// already in a slot, compared by color since each frame has its own palette
+// (palettes are reordered so that shared colors keep their index). New tiles
+// avoid the slots on screen, so they can be written while it's displayed.
+// Every `keyframeInterval` frames, a keyframe record with all the tiles of
+// the frame is stored before the normal one. It's only read after seeking.
+const MAGIC = 0x32444956; // ("VID2")
+const SECTOR = 512;
+const SIZE_PALETTE = 512;
+const SIZE_MAP = 2048;
+const TILE_SIZE = 64;
+const TOTAL_SLOTS = 768; // (the maps start at 48KB)
+const MAP_TILE_MASK = 0x3ff;
+const FIRST_COLOR = 1; // (0 is always black)
+const LAST_COLOR = 253; // (254 and 255 belong to the game)
+const KEYFRAME_INTERVAL = 30;
+const MAX_KEYFRAMES = 512;
+const MAX_FRAME_SECTORS = 84;
+const HEADER_SIZE = 8;
+const BLOCK_COMPRESSED = 1;
+
+module.exports = class VideoSerializer {
+  constructor(frameCount, options = {}) {
+    this.compress = !!options.compress;
+    this.keyframeInterval = Math.max(
+      KEYFRAME_INTERVAL,
+      Math.ceil(frameCount / MAX_KEYFRAMES)
+    );
+    this.frames = [];
+    this.slots = [];
+    this.displayedSlots = new Set();
+    this.colors = null;
+  }
+
+  addFrame(palette, map, tiles) {
+    const index = this.frames.length;
+    const isKeyframe = index % this.keyframeInterval === 0;
+
+    const { colors, indexes } = this._stabilizePalette(palette);
+    palette = Buffer.alloc(SIZE_PALETTE);
+    colors.forEach((it, i) => palette.writeUInt16LE(it, i * 2));
+    tiles = tiles.map((it) => indexes[it]);
+    const keyOf = (data, offset) =>
+      String.fromCharCode(
+        ...Array.from(
+          data.subarray(offset, offset + TILE_SIZE),
+          (it) => colors[it]
+        )
+      );
+
+    const mapEntries = [];
+    for (let i = 0; i < SIZE_MAP / 2; i++)
+      mapEntries.push(i * 2 < map.length ? map.readUInt16LE(i * 2) : 0);
+    const tileCount =
+      Math.max(...mapEntries.map((it) => it & MAP_TILE_MASK)) + 1;
+    if (tileCount > TOTAL_SLOTS)
+      throw new Error(`too many tiles in a frame: ${tileCount}`);
+
+    // reuse the slots that already show the same colors
+    const slotsByKey = new Map();
+    this.slots.forEach((slot, i) => {
+      const key = keyOf(slot, 0);
+      if (!slotsByKey.has(key)) slotsByKey.set(key, i);
+    });
+    const slotOfTile = [];
+    const isUsed = new Array(TOTAL_SLOTS).fill(false);
+    const pending = [];
+    for (let tile = 0; tile < tileCount; tile++) {
+      const key = keyOf(tiles, tile * TILE_SIZE);
+      const slot = slotsByKey.get(key);
+      if (slot !== undefined) {
+        slotOfTile[tile] = slot;
+        isUsed[slot] = true;
+      } else pending.push({ tile, key });
+    }
+
+    // write the rest into free slots, off-screen ones first
+    const offscreenSlots = [];
+    const onscreenSlots = [];
+    for (let slot = 0; slot < TOTAL_SLOTS; slot++) {
+      if (isUsed[slot]) continue;
+      if (this.displayedSlots.has(slot)) onscreenSlots.push(slot);
+      else offscreenSlots.push(slot);
+    }
+    const freeSlots = [...offscreenSlots, ...onscreenSlots];
+    const written = [];
+    const newSlotsByKey = new Map();
+    let isTorn = false;
+    pending.forEach(({ tile, key }) => {
+      if (newSlotsByKey.has(key)) {
+        slotOfTile[tile] = newSlotsByKey.get(key);
+        return;
+      }
+
+      const slot = freeSlots[written.length];
+      const offset = tile * TILE_SIZE;
+      this.slots[slot] = Buffer.from(
+        tiles.subarray(offset, offset + TILE_SIZE)
+      );
+      if (this.displayedSlots.has(slot)) isTorn = true;
+      slotOfTile[tile] = slot;
+      newSlotsByKey.set(key, slot);
+      written.push(slot);
+    });
+
+    const newMap = Buffer.alloc(SIZE_MAP);
+    mapEntries.forEach((entry, i) => {
+      const slot = slotOfTile[entry & MAP_TILE_MASK];
+      newMap.writeUInt16LE((entry & ~MAP_TILE_MASK) | slot, i * 2);
+    });
+    const displayedSlots = new Set(slotOfTile);
+
+    // (keyframes restore only the slots on screen, so forget the rest)
+    let keyframe = null;
+    if (isKeyframe) {
+      this.slots.forEach((_, i) => {
+        if (!displayedSlots.has(i)) delete this.slots[i];
+      });
+      keyframe = this._record(palette, newMap, [...displayedSlots]);
+    }
+    const frame = index > 0 ? this._record(palette, newMap, written) : null;
+    this.displayedSlots = displayedSlots;
+
+    this.frames.push({ frame, keyframe, tiles: written.length, isTorn });
+  }
+
+  serialize() {
+    const records = [];
+    this.frames.forEach(({ frame, keyframe }, i) => {
+      const next = this.frames[i + 1];
+      const nextSectors = next ? this._sectors(next.frame) : 0;
+
+      if (keyframe) {
+        keyframe.writeUInt16LE(nextSectors, 0);
+        keyframe.writeUInt16LE(this._sectors(frame), 4);
+        records.push({ buffer: keyframe, isKeyframe: true });
+      }
+      if (frame) {
+        frame.writeUInt16LE(nextSectors, 0);
+        frame.writeUInt16LE(next ? this._sectors(next.keyframe) : 0, 4);
+        records.push({ buffer: frame, isKeyframe: false });
+      }
+    });
+
+    let sector = 1 + this._keyframeTableSectors();
+    const keyframes = [];
+    records.forEach(({ buffer, isKeyframe }) => {
+      const sectors = this._sectors(buffer);
+      if (isKeyframe) keyframes.push({ sector, sectors });
+      sector += sectors;
+    });
+
+    const header = Buffer.alloc(SECTOR);
+    header.writeUInt32LE(MAGIC, 0);
+    header.writeUInt32LE(this.frames.length, 4);
+    header.writeUInt32LE(this.keyframeInterval, 8);
+    header.writeUInt32LE(keyframes.length, 12);
+    const table = Buffer.alloc(this._keyframeTableSectors() * SECTOR);
+    keyframes.forEach(({ sector, sectors }, i) => {
+      table.writeUInt32LE(sector, i * 8);
+      table.writeUInt32LE(sectors, i * 8 + 4);
+    });
+
+    return Buffer.concat([header, table, ...records.map((it) => it.buffer)]);
+  }
+
+  stats() {
+    const frames = this.frames.filter((it) => it.frame);
+    const bytes = frames.map((it) => it.frame.length);
+    const tiles = frames.map((it) => it.tiles);
+    const average = (values) =>
+      Math.round(values.reduce((a, b) => a + b, 0) / values.length);
+
+    return {
+      frames: this.frames.length,
+      averageBytes: average(bytes),
+      maxBytes: Math.max(...bytes),
+      averageTiles: average(tiles),
+      tornFrames: frames.filter((it) => it.isTorn).length,
+    };
+  }
+
+  _record(palette, map, slots) {
+    const runs = [];
+    slots
+      .sort((a, b) => a - b)
+      .forEach((slot) => {
+        const last = runs[runs.length - 1];
+        if (last && last.firstSlot + last.count === slot) last.count++;
+        else runs.push({ firstSlot: slot, count: 1 });
+      });
+
+    const header = Buffer.alloc(HEADER_SIZE);
+    header.writeUInt16LE(runs.length, 2);
+    const parts = [header, palette, this._block(map)];
+    runs.forEach(({ firstSlot, count }) => {
+      const runHeader = Buffer.alloc(4);
+      runHeader.writeUInt16LE(firstSlot, 0);
+      runHeader.writeUInt16LE(count, 2);
+      const data = Buffer.concat(
+        this.slots.slice(firstSlot, firstSlot + count)
+      );
+      parts.push(runHeader, this._block(data));
+    });
+
+    const record = this._pad(Buffer.concat(parts), SECTOR);
+    if (this._sectors(record) > MAX_FRAME_SECTORS)
+      throw new Error(`frame too big: ${record.length} bytes`);
+
+    return record;
+  }
+
+  _stabilizePalette(palette) {
+    const colors = [];
+    for (let i = 0; i < SIZE_PALETTE / 2; i++)
+      colors.push(i * 2 < palette.length ? palette.readUInt16LE(i * 2) : 0);
+    const indexes = colors.map((_, i) => i);
+    const previous = this.colors;
+    this.colors = colors;
+    if (!previous) return { colors, indexes };
+
+    const previousIndexes = new Map();
+    for (let i = LAST_COLOR; i >= FIRST_COLOR; i--) {
+      const list = previousIndexes.get(previous[i]) || [];
+      list.push(i);
+      previousIndexes.set(previous[i], list);
+    }
+
+    const isTaken = [];
+    const pending = [];
+    for (let i = FIRST_COLOR; i <= LAST_COLOR; i++) {
+      const list = previousIndexes.get(colors[i]);
+      if (list && list.length > 0) {
+        indexes[i] = list.pop();
+        isTaken[indexes[i]] = true;
+      } else pending.push(i);
+    }
+    let free = FIRST_COLOR;
+    pending.forEach((i) => {
+      while (isTaken[free]) free++;
+      indexes[i] = free;
+      isTaken[free] = true;
+    });
+
+    const newColors = colors.slice();
+    for (let i = FIRST_COLOR; i <= LAST_COLOR; i++)
+      newColors[indexes[i]] = colors[i];
+    this.colors = newColors;
+
+    return { colors: newColors, indexes };
+  }
+
+  _keyframeTableSectors() {
+    const keyframes = Math.ceil(this.frames.length / this.keyframeInterval);
+    return Math.max(Math.ceil((keyframes * 8) / SECTOR), 1);
+  }
+
+  _sectors(record) {
+    return record ? record.length / SECTOR : 0;
+  }
+
+  _block(data) {
+    const compressed = this.compress ? lz77(data, { vram: true }) : null;
+    const isCompressed = compressed && compressed.length < data.length;
+    const content = isCompressed ? compressed : data;
+    const header = Buffer.alloc(4);
+    header.writeUInt32LE(
+      content.length | ((isCompressed ? BLOCK_COMPRESSED : 0) << 24)
+    );
+
+    return Buffer.concat([header, this._pad(content, 4)]);
+  }
+
+  _pad(buffer, alignment) {
+    const padding = (alignment - (buffer.length % alignment)) % alignment;
+    return Buffer.concat([buffer, Buffer.alloc(padding)]);
+  }
+};
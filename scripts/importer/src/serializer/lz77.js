@@ -0,0 +1,90 @@
+// Mirrors `LZ77_decompress` (src/utils/LZ77.h), which uses the GBA BIOS format:
+// - Header: 0x10, then the decompressed size (u24, little endian).
+// - Groups of 8 blocks, each group preceded by a flag byte (MSB first).
+// - Flag 0: a literal byte.
+// - Flag 1: a reference (2 bytes): 4 bits of (length - 3) and 12 bits of
+//   (distance - 1), copied byte by byte, so it can overlap its own output.
+// `LZ77UnCompVram` writes 16 bits at a time, so its input can't contain
+// references to the previous byte (use `{ vram: true }`).
+const LZ77_TYPE = 0x10;
+const MIN_MATCH = 3;
+const MAX_MATCH = 18;
+const WINDOW_SIZE = 4096;
+const MAX_CHAIN = 64;
+
+module.exports = (input, { vram = false } = {}) => {
+  const minDistance = vram ? 2 : 1;
+  const output = [
+    LZ77_TYPE,
+    input.length & 0xff,
+    (input.length >> 8) & 0xff,
+    (input.length >> 16) & 0xff,
+  ];
+  const heads = new Map();
+  const previous = new Int32Array(input.length).fill(-1);
+
+  const hashAt = (i) => input[i] | (input[i + 1] << 8) | (input[i + 2] << 16);
+  const insert = (i) => {
+    if (i + MIN_MATCH > input.length) return;
+    const hash = hashAt(i);
+    if (heads.has(hash)) previous[i] = heads.get(hash);
+    heads.set(hash, i);
+  };
+  const findMatch = (i) => {
+    let best = { length: 0, distance: 0 };
+    if (i + MIN_MATCH > input.length) return best;
+
+    const maxLength = Math.min(MAX_MATCH, input.length - i);
+    const hash = hashAt(i);
+    let candidate = heads.has(hash) ? heads.get(hash) : -1;
+    for (
+      let steps = 0;
+      candidate >= 0 && i - candidate <= WINDOW_SIZE && steps < MAX_CHAIN;
+      steps++
+    ) {
+      if (i - candidate < minDistance) {
+        candidate = previous[candidate];
+        continue;
+      }
+
+      let length = 0;
+      while (
+        length < maxLength &&
+        input[candidate + length] === input[i + length]
+      )
+        length++;
+      if (length > best.length) best = { length, distance: i - candidate };
+      if (length === maxLength) break;
+      candidate = previous[candidate];
+    }
+
+    return best;
+  };
+
+  let i = 0;
+  while (i < input.length) {
+    const flagsIndex = output.length;
+    output.push(0);
+
+    for (let bit = 7; bit >= 0 && i < input.length; bit--) {
+      const { length, distance } = findMatch(i);
+
+      if (length >= MIN_MATCH) {
+        const encodedDistance = distance - 1;
+        output[flagsIndex] |= 1 << bit;
+        output.push(
+          ((length - MIN_MATCH) << 4) | (encodedDistance >> 8),
+          encodedDistance & 0xff
+        );
+        for (let j = 0; j < length; j++) insert(i + j);
+        i += length;
+      } else {
+        output.push(input[i]);
+        insert(i);
+        i++;
+      }
+    }
+  }
+
+  return Buffer.from(output);
+};
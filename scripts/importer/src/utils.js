@@ -1,4 +1,5 @@
 const util = require("util");
+const os = require("os");
 const childProcess = require("child_process");
 const exec = util.promisify(childProcess.exec);
 const execSync = (...args) => {
@@ -12,7 +13,7 @@ const {
 } = require("console-table-printer/dist/src/internalTable/internal-table");
 const _ = require("lodash");
 
-const PROCESS_ASYNC_CONCURRENCY = 10;
+const PROCESS_ASYNC_CONCURRENCY = os.cpus().length;
 
 const processSync = async (content, action) => {
   const processedContent = [];
@@ -25,11 +26,19 @@ const processSync = async (content, action) => {
 const processAsync = async (content, action) => {
   return await Promise.all(content.map((content, i) => action(content, i)));
 };
-const chunkedProcessAsync = async (content, action) => {
+const pooledProcessAsync = async (content, action) => {
+  // (each worker takes the next item when it finishes, so a slow item doesn't
+  // hold back the rest like a fixed chunk would)
   const results = [];
-  const chunkedContent = _.chunk(content, PROCESS_ASYNC_CONCURRENCY);
-  for (let chunk of chunkedContent)
-    results.push(...(await processAsync(chunk, action)));
+  let next = 0;
+  const work = async () => {
+    while (next < content.length) {
+      const i = next++;
+      results[i] = await action(content[i], i);
+    }
+  };
+  const workers = Math.min(PROCESS_ASYNC_CONCURRENCY, content.length);
+  await processAsync(_.range(workers), work);
   return results;
 };
 
@@ -52,7 +61,7 @@ module.exports = {
     }
   },
   async processContent(content, action) {
-    const func = GLOBAL_OPTIONS.fast ? chunkedProcessAsync : processSync;
+    const func = GLOBAL_OPTIONS.fast ? pooledProcessAsync : processSync;
     return await func(content, action);
   },
   replaceRange(input, search, replace, start, end = input.length) {
@@ -0,0 +1,117 @@
+const fs = require("fs");
+
+// Usage: node io_trace_report.js <trace.csv>
+// Summarizes a flash cart I/O trace (written by host builds with
+// FLASHCARTIO_TRACE, see src/utils/flashcartio/diskimage/io_image.h):
+// reads and sectors per frame, seeks, repeated single-sector reads (partial
+// sector reads served again by FatFs) and modeled time per frame, by stream.
+
+const FRAME_US = 16743;
+const IO_FRAME_BUDGET_SECTORS = 48; // (src/player/io_scheduler.h)
+const STREAMS = ["audio", "video", "other"];
+
+const [tracePath] = process.argv.slice(2);
+if (!tracePath) {
+  console.error("Usage: node io_trace_report.js <trace.csv>");
+  process.exit(1);
+}
+
+const requests = fs
+  .readFileSync(tracePath, "utf8")
+  .split(/\r?\n/)
+  .slice(1)
+  .filter((it) => it.trim() !== "")
+  .map((line) => {
+    const [frame, stream, sector, count, us] = line.split(",");
+    return {
+      frame: parseInt(frame),
+      stream,
+      sector: parseInt(sector),
+      count: parseInt(count),
+      us: parseInt(us),
+    };
+  });
+if (requests.length === 0) {
+  console.log("(empty trace)");
+  process.exit(0);
+}
+
+const firstFrame = requests[0].frame;
+const frameCount = requests[requests.length - 1].frame - firstFrame + 1;
+
+const summarize = (list) => {
+  const perFrame = new Map();
+  const last = {};
+  let seeks = 0;
+  let seekDistance = 0;
+  let rereads = 0;
+
+  list.forEach((it) => {
+    const frame = perFrame.get(it.frame) || { reads: 0, sectors: 0, us: 0 };
+    frame.reads++;
+    frame.sectors += it.count;
+    frame.us += it.us;
+    perFrame.set(it.frame, frame);
+
+    const previous = last[it.stream];
+    if (previous) {
+      if (it.count === 1 && it.sector === previous.sector) rereads++;
+      else if (it.sector !== previous.sector + previous.count) {
+        const end = previous.sector + previous.count;
+        seeks++;
+        seekDistance += Math.abs(it.sector - end);
+      }
+    }
+    last[it.stream] = it;
+  });
+
+  const frames = [...perFrame.values()];
+  const total = (key) => frames.reduce((sum, it) => sum + it[key], 0);
+  const max = (key) => Math.max(0, ...frames.map((it) => it[key]));
+  const countFrames = (condition) => frames.filter(condition).length;
+
+  return {
+    reads: list.length,
+    sectors: total("sectors"),
+    readsPerFrame: total("reads") / frameCount,
+    maxReads: max("reads"),
+    sectorsPerFrame: total("sectors") / frameCount,
+    maxSectors: max("sectors"),
+    usPerFrame: total("us") / frameCount,
+    maxUs: max("us"),
+    overBudget: countFrames((it) => it.sectors > IO_FRAME_BUDGET_SECTORS),
+    overTime: countFrames((it) => it.us > FRAME_US),
+    seeks,
+    averageSeek: seeks > 0 ? Math.round(seekDistance / seeks) : 0,
+    rereads,
+  };
+};
+
+const print = (name, it) => {
+  console.log(`\n${name}:`);
+  console.log(`  reads:      ${it.reads} (${it.sectors} sectors)`);
+  console.log(
+    `  per frame:  ${it.readsPerFrame.toFixed(2)} reads ` +
+      `(max ${it.maxReads}), ${it.sectorsPerFrame.toFixed(2)} sectors ` +
+      `(max ${it.maxSectors})`
+  );
+  console.log(
+    `  time:       ${Math.round(it.usPerFrame)}us per frame ` +
+      `(max ${it.maxUs}us, ${it.overTime} frames over ${FRAME_US}us)`
+  );
+  console.log(
+    `  budget:     ${it.overBudget} frames over ` +
+      `${IO_FRAME_BUDGET_SECTORS} sectors`
+  );
+  console.log(
+    `  seeks:      ${it.seeks} (${it.averageSeek} sectors on average)`
+  );
+  console.log(`  rereads:    ${it.rereads} (repeated single-sector reads)`);
+};
+
+console.log(`=== I/O TRACE (${frameCount} frames) ===`);
+print("all", summarize(requests));
+STREAMS.forEach((stream) => {
+  const list = requests.filter((it) => it.stream === stream);
+  if (list.length > 0) print(stream, summarize(list));
+});
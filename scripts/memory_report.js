@@ -0,0 +1,167 @@
+const fs = require("fs");
+const $path = require("path");
+
+// Usage: node memory_report.js <elf> [<linker map>] [--top=N]
+// Prints how much IWRAM/EWRAM is used by each output section (read from the
+// ELF section headers) and by each object file (read from the GNU ld map).
+
+const REGIONS = [
+  { name: "IWRAM", start: 0x03000000, size: 32 * 1024 },
+  { name: "EWRAM", start: 0x02000000, size: 256 * 1024 },
+];
+const IWRAM_RESERVED = 0x100; // (BIOS and interrupt vector, at the end)
+const SHF_ALLOC = 0x2;
+const SHT_NOBITS = 8;
+const DEFAULT_TOP = 25;
+
+const args = process.argv.slice(2);
+const topArg = args.find((it) => it.startsWith("--top="));
+const top = topArg ? parseInt(topArg.split("=")[1]) : DEFAULT_TOP;
+const [elfPath, mapPath] = args.filter((it) => !it.startsWith("--"));
+
+if (!elfPath) {
+  console.error("Usage: node memory_report.js <elf> [<map>] [--top=N]");
+  process.exit(1);
+}
+
+const regionOf = (address) =>
+  REGIONS.find((it) => address >= it.start && address < it.start + it.size);
+
+const readSections = (path) => {
+  const elf = fs.readFileSync(path);
+  if (elf.readUInt32BE(0) !== 0x7f454c46 || elf[4] !== 1 || elf[5] !== 1)
+    throw new Error("not a 32-bit little-endian ELF: " + path);
+
+  const shOffset = elf.readUInt32LE(0x20);
+  const shEntrySize = elf.readUInt16LE(0x2e);
+  const shCount = elf.readUInt16LE(0x30);
+  const shStringIndex = elf.readUInt16LE(0x32);
+  const header = (i) => {
+    const offset = shOffset + i * shEntrySize;
+    return {
+      nameOffset: elf.readUInt32LE(offset),
+      type: elf.readUInt32LE(offset + 4),
+      flags: elf.readUInt32LE(offset + 8),
+      address: elf.readUInt32LE(offset + 12),
+      offset: elf.readUInt32LE(offset + 16),
+      size: elf.readUInt32LE(offset + 20),
+    };
+  };
+  const strings = header(shStringIndex);
+  const nameAt = (offset) => {
+    const start = strings.offset + offset;
+    return elf.toString("latin1", start, elf.indexOf(0, start));
+  };
+
+  const sections = [];
+  for (let i = 0; i < shCount; i++) {
+    const section = header(i);
+    if (!(section.flags & SHF_ALLOC) || section.size === 0) continue;
+    sections.push({
+      name: nameAt(section.nameOffset),
+      address: section.address,
+      size: section.size,
+      isBss: section.type === SHT_NOBITS,
+    });
+  }
+  return sections;
+};
+
+// Input section lines look like ` .text.foo 0x03000000 0x1c path/file.o`,
+// with the address/size/file part on the next line when the name is long.
+const readObjects = (path) => {
+  const lines = fs.readFileSync(path, "utf8").split(/\r?\n/);
+  const start = lines.findIndex((it) => it.startsWith("Linker script and"));
+  const objects = {};
+  let pendingName = null;
+
+  lines.slice(start + 1).forEach((line) => {
+    const full = line.match(/^ (\S+)\s+0x([0-9a-f]+)\s+0x([0-9a-f]+)\s+(.+)$/);
+    const split = line.match(/^\s+0x([0-9a-f]+)\s+0x([0-9a-f]+)\s+(.+)$/);
+    const name = line.match(/^ ([.\w]\S*)$/);
+
+    let entry = null;
+    if (full) entry = full.slice(1);
+    else if (split && pendingName) entry = [pendingName, ...split.slice(1)];
+    pendingName = name ? name[1] : null;
+    if (!entry) return;
+
+    const [section, address, size, file] = entry;
+    const region = regionOf(parseInt(address, 16));
+    const bytes = parseInt(size, 16);
+    if (!region || bytes === 0 || section === "*fill*") return;
+
+    const key = $path.basename(file.trim());
+    if (!objects[key]) objects[key] = { file: key, IWRAM: 0, EWRAM: 0 };
+    objects[key][region.name] += bytes;
+  });
+
+  return Object.values(objects);
+};
+
+const kb = (bytes) => (bytes / 1024).toFixed(1).padStart(7) + " KB";
+const percent = (part, total) =>
+  ((part * 100) / total).toFixed(1).padStart(5) + "%";
+
+const sections = readSections(elfPath);
+
+console.log("=== SECTIONS ===");
+REGIONS.forEach((region) => {
+  const inRegion = sections.filter((it) => regionOf(it.address) === region);
+  const end = Math.max(
+    region.start,
+    ...inRegion.map((it) => it.address + it.size)
+  );
+  const used = end - region.start;
+  const available =
+    region.name === "IWRAM" ? region.size - IWRAM_RESERVED : region.size;
+
+  console.log(`\n${region.name}: ${kb(used)} / ${kb(region.size)}`);
+  inRegion.forEach((it) => {
+    console.log(
+      `  ${it.name.padEnd(16)} ${kb(it.size)} ${percent(it.size, region.size)}` +
+        (it.isBss ? "  (zero-initialized)" : "")
+    );
+  });
+  console.log(
+    `  ${"headroom".padEnd(16)} ${kb(available - used)} ${percent(
+      available - used,
+      region.size
+    )}` +
+      (region.name === "IWRAM"
+        ? "  (shared with the stacks)"
+        : "  (max heap size)")
+  );
+});
+
+if (!mapPath || !fs.existsSync(mapPath)) {
+  console.log("\n(no linker map, skipping the per-object report)");
+  process.exit(0);
+}
+
+const objects = readObjects(mapPath);
+REGIONS.forEach((region) => {
+  const sorted = objects
+    .filter((it) => it[region.name] > 0)
+    .sort((a, b) => b[region.name] - a[region.name]);
+
+  console.log(`\n=== ${region.name} BY OBJECT (top ${top}) ===\n`);
+  sorted.slice(0, top).forEach((it) => {
+    console.log(
+      `  ${it.file.padEnd(40)} ${kb(it[region.name])} ${percent(
+        it[region.name],
+        region.size
+      )}`
+    );
+  });
+  const rest = sorted.slice(top);
+  if (rest.length > 0) {
+    const bytes = rest.reduce((sum, it) => sum + it[region.name], 0);
+    console.log(
+      `  ${`(${rest.length} more)`.padEnd(40)} ${kb(bytes)} ${percent(
+        bytes,
+        region.size
+      )}`
+    );
+  }
+});
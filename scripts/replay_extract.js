@@ -0,0 +1,42 @@
+const fs = require("fs");
+
+// Usage: node replay_extract.js <mgba.log> <output.rpl>
+// Extracts the last replay dumped to the mGBA debug log by a development
+// build (see `REPLAY_dump` in src/gameplay/Replay.cpp) into a `.rpl` file,
+// which `make replay REPLAYS=...` runs on the host.
+
+const PREFIX = "RPL "; // (REPLAY_DUMP_PREFIX)
+
+const [logPath, outputPath] = process.argv.slice(2);
+if (!logPath || !outputPath) {
+  console.error("Usage: node replay_extract.js <mgba.log> <output.rpl>");
+  process.exit(1);
+}
+
+let replay = null;
+let current = null;
+fs.readFileSync(logPath, "utf8")
+  .split(/\r?\n/)
+  .forEach((line) => {
+    const index = line.indexOf(PREFIX);
+    if (index === -1) return;
+    const content = line.slice(index + PREFIX.length).trim();
+
+    if (content.startsWith("begin ")) {
+      const parts = content.split(" ");
+      current = { name: parts[1], size: parseInt(parts[2]), hex: "" };
+    } else if (content === "end") {
+      if (current && current.hex.length === current.size * 2) replay = current;
+      current = null;
+    } else if (current) {
+      current.hex += content;
+    }
+  });
+
+if (!replay) {
+  console.error("No complete replay found in " + logPath);
+  process.exit(1);
+}
+
+fs.writeFileSync(outputPath, Buffer.from(replay.hex, "hex"));
+console.log(`${replay.name}: ${replay.size} bytes => ${outputPath}`);
@@ -0,0 +1,82 @@
+#ifndef CALIBRATION_H
+#define CALIBRATION_H
+
+#include <libgba-sprite-engine/gba/tonc_core.h>
+#include <libgba-sprite-engine/gba/tonc_math.h>
+
+const u32 CALIBRATION_MAX_TAPS = 32;
+const u32 CALIBRATION_MIN_TAPS = 8;
+const u32 CALIBRATION_MIN_OUTLIER_DISTANCE = 17;  // (1 frame)
+const u32 CALIBRATION_MAX_SPREAD = 17;
+const u32 CALIBRATION_MIN_INLIERS_PERCENT = 75;
+
+typedef struct {
+  int lag;     // (median of the inliers)
+  u32 spread;  // (median absolute deviation of the inliers)
+  u32 inliers;
+  bool isReliable;
+} CalibrationResult;
+
+inline void CALIBRATION_sort(int* values, u32 count) {
+  for (u32 i = 1; i < count; i++) {
+    int value = values[i];
+    int j = (int)i - 1;
+    while (j >= 0 && values[j] > value) {
+      values[j + 1] = values[j];
+      j--;
+    }
+    values[j + 1] = value;
+  }
+}
+
+// (sorts `values` in place)
+inline int CALIBRATION_median(int* values, u32 count) {
+  CALIBRATION_sort(values, count);
+  return count % 2 == 1 ? values[count / 2]
+                        : (values[count / 2 - 1] + values[count / 2]) / 2;
+}
+
+inline u32 CALIBRATION_mad(const int* values, u32 count, int median) {
+  int deviations[CALIBRATION_MAX_TAPS];
+  for (u32 i = 0; i < count; i++)
+    deviations[i] = ABS(values[i] - median);
+  return (u32)CALIBRATION_median(deviations, count);
+}
+
+// Robust audio lag estimate from tap offsets (ms, relative to each beat).
+// Taps farther than ~3 standard deviations from the median (estimated as
+// 1.5 * MAD) are rejected, and the estimate is only reliable when most taps
+// agree within `CALIBRATION_MAX_SPREAD` (and there are at least
+// `CALIBRATION_MIN_TAPS`).
+inline CalibrationResult CALIBRATION_estimate(const int* taps, u32 count) {
+  CalibrationResult result = {0, 0, 0, false};
+  if (count == 0)
+    return result;
+  if (count > CALIBRATION_MAX_TAPS)
+    count = CALIBRATION_MAX_TAPS;
+
+  int sorted[CALIBRATION_MAX_TAPS];
+  for (u32 i = 0; i < count; i++)
+    sorted[i] = taps[i];
+  int median = CALIBRATION_median(sorted, count);
+  u32 mad = CALIBRATION_mad(sorted, count, median);
+
+  u32 maxDistance = (u32)max((int)(mad * 9 / 2),
+                             (int)CALIBRATION_MIN_OUTLIER_DISTANCE);
+  int inliers[CALIBRATION_MAX_TAPS];
+  for (u32 i = 0; i < count; i++) {
+    if ((u32)ABS(sorted[i] - median) <= maxDistance)
+      inliers[result.inliers++] = sorted[i];
+  }
+
+  result.lag = CALIBRATION_median(inliers, result.inliers);
+  result.spread = CALIBRATION_mad(inliers, result.inliers, result.lag);
+  result.isReliable =
+      count >= CALIBRATION_MIN_TAPS &&
+      result.spread <= CALIBRATION_MAX_SPREAD &&
+      result.inliers * 100 >= count * CALIBRATION_MIN_INLIERS_PERCENT;
+
+  return result;
+}
+
+#endif  // CALIBRATION_H
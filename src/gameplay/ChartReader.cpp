@@ -33,6 +33,8 @@ ChartReader::ChartReader(Chart* chart,
   this->audioLag = audioLag;
   this->rateAudioLag = audioLag;
   this->customOffset = chart->customOffset + globalOffset;
+  chart->rhythmEvents.attach(playerId);
+  chart->events.attach(playerId);
 
   holdArrows = std::unique_ptr<ObjectPool<HoldArrow>>{new ObjectPool<HoldArrow>(
       HOLD_ARROW_POOL_SIZE * (1 + chart->isDouble),
@@ -47,10 +49,12 @@ ChartReader::ChartReader(Chart* chart,
   syncInitialScrollSpeed(multiplier);
 };
 
-CODE_PLACEMENT bool ChartReader::update(int songMsecs) {
+CODE_PLACEMENT bool ChartReader::update(int songMsecs,
+                                       u32 songMsecsFraction) {
   int rhythmMsecs = songMsecs - rateAudioLag + customOffset - lastBpmChange;
   msecs =
       songMsecs - rateAudioLag + customOffset - (int)stoppedMs + (int)warpedMs;
+  msecsFraction = songMsecsFraction;  // (the offsets are whole milliseconds)
 
   MATH_approximate(&arrowTime, targetArrowTime, maxArrowTimeJump);
 
@@ -116,23 +120,23 @@ CODE_PLACEMENT int ChartReader::getYFor(Arrow* arrow) {
       y = getYFor(arrow->timestamp);
   };
 
-  return min(y, ARROW_INITIAL_Y);
+  return min(y, getInitialY());
 }
 
 CODE_PLACEMENT int ChartReader::getYFor(int timestamp) {
-  // arrowTime ms           -> ARROW_DISTANCE() px
-  // timeLeft ms            -> x = timeLeft * ARROW_DISTANCE() / arrowTime
+  // arrowTime ms           -> distance px
+  // timeLeft ms            -> x = timeLeft * distance / arrowTime
   int now = hasStopped ? stopStart : msecs;
   int timeLeft = timestamp - now;
+  int distance = ARROW_DISTANCE() - fieldOffsetY;
 
-  return min(ARROW_FINAL_Y() + MATH_div(timeLeft * ARROW_DISTANCE(), arrowTime),
-             ARROW_INITIAL_Y);
+  return min(ARROW_FINAL_Y() + MATH_div(timeLeft * distance, arrowTime),
+             getInitialY());
 }
 
 CODE_PLACEMENT void ChartReader::processRhythmEvents() {
   processEvents(
-      chart->rhythmEvents, chart->rhythmEventCount, rhythmEventIndex,
-      msecs + (int)asyncStoppedMs,
+      &chart->rhythmEvents, rhythmEventIndex, msecs + (int)asyncStoppedMs,
       [this](EventType type, Event* event, bool* stop) {
         if (type == EventType::SET_TEMPO) {
           u32 oldBpm = bpm;
@@ -182,7 +186,7 @@ CODE_PLACEMENT void ChartReader::processRhythmEvents() {
 
 CODE_PLACEMENT void ChartReader::processNextEvents(int now) {
   processEvents(
-      chart->events, chart->eventCount, eventIndex, now + arrowTime,
+      &chart->events, eventIndex, now + arrowTime,
       [&now, this](EventType type, Event* event, bool* stop) {
         switch (type) {
           case EventType::NOTE: {
@@ -363,7 +367,7 @@ CODE_PLACEMENT void ChartReader::orchestrateHoldArrows() {
                   min(holdArrow->lastPressTopY - topY, HOLD_FILL_FINAL_Y())
             : 0;
     int bottomY = holdArrow->hasEndTime() ? getFillBottomY(holdArrow, topY)
-                                          : ARROW_INITIAL_Y;
+                                          : getInitialY();
 
     if (bottomY < ARROW_OFFSCREEN_LIMIT) {
       holdArrows->discard(holdArrow->id);
@@ -36,9 +36,13 @@ class ChartReader : public TimingProvider {
               int globalOffset,
               u32 multiplier);
 
-  bool update(int msecs);
+  bool update(int msecs, u32 msecsFraction = 0);
   int getYFor(Arrow* arrow);
 
+  // The playfield is drawn `offsetY` px lower (see `PLAYFIELD_setOffset`), so
+  // arrows scroll a shorter distance and still enter from the screen's bottom.
+  inline void setFieldOffsetY(int offsetY) { fieldOffsetY = offsetY; }
+
   inline u32 getMultiplier() { return multiplier; }
   inline bool setMultiplier(u32 multiplier) {
     u32 oldMultiplier = this->multiplier;
@@ -118,22 +122,30 @@ class ChartReader : public TimingProvider {
   int lastBeat = -1;
   int lastTick = -1;
   u32 stoppedMs = 0;
+  int fieldOffsetY = 0;
   u32 asyncStoppedMs = 0;
   u32 warpedMs = 0;
   int currentRate = 0;
 
   template <typename F>
-  inline void processEvents(Event* events,
-                            u32 count,
+  inline void processEvents(EventStream* events,
                             u32& index,
                             int targetMsecs,
                             F action) {
     u32 currentIndex = index;
     bool skipped = false;
 
-    while (targetMsecs >= events[currentIndex].timestamp() &&
-           currentIndex < count) {
-      auto event = events + currentIndex;
+    while (currentIndex < events->count) {
+      auto event = events->at(currentIndex);
+      if (event == NULL) {
+        events->release(playerId, index);  // (ring is full, make room)
+        event = events->at(currentIndex);
+        if (event == NULL)
+          break;
+      }
+      if (targetMsecs < event->timestamp())
+        break;
+
       EventType type = static_cast<EventType>(event->data() & EVENT_TYPE);
 
       if (event->handled[playerId]) {
@@ -150,8 +162,10 @@ class ChartReader : public TimingProvider {
       if (!skipped)
         index = currentIndex;
       if (stop)
-        return;
+        break;
     }
+
+    events->release(playerId, index);
   }
 
   template <typename F>
@@ -238,6 +252,7 @@ class ChartReader : public TimingProvider {
   void orchestrateHoldArrows();
   bool processTicks(int rhythmMsecs, bool checkHoldArrows);
   void connectArrows(std::vector<Arrow*>& arrows);
+  inline int getInitialY() { return (int)ARROW_INITIAL_Y - fieldOffsetY; }
   int getFillTopY(HoldArrow* holdArrow);
   int getFillBottomY(HoldArrow* holdArrow, int topY);
   u8 getRandomStep(int timestamp, u8 data);
@@ -3,6 +3,17 @@
 #include <libgba-sprite-engine/gba/tonc_bios.h>
 
 #include "save/SaveFile.h"
+#include "utils/BackgroundUtils.h"
+
+enum PrefetchStep {
+  PREFETCH_START,
+  PREFETCH_TILES,
+  PREFETCH_MAP,
+  PREFETCH_PALETTE,
+  PREFETCH_METADATA,
+  PREFETCH_CHART,
+  PREFETCH_DONE
+};
 
 DeathMix::DeathMix(const GBFS_FILE* fs, MixMode mixMode) {
   this->mixMode = mixMode;
@@ -23,28 +34,140 @@ DeathMix::DeathMix(const GBFS_FILE* fs, MixMode mixMode) {
   }
 
   for (u32 i = 0; i < songFiles.size(); i++)
-    songFiles[i]->index = i;
+    songFiles[i].index = i;
 
   this->fs = fs;
   this->next = 0;
   this->total = librarySize;
 }
 
+DeathMix::~DeathMix() {
+  unstage();
+}
+
 SongChart DeathMix::getNextSongChart() {
-  if (next >= total)
-    return SongChart{.song = NULL, .chart = NULL};
+  // (songs that can't be loaded are skipped, see `SONG_parse`)
+  while (next < total) {
+    // (files that weren't preloaded yet are read now, in one go, and a
+    // half-staged background is loaded by the scene like before)
+    if (prefetchStep == PREFETCH_START)
+      prefetch();
+    if (prefetchStep < PREFETCH_CHART) {
+      libraryStore->stopPreload();
+      if (prefetchStep < PREFETCH_METADATA)
+        unstage();
+      prefetchStep = PREFETCH_CHART;
+    }
+    prefetch();
+    prefetchStep = PREFETCH_START;
+    hasStagedBackground = isStaged(STAGED_TILES) && isStaged(STAGED_MAP) &&
+                          isStaged(STAGED_PALETTE);
 
-  Song* tempSong = SONG_parse(fs, songFiles[next].get());
-  int index = getNextChartIndex(tempSong);
-  SONG_free(tempSong);
-  if (index == -1)  // (should not happen, just a fail-safe)
-    return SongChart{.song = NULL, .chart = NULL};
+    Song* song = nextChartIndex != -1
+                     ? SONG_parse(fs, &songFiles[next],
+                                  std::vector<u8>{(u8)nextChartIndex})
+                     : NULL;
+    next++;
+    if (song != NULL) {
+      played++;
+      return SongChart{.song = song, .chart = song->charts + nextChartIndex};
+    }
+  }
 
-  Song* song =
-      SONG_parse(fs, songFiles[next].get(), std::vector<u8>{(u8)index});
-  Chart* chart = song->charts + index;
+  return SongChart{.song = NULL, .chart = NULL};
+}
+
+bool DeathMix::prefetch() {
+  auto songFile = next < total ? &songFiles[next] : NULL;
 
-  next++;
+  switch (prefetchStep) {
+    case PREFETCH_START: {
+      // (the scene has already copied the previous background to VRAM)
+      unstage();
+      nextChartIndex = -1;
+      if (next >= total) {
+        prefetchStep = PREFETCH_DONE;
+        return true;
+      }
+      break;
+    }
+    case PREFETCH_TILES: {
+      auto tiles = songFile->getBackgroundTilesFile();
+      if (!libraryStore->preload(tiles.c_str()))
+        return false;
+      stage(STAGED_TILES, tiles.c_str());
+      break;
+    }
+    case PREFETCH_MAP: {
+      auto map = songFile->getBackgroundMapFile();
+      if (!libraryStore->preload(map.c_str()))
+        return false;
+      if (libraryStore->peekFile(fs, map.c_str(), NULL) == NULL &&
+          !libraryStore->preload(UNIQUE_MAP_FILE_NAME))
+        return false;
+      stage(STAGED_MAP, map.c_str());
+      if (!isStaged(STAGED_MAP))
+        stage(STAGED_MAP, UNIQUE_MAP_FILE_NAME);
+      break;
+    }
+    case PREFETCH_PALETTE: {
+      auto palette = songFile->getBackgroundPaletteFile();
+      if (!libraryStore->preload(palette.c_str()))
+        return false;
+      stage(STAGED_PALETTE, palette.c_str());
+      break;
+    }
+    case PREFETCH_METADATA: {
+      if (songFile->metadata != NULL)
+        break;
+      auto metadata = songFile->getMetadataFile();
+      if (!libraryStore->preload(metadata.c_str()))
+        return false;
 
-  return SongChart{.song = song, .chart = chart};
+      // (the chart comes first: if the staged background leaves no room for
+      // it, the background is dropped and the metadata is preloaded again)
+      if (libraryStore->peekFile(fs, metadata.c_str(), NULL) == NULL &&
+          hasStagedBackgroundFiles()) {
+        unstage();
+        return false;
+      }
+      stage(STAGED_METADATA, metadata.c_str());
+      break;
+    }
+    case PREFETCH_CHART: {
+      // (the metadata is preloaded last, so it's still cached for `SONG_parse`)
+      Song* tempSong = SONG_parse(fs, songFile);
+      if (tempSong == NULL && hasStagedBackgroundFiles()) {
+        unstage();  // (same as above, when it's read here in one go)
+        tempSong = SONG_parse(fs, songFile);
+      }
+      if (tempSong != NULL) {
+        nextChartIndex = getNextChartIndex(tempSong);
+        SONG_free(tempSong);
+      }
+      break;
+    }
+    default:
+      return true;
+  }
+
+  prefetchStep++;
+  return prefetchStep == PREFETCH_DONE;
+}
+
+void DeathMix::stage(u32 type, const char* name) {
+  // (only cached or ROM files; pinned, so newer reads can't overwrite them)
+  auto file = &stagedFiles[type];
+  file->data = libraryStore->peekFile(fs, name, &file->length);
+  if (file->data != NULL && !libraryStore->pin(file->data))
+    file->data = NULL;
+}
+
+void DeathMix::unstage() {
+  hasStagedBackground = false;
+  for (u32 i = 0; i < STAGED_FILES; i++) {
+    if (stagedFiles[i].data != NULL)
+      libraryStore->unpin(stagedFiles[i].data);
+    stagedFiles[i].data = NULL;
+  }
 }
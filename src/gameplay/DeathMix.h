@@ -16,10 +16,22 @@ typedef struct {
   Chart* chart;
 } SongChart;
 
+typedef struct {
+  const void* data;
+  u32 length;
+} StagedFile;
+
+enum StagedFileType {
+  STAGED_TILES,
+  STAGED_MAP,
+  STAGED_PALETTE,
+  STAGED_METADATA,
+  STAGED_FILES
+};
+
 class DeathMix {
  public:
   MixMode mixMode;
-  bool didStartScroll = false;
   u32 multiplier = 1;
   u32 combo = 0;
   int life = INITIAL_LIFE;
@@ -31,20 +43,47 @@ class DeathMix {
   u32 longNotes = 0;
 
   DeathMix(const GBFS_FILE* fs, MixMode mixMode);
+  virtual ~DeathMix();
 
-  bool isInitialSong() { return next == 1; }
+  bool isInitialSong() { return played == 1; }
+  // Returns NULLs when there are no more songs.
   SongChart getNextSongChart();
-  u32 getCurrentSongNumber() { return next - 1; }
+  // Runs one slice of the work needed by the next `getNextSongChart()` (its
+  // background and metadata files are preloaded into the library cache, a
+  // few sectors per frame, and staged there by pinning them; then its chart
+  // is picked). Returns true when it's done. (call it while the current song
+  // plays)
+  bool prefetch();
+  // Background files (`StagedFileType`) of the song returned by the last
+  // `getNextSongChart()`, or NULL if they weren't staged. They're valid until
+  // `prefetch()` runs again.
+  const StagedFile* getStagedBackground() {
+    return hasStagedBackground ? stagedFiles : NULL;
+  }
+  u32 getCurrentSongNumber() { return played - 1; }
   bool isEmpty() { return songFiles.empty(); }
 
  protected:
   virtual int getNextChartIndex(Song* tempSong) = 0;
-  std::vector<std::unique_ptr<SongFile>> songFiles;
+  std::vector<SongFile> songFiles;
   u32 next;
   u32 total;
+  u32 played = 0;
 
  private:
   const GBFS_FILE* fs;
+  u32 prefetchStep = 0;
+  int nextChartIndex = -1;
+  StagedFile stagedFiles[STAGED_FILES] = {};
+  bool hasStagedBackground = false;
+
+  void stage(u32 type, const char* name);
+  bool isStaged(u32 type) { return stagedFiles[type].data != NULL; }
+  bool hasStagedBackgroundFiles() {
+    return isStaged(STAGED_TILES) || isStaged(STAGED_MAP) ||
+           isStaged(STAGED_PALETTE);
+  }
+  void unstage();
 };
 
 #endif  // DEATH_MIX_H
@@ -17,13 +17,13 @@ bool Judge::onPress(Arrow* arrow, TimingProvider* timingProvider, int offset) {
   u32 diff = getDiff(arrow, timingProvider, offset);
 
   if (isInsideTimingWindow(diff)) {
-    if (diff >= FRAME_MS * getTimingWindowOf(FeedbackType::BAD)) {
+    if (diff >= getTimingWindowOf(FeedbackType::BAD)) {
       onResult(arrow, FeedbackType::BAD);
 
       return false;
-    } else if (diff >= FRAME_MS * getTimingWindowOf(FeedbackType::GOOD))
+    } else if (diff >= getTimingWindowOf(FeedbackType::GOOD))
       onResult(arrow, FeedbackType::GOOD);
-    else if (diff >= FRAME_MS * getTimingWindowOf(FeedbackType::GREAT))
+    else if (diff >= getTimingWindowOf(FeedbackType::GREAT))
       onResult(arrow, FeedbackType::GREAT);
     else
       onResult(arrow, FeedbackType::PERFECT);
@@ -54,7 +54,7 @@ void Judge::onHoldTick(u16 arrows, u8 playerId, bool canMiss) {
 bool Judge::endIfNeeded(Arrow* arrow, TimingProvider* timingProvider) {
   int actualMsecs = timingProvider->getMsecs();
   int expectedMsecs = arrow->timestamp;
-  u32 diff = (u32)abs(actualMsecs - expectedMsecs);
+  u32 diff = timingProvider->getDistanceTo(expectedMsecs);
   if (isInsideTimingWindow(diff) || actualMsecs < expectedMsecs)
     return false;
   if (arrow->getWasMissed())
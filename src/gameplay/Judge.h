@@ -12,9 +12,11 @@
 #include "objects/score/Score.h"
 #include "utils/pool/ObjectPool.h"
 
-const u32 TIMING_WINDOWS[] = {0, 2, 4, 6, 8};
-const int HOLD_ARROW_TICK_OFFSET_MS = 33;
-//                                  ^ OFFSET_GREAT * FRAME_MS = 2 * 16.73322954
+// (2, 4, 6 and 8 frames of 17ms; these are the tuned scoring windows, so
+// they don't follow the exact frame length)
+const u32 TIMING_WINDOWS[] = {0, 34, 68, 102, 136};
+const int HOLD_ARROW_TICK_OFFSET_MS = TIMING_framesToMsecs(2);
+//                                    ^ OFFSET_GREAT frames = 2 * 16.7427 ms
 const u32 MAX_JUDGABLE_SCROLL_BPM = 300 * ARROW_MAX_MULTIPLIER;
 
 class Judge {
@@ -32,7 +34,7 @@ class Judge {
   inline void enable() { isDisabled = false; }
 
   inline bool isInsideTimingWindow(u32 diff) {
-    return diff < FRAME_MS * getTimingWindowOf(FeedbackType::MISS);
+    return diff < getTimingWindowOf(FeedbackType::MISS);
   }
 
   inline bool isPressed(ArrowDirection direction, u8 playerId) {
@@ -48,9 +50,7 @@ class Judge {
   bool isDisabled = false;
 
   inline u32 getDiff(Arrow* arrow, TimingProvider* timingProvider, int offset) {
-    int actualMsecs = timingProvider->getMsecs() + offset;
-    int expectedMsecs = arrow->timestamp;
-    return (u32)abs(actualMsecs - expectedMsecs);
+    return timingProvider->getDistanceTo(arrow->timestamp, offset);
   }
 
   inline bool canMiss(Arrow* arrow, TimingProvider* timingProvider) {
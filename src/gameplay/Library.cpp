@@ -1,23 +1,84 @@
 #include "Library.h"
 
+#include "library/LibraryStore.h"
 #include "utils/StringUtils.h"
+#include "utils/parse.h"
+
+const u32 INDEX_LEVELS = 4;
+const u32 INDEX_HEADER_SIZE = INDEX_LEVELS * sizeof(u32);
+const u32 INDEX_ROW_SIZE = 20;
+const u32 INDEX_METADATA_ENTRY = SONG_NAME_LEN;
+const u32 INDEX_ID = INDEX_METADATA_ENTRY + sizeof(u16);
+const u32 INDEX_NO_ENTRY = 0xffff;
+const u32 GBFS_NAME_LENGTH = 24;
 
 Library::Library(const GBFS_FILE* fs) {
   this->fs = fs;
+
+  // (the SD card library can differ from the ROM, so it uses the text lists)
+  if (!libraryStore->isActive())
+    index = (const u8*)gbfs_get_obj(fs, LIBRARY_INDEX_FILE, NULL);
 }
 
-void Library::loadSongs(std::vector<std::unique_ptr<SongFile>>& files,
+void Library::loadSongs(std::vector<SongFile>& files,
                         DifficultyLevel libraryType,
                         u32 pageStart) {
   this->libraryType = libraryType;
 
+  if (index != NULL && loadSongsFromIndex(files, pageStart))
+    return;
+
   std::string listFileName =
       getPrefix() + std::to_string(pageStart) + SUFFIX_LIST;
-  auto library =
-      std::string((char*)gbfs_get_obj(fs, listFileName.c_str(), NULL));
+  auto list = (char*)libraryStore->getFile(fs, listFileName.c_str(), NULL);
+  if (list == NULL)
+    return;  // (no songs, see `LibraryStore::getLastError`)
+
+  auto library = std::string(list);
   auto fileNames = STRING_split(library, LINE_BREAK);
 
   for (u32 i = 0; i < fileNames.size(); i++)
-    files.push_back(
-        std::unique_ptr<SongFile>{new SongFile(fileNames[i], pageStart + i)});
+    files.push_back(SongFile(fileNames[i].c_str(), pageStart + i));
+}
+
+bool Library::loadSongsFromIndex(std::vector<SongFile>& files, u32 pageStart) {
+  u32 firstRow = 0;
+  u32 count = 0;
+  for (u32 i = 0; i <= libraryType; i++) {
+    count = as_le((u8*)index + i * sizeof(u32));
+    if (i < libraryType)
+      firstRow += count;
+  }
+  if (pageStart >= count)
+    return false;
+
+  u32 total = min(PAGE_SIZE, count - pageStart);
+  for (u32 i = 0; i < total; i++) {
+    const u8* row =
+        index + INDEX_HEADER_SIZE + (firstRow + pageStart + i) * INDEX_ROW_SIZE;
+    u32 entry =
+        row[INDEX_METADATA_ENTRY] | (row[INDEX_METADATA_ENTRY + 1] << 8);
+
+    u32 length = 0;
+    auto metadata =
+        entry != INDEX_NO_ENTRY ? getIndexedMetadata(row, entry, &length)
+                                : NULL;
+    files.push_back(SongFile((const char*)row, pageStart + i, metadata, length,
+                             row[INDEX_ID]));
+  }
+
+  return true;
+}
+
+const u8* Library::getIndexedMetadata(const u8* row, u32 entry, u32* length) {
+  char name[GBFS_NAME_LENGTH + 1];  // (+ '\0')
+  auto metadata = (const u8*)gbfs_get_nth_obj(fs, entry, name, length);
+
+  // (an archive packed with other files than the index expected would load
+  // the wrong chart, so those are looked up by name)
+  auto expectedName = std::string((const char*)row) + METADATA_EXTENSION;
+  if (metadata == NULL || expectedName != name)
+    metadata = (const u8*)gbfs_get_obj(fs, expectedName.c_str(), length);
+
+  return metadata;
 }
@@ -20,6 +20,7 @@ extern "C" {
 #define PREFIX_CRAZY "_scz_"
 #define PREFIX_BONUS "_bns_"
 #define SUFFIX_LIST "_list.txt"
+#define LIBRARY_INDEX_FILE "_library.idx"
 
 const u32 PAGE_SIZE = 4;
 
@@ -27,7 +28,7 @@ class Library {
  public:
   Library(const GBFS_FILE* fs);
 
-  void loadSongs(std::vector<std::unique_ptr<SongFile>>& files,
+  void loadSongs(std::vector<SongFile>& files,
                  DifficultyLevel libraryType,
                  u32 pageStart);
 
@@ -46,7 +47,11 @@ class Library {
 
  private:
   const GBFS_FILE* fs;
+  const u8* index = NULL;
   DifficultyLevel libraryType;
+
+  bool loadSongsFromIndex(std::vector<SongFile>& files, u32 pageStart);
+  const u8* getIndexedMetadata(const u8* row, u32 entry, u32* length);
 };
 
 #endif  // LIBRARY_H
@@ -0,0 +1,68 @@
+#ifndef LIBRARY_STATS_H
+#define LIBRARY_STATS_H
+
+#include <libgba-sprite-engine/gba/tonc_core.h>
+
+#include <string.h>
+
+#include "library/LibraryStore.h"
+#include "models/SongFile.h"
+#include "utils/parse.h"
+
+extern "C" {
+#include "utils/gbfs/gbfs.h"
+}
+
+#define LIBRARY_STATS_FILE "_library_stats.bin"
+
+const u32 LIBRARY_STATS_MAX_LEVEL = 103;
+
+// Per-song chart summary written by the importer (one row per song id), so
+// whole-library screens don't need to SONG_parse every song.
+// (see `libraryStats.js`)
+typedef struct {
+  char name[SONG_NAME_LEN];
+  u8 singleCount;
+  u8 doubleCount;  // (double + co-op charts)
+  u8 singleLevels[(LIBRARY_STATS_MAX_LEVEL + 1) / 8];  // (bitmask)
+  u8 reserved;
+} SongStats;
+static_assert(sizeof(SongStats) == 32, "Wrong SongStats size");
+
+inline const SongStats* LIBRARY_STATS_load(const GBFS_FILE* fs, u32* count) {
+  u32 length;
+  auto data = (u8*)libraryStore->getFile(fs, LIBRARY_STATS_FILE, &length);
+  if (data == NULL || length < sizeof(u32))
+    return NULL;
+
+  *count = as_le(data);
+  if (length < sizeof(u32) + *count * sizeof(SongStats))
+    return NULL;
+
+  return (const SongStats*)(data + sizeof(u32));
+}
+
+// Finds the stats of `file` by id, or by name when it has no id (the SD card
+// library is loaded from the text lists). Returns NULL if it's not there.
+inline const SongStats* LIBRARY_STATS_find(const SongStats* stats,
+                                           u32 count,
+                                           SongFile* file) {
+  if (file->id != SONG_ID_UNKNOWN)
+    return file->id < count ? stats + file->id : NULL;
+
+  for (u32 i = 0; i < count; i++) {
+    if (strncmp(stats[i].name, file->name, SONG_NAME_LEN) == 0)
+      return stats + i;
+  }
+
+  return NULL;
+}
+
+inline bool LIBRARY_STATS_hasSingleLevel(const SongStats* stats, u8 level) {
+  if (level > LIBRARY_STATS_MAX_LEVEL)
+    return false;
+
+  return (stats->singleLevels[level / 8] >> (level % 8)) & 1;
+}
+
+#endif  // LIBRARY_STATS_H
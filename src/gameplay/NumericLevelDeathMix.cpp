@@ -1,15 +1,28 @@
 #include "NumericLevelDeathMix.h"
 
+#include "LibraryStats.h"
+
 NumericLevelDeathMix::NumericLevelDeathMix(const GBFS_FILE* fs, u8 numericLevel)
     : DeathMix(fs, MixMode::SHUFFLE) {
   this->numericLevel = numericLevel;
 
+  u32 statsCount = 0;
+  auto stats = LIBRARY_STATS_load(fs, &statsCount);
+
   for (auto it = songFiles.begin(); it != songFiles.end();) {
-    Song* tempSong = SONG_parse(fs, it->get());
-    int index = getNextChartIndex(tempSong);
-    SONG_free(tempSong);
+    bool hasLevel;
+    auto songStats =
+        stats != NULL ? LIBRARY_STATS_find(stats, statsCount, &*it) : NULL;
+    if (songStats != NULL) {
+      hasLevel = LIBRARY_STATS_hasSingleLevel(songStats, numericLevel);
+    } else {
+      Song* tempSong = SONG_parse(fs, &*it);
+      hasLevel = tempSong != NULL && getNextChartIndex(tempSong) != -1;
+      if (tempSong != NULL)
+        SONG_free(tempSong);
+    }
 
-    if (index == -1)
+    if (!hasLevel)
       it = songFiles.erase(it);
     else
       ++it;
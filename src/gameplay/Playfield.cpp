@@ -0,0 +1,73 @@
+#include "Playfield.h"
+
+#include <libgba-sprite-engine/gba/tonc_memdef.h>
+#include <libgba-sprite-engine/gba/tonc_memmap.h>
+
+#include "gameplay/models/Event.h"
+#include "objects/ArrowInfo.h"
+#include "utils/SpriteUtils.h"
+
+typedef struct {
+  Sprite* sprite;
+  const u8* playerId;
+  PlayfieldLayer layer;
+} PlayfieldEntry;
+
+typedef struct {
+  int x;
+  int y;
+} PlayfieldOffset;
+
+static PlayfieldEntry entries[PLAYFIELD_MAX_SPRITES];
+static PlayfieldOffset offsets[GAME_MAX_PLAYERS][PLAYFIELD_TOTAL_LAYERS];
+static u32 entryCount = 0;
+static bool isMoved = false;
+
+void PLAYFIELD_reset() {
+  entryCount = 0;
+  isMoved = false;
+  for (u32 playerId = 0; playerId < GAME_MAX_PLAYERS; playerId++) {
+    for (u32 layer = 0; layer < PLAYFIELD_TOTAL_LAYERS; layer++)
+      offsets[playerId][layer] = PlayfieldOffset{0, 0};
+  }
+}
+
+void PLAYFIELD_add(Sprite* sprite, PlayfieldLayer layer, const u8* playerId) {
+  if (entryCount == PLAYFIELD_MAX_SPRITES)
+    return;
+
+  entries[entryCount++] = PlayfieldEntry{sprite, playerId, layer};
+}
+
+void PLAYFIELD_setOffset(u8 playerId, PlayfieldLayer layer, int x, int y) {
+  offsets[playerId][layer] = PlayfieldOffset{x, y};
+  if (x != 0 || y != 0)
+    isMoved = true;
+}
+
+CODE_IWRAM void PLAYFIELD_render() {
+  if (!isMoved)
+    return;
+
+  for (u32 i = 0; i < entryCount; i++) {
+    auto& entry = entries[i];
+    auto& offset = offsets[*entry.playerId][entry.layer];
+    if (offset.x == 0 && offset.y == 0)
+      continue;
+
+    OBJ_ATTR* attributes = &oam_mem[i];
+    if (!entry.sprite->enabled) {
+      // (the engine doesn't copy disabled sprites, so pooled arrows would
+      // stay where they were last drawn, which can be on screen when moved)
+      attributes->attr0 = ATTR0_HIDE;
+      continue;
+    }
+    if (SPRITE_isHidden(entry.sprite))
+      continue;  // (hidden sprites would show up when moved)
+
+    attributes->attr0 = (attributes->attr0 & ~ATTR0_Y_MASK) |
+                        ((attributes->attr0 + offset.y) & ATTR0_Y_MASK);
+    attributes->attr1 = (attributes->attr1 & ~ATTR1_X_MASK) |
+                        ((attributes->attr1 + offset.x) & ATTR1_X_MASK);
+  }
+}
@@ -0,0 +1,26 @@
+#ifndef PLAYFIELD_H
+#define PLAYFIELD_H
+
+#include <libgba-sprite-engine/sprites/sprite.h>
+
+const u32 PLAYFIELD_MAX_SPRITES = 128;
+
+// Parts of a playfield that mods move separately.
+enum PlayfieldLayer : u8 {
+  PLAYFIELD_BASE,
+  PLAYFIELD_SCORE,
+  PLAYFIELD_HOLDERS,
+  PLAYFIELD_ARROWS,
+  PLAYFIELD_TOTAL_LAYERS
+};
+
+// Registered sprites are drawn moved by the offset of their player and layer.
+// Offsets are added to OAM right after the engine copies it, so moving a whole
+// playfield doesn't touch its sprites. Entries must be added in OAM order.
+// `playerId` is read on every frame (pooled arrows change players).
+void PLAYFIELD_reset();
+void PLAYFIELD_add(Sprite* sprite, PlayfieldLayer layer, const u8* playerId);
+void PLAYFIELD_setOffset(u8 playerId, PlayfieldLayer layer, int x, int y);
+void PLAYFIELD_render();
+
+#endif  // PLAYFIELD_H
@@ -0,0 +1,219 @@
+#include "Replay.h"
+
+#ifdef SENV_DEVELOPMENT
+
+#include <libgba-sprite-engine/gba/tonc_memdef.h>
+
+#include <string.h>
+
+#include "gameplay/debug/DebugTools.h"
+#include "gameplay/save/SaveFile.h"
+#include "gameplay/save/State.h"
+#include "player/PlaybackState.h"
+
+enum ReplayMode { REPLAY_OFF, REPLAY_RECORDING, REPLAY_PLAYING };
+
+DATA_EWRAM static ReplayHeader header;
+DATA_EWRAM static ReplayEvent events[REPLAY_MAX_EVENTS];
+static ReplayPlayback playback;
+static ReplayMode mode = REPLAY_OFF;
+static bool isPlaybackPending = false;
+static u32 cursor = 0;
+static u32 frame = 0;
+static u32 nextEventFrame = 0;
+static u16 currentKeys = 0;
+static u32 heldFrames = 0;
+
+inline u16 eventKeys(ReplayEvent event) {
+  return event & KEY_ANY;
+}
+
+inline u32 eventFrames(ReplayEvent event) {
+  return event >> REPLAY_KEY_BITS;
+}
+
+inline void record(u16 keys) {
+  if (header.eventCount == REPLAY_MAX_EVENTS) {
+    mode = REPLAY_OFF;  // (too long, the replay stays incomplete)
+    return;
+  }
+
+  events[header.eventCount++] = (heldFrames << REPLAY_KEY_BITS) | keys;
+  currentKeys = keys;
+  heldFrames = 0;
+}
+
+inline u16 play() {
+  while (cursor < header.eventCount && frame == nextEventFrame) {
+    currentKeys = eventKeys(events[cursor]);
+    cursor++;
+    if (cursor < header.eventCount)
+      nextEventFrame += eventFrames(events[cursor]);
+  }
+
+  return currentKeys;
+}
+
+void REPLAY_begin(Song* song, Chart* chart) {
+  cursor = 0;
+  frame = 0;
+  nextEventFrame = 0;
+  currentKeys = 0;
+  heldFrames = 0;
+
+  if (isPlaybackPending) {
+    isPlaybackPending = false;
+    mode = REPLAY_PLAYING;
+    playback = ReplayPlayback{};
+    __qran_seed = header.seed;
+    return;
+  }
+
+  mode = REPLAY_RECORDING;
+  header.magic = REPLAY_MAGIC;
+  strncpy(header.songName, song->audioPath.c_str(), SONG_NAME_LEN - 1);
+  header.songName[SONG_NAME_LEN - 1] = '\0';
+  header.songIndex = song->index;
+  header.chartIndex = (u8)(chart - song->charts);
+  header.levelIndex = chart->levelIndex;
+  header.gameMode = GameState.mode;
+  header.isComplete = false;
+  header.customOffset = chart->customOffset;
+  header.audioLag = GameState.settings.audioLag;
+  header.globalOffset = (int)SAVEFILE_read32(SRAM->globalOffset);
+  header.mods = GameState.mods;
+  header.arcadeCharts = SAVEFILE_read8(SRAM->adminSettings.arcadeCharts);
+  header.isPCM = false;
+  header.seed = __qran_seed;
+  header.frameCount = 0;
+  header.eventCount = 0;
+}
+
+void REPLAY_stop() {
+  if (mode == REPLAY_RECORDING)
+    header.isComplete = false;
+
+  mode = REPLAY_OFF;
+  isPlaybackPending = false;
+}
+
+u16 REPLAY_process(u16 keys) {
+  if (mode == REPLAY_PLAYING) {
+    keys = play();
+    frame++;
+    return keys;
+  }
+
+  if (mode == REPLAY_RECORDING) {
+    keys &= KEY_ANY;
+    if (header.frameCount == 0)
+      header.isPCM = PlaybackState.isPCM;  // (the song has started by now)
+    if (header.frameCount == 0 || keys != currentKeys ||
+        heldFrames == REPLAY_MAX_HELD_FRAMES)
+      record(keys);
+    heldFrames++;
+    header.frameCount++;
+  }
+
+  return keys;
+}
+
+bool REPLAY_finish(Evaluation* evaluation) {
+  ReplayResult result = {evaluation->perfects, evaluation->greats,
+                         evaluation->goods,    evaluation->bads,
+                         evaluation->misses,   evaluation->maxCombo,
+                         evaluation->points,   evaluation->longNotes};
+  auto previousMode = mode;
+  mode = REPLAY_OFF;
+
+  if (previousMode == REPLAY_RECORDING) {
+    header.result = result;
+    header.isComplete = true;
+    REPLAY_dump();
+  } else if (previousMode == REPLAY_PLAYING) {
+    playback.isFinished = true;
+    playback.frameCount = frame;
+    playback.result = result;
+    playback.isValid =
+        frame == header.frameCount &&
+        memcmp(&result, &header.result, sizeof(ReplayResult)) == 0;
+    return playback.isValid;
+  }
+
+  return true;
+}
+
+bool REPLAY_isPlaying() {
+  return mode == REPLAY_PLAYING;
+}
+
+bool REPLAY_canPlay(GameMode gameMode) {
+  return mode == REPLAY_OFF && header.magic == REPLAY_MAGIC &&
+         header.isComplete && header.gameMode == gameMode;
+}
+
+const ReplayHeader* REPLAY_getHeader() {
+  return &header;
+}
+
+void REPLAY_preparePlayback() {
+  GameState.mods = header.mods;
+  GameState.settings.audioLag = header.audioLag;
+  isPlaybackPending = true;
+}
+
+u32 REPLAY_save(u8* buffer, u32 size) {
+  u32 eventsSize = header.eventCount * sizeof(ReplayEvent);
+  if (sizeof(ReplayHeader) + eventsSize > size)
+    return 0;
+
+  memcpy(buffer, &header, sizeof(ReplayHeader));
+  memcpy(buffer + sizeof(ReplayHeader), events, eventsSize);
+  return sizeof(ReplayHeader) + eventsSize;
+}
+
+bool REPLAY_load(const u8* buffer, u32 size) {
+  if (mode != REPLAY_OFF || size < sizeof(ReplayHeader))
+    return false;
+
+  ReplayHeader newHeader;
+  memcpy(&newHeader, buffer, sizeof(ReplayHeader));
+  if (newHeader.magic != REPLAY_MAGIC || !newHeader.isComplete ||
+      newHeader.eventCount > REPLAY_MAX_EVENTS ||
+      size != sizeof(ReplayHeader) +
+                  newHeader.eventCount * sizeof(ReplayEvent))
+    return false;
+
+  header = newHeader;
+  memcpy(events, buffer + sizeof(ReplayHeader),
+         header.eventCount * sizeof(ReplayEvent));
+  return true;
+}
+
+void REPLAY_dump() {
+  // (`.rpl` bytes in hex, see `scripts/replay_extract.js`)
+  u32 size = sizeof(ReplayHeader) + header.eventCount * sizeof(ReplayEvent);
+  auto byteAt = [](u32 i) {
+    return i < sizeof(ReplayHeader)
+               ? ((const u8*)&header)[i]
+               : ((const u8*)events)[i - sizeof(ReplayHeader)];
+  };
+
+  log(REPLAY_DUMP_PREFIX "begin %s %u", header.songName, size);
+  char line[REPLAY_DUMP_BYTES_PER_LINE * 2 + 1];
+  u32 length = 0;
+  for (u32 i = 0; i < size; i++) {
+    length += sprintf(line + length, "%02x", byteAt(i));
+    if (length == sizeof(line) - 1 || i == size - 1) {
+      log(REPLAY_DUMP_PREFIX "%s", line);
+      length = 0;
+    }
+  }
+  log(REPLAY_DUMP_PREFIX "end");
+}
+
+const ReplayPlayback* REPLAY_getPlayback() {
+  return &playback;
+}
+
+#endif
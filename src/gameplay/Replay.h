@@ -0,0 +1,123 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <libgba-sprite-engine/gba/tonc_core.h>
+
+#include "gameplay/Evaluation.h"
+#include "gameplay/models/Song.h"
+#include "gameplay/models/SongFile.h"
+#include "gameplay/save/GameMode.h"
+#include "gameplay/save/Mods.h"
+
+#define REPLAY_MAGIC 0x324c5052  // ("RPL2")
+#define REPLAY_DUMP_PREFIX "RPL "
+#define REPLAY_DUMP_BYTES_PER_LINE 64
+const u32 REPLAY_MAX_EVENTS = 4096;
+const u32 REPLAY_KEY_BITS = 10;
+const u32 REPLAY_MAX_HELD_FRAMES = (1 << (16 - REPLAY_KEY_BITS)) - 1;
+
+// Each event is a u16: the keypad state (low 10 bits) and the number of
+// frames the previous state was held for (high 6 bits). Long holds are split
+// into repeated events.
+typedef u16 ReplayEvent;
+
+typedef struct __attribute__((__packed__)) {
+  u32 perfects;
+  u32 greats;
+  u32 goods;
+  u32 bads;
+  u32 misses;
+  u32 maxCombo;
+  u32 points;
+  u32 longNotes;
+} ReplayResult;
+
+// (packed, so `.rpl` files are the same on the GBA and the host runner)
+typedef struct __attribute__((__packed__)) {
+  u32 magic;
+  char songName[SONG_NAME_LEN];
+  u32 songIndex;
+  u8 chartIndex;
+  u8 levelIndex;
+  GameMode gameMode;
+  bool isComplete;
+  s32 customOffset;
+  s32 audioLag;
+  s32 globalOffset;
+  Mods mods;
+  u8 arcadeCharts;
+  bool isPCM;
+  u32 seed;
+  u32 frameCount;
+  u32 eventCount;
+  ReplayResult result;
+} ReplayHeader;
+
+static_assert(sizeof(ReplayHeader) == 98, "the .rpl format changed");
+
+typedef struct {
+  bool isFinished;
+  bool isValid;
+  u32 frameCount;
+  ReplayResult result;
+} ReplayPlayback;
+
+// Development builds record the last single-player song into EWRAM and can
+// play it back, feeding the recorded keys to SongScene instead of the keypad.
+// Finished recordings are dumped to the debug log (see `REPLAY_dump`), so
+// `scripts/replay_extract.js` can turn them into `.rpl` files for the host
+// runner (`tests/replay`). Release builds don't record anything.
+#ifdef SENV_DEVELOPMENT
+
+void REPLAY_begin(Song* song, Chart* chart);
+void REPLAY_stop();
+u16 REPLAY_process(u16 keys);
+bool REPLAY_finish(Evaluation* evaluation);
+
+bool REPLAY_isPlaying();
+bool REPLAY_canPlay(GameMode gameMode);
+const ReplayHeader* REPLAY_getHeader();
+void REPLAY_preparePlayback();
+
+// A `.rpl` file is the header followed by `eventCount` events.
+u32 REPLAY_save(u8* buffer, u32 size);  // (returns the written bytes)
+bool REPLAY_load(const u8* buffer, u32 size);
+void REPLAY_dump();  // (mGBA debug log, hex lines after `REPLAY_DUMP_PREFIX`)
+const ReplayPlayback* REPLAY_getPlayback();
+
+#else
+
+inline void REPLAY_begin(Song* song, Chart* chart) {}
+inline void REPLAY_stop() {}
+inline u16 REPLAY_process(u16 keys) {
+  return keys;
+}
+inline bool REPLAY_finish(Evaluation* evaluation) {
+  return true;
+}
+
+inline bool REPLAY_isPlaying() {
+  return false;
+}
+inline bool REPLAY_canPlay(GameMode gameMode) {
+  return false;
+}
+inline const ReplayHeader* REPLAY_getHeader() {
+  return NULL;
+}
+inline void REPLAY_preparePlayback() {}
+
+inline u32 REPLAY_save(u8* buffer, u32 size) {
+  return 0;
+}
+inline bool REPLAY_load(const u8* buffer, u32 size) {
+  return false;
+}
+inline void REPLAY_dump() {}
+inline const ReplayPlayback* REPLAY_getPlayback() {
+  return NULL;
+}
+
+#endif
+
+#endif  // REPLAY_H
@@ -8,6 +8,8 @@
 #include "Key.h"
 #include "SequenceMessages.h"
 #include "gameplay/Library.h"
+#include "gameplay/Replay.h"
+#include "gameplay/library/LibraryStore.h"
 #include "gameplay/video/VideoStore.h"
 #include "multiplayer/PS2Keyboard.h"
 #include "multiplayer/Syncer.h"
@@ -29,6 +31,10 @@ static void goTo(Scene* scene) {
   _engine->transitionIntoScene(scene, new PixelTransitionEffect());
 }
 
+static void goToSong(SongScene* scene) {
+  _engine->transitionIntoScene(scene, scene->createTransition());
+}
+
 void SEQUENCE_initialize(std::shared_ptr<GBAEngine> engine,
                          const GBFS_FILE* fs) {
   _engine = engine;
@@ -119,6 +125,9 @@ Scene* SEQUENCE_activateVideo(bool showSuccessMessage) {
     }
     case VideoStore::ACTIVE:
     default: {
+      if (libraryStore->activate(_fs))
+        SAVEFILE_useLibrary(libraryStore->getRomId());
+
       return showSuccessMessage ? SEQUENCE_halt(VIDEO_ACTIVATION_SUCCESS)
                                 : NULL;
     }
@@ -277,7 +286,7 @@ void SEQUENCE_goToMessageOrSong(Song* song, Chart* chart, Chart* remoteChart) {
                        [song, chart](u16 keys) {
                          bool isPressed = KEY_CONFIRM(keys);
                          if (isPressed)
-                           goTo(new SongScene(_engine, _fs, song, chart));
+                           goToSong(new SongScene(_engine, _fs, song, chart));
                        }));
     return;
   }
@@ -288,7 +297,7 @@ void SEQUENCE_goToMessageOrSong(Song* song, Chart* chart, Chart* remoteChart) {
         [song, chart](u16 keys) {
           bool isPressed = KEY_CONFIRM(keys);
           if (isPressed)
-            goTo(new SongScene(_engine, _fs, song, chart));
+            goToSong(new SongScene(_engine, _fs, song, chart));
         },
         true));
     return;
@@ -301,7 +310,7 @@ void SEQUENCE_goToMessageOrSong(Song* song, Chart* chart, Chart* remoteChart) {
         [song, chart](u16 keys) {
           bool isPressed = KEY_CONFIRM(keys);
           if (isPressed)
-            goTo(new SongScene(_engine, _fs, song, chart));
+            goToSong(new SongScene(_engine, _fs, song, chart));
         },
         true));
     return;
@@ -314,7 +323,7 @@ void SEQUENCE_goToMessageOrSong(Song* song, Chart* chart, Chart* remoteChart) {
         [song, chart](u16 keys) {
           bool isPressed = KEY_CONFIRM(keys);
           if (isPressed)
-            goTo(new SongScene(_engine, _fs, song, chart));
+            goToSong(new SongScene(_engine, _fs, song, chart));
         },
         true));
     return;
@@ -327,13 +336,13 @@ void SEQUENCE_goToMessageOrSong(Song* song, Chart* chart, Chart* remoteChart) {
         [song, chart](u16 keys) {
           bool isPressed = KEY_CONFIRM(keys);
           if (isPressed)
-            goTo(new SongScene(_engine, _fs, song, chart));
+            goToSong(new SongScene(_engine, _fs, song, chart));
         },
         true));
     return;
   }
 
-  goTo(new SongScene(_engine, _fs, song, chart, remoteChart));
+  goToSong(new SongScene(_engine, _fs, song, chart, remoteChart));
 }
 
 void SEQUENCE_goToWinOrSelection(bool isLastSong) {
@@ -361,6 +370,24 @@ void SEQUENCE_goToWinOrSelection(bool isLastSong) {
     goTo(new SelectionScene(_engine, _fs));
 }
 
+void SEQUENCE_goToReplay() {
+  auto replay = REPLAY_getHeader();
+  if (replay == NULL)
+    return;  // (release builds don't record replays)
+
+  SongFile file(replay->songName, replay->songIndex);
+  Song* song = SONG_parse(_fs, &file, std::vector<u8>{replay->chartIndex});
+  if (song == NULL)
+    return;
+  Chart* chart = song->charts + replay->chartIndex;
+  chart->customOffset = replay->customOffset;
+  chart->levelIndex = replay->levelIndex;
+
+  STATE_setup(song, chart);
+  REPLAY_preparePlayback();
+  goToSong(new SongScene(_engine, _fs, song, chart));
+}
+
 void SEQUENCE_goToAdminMenuHint() {
   goTo(new TalkScene(_engine, _fs, OPEN_ADMIN_MENU_HINT, [](u16 keys) {
     bool isPressed = KEY_CONFIRM(keys);
@@ -29,6 +29,7 @@ void SEQUENCE_goToMessageOrSong(Song* song,
                                 Chart* chart,
                                 Chart* remoteChart = NULL);
 void SEQUENCE_goToWinOrSelection(bool isLastSong);
+void SEQUENCE_goToReplay();
 void SEQUENCE_goToAdminMenuHint();
 bool SEQUENCE_isMultiplayerSessionDead();
 
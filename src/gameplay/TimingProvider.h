@@ -15,14 +15,27 @@ const u32 ARROW_TIME[] = {0, 2426, 1213, 809, 607, 485, 404};
 const u32 MAX_ARROW_TIME = 2426;
 const u32 MAX_ARROW_TIME_JUMP = 150;
 const u32 MINUTE = 60000;
-const u32 FRAME_MS = 17;
+const u32 FRAME_MS_Q16 = 1097250;  // (280896 cycles / 16.78MHz = 16.7427 ms)
 const u32 BEAT_UNIT = 4;
 const u32 ARROW_SCROLL_LENGTH_BEATS = BEAT_UNIT * 2;
 const u32 FRACUMUL_DIV_BY_MINUTE = 71583;  // (1/MINUTE) * INFINITY
 
+// Exact (rounded) duration of a number of frames, without the drift of
+// accumulating a whole-millisecond frame length.
+constexpr u32 TIMING_framesToMsecs(u32 frames) {
+  return (u32)(((u64)frames * FRAME_MS_Q16 + (1 << 15)) >> 16);
+}
+
 class TimingProvider {
  public:
   inline int getMsecs() { return msecs; }
+  inline u32 getMsecsFraction() { return msecsFraction; }
+  inline u32 getDistanceTo(int timestamp, int offset = 0) {
+    // (rounded with the song clock's sub-millisecond part, so judgements
+    // aren't biased by truncation)
+    s64 diff = ((s64)(msecs + offset - timestamp) << 16) + msecsFraction;
+    return (u32)(((diff < 0 ? -diff : diff) + (1 << 15)) >> 16);
+  }
   inline u32 getArrowTime() { return arrowTime; }
   inline bool isStopped() { return hasStopped; }
   inline int getStopStart() { return stopStart; }
@@ -33,6 +46,7 @@ class TimingProvider {
 
  protected:
   int msecs = 0;
+  u32 msecsFraction = 0;  // (Q0.16, see `PlaybackState`)
   bool hasStopped = false;
   u32 arrowTime;
   u32 scrollBpm = 0;
@@ -35,16 +35,20 @@ void ChartReader::logDebugInfo<CHART_DEBUG>() {
 
   std::string typeStr;
   u32 currentIndex = eventIndex;
+  Event* nextEvent = NULL;
   while (currentIndex < chart->eventCount) {
-    Event* event = chart->events + currentIndex;
+    Event* event = chart->events.at(currentIndex);
+    if (event == NULL)
+      break;
     EventType type = static_cast<EventType>((event->data() & EVENT_TYPE));
-    if (EVENT_HAS_PARAM(type))
+    if (EVENT_HAS_PARAM(type)) {
+      nextEvent = event;
       break;
+    }
     currentIndex++;
   }
 
-  if (currentIndex < chart->eventCount) {
-    Event* nextEvent = chart->events + currentIndex;
+  if (nextEvent != NULL) {
     EventType type = static_cast<EventType>((nextEvent->data() & EVENT_TYPE));
 
     switch (type) {
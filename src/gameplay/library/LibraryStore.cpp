@@ -0,0 +1,384 @@
+#include "LibraryStore.h"
+
+#include <libgba-sprite-engine/gba/tonc_math.h>
+
+#include <string.h>
+
+#include <new>
+#include <string>
+
+#include "gameplay/save/SaveFile.h"
+#include "player/PlaybackState.h"
+
+extern "C" {
+#include "player/io_scheduler.h"
+#include "utils/flashcartio/flashcartio.h"
+}
+
+DATA_EWRAM static FIL file;
+DATA_EWRAM static FIL preloadFile;
+
+inline u32 hashName(const char* name) {
+  u32 hash = 2166136261;  // (FNV-1a)
+  while (*name != '\0') {
+    hash ^= (u8)*name++;
+    hash *= 16777619;
+  }
+  return hash;
+}
+
+inline u32 allocatedSizeOf(u32 size) {
+  return (size + 1 + 3) & ~3;  // (+ '\0', 4-byte aligned)
+}
+
+inline bool matches(u32 hash,
+                    const char* name,
+                    u32 entryHash,
+                    const char* entryName) {
+  // (hashes only speed up lookups, the names are compared too)
+  return entryHash == hash &&
+         strncmp(entryName, name, LIBRARY_NAME_LENGTH) == 0 &&
+         strlen(name) <= LIBRARY_NAME_LENGTH;
+}
+
+bool LibraryStore::activate(const GBFS_FILE* fs) {
+  if (isActive())
+    return true;
+  if (PlaybackState.fatfs == NULL)
+    return false;
+
+  // (the SD card library must belong to the same ROM id, so the save file
+  // stays valid; only the library size can differ)
+  auto romRomId = (u8*)gbfs_get_obj(fs, ROM_ID_FILE, NULL);
+  if (romRomId == NULL)
+    return false;
+
+  u32 readBytes;
+  u8 sdRomId[4];
+  if (f_open(&file, (std::string(LIBRARY_FOLDER_NAME) + ROM_ID_FILE).c_str(),
+             FA_READ) > 0)
+    return false;
+  bool success = f_read(&file, sdRomId, 4, &readBytes) == 0 && readBytes == 4;
+  f_close(&file);
+  if (!success ||
+      (as_le(sdRomId) & ROM_ID_MASK) != (as_le(romRomId) & ROM_ID_MASK))
+    return false;
+
+  cache = new (std::nothrow) u8[LIBRARY_CACHE_SIZE];
+  if (cache == NULL)
+    return false;
+
+  romId = as_le(sdRomId);
+  firstEntry = 0;
+  entryCount = 0;
+  cursor = 0;
+  for (auto& pin : pins)
+    pin.data = NULL;
+  preloadEntry = NULL;
+  missingCount = 0;
+  missingCursor = 0;
+  romFallbacks = 0;
+  lastError = Error::NONE;
+
+  return true;
+}
+
+const void* LibraryStore::getFile(const GBFS_FILE* fs,
+                                  const char* name,
+                                  u32* length) {
+  lastError = Error::NONE;
+  if (isActive()) {
+    u32 hash = hashName(name);
+    auto data = find(name, hash, length);
+    if (data == NULL && !isMissing(name, hash))
+      data = read(name, hash, length);
+    if (data != NULL)
+      return data;
+  }
+
+  auto data = gbfs_get_obj(fs, name, length);
+  if (data == NULL) {
+    if (lastError == Error::NONE)
+      lastError = Error::NOT_FOUND;
+    return NULL;
+  }
+
+  if (lastError == Error::UNCACHEABLE)
+    romFallbacks++;
+  lastError = Error::NONE;
+  return data;
+}
+
+const void* LibraryStore::peekFile(const GBFS_FILE* fs,
+                                   const char* name,
+                                   u32* length) {
+  if (isActive()) {
+    u32 hash = hashName(name);
+    auto data = find(name, hash, length);
+    if (data != NULL)
+      return data;
+    if (!isMissing(name, hash))
+      return NULL;
+  }
+
+  return gbfs_get_obj(fs, name, length);
+}
+
+bool LibraryStore::preload(const char* name) {
+  if (!isActive())
+    return true;
+
+  u32 hash = hashName(name);
+  if (!isPreloading(name, hash)) {
+    stopPreload();
+    if (find(name, hash, NULL) != NULL || isMissing(name, hash))
+      return true;
+
+    FRESULT result = f_open(
+        &preloadFile, (std::string(LIBRARY_FOLDER_NAME) + name).c_str(),
+        FA_READ);
+    if (result > 0) {
+      if (result == FR_NO_FILE || result == FR_NO_PATH)
+        addMissing(name, hash);
+      return true;
+    }
+
+    preloadEntry = add(name, hash, f_size(&preloadFile));
+    if (preloadEntry == NULL) {
+      f_close(&preloadFile);
+      return true;  // (`getFile` will fall back to ROM)
+    }
+    preloadEntry->isLoading = true;
+    preloadOffset = preloadEntry->offset;
+    preloadCursor = 0;
+  }
+
+  u32 size = preloadEntry->size;
+  u32 chunk =
+      min(size - preloadCursor, LIBRARY_PRELOAD_SECTORS * IO_SECTOR_SIZE);
+  u32 sectors = (chunk + IO_SECTOR_SIZE - 1) / IO_SECTOR_SIZE;
+  if (chunk > 0 && !io_scheduler_request(IO_STREAM_OTHER, sectors))
+    return false;
+
+  u32 readBytes;
+  if (f_read(&preloadFile, cache + preloadOffset + preloadCursor, chunk,
+             &readBytes) > 0 ||
+      readBytes != chunk) {
+    preloadEntry->isValid = false;
+    stopPreload();
+    return true;
+  }
+  preloadCursor += chunk;
+  if (preloadCursor < size)
+    return false;
+
+  cache[preloadOffset + size] = '\0';
+  preloadEntry->isLoading = false;
+  stopPreload();
+  return true;
+}
+
+bool LibraryStore::pin(const void* data) {
+  if (!isCached(data))
+    return true;  // (ROM files are always valid)
+
+  auto pin = findPin(data);
+  if (pin != NULL) {
+    pin->count++;
+    return true;
+  }
+
+  pin = findPin(NULL);
+  if (pin == NULL)
+    return false;
+  for (u32 i = 0; i < entryCount; i++) {
+    auto entry = &entries[(firstEntry + i) % LIBRARY_CACHE_ENTRIES];
+    if (entry->isValid && !entry->isLoading && cache + entry->offset == data) {
+      pin->data = (const u8*)data;
+      pin->size = allocatedSizeOf(entry->size);
+      pin->count = 1;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void LibraryStore::unpin(const void* data) {
+  auto pin = data != NULL ? findPin(data) : NULL;
+  if (pin == NULL)
+    return;
+
+  pin->count--;
+  if (pin->count == 0)
+    pin->data = NULL;
+}
+
+const void* LibraryStore::find(const char* name, u32 hash, u32* length) {
+  for (u32 i = 0; i < entryCount; i++) {
+    auto entry = &entries[(firstEntry + i) % LIBRARY_CACHE_ENTRIES];
+    if (entry->isValid && !entry->isLoading &&
+        matches(hash, name, entry->hash, entry->name)) {
+      if (length != NULL)
+        *length = entry->size;
+      return cache + entry->offset;
+    }
+  }
+
+  return NULL;
+}
+
+bool LibraryStore::isMissing(const char* name, u32 hash) {
+  for (u32 i = 0; i < missingCount; i++) {
+    if (matches(hash, name, missing[i].hash, missing[i].name))
+      return true;
+  }
+
+  return false;
+}
+
+void LibraryStore::addMissing(const char* name, u32 hash) {
+  auto entry = &missing[missingCursor];
+  entry->hash = hash;
+  strncpy(entry->name, name, LIBRARY_NAME_LENGTH);
+  missingCursor = (missingCursor + 1) % LIBRARY_MISSING_ENTRIES;
+  if (missingCount < LIBRARY_MISSING_ENTRIES)
+    missingCount++;
+}
+
+const void* LibraryStore::read(const char* name, u32 hash, u32* length) {
+  FRESULT result =
+      f_open(&file, (std::string(LIBRARY_FOLDER_NAME) + name).c_str(), FA_READ);
+  if (result > 0) {
+    // (GBFS-only files would be looked up on every call otherwise)
+    if (result == FR_NO_FILE || result == FR_NO_PATH)
+      addMissing(name, hash);
+    else
+      lastError = Error::READ_FAILED;
+    return NULL;
+  }
+
+  u32 size = f_size(&file);
+  auto entry = add(name, hash, size);
+  if (entry == NULL) {
+    // (too big, or the pinned files leave no room for it)
+    f_close(&file);
+    lastError = Error::UNCACHEABLE;
+    return NULL;
+  }
+
+  u32 readBytes;
+  bool success = f_read(&file, cache + entry->offset, size, &readBytes) == 0 &&
+                 readBytes == size;
+  f_close(&file);
+  if (!success) {
+    entry->isValid = false;
+    lastError = Error::READ_FAILED;
+    return NULL;
+  }
+  cache[entry->offset + size] = '\0';  // (text files are used as C strings)
+
+  if (length != NULL)
+    *length = size;
+  return cache + entry->offset;
+}
+
+LibraryStore::CacheEntry* LibraryStore::add(const char* name,
+                                            u32 hash,
+                                            u32 size) {
+  u32 allocatedSize = allocatedSizeOf(size);
+  if (allocatedSize > LIBRARY_CACHE_SIZE || !allocate(allocatedSize))
+    return NULL;
+  if (entryCount == LIBRARY_CACHE_ENTRIES) {
+    firstEntry = (firstEntry + 1) % LIBRARY_CACHE_ENTRIES;
+    entryCount--;
+  }
+
+  auto entry = &entries[(firstEntry + entryCount) % LIBRARY_CACHE_ENTRIES];
+  entry->hash = hash;
+  strncpy(entry->name, name, LIBRARY_NAME_LENGTH);
+  entry->offset = cursor;
+  entry->size = size;
+  entry->isValid = true;
+  entry->isLoading = false;
+  entryCount++;
+  cursor += allocatedSize;
+  return entry;
+}
+
+bool LibraryStore::isPreloading(const char* name, u32 hash) {
+  // (newer files can take its space or its entry while it's loading)
+  return preloadEntry != NULL && preloadEntry->isValid &&
+         preloadEntry->isLoading && preloadEntry->offset == preloadOffset &&
+         matches(hash, name, preloadEntry->hash, preloadEntry->name);
+}
+
+void LibraryStore::stopPreload() {
+  if (preloadEntry == NULL)
+    return;
+
+  if (preloadEntry->isLoading)
+    preloadEntry->isValid = false;
+  f_close(&preloadFile);
+  preloadEntry = NULL;
+}
+
+bool LibraryStore::allocate(u32 size) {
+  // (allocations are sequential, wrapping around once and skipping the pinned
+  // files)
+  u32 offset = cursor;
+  bool hasWrapped = false;
+  while (true) {
+    if (offset + size > LIBRARY_CACHE_SIZE) {
+      if (hasWrapped)
+        return false;
+      offset = 0;
+      hasWrapped = true;
+    }
+
+    auto pin = findOverlappingPin(offset, offset + size);
+    if (pin == NULL)
+      break;
+    offset = (u32)(pin->data - cache) + pin->size;
+  }
+
+  evict(offset, offset + size);
+  cursor = offset;
+  return true;
+}
+
+LibraryStore::Pin* LibraryStore::findPin(const void* data) {
+  for (auto& pin : pins) {
+    if (pin.data == data)
+      return &pin;
+  }
+
+  return NULL;
+}
+
+LibraryStore::Pin* LibraryStore::findOverlappingPin(u32 start, u32 end) {
+  for (auto& pin : pins) {
+    if (pin.data == NULL)
+      continue;
+
+    u32 pinStart = (u32)(pin.data - cache);
+    if (start < pinStart + pin.size && end > pinStart)
+      return &pin;
+  }
+
+  return NULL;
+}
+
+void LibraryStore::evict(u32 start, u32 end) {
+  for (u32 i = 0; i < entryCount; i++) {
+    auto entry = &entries[(firstEntry + i) % LIBRARY_CACHE_ENTRIES];
+    bool overlaps = entry->offset < end && entry->offset + entry->size >= start;
+    if (overlaps)
+      entry->isValid = false;
+  }
+
+  while (entryCount > 0 && !entries[firstEntry].isValid) {
+    firstEntry = (firstEntry + 1) % LIBRARY_CACHE_ENTRIES;
+    entryCount--;
+  }
+}
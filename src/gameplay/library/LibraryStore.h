@@ -0,0 +1,116 @@
+#ifndef LIBRARY_STORE_H
+#define LIBRARY_STORE_H
+
+#include <libgba-sprite-engine/gba/tonc_core.h>
+
+extern "C" {
+#include "utils/gbfs/gbfs.h"
+}
+
+#define LIBRARY_FOLDER_NAME "/piuGBA_library/"
+#define LIBRARY_CACHE_SIZE (64 * 1024)
+#define LIBRARY_CACHE_ENTRIES 16
+#define LIBRARY_MISSING_ENTRIES 16
+#define LIBRARY_NAME_LENGTH 24  // (like GBFS names)
+#define LIBRARY_PRELOAD_SECTORS 8  // (per `preload(...)` call)
+#define LIBRARY_PINS 5  // (two charts at a song transition + a background)
+
+class LibraryStore {
+ public:
+  // Why the last `getFile` returned NULL.
+  enum class Error {
+    NONE,
+    NOT_FOUND,    // (neither on the SD card nor in ROM)
+    UNCACHEABLE,  // (on the SD card, but it didn't fit in the cache)
+    READ_FAILED
+  };
+
+  bool isActive() { return cache != NULL; }
+
+  bool activate(const GBFS_FILE* fs);
+  u32 getRomId() { return romId; }
+
+  // Same contract as `gbfs_get_obj`, but when the SD card library is active,
+  // files are read from `LIBRARY_FOLDER_NAME` through an EWRAM cache.
+  // Returned pointers stay valid until ~`LIBRARY_CACHE_SIZE` bytes of newer
+  // files have been read (FIFO eviction). SD files that can't be cached are
+  // read from ROM, so songs that only exist on the SD card return NULL (see
+  // `getLastError`) and must be skipped.
+  const void* getFile(const GBFS_FILE* fs, const char* name, u32* length);
+  // Like `getFile`, but it never reads the SD card: returns NULL if the file
+  // would have to be read.
+  const void* peekFile(const GBFS_FILE* fs, const char* name, u32* length);
+
+  // Reads `name` into the cache `LIBRARY_PRELOAD_SECTORS` at a time, when the
+  // frame's I/O budget allows it (`io_scheduler_request`), so a later
+  // `getFile` finds it without reading. Call it once per frame until it
+  // returns true (also when the file is missing or can't be cached).
+  bool preload(const char* name);
+  void stopPreload();  // (a half-read file is dropped)
+
+  // Keeps a cached file from being overwritten (e.g. while chart events are
+  // streamed from it). Pins are counted, for up to `LIBRARY_PINS` files at
+  // once. Returns false if `data` couldn't be pinned (ROM files always can).
+  bool pin(const void* data);
+  void unpin(const void* data);
+  // Whether `data` points into the cache (so it can be overwritten later).
+  bool isCached(const void* data) {
+    return isActive() && data >= cache && data < cache + LIBRARY_CACHE_SIZE;
+  }
+  // Files found on the SD card that didn't fit in the cache, so they were
+  // read from ROM instead.
+  u32 getRomFallbacks() { return romFallbacks; }
+  Error getLastError() { return lastError; }
+
+ private:
+  typedef struct {
+    u32 hash;
+    char name[LIBRARY_NAME_LENGTH];
+    u32 offset;
+    u32 size;
+    bool isValid;
+    bool isLoading;  // (being preloaded)
+  } CacheEntry;
+
+  typedef struct {
+    u32 hash;
+    char name[LIBRARY_NAME_LENGTH];
+  } MissingEntry;  // (files that aren't on the SD card)
+
+  typedef struct {
+    const u8* data;
+    u32 size;  // (allocated)
+    u32 count;
+  } Pin;
+
+  u8* cache = NULL;
+  u32 romId = 0;
+  CacheEntry entries[LIBRARY_CACHE_ENTRIES];
+  u32 firstEntry = 0;
+  u32 entryCount = 0;
+  u32 cursor = 0;
+  Pin pins[LIBRARY_PINS];
+  MissingEntry missing[LIBRARY_MISSING_ENTRIES];
+  u32 missingCount = 0;
+  u32 missingCursor = 0;
+  u32 romFallbacks = 0;
+  Error lastError = Error::NONE;
+  CacheEntry* preloadEntry = NULL;
+  u32 preloadOffset = 0;
+  u32 preloadCursor = 0;
+
+  const void* find(const char* name, u32 hash, u32* length);
+  bool isMissing(const char* name, u32 hash);
+  void addMissing(const char* name, u32 hash);
+  const void* read(const char* name, u32 hash, u32* length);
+  CacheEntry* add(const char* name, u32 hash, u32 size);
+  bool isPreloading(const char* name, u32 hash);
+  bool allocate(u32 size);
+  Pin* findPin(const void* data);
+  Pin* findOverlappingPin(u32 start, u32 end);
+  void evict(u32 start, u32 end);
+};
+
+extern LibraryStore* libraryStore;
+
+#endif  // LIBRARY_STORE_H
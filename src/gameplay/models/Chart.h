@@ -5,9 +5,11 @@
 
 #include <string>
 #include "Event.h"
+#include "EventStream.h"
 
 enum DifficultyLevel { NORMAL, HARD, CRAZY, NUMERIC };
 enum ChartType { SINGLE_CHART, DOUBLE_CHART, DOUBLE_COOP_CHART };
+const u8 CHART_COMPRESSED_EVENTS = 0x80;  // (flag in the `type` byte)
 const u32 MAX_DIFFICULTY = 2;
 
 typedef struct {
@@ -20,10 +22,10 @@ typedef struct {
   u32 eventChunkSize;
 
   u32 rhythmEventCount;
-  Event* rhythmEvents;  // ("rhythmEventCount" times)
+  EventStream rhythmEvents;  // ("rhythmEventCount" times)
 
   u32 eventCount;
-  Event* events;  // ("eventCount" times)
+  EventStream events;  // ("eventCount" times)
 
   // custom fields:
   bool isDouble;  // type == ChartType::DOUBLE_CHART ||
@@ -0,0 +1,96 @@
+#include "EventStream.h"
+
+#include "utils/LZ77.h"
+#include "utils/parse.h"
+
+inline void parseEvent(Event* event, bool isDouble, u8* data, u32* cursor) {
+  event->timestampAndData = parse_u32le(data, cursor);
+
+  auto eventType = static_cast<EventType>(event->data() & EVENT_TYPE);
+  event->data2 =
+      EVENT_HAS_DATA2(eventType, isDouble) ? parse_u8(data, cursor) : 0;
+
+  if (EVENT_HAS_PARAM(eventType))
+    event->param = parse_u32le(data, cursor);
+  if (EVENT_HAS_PARAM2(eventType))
+    event->param2 = parse_u32le(data, cursor);
+  if (EVENT_HAS_PARAM3(eventType))
+    event->param3 = parse_u32le(data, cursor);
+
+  event->handled[0] = false;
+  event->handled[1] = false;
+}
+
+void EventStream::initialize(u8* data,
+                             u32 count,
+                             bool isDouble,
+                             Event* ring,
+                             u32 size,
+                             u8* block) {
+  this->data = block != NULL ? block : data;
+  this->compressedData = block != NULL ? data : NULL;
+  this->count = count;
+  this->isDouble = isDouble;
+  this->ring = ring;
+  this->size = size;
+  reset();
+}
+
+void EventStream::reset() {
+  start = 0;
+  end = 0;
+  cursor = 0;
+  compressedCursor = 0;
+  blockLength = 0;
+  readers = 0;
+}
+
+void EventStream::attach(u8 playerId) {
+  readers |= 1 << playerId;
+  readerIndexes[playerId] = start;
+}
+
+void EventStream::release(u8 playerId, u32 index) {
+  readerIndexes[playerId] = index;
+
+  u32 newStart = end;
+  for (u32 i = 0; i < GAME_MAX_PLAYERS; i++) {
+    if ((readers & (1 << i)) && readerIndexes[i] < newStart)
+      newStart = readerIndexes[i];
+  }
+  start = newStart;
+}
+
+bool EventStream::fill(u32 index) {
+  while (end <= index && end < count && end - start < size) {
+    if (compressedData != NULL && cursor == blockLength)
+      decompressBlock();
+
+    parseEvent(ring + (end & (size - 1)), isDouble, data, &cursor);
+    end++;
+  }
+
+  return end > index;
+}
+
+void EventStream::decompressBlock() {
+  u32 length;
+  blockLength =
+      LZ77_decompress(compressedData + compressedCursor, data, &length);
+  compressedCursor += length;
+  cursor = 0;
+}
+
+u32 EventStream::measure(u8* data, u32 count, bool isDouble) {
+  u32 cursor = 0;
+  for (u32 i = 0; i < count; i++) {
+    // (the type is in the high byte of `timestampAndData`)
+    auto eventType = static_cast<EventType>(data[cursor + 3] & EVENT_TYPE);
+    cursor += sizeof(u32) + EVENT_HAS_DATA2(eventType, isDouble) +
+              (EVENT_HAS_PARAM(eventType) + EVENT_HAS_PARAM2(eventType) +
+               EVENT_HAS_PARAM3(eventType)) *
+                  sizeof(u32);
+  }
+
+  return cursor;
+}
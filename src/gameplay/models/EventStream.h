@@ -0,0 +1,65 @@
+#ifndef EVENT_STREAM_H
+#define EVENT_STREAM_H
+
+#include <libgba-sprite-engine/gba/tonc_core.h>
+
+#include <stddef.h>
+
+#include "Event.h"
+
+// (compressed charts store their events in LZ77 blocks of up to
+// `EVENT_STREAM_BLOCK_EVENTS` events, see `SongSerializer.js`)
+#define EVENT_STREAM_BLOCK_EVENTS 128
+#define EVENT_STREAM_MAX_EVENT_SIZE 16
+#define EVENT_STREAM_BLOCK_SIZE \
+  (EVENT_STREAM_BLOCK_EVENTS * EVENT_STREAM_MAX_EVENT_SIZE)
+
+// Chart events are parsed lazily from the serialized `.pius` data into a
+// fixed-size ring, so RAM usage doesn't depend on the chart length.
+// Events stay in the ring until every attached reader has `release`d them.
+class EventStream {
+ public:
+  u32 count = 0;
+
+  // When `block` is provided, `data` points to LZ77 blocks that are
+  // decompressed into it (`EVENT_STREAM_BLOCK_SIZE` bytes) one at a time.
+  void initialize(u8* data,
+                  u32 count,
+                  bool isDouble,
+                  Event* ring,
+                  u32 size,
+                  u8* block = NULL);
+  void reset();  // (back to the first event, detaching all readers)
+
+  void attach(u8 playerId);
+  void release(u8 playerId, u32 index);
+
+  // Returns NULL when the ring is full of unreleased events.
+  inline Event* at(u32 index) {
+    if (index >= end && !fill(index))
+      return NULL;
+
+    return ring + (index & (size - 1));
+  }
+
+  static u32 measure(u8* data, u32 count, bool isDouble);
+
+ private:
+  u8* data;
+  bool isDouble;
+  Event* ring;
+  u32 size;       // (power of 2)
+  u32 start = 0;  // (index of the oldest event in the ring)
+  u32 end = 0;    // (index of the next event to parse)
+  u32 cursor = 0;
+  u8* compressedData = NULL;
+  u32 compressedCursor = 0;
+  u32 blockLength = 0;
+  u32 readerIndexes[GAME_MAX_PLAYERS];
+  u8 readers = 0;
+
+  bool fill(u32 index);
+  void decompressBlock();
+};
+
+#endif  // EVENT_STREAM_H
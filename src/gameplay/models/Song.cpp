@@ -2,6 +2,7 @@
 
 #include <string.h>
 
+#include "gameplay/library/LibraryStore.h"
 #include "utils/VectorUtils.h"
 
 const u32 TITLE_LEN = 31;
@@ -9,37 +10,43 @@ const u32 ARTIST_LEN = 27;
 const u32 MESSAGE_LEN = 107;
 
 #define DATA_EWRAM __attribute__((section(".ewram")))
-#define MAX_EVENTS 3250
-#define ALLOCATION_SIZE (MAX_EVENTS * sizeof(Event))
-// (65000 bytes) -> (3250)*20
+#define RHYTHM_EVENTS_RING_SIZE 64
+#define EVENTS_RING_SIZE 512
+#define SECONDARY_MEMORY_SIZE (50 * 1024)
+// (events are streamed from ROM, see `EventStream`)
 
 typedef struct {
-  Event events[MAX_EVENTS];
+  Event rhythmEvents[RHYTHM_EVENTS_RING_SIZE];
+  Event events[EVENTS_RING_SIZE];
+  u8 rhythmBlock[EVENT_STREAM_BLOCK_SIZE];
+  u8 block[EVENT_STREAM_BLOCK_SIZE];
 } ChartAllocation;
 
 DATA_EWRAM ChartAllocation chartAllocations[GAME_MAX_PLAYERS];
-DATA_EWRAM u32 usedSpace[GAME_MAX_PLAYERS];
+DATA_EWRAM u8 secondaryMemory[SECONDARY_MEMORY_SIZE] __attribute__((aligned(4)));
 
-void parseEvents(Event* events,
-                 u32 count,
-                 bool isDouble,
-                 u8* data,
-                 u32* cursor);
+u8* getMetadata(const GBFS_FILE* fs, SongFile* file, u32* length) {
+  if (file->metadata != NULL) {
+    *length = file->metadataLength;
+    return (u8*)file->metadata;
+  }
+
+  return (u8*)libraryStore->getFile(fs, file->getMetadataFile().c_str(),
+                                    length);
+}
 
 Song* SONG_parse(const GBFS_FILE* fs,
                  SongFile* file,
                  std::vector<u8> chartIndexes) {
-  for (u32 i = 0; i < GAME_MAX_PLAYERS; i++)
-    usedSpace[i] = 0;
-
   u32 length;
-  auto data = (u8*)gbfs_get_obj(fs, file->getMetadataFile().c_str(), &length);
+  auto data = getMetadata(fs, file, &length);
+  if (data == NULL)
+    return NULL;
 
   u32 cursor = 0;
   auto song = new Song();
 
   song->id = parse_u8(data, &cursor);
-  song->totalSize = 0;
 
   song->title = new (std::nothrow) char[TITLE_LEN];
   parse_array(data, &cursor, song->title, TITLE_LEN);
@@ -72,7 +79,6 @@ Song* SONG_parse(const GBFS_FILE* fs,
 
   song->chartCount = parse_u8(data, &cursor);
   song->charts = new (std::nothrow) Chart[song->chartCount];
-  song->totalSize += sizeof(Chart) * song->chartCount;
   u32 slot = 0;
   for (u32 i = 0; i < song->chartCount; i++) {
     auto chart = song->charts + i;
@@ -81,13 +87,16 @@ Song* SONG_parse(const GBFS_FILE* fs,
     chart->level = parse_u8(data, &cursor);
     chart->variant = parse_u8(data, &cursor);
     chart->offsetLabel = parse_u8(data, &cursor);
-    chart->type = static_cast<ChartType>(parse_u8(data, &cursor));
+    u8 type = parse_u8(data, &cursor);
+    bool isCompressed = type & CHART_COMPRESSED_EVENTS;
+    chart->type = static_cast<ChartType>(type & ~CHART_COMPRESSED_EVENTS);
     chart->isDouble = chart->type == ChartType::DOUBLE_CHART ||
                       chart->type == ChartType::DOUBLE_COOP_CHART;
     chart->customOffset = 0;
     chart->levelIndex = 0;
 
     chart->eventChunkSize = parse_u32le(data, &cursor);
+    u32 chunkEnd = cursor + chart->eventChunkSize;
     bool shouldParseEvents = VECTOR_contains(chartIndexes, i);
     if (!shouldParseEvents) {
       cursor += chart->eventChunkSize;
@@ -96,21 +105,38 @@ Song* SONG_parse(const GBFS_FILE* fs,
       continue;
     }
 
+    auto allocation = &chartAllocations[slot];
     chart->rhythmEventCount = parse_u32le(data, &cursor);
-    chart->rhythmEvents = chartAllocations[slot].events;
-    song->totalSize += sizeof(Event) * chart->rhythmEventCount;
-    parseEvents(chart->rhythmEvents, chart->rhythmEventCount, chart->isDouble,
-                data, &cursor);
+    if (isCompressed) {
+      u32 compressedSize = parse_u32le(data, &cursor);
+      chart->rhythmEvents.initialize(
+          data + cursor, chart->rhythmEventCount, chart->isDouble,
+          allocation->rhythmEvents, RHYTHM_EVENTS_RING_SIZE,
+          allocation->rhythmBlock);
+      cursor += compressedSize;
+    } else {
+      chart->rhythmEvents.initialize(data + cursor, chart->rhythmEventCount,
+                                     chart->isDouble, allocation->rhythmEvents,
+                                     RHYTHM_EVENTS_RING_SIZE);
+      cursor += EventStream::measure(data + cursor, chart->rhythmEventCount,
+                                     chart->isDouble);
+    }
 
     chart->eventCount = parse_u32le(data, &cursor);
-    chart->events = chartAllocations[slot].events + chart->rhythmEventCount;
-    song->totalSize += sizeof(Event) * chart->eventCount;
-    parseEvents(chart->events, chart->eventCount, chart->isDouble, data,
-                &cursor);
-    usedSpace[slot] = song->totalSize;
+    if (isCompressed)
+      cursor += 4;  // (compressedSize)
+    chart->events.initialize(data + cursor, chart->eventCount,
+                             chart->isDouble, allocation->events,
+                             EVENTS_RING_SIZE,
+                             isCompressed ? allocation->block : NULL);
+    cursor = chunkEnd;
     slot++;
   }
 
+  song->streamedData = slot > 0 ? data : NULL;
+  if (song->streamedData != NULL)
+    libraryStore->pin(song->streamedData);
+
   song->index = file->index;
   song->audioPath = file->getAudioFile();
   song->backgroundTilesPath = file->getBackgroundTilesFile();
@@ -129,7 +155,9 @@ Channel SONG_getChannel(const GBFS_FILE* fs,
     return Channel::BOSS;
 
   u32 length;
-  auto data = (u8*)gbfs_get_obj(fs, file->getMetadataFile().c_str(), &length);
+  auto data = getMetadata(fs, file, &length);
+  if (data == NULL)
+    return Channel::ORIGINAL;
 
   u32 cursor = sizeof(u8) + TITLE_LEN + ARTIST_LEN;
   auto channel = static_cast<Channel>(parse_u8(data, &cursor));
@@ -217,40 +245,13 @@ void SONG_free(Song* song) {
 
   delete[] song->charts;
 
-  delete song;
-}
+  if (song->streamedData != NULL)
+    libraryStore->unpin(song->streamedData);
 
-void parseEvents(Event* events,
-                 u32 count,
-                 bool isDouble,
-                 u8* data,
-                 u32* cursor) {
-  for (u32 j = 0; j < count; j++) {
-    auto event = events + j;
-
-    event->timestampAndData = parse_u32le(data, cursor);
-
-    auto eventType = static_cast<EventType>(event->data() & EVENT_TYPE);
-    event->data2 =
-        EVENT_HAS_DATA2(eventType, isDouble) ? parse_u8(data, cursor) : 0;
-
-    if (EVENT_HAS_PARAM(eventType))
-      event->param = parse_u32le(data, cursor);
-    if (EVENT_HAS_PARAM2(eventType))
-      event->param2 = parse_u32le(data, cursor);
-    if (EVENT_HAS_PARAM3(eventType))
-      event->param3 = parse_u32le(data, cursor);
-
-    event->handled[0] = false;
-    event->handled[1] = false;
-  }
+  delete song;
 }
 
-// this allows *misusing* chart-reserved EWRAM for other things
+// (a shared EWRAM buffer for per-song data, e.g. the video decoder)
 u8* getSecondaryMemory(u32 requiredSize) {
-  for (u32 i = 0; i < GAME_MAX_PLAYERS; i++)
-    if (ALLOCATION_SIZE - usedSpace[i] >= requiredSize)
-      return ((u8*)(&chartAllocations[i])) + usedSpace[i];
-
-  return NULL;
+  return requiredSize <= SECONDARY_MEMORY_SIZE ? secondaryMemory : NULL;
 }
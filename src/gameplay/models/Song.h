@@ -49,9 +49,11 @@ typedef struct {
   std::string backgroundPalettePath;
   std::string backgroundMapPath;
   std::string videoPath;
-  u32 totalSize;
+  u8* streamedData;  // (chart events are streamed from here while playing)
 } Song;
 
+// Returns NULL when the metadata file can't be loaded (songs that only exist
+// on the SD card can be too big for its cache, see `LibraryStore::getFile`).
 Song* SONG_parse(const GBFS_FILE* fs,
                  SongFile* file,
                  std::vector<u8> chartIndexes = std::vector<u8>{});
@@ -3,6 +3,8 @@
 
 #include <libgba-sprite-engine/gba/tonc_core.h>
 
+#include <string.h>
+
 #include <string>
 
 #define METADATA_EXTENSION ".pius"
@@ -11,25 +13,48 @@
 #define BACKGROUND_MAP_EXTENSION ".map.bin"
 #define VIDEO_EXTENSION ".vid.bin"
 
+const u32 SONG_NAME_LEN = 16;  // (15 characters + '\0')
+const u8 SONG_ID_UNKNOWN = 0xff;
+
+// POD handle: `metadata` points directly to the `.pius` file in ROM when the
+// library index resolved it, or is NULL when it must be looked up by name
+// (`id` is also only known when it comes from the index)
 typedef struct SongFile {
   u32 index;
-  std::string name;
+  char name[SONG_NAME_LEN];
+  const u8* metadata;
+  u32 metadataLength;
+  u8 id;
+
+  SongFile() {}
 
-  SongFile(std::string name, u32 index) {
+  SongFile(const char* name,
+           u32 index,
+           const u8* metadata = NULL,
+           u32 metadataLength = 0,
+           u8 id = SONG_ID_UNKNOWN) {
     this->index = index;
-    this->name = name;
+    strncpy(this->name, name, SONG_NAME_LEN - 1);
+    this->name[SONG_NAME_LEN - 1] = '\0';
+    this->metadata = metadata;
+    this->metadataLength = metadataLength;
+    this->id = id;
   }
 
-  std::string getMetadataFile() { return name + METADATA_EXTENSION; }
+  std::string getMetadataFile() {
+    return std::string(name) + METADATA_EXTENSION;
+  }
   std::string getAudioFile() { return name; }  // (extensions: .gsm || .aud.bin)
   std::string getBackgroundTilesFile() {
-    return name + BACKGROUND_TILES_EXTENSION;
+    return std::string(name) + BACKGROUND_TILES_EXTENSION;
   }
   std::string getBackgroundPaletteFile() {
-    return name + BACKGROUND_PALETTE_EXTENSION;
+    return std::string(name) + BACKGROUND_PALETTE_EXTENSION;
+  }
+  std::string getBackgroundMapFile() {
+    return std::string(name) + BACKGROUND_MAP_EXTENSION;
   }
-  std::string getBackgroundMapFile() { return name + BACKGROUND_MAP_EXTENSION; }
-  std::string getVideoFile() { return name + VIDEO_EXTENSION; }
+  std::string getVideoFile() { return std::string(name) + VIDEO_EXTENSION; }
 } SongFile;
 
 #endif  // SONG_FILE_H
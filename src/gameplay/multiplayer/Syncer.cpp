@@ -1,7 +1,13 @@
 #include "Syncer.h"
 
+#include <libgba-sprite-engine/gba/tonc_bios.h>
+
 #include "gameplay/Key.h"
 
+extern "C" {
+#include "player/player.h"
+}
+
 #define ASSERT(CONDITION, FAILURE_REASON) \
   if (!(CONDITION)) {                     \
     fail(FAILURE_REASON);                 \
@@ -91,6 +97,44 @@ void Syncer::clearTimeout() {
   timeoutCount = 0;
 }
 
+void Syncer::synchronizeSongStart() {
+  // discard all previous messages and wait for sync
+  u8 remoteId = getRemotePlayerId();
+
+  while (linkUniversal->read(remoteId) != LINK_CABLE_NO_DATA)
+    ;
+
+  u16 start = SYNC_START_SONG | $currentSongChecksum;
+  bool isOnSync = false;
+  while ($isPlayingSong && !isOnSync) {
+    directSend(start);
+    VBlankIntrWait();
+    linkUniversal->sync();
+    isOnSync = linkUniversal->read(remoteId) == start;
+    if (!isOnSync)
+      registerTimeout();
+  }
+  if (!isOnSync)
+    return;
+
+  while (linkUniversal->read(remoteId) != LINK_CABLE_NO_DATA)
+    ;
+
+  if (!isMaster())
+    $currentAudioChunk = AUDIO_SYNC_LIMIT;
+
+  $hasStartedAudio = true;
+  clearTimeout();
+}
+
+void Syncer::onAudioChunk(u32 current) {
+  if (!$isPlayingSong || !isMaster())
+    return;
+
+  $currentAudioChunk = current;
+  directSend(SYNC_AUDIO_CHUNK_HEADER | ((u16)current + AUDIO_SYNC_LIMIT));
+}
+
 void Syncer::sync() {
   u16 incomingData = linkUniversal->read(getRemotePlayerId());
   u8 incomingEvent = SYNC_MSG_EVENT(incomingData);
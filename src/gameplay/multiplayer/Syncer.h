@@ -98,6 +98,8 @@ class Syncer {
   void registerTimeout();
   void clearTimeout();
   void resetSongState();
+  void synchronizeSongStart();
+  void onAudioChunk(u32 current);
 
   void setRemoteNumericLevel(int newIndex, int newLevel) {
     $remoteNumericLevelIndex = newIndex;
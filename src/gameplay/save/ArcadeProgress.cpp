@@ -68,7 +68,7 @@ void ARCADE_writeDouble(u8 songId, u8 levelIndex, GradeType grade) {
 void ARCADE_migrate() {
   const GBFS_FILE* fs = find_first_gbfs_file(0);
 
-  std::vector<std::unique_ptr<SongFile>> songFiles;
+  std::vector<SongFile> songFiles;
   auto library = std::unique_ptr<Library>{new Library(fs)};
   u32 librarySize = SAVEFILE_getLibrarySize();
   u32 pages =
@@ -77,7 +77,9 @@ void ARCADE_migrate() {
     library->loadSongs(songFiles, DifficultyLevel::CRAZY, i * PAGE_SIZE);
 
   for (u32 i = 0; i < songFiles.size(); i++) {
-    Song* song = SONG_parse(fs, songFiles[i].get());
+    Song* song = SONG_parse(fs, &songFiles[i]);
+    if (song == NULL)
+      continue;
 
     std::vector<GradeType> singleGrades;
     for (u32 i = 0; i < song->chartCount; i++)
@@ -16,6 +16,7 @@
 #include "Stats.h"
 #include "assets.h"
 #include "gameplay/debug/DebugTools.h"
+#include "gameplay/library/LibraryStore.h"
 #include "gameplay/models/Chart.h"
 #include "utils/MathUtils.h"
 #include "utils/parse.h"
@@ -314,8 +315,8 @@ inline u32 SAVEFILE_normalize(u32 librarySize) {
 inline u32 SAVEFILE_initialize(const GBFS_FILE* fs) {
   u32 romId = as_le((u8*)gbfs_get_obj(fs, ROM_ID_FILE, NULL));
   u32 librarySize = romId & LIBRARY_SIZE_MASK;
-  bool isNew =
-      (SAVEFILE_read32(SRAM->romId) & ROM_ID_MASK) != (romId & ROM_ID_MASK);
+  u32 previousRomId = SAVEFILE_read32(SRAM->romId);
+  bool isNew = (previousRomId & ROM_ID_MASK) != (romId & ROM_ID_MASK);
 
   // write rom id
   SAVEFILE_write32(SRAM->romId, romId);
@@ -366,16 +367,28 @@ inline u32 SAVEFILE_initialize(const GBFS_FILE* fs) {
         SRAM->deathMixProgress.completedSongs[DifficultyLevel::CRAZY], 0);
   }
 
+  // (an SD card library can extend the catalog, don't discard its progress)
+  if (!isNew)
+    librarySize = max(librarySize, previousRomId & LIBRARY_SIZE_MASK);
+
   return SAVEFILE_normalize(librarySize);
 }
 
+inline void SAVEFILE_useLibrary(u32 romId) {
+  if ((SAVEFILE_read32(SRAM->romId) & ROM_ID_MASK) != (romId & ROM_ID_MASK))
+    return;
+
+  SAVEFILE_write32(SRAM->romId, romId);
+  SAVEFILE_normalize(romId & LIBRARY_SIZE_MASK);
+}
+
 inline bool SAVEFILE_isWorking(const GBFS_FILE* fs) {
   u32 romId = as_le((u8*)gbfs_get_obj(fs, ROM_ID_FILE, NULL));
   return SAVEFILE_read32(SRAM->romId) == romId;
 }
 
 inline u32 SAVEFILE_bonusCount(const GBFS_FILE* fs) {
-  auto count = (u8*)gbfs_get_obj(fs, BONUS_COUNT_FILE, NULL);
+  auto count = (u8*)libraryStore->getFile(fs, BONUS_COUNT_FILE, NULL);
   return count != NULL ? as_le(count) : 0;
 }
 
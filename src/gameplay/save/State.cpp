@@ -1,6 +1,6 @@
 #include "State.h"
 
-#include "Savefile.h"
+#include "SaveFile.h"
 #include "gameplay/multiplayer/Syncer.h"
 
 DATA_EWRAM RAMState GameState;
@@ -148,10 +148,9 @@ void STATE_setup(Song* song, Chart* chart) {
   GameState.scorePositionY = 0;
 
   if (GameState.mods.reduce != ReduceOpts::rOFF) {
-    GameState.positionY = GameState.mods.reduce == ReduceOpts::rLINEAR ||
-                                  GameState.mods.reduce == ReduceOpts::rMICRO
-                              ? 0
-                              : REDUCE_MOD_POSITION_Y;
+    // (the other reduce mods move the playfield while playing)
+    if (GameState.mods.reduce == ReduceOpts::rFIXED)
+      GameState.positionY = REDUCE_MOD_POSITION_Y;
     if (GameState.mods.reduce != ReduceOpts::rMICRO)
       GameState.scorePositionY = REDUCE_MOD_SCORE_POSITION_Y;
   }
@@ -0,0 +1,105 @@
+#include "StorageBenchmark.h"
+
+#include <libgba-sprite-engine/gba/tonc_math.h>
+#include <libgba-sprite-engine/gba/tonc_memdef.h>
+#include <libgba-sprite-engine/gba/tonc_memmap.h>
+
+#include <new>
+
+#include "player/PlaybackState.h"
+#include "utils/gba-link-connection/LinkUniversal.hpp"
+
+extern "C" {
+#include "utils/flashcartio/flashcartio.h"
+}
+
+#define SEQUENTIAL_SECTORS 2048  // (1 MB)
+#define SEQUENTIAL_BATCH 32
+#define RANDOM_READS 256
+#define CYCLES_PER_SECOND 16777216
+#define CYCLES_PER_TICK 64  // (`TM_FREQ_64`: it wraps after 250ms)
+
+// Reads are timed one batch at a time with TM2 alone: TM0 measures interrupt
+// latency, TM1 drives the audio and TM3 is the link's send timer.
+inline void startTimer() {
+  REG_TM2CNT_H = 0;
+  REG_TM2CNT_L = 0;
+  REG_TM2CNT_H = TM_ENABLE | TM_FREQ_64;
+}
+
+inline u32 stopTimer() {
+  REG_TM2CNT_H = 0;
+  return REG_TM2CNT_L * CYCLES_PER_TICK;
+}
+
+inline u32 cyclesToUs(u32 cycles) {
+  return (u32)((u64)cycles * 1000000 / CYCLES_PER_SECOND);
+}
+
+StorageBenchmarkResult STORAGE_BENCHMARK_run() {
+  StorageBenchmarkResult result = {.success = false,
+                                   .sequentialKBps = 0,
+                                   .randomIOPS = 0,
+                                   .randomAvgUs = 0,
+                                   .randomMaxUs = 0};
+
+  auto fatfs = (FATFS*)PlaybackState.fatfs;
+  if (fatfs == NULL || active_flashcart == NO_FLASHCART)
+    return result;
+  // (it blocks for about a second, so the other player would time out)
+  if (linkUniversal->isActive())
+    return result;
+
+  u8* buffer =
+      new (std::nothrow) u8[SEQUENTIAL_BATCH * FLASHCARTIO_SECTOR_SIZE];
+  if (buffer == NULL)
+    return result;
+
+  u32 firstSector = fatfs->database;
+  u32 totalSectors = (fatfs->n_fatent - 2) * fatfs->csize;
+  if (totalSectors < SEQUENTIAL_SECTORS) {
+    delete[] buffer;
+    return result;
+  }
+
+  FlashcartStream stream;
+  bool success = true;
+  u16 timerControl = REG_TM2CNT_H;
+
+  // sequential
+  u32 sequentialCycles = 0;
+  flashcartio_stream_open(&stream, firstSector);
+  for (u32 i = 0; i < SEQUENTIAL_SECTORS / SEQUENTIAL_BATCH && success; i++) {
+    startTimer();
+    success = flashcartio_stream_read(&stream, buffer, SEQUENTIAL_BATCH);
+    sequentialCycles += stopTimer();
+  }
+
+  // random
+  u32 randomCycles = 0;
+  for (u32 i = 0; i < RANDOM_READS && success; i++) {
+    u32 offset = (u32)((u64)qran() * totalSectors / (QRAN_MAX + 1));
+    flashcartio_stream_open(&stream, firstSector + offset);
+    startTimer();
+    success = flashcartio_stream_read(&stream, buffer, 1);
+    u32 cycles = stopTimer();
+
+    randomCycles += cycles;
+    result.randomMaxUs = max(result.randomMaxUs, cyclesToUs(cycles));
+  }
+
+  delete[] buffer;
+  REG_TM2CNT_L = 0;
+  REG_TM2CNT_H = timerControl;
+  if (!success || sequentialCycles == 0 || randomCycles == 0)
+    return result;
+
+  result.success = true;
+  result.sequentialKBps =
+      (u32)((u64)SEQUENTIAL_SECTORS / 2 * CYCLES_PER_SECOND / sequentialCycles);
+  result.randomIOPS =
+      (u32)((u64)RANDOM_READS * CYCLES_PER_SECOND / randomCycles);
+  result.randomAvgUs = cyclesToUs(randomCycles / RANDOM_READS);
+
+  return result;
+}
@@ -0,0 +1,19 @@
+#ifndef STORAGE_BENCHMARK_H
+#define STORAGE_BENCHMARK_H
+
+#include <libgba-sprite-engine/gba/tonc_core.h>
+
+typedef struct {
+  bool success;
+  u32 sequentialKBps;  // (KB per second)
+  u32 randomIOPS;      // (single-sector reads per second)
+  u32 randomAvgUs;     // (average single-sector latency, in microseconds)
+  u32 randomMaxUs;     // (worst single-sector latency, in microseconds)
+} StorageBenchmarkResult;
+
+// Reads raw sectors from the data region of the mounted SD card.
+// (HQ mode must be active and the link inactive; it blocks for about a
+// second)
+StorageBenchmarkResult STORAGE_BENCHMARK_run();
+
+#endif  // STORAGE_BENCHMARK_H
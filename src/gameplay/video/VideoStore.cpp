@@ -1,5 +1,6 @@
 #include "VideoStore.h"
 
+#include <libgba-sprite-engine/gba/tonc_bios.h>
 #include <libgba-sprite-engine/gba/tonc_math.h>
 
 #include "gameplay/models/Song.h"
@@ -9,20 +10,31 @@
 #include "utils/MathUtils.h"
 
 extern "C" {
+#include "player/io_scheduler.h"
 #include "utils/flashcartio/flashcartio.h"
 }
 
-#define VIDEO_SECTOR 512
 #define CLMT_ENTRIES 1024
 #define SIZE_CLMT (CLMT_ENTRIES * sizeof(u32))
-#define SIZE_HALF_FRAME \
-  (VIDEO_SIZE_PALETTE + VIDEO_SIZE_MAP + VIDEO_SIZE_TILES / 2)
-#define REQUIRED_MEMORY (SIZE_CLMT + SIZE_HALF_FRAME)
+#define SIZE_KEYFRAMES (VIDEO_MAX_KEYFRAMES * 2 * sizeof(u32))
+#define SIZE_BUFFER (VIDEO_MAX_FRAME_SECTORS * VIDEO_SECTOR)
+#define REQUIRED_MEMORY (SIZE_CLMT + SIZE_KEYFRAMES + SIZE_BUFFER)
+#define MAX_LEAD_FRAMES 15
+#define BLOCK_SIZE_MASK 0xffffff
+#define BLOCK_COMPRESSED (1 << 24)
 
 const u32 FRACUMUL_MS_TO_FRAME_AT_30FPS = 128849018;  // (*30/1000)
 
+typedef struct {
+  u32 magic;
+  u32 frameCount;
+  u32 keyframeInterval;
+  u32 keyframeCount;
+} VideoHeader;
+
 DATA_EWRAM static FATFS fatfs;
 DATA_EWRAM static FIL file;
+DATA_EWRAM static COLOR backPalette[VIDEO_PALETTE_COLORS];
 
 HQModeOpts getMode() {
   return static_cast<HQModeOpts>(SAVEFILE_read8(SRAM->adminSettings.hqMode));
@@ -85,7 +97,11 @@ VideoStore::LoadResult VideoStore::load(std::string videoPath,
 
   isPlaying = true;
   frame = 0;
+  hasPosition = false;
+  io_scheduler_reset_stats();
   this->videoOffset = videoOffset;
+  keyframes = (u32*)(memory + SIZE_CLMT);
+  buffer = memory + SIZE_CLMT + SIZE_KEYFRAMES;
 
   file.cltbl = (DWORD*)memory;
   file.cltbl[0] = CLMT_ENTRIES;
@@ -94,6 +110,29 @@ VideoStore::LoadResult VideoStore::load(std::string videoPath,
     return LoadResult::ERROR;
   }
 
+  u32 readBytes;
+  if (f_read(&file, buffer, VIDEO_SECTOR, &readBytes) > 0) {
+    unload();
+    return LoadResult::ERROR;
+  }
+  auto header = (VideoHeader*)buffer;
+  if (readBytes < sizeof(VideoHeader) || header->magic != VIDEO_MAGIC ||
+      header->keyframeCount == 0 ||
+      header->keyframeCount > VIDEO_MAX_KEYFRAMES) {
+    unload();
+    return LoadResult::NO_FILE;  // (old or unknown format)
+  }
+  frameCount = header->frameCount;
+  keyframeInterval = header->keyframeInterval;
+  keyframeCount = header->keyframeCount;
+
+  u32 tableSize = keyframeCount * 2 * sizeof(u32);
+  tableSize = (tableSize + VIDEO_SECTOR - 1) / VIDEO_SECTOR * VIDEO_SECTOR;
+  if (f_read(&file, keyframes, tableSize, &readBytes) > 0) {
+    unload();
+    return LoadResult::ERROR;
+  }
+
   if (!seek(0))
     return LoadResult::ERROR;
 
@@ -106,55 +145,170 @@ void VideoStore::unload() {
 
   f_close(&file);
   isPlaying = false;
+  isFlipPending = false;
 }
 
 bool VideoStore::seek(u32 msecs) {
-  frame = MATH_fracumul(msecs, FRACUMUL_MS_TO_FRAME_AT_30FPS) -
-          SGN(videoOffset) *
-              MATH_fracumul(ABS(videoOffset), FRACUMUL_MS_TO_FRAME_AT_30FPS);
+  if (!isPlaying)
+    return true;  // (stopped, see `setFrameSectors`)
+
+  int target =
+      MATH_fracumul(msecs, FRACUMUL_MS_TO_FRAME_AT_30FPS) -
+      SGN(videoOffset) *
+          MATH_fracumul(ABS(videoOffset), FRACUMUL_MS_TO_FRAME_AT_30FPS);
   frameLatch = false;
-  cursor = frame > 0 ? frame * VIDEO_SIZE_FRAME / VIDEO_SECTOR : 0;
-  memoryCursor = 0;
 
-  if (f_lseek(&file, cursor * VIDEO_SECTOR) > 0) {
-    unload();
-    return false;
+  // (frames can only be decoded in order, so small drifts are absorbed by
+  // reading late or waiting, and anything else jumps to a keyframe)
+  if (hasPosition && readSectors == 0) {
+    int keyframe = target > 0 ? target - target % keyframeInterval : 0;
+    bool isOnTime = target == position || target == position - 1;
+    bool isLate = target > position && keyframe <= position;
+    bool isEarly = target < position && target >= position - MAX_LEAD_FRAMES;
+
+    if (isOnTime || isLate) {
+      frame = position;
+      return true;
+    }
+    if (isEarly) {
+      frame = target;
+      return true;
+    }
+  }
+
+  if (target >= (int)frameCount) {
+    hasPosition = true;
+    frame = position = target;
+    frameSectors = 0;
+    readSectors = 0;
+    return true;
   }
 
+  if (!jump(target > 0 ? target / keyframeInterval : 0))
+    return false;
+  frame = target < 0 ? target : position;
+
   return true;
 }
 
+bool VideoStore::requestRead() {
+  // (video is best-effort: if audio took the budget, the read waits a frame)
+  u32 preReadSectors = (frameSectors + 1) / 2;
+  return io_scheduler_request(IO_STREAM_VIDEO,
+                              isPreRead() ? preReadSectors
+                                          : frameSectors - readSectors);
+}
+
 CODE_IWRAM bool VideoStore::preRead() {
+  u32 sectors = (frameSectors + 1) / 2;
   u32 readBytes;
   bool success =
-      f_read(&file, memory + SIZE_CLMT, SIZE_HALF_FRAME, &readBytes) == 0;
-  cursor += SIZE_HALF_FRAME / VIDEO_SECTOR;
-  memoryCursor = 0;
+      f_read(&file, buffer, sectors * VIDEO_SECTOR, &readBytes) == 0;
+  readSectors = sectors;
   return success;
 }
 
-CODE_IWRAM bool VideoStore::endRead(u8* buffer, u32 sectors) {
-  u32 readFromMemory = 0;
+CODE_IWRAM bool VideoStore::endRead() {
+  u32 readBytes;
+  if (f_read(&file, buffer + readSectors * VIDEO_SECTOR,
+             (frameSectors - readSectors) * VIDEO_SECTOR, &readBytes) > 0)
+    return false;
+
+  u32 skipSectors = *((u16*)(buffer + 4));
+  if (skipSectors > 0 &&
+      f_lseek(&file, f_tell(&file) + skipSectors * VIDEO_SECTOR) > 0)
+    return false;
 
-  while (sectors > 0) {
-    u32 availableMemory = SIZE_HALF_FRAME - memoryCursor;
-    u32 pendingBytes = sectors * VIDEO_SECTOR;
+  bufferSize = frameSectors * VIDEO_SECTOR;
+  position++;
+  setFrameSectors(*((u16*)buffer));
+  readSectors = 0;
+  return true;
+}
 
-    if (availableMemory > 0) {
-      u32 readableBytes = min(availableMemory, pendingBytes);
-      dma3_cpy(buffer, memory + SIZE_CLMT + memoryCursor, readableBytes);
-      memoryCursor += readableBytes;
-      readFromMemory += readableBytes;
-      sectors -= readableBytes / VIDEO_SECTOR;
-    } else {
-      u32 readBytes;
-      if (f_read(&file, buffer + readFromMemory, pendingBytes, &readBytes) > 0)
+bool VideoStore::decode(u32 backgroundId,
+                        u32 charblock,
+                        u32 screenblock,
+                        u32 priority) {
+  if (isFlipPending)
+    return false;  // (the previous frame must be on screen first)
+
+  u8* end = buffer + bufferSize;
+  u8* cursor = buffer;
+  u32 runs = *((u16*)(cursor + 2));
+  cursor += VIDEO_HEADER_SIZE;
+
+  memcpy32(backPalette, cursor,
+           VIDEO_PALETTE_COLORS * sizeof(COLOR) / sizeof(u32));
+  cursor += VIDEO_SIZE_PALETTE;
+
+  u32 backMap = !frontMap;
+  void* target = se_mem[screenblock + backMap];
+  for (u32 i = 0; i <= runs; i++) {
+    if (i > 0) {
+      u32 firstSlot = *((u16*)cursor);
+      u32 count = *((u16*)(cursor + 2));
+      if (firstSlot + count > VIDEO_TILE_SLOTS)
         return false;
-      cursor += sectors;
-      sectors = 0;
+      target = (u8*)tile_mem[charblock] + firstSlot * VIDEO_TILE_SIZE;
+      cursor += 4;
     }
+
+    u32 block = *((u32*)cursor);
+    u32 size = block & BLOCK_SIZE_MASK;
+    cursor += 4;
+    if (cursor + size > end)
+      return false;
+
+    if (block & BLOCK_COMPRESSED)
+      LZ77UnCompVram(cursor, target);
+    else
+      memcpy32(target, cursor, size / sizeof(u32));
+    cursor += (size + 3) & ~3;
+  }
+
+  frontMap = backMap;
+  flipBackgroundId = backgroundId;
+  flipControl = BG_CBB(charblock) | BG_SBB(screenblock + backMap) | BG_8BPP |
+                BG_REG_32x32 | BG_MOSAIC | priority;
+  asm volatile("" ::: "memory");  // (the ISR can't see a partial flip)
+  isFlipPending = true;
+  return true;
+}
+
+CODE_IWRAM void VideoStore::onVBlank() {
+  if (!isFlipPending)
+    return;
+
+  dma3_cpy(pal_bg_mem, backPalette, VIDEO_PALETTE_COLORS * sizeof(COLOR));
+  REG_BGCNT[flipBackgroundId] = flipControl;
+  isFlipPending = false;
+}
+
+bool VideoStore::jump(u32 keyframe) {
+  hasPosition = true;
+  position = keyframe * keyframeInterval;
+  readSectors = 0;
+  if (!setFrameSectors(keyframes[keyframe * 2 + 1]))
+    return true;
+
+  if (f_lseek(&file, keyframes[keyframe * 2] * VIDEO_SECTOR) > 0) {
+    unload();
+    return false;
+  }
+
+  return true;
+}
+
+bool VideoStore::setFrameSectors(u32 sectors) {
+  if (sectors > VIDEO_MAX_FRAME_SECTORS) {
+    // (a corrupt size would overflow `buffer`, so the video stops here)
+    unload();
+    frameSectors = 0;
+    return false;
   }
 
+  frameSectors = sectors;
   return true;
 }
 
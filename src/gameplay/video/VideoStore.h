@@ -6,12 +6,23 @@
 #include <string>
 
 #define VIDEOS_FOLDER_NAME "/piuGBA_videos/"
+#define VIDEO_MAGIC 0x32444956  // ("VID2")
 #define VIDEO_SIZE_PALETTE 512
 #define VIDEO_SIZE_MAP 2048
-#define VIDEO_SIZE_TILES 38912
+#define VIDEO_PALETTE_COLORS 254  // (254 and 255 belong to the game)
+#define VIDEO_TILE_SIZE 64
+#define VIDEO_TILE_SLOTS 768  // (48KB, the two maps go right after)
+#define VIDEO_HEADER_SIZE 8
 #define VIDEO_SECTOR 512
-#define VIDEO_SIZE_FRAME \
-  (VIDEO_SIZE_PALETTE + VIDEO_SIZE_MAP + VIDEO_SIZE_TILES)
+#define VIDEO_MAX_FRAME_SECTORS 84
+#define VIDEO_MAX_KEYFRAMES 512
+
+// Frames only carry the tiles that changed, so they depend on the previous
+// one, except for keyframes (see the importer's `VideoSerializer`).
+// New tiles never overwrite the ones on screen, and the map and palette are
+// double buffered, so a frame can be decoded at any time and it's shown at
+// the next VBlank. Until then, `decode` returns false without touching the
+// buffers (the read frame stays there, so it can be decoded after VBlank).
 
 class VideoStore {
  public:
@@ -19,8 +30,9 @@ class VideoStore {
   enum LoadResult { OK, NO_FILE, ERROR };
 
   bool isActive() { return state == ACTIVE; }
-  bool canRead() { return frame >= 0; }
+  bool canRead() { return frame == position && frameSectors > 0; }
   bool isPreRead() { return !frameLatch; }
+  bool hasPendingFlip() { return isFlipPending; }
   void advance(bool newFrame = false) {
     frameLatch = !frameLatch;
     frame += newFrame;
@@ -34,19 +46,36 @@ class VideoStore {
   void unload();
 
   bool seek(u32 msecs);
+  bool requestRead();
   bool preRead();
-  bool endRead(u8* buffer, u32 sectors);
+  bool endRead();
+  bool decode(u32 backgroundId, u32 charblock, u32 screenblock, u32 priority);
+  void onVBlank();
 
  private:
   State state = OFF;
   u8* memory = NULL;
-  u32 cursor = 0;
-  u32 memoryCursor = 0;
+  u32* keyframes = NULL;
+  u8* buffer = NULL;
+  u32 frameCount = 0;
+  u32 keyframeInterval = 0;
+  u32 keyframeCount = 0;
   bool isPlaying = false;
   bool frameLatch = false;
+  bool hasPosition = false;
   int frame = 0;
+  int position = 0;      // (frame at the file cursor)
+  u32 frameSectors = 0;  // (its size, 0 = end of video)
+  u32 readSectors = 0;   // (how much of it is already in `buffer`)
+  u32 bufferSize = 0;    // (size of the frame in `buffer`)
   int videoOffset = 0;
+  u32 frontMap = 0;
+  u32 flipBackgroundId = 0;
+  u16 flipControl = 0;
+  volatile bool isFlipPending = false;
 
+  bool jump(u32 keyframe);
+  bool setFrameSectors(u32 sectors);
   State setState(State newState, void* fatfs = NULL);
 };
 
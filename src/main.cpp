@@ -2,8 +2,10 @@
 #include <tonc.h>
 
 #include "../libs/interrupt.h"
+#include "gameplay/Playfield.h"
 #include "gameplay/Sequence.h"
 #include "gameplay/debug/DebugTools.h"
+#include "gameplay/library/LibraryStore.h"
 #include "gameplay/multiplayer/PS2Keyboard.h"
 #include "gameplay/multiplayer/Syncer.h"
 #include "gameplay/video/VideoStore.h"
@@ -23,10 +25,10 @@ void validateBuild();
 void setUpInterrupts();
 void startRandomSeed();
 void stopRandomSeed();
-void synchronizeSongStart();
 static std::shared_ptr<GBAEngine> engine{new GBAEngine()};
 static bool isCalculatingRandomSeed = false;
 VideoStore* videoStore = new VideoStore();
+LibraryStore* libraryStore = new LibraryStore();
 PS2Keyboard* ps2Keyboard = new PS2Keyboard();
 LinkUniversal* linkUniversal =
     new LinkUniversal(LinkUniversal::Protocol::AUTODETECT,
@@ -48,8 +50,14 @@ static const GBFS_FILE* fs = find_first_gbfs_file(0);
 
 LINK_CODE_IWRAM void ISR_vblank() {
   player_onVBlank();
-  if (linkUniversal->isActive())
+  videoStore->onVBlank();
+  if (linkUniversal->isActive()) {
+    // (the link's VBlank handler can't be preempted by its own handlers)
+    u16 ime = REG_IME;
+    REG_IME = 0;
     LINK_UNIVERSAL_ISR_VBLANK();
+    REG_IME = ime;
+  }
 }
 
 int main() {
@@ -65,13 +73,16 @@ int main() {
   startRandomSeed();
 
   engine->setScene(SEQUENCE_getInitialScene());
+  SPRITE_TILES_commit();
   player_forever(
       []() {
         // (onUpdate)
         PS2_ISR_VBLANK();
 
         syncer->update();
+        PixelTransitionEffect::update();  // (preloads the incoming scene)
         engine->update();
+        SPRITE_TILES_commit();  // (after scenes are set)
 
         if (isCalculatingRandomSeed) {
           (void)qran();
@@ -80,7 +91,7 @@ int main() {
         }
 
         if (syncer->$isPlayingSong && !syncer->$hasStartedAudio)
-          synchronizeSongStart();
+          syncer->synchronizeSongStart();
 
         return syncer->$isPlayingSong && !syncer->isMaster()
                    ? (int)syncer->$currentAudioChunk
@@ -94,6 +105,8 @@ int main() {
 
         EFFECT_render();
         engine->render();
+        PLAYFIELD_render();  // (after the OAM copy)
+        TEXT_render();
 
         if (syncer->pendingAudio != "") {
           player_play(syncer->pendingAudio.c_str(),
@@ -108,17 +121,13 @@ int main() {
       },
       [](u32 current) {
         // (onAudioChunk)
-        if (syncer->$isPlayingSong) {
-          if (syncer->isMaster()) {
-            syncer->$currentAudioChunk = current;
-            syncer->directSend(SYNC_AUDIO_CHUNK_HEADER |
-                               ((u16)current + AUDIO_SYNC_LIMIT));
-          }
+        syncer->onAudioChunk(current);
 #ifdef SENV_DEBUG
+        if (syncer->$isPlayingSong) {
           LOGN(current, -1);
           LOGN(syncer->$currentAudioChunk, 0);
-#endif
         }
+#endif
       },
       []() { SCENE_softReset(); });
 
@@ -158,6 +167,12 @@ void setUpInterrupts() {
   // A+B+START+SELECT
   REG_KEYCNT = 0b1100000000001111;
   interrupt_add(INTR_KEYPAD, ISR_reset);
+
+  // Priorities (link transfers can preempt VBlank)
+  interrupt_set_priority(INTR_SERIAL, 0);
+  interrupt_set_priority(INTR_TIMER3, 1);
+  interrupt_set_priority(INTR_VBLANK, 2);
+  interrupt_set_priority(INTR_KEYPAD, 3);
 }
 
 inline void startRandomSeed() {
@@ -176,33 +191,3 @@ inline void stopRandomSeed() {
   SAVEFILE_write32(SRAM->randomSeed, __qran_seed);
   Link::randomSeed = __qran_seed;
 }
-
-void synchronizeSongStart() {
-  // discard all previous messages and wait for sync
-  u8 remoteId = syncer->getRemotePlayerId();
-
-  while (linkUniversal->read(remoteId) != LINK_CABLE_NO_DATA)
-    ;
-
-  u16 start = SYNC_START_SONG | syncer->$currentSongChecksum;
-  bool isOnSync = false;
-  while (syncer->$isPlayingSong && !isOnSync) {
-    syncer->directSend(start);
-    VBlankIntrWait();
-    linkUniversal->sync();
-    isOnSync = linkUniversal->read(remoteId) == start;
-    if (!isOnSync)
-      syncer->registerTimeout();
-  }
-  if (!isOnSync)
-    return;
-
-  while (linkUniversal->read(remoteId) != LINK_CABLE_NO_DATA)
-    ;
-
-  if (!syncer->isMaster())
-    syncer->$currentAudioChunk = AUDIO_SYNC_LIMIT;
-
-  syncer->$hasStartedAudio = true;
-  syncer->clearTimeout();
-}
@@ -25,9 +25,6 @@ Arrow::Arrow(u32 id) {
           .buildPtr();
   sprite->enabled = false;
 
-  if (id != ARROW_TILEMAP_LOADING_ID)
-    SPRITE_reuseTiles(sprite.get());
-
   this->id = id;
 }
 
@@ -6,9 +6,7 @@
 #include "data/content/_compiled_sprites/spr_arrows_mdrn.h"
 #include "utils/SpriteUtils.h"
 
-ArrowHolder::ArrowHolder(ArrowDirection direction,
-                         u8 playerId,
-                         bool reuseTiles) {
+ArrowHolder::ArrowHolder(ArrowDirection direction, u8 playerId) {
   u32 startTile = 0;
   u32 endTile = 0;
   ARROW_initialize(direction, startTile, endTile, this->flip);
@@ -30,9 +28,6 @@ ArrowHolder::ArrowHolder(ArrowDirection direction,
               ARROW_FINAL_Y())
           .buildPtr();
 
-  if (reuseTiles)
-    SPRITE_reuseTiles(sprite.get());
-
   SPRITE_goToFrame(sprite.get(), endTile);
   ARROW_setUpOrientation(sprite.get(), flip);
 }
@@ -41,15 +36,11 @@ void ArrowHolder::blink() {
   isBlinking = true;
 }
 
-void ArrowHolder::tick(int offsetX) {
+void ArrowHolder::tick() {
   u32 currentFrame = sprite->getCurrentFrame();
   u32 idleFrame = endTile;
   u32 pressedFrame = endTile + ARROW_HOLDER_PRESSED_OFFSET;
 
-  sprite->moveTo(
-      ARROW_CORNER_MARGIN_X(playerId) + ARROW_MARGIN * direction + offsetX,
-      ARROW_FINAL_Y());
-
   if ((isPressed || isBlinking) && currentFrame < pressedFrame) {
     SPRITE_goToFrame(sprite.get(), currentFrame + 1);
 
@@ -13,11 +13,11 @@ class ArrowHolder : public InputHandler {
   ArrowDirection direction;
   u8 playerId;
 
-  ArrowHolder(ArrowDirection direction, u8 playerId, bool reuseTiles);
+  ArrowHolder(ArrowDirection direction, u8 playerId);
 
   void blink();
 
-  void tick(int offsetX = 0);
+  void tick();
   inline Sprite* get() { return sprite.get(); }
 
  private:
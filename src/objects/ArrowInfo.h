@@ -7,7 +7,11 @@
 #include "gameplay/debug/DebugTools.h"
 #include "gameplay/save/SaveFile.h"
 
+#ifdef __arm__
 #define CODE_IWRAM __attribute__((section(".iwram"), target("arm"), noinline))
+#else
+#define CODE_IWRAM  // (host builds, see `tests/host`)
+#endif
 
 #define ARROWS_GAME_TOTAL (isDouble() ? 10 : 5)
 
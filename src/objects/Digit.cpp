@@ -13,7 +13,7 @@
 const u32 DIGIT_WIDTHS[] = {26, 19, 13};
 const u32 TOTAL_NUMBERS = 10;
 
-Digit::Digit(DigitSize size, u32 x, u32 y, u32 index, bool reuseTiles) {
+Digit::Digit(DigitSize size, u32 x, u32 y, u32 index) {
   this->modern = SAVEFILE_isUsingModernTheme();
   this->size = size;
   this->currentIndex = index;
@@ -35,9 +35,6 @@ Digit::Digit(DigitSize size, u32 x, u32 y, u32 index, bool reuseTiles) {
           .withSize(SIZE_32_16)
           .withLocation(HIDDEN_WIDTH, HIDDEN_HEIGHT)
           .buildPtr();
-
-  if (reuseTiles || index > 0)
-    SPRITE_reuseTiles(sprite.get());
 }
 
 void Digit::set(u32 value, bool isRed) {
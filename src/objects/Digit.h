@@ -9,7 +9,7 @@ enum DigitSize { BIG, MINI, MINI_NARROW };
 
 class Digit : public AnimatedIndicator {
  public:
-  Digit(DigitSize size, u32 x, u32 y, u32 index, bool reuseTiles);
+  Digit(DigitSize size, u32 x, u32 y, u32 index);
 
   void set(u32 value, bool isRed);
   void relocate(u32 x, u32 y, u32 spacing = 26);
@@ -61,9 +61,6 @@ LifeBar::LifeBar(u8 playerId) {
                              GameState.positionY + LIFEBAR_POSITION_Y)
                .buildPtr();
 
-  if (playerId > 0)
-    SPRITE_reuseTiles(sprite.get());
-
   this->playerId = playerId;
   sprite->flipVertically(playerId > 0);
   isModern = SAVEFILE_isUsingModernTheme();
@@ -85,13 +82,6 @@ void LifeBar::die() {
   isDead = true;
 }
 
-void LifeBar::relocate() {
-  sprite->moveTo(
-      (isDouble() ? GAME_POSITION_X[1] : GameState.positionX[playerId]) +
-          LIFEBAR_POSITION_X,
-      sprite->getY());
-}
-
 void LifeBar::tick(ForegroundPaletteManager* foregroundPalette) {
   paint(foregroundPalette);
 
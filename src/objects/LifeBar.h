@@ -20,7 +20,6 @@ class LifeBar {
   void setLife(int life);
   void blink();
   void die();
-  void relocate();
 
   inline bool getIsDead() { return isDead; }
 
@@ -72,11 +72,6 @@ std::unique_ptr<Evaluation> Score::evaluate() {
   return evaluation;
 }
 
-void Score::relocate() {
-  feedback->relocate();
-  combo->relocate();
-}
-
 void Score::tick() {
   feedback->tick();
   combo->tick();
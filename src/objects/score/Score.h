@@ -44,7 +44,6 @@ class Score {
 
   bool update(FeedbackType feedbackType, bool isLong);
   std::unique_ptr<Evaluation> evaluate();
-  void relocate();
 
   void tick();
 
@@ -12,7 +12,7 @@ const u32 NUMBER_WIDTH_4_DIGITS = 13;
 const int OFFSET_3_DIGITS = -NUMBER_WIDTH_3_DIGITS;
 const int OFFSET_4_DIGITS = -1;
 
-Total::Total(u32 x, u32 y, bool has4Digits, bool isFirst) {
+Total::Total(u32 x, u32 y, bool has4Digits) {
   u32 numberWidth4Digits = NUMBER_WIDTH_4_DIGITS;
   u32 offset4Digits = OFFSET_4_DIGITS;
   if (!SAVEFILE_isUsingModernTheme()) {
@@ -22,7 +22,7 @@ Total::Total(u32 x, u32 y, bool has4Digits, bool isFirst) {
 
   for (u32 i = 0; i < DIGITS; i++) {
     auto digit = std::unique_ptr<Digit>{new Digit(
-        has4Digits ? DigitSize::MINI_NARROW : DigitSize::MINI, x, y, i, false)};
+        has4Digits ? DigitSize::MINI_NARROW : DigitSize::MINI, x, y, i)};
 
     digit->relocate(x + (i > 0 && !has4Digits ? OFFSET_3_DIGITS : 0) +
                         (has4Digits ? offset4Digits : 0),
@@ -31,9 +31,6 @@ Total::Total(u32 x, u32 y, bool has4Digits, bool isFirst) {
     if (i > 0 || has4Digits)
       digit->showAt(0);
 
-    if (i == 0 && !isFirst)
-      SPRITE_reuseTiles(digit->get());
-
     digits.push_back(std::move(digit));
   }
 }
@@ -26,7 +26,7 @@ Combo::Combo(u8 playerId) {
         DigitSize::BIG,
         (isDouble() ? GAME_POSITION_X[1] : GameState.positionX[playerId]) +
             DIGITS_POSITION_X + offsetX + (i > 0 ? OFFSET_3_DIGITS : 0),
-        GameState.scorePositionY + DIGITS_POSITION_Y, i, playerId > 0)};
+        GameState.scorePositionY + DIGITS_POSITION_Y, i)};
     digits.push_back(std::move(digit));
   }
 }
@@ -27,9 +27,6 @@ ComboTitle::ComboTitle(u8 playerId) {
           .withSize(SIZE_64_32)
           .withLocation(HIDDEN_WIDTH, HIDDEN_HEIGHT)
           .buildPtr();
-
-  if (playerId > 0)
-    SPRITE_reuseTiles(sprite.get());
 }
 
 void ComboTitle::relocate() {
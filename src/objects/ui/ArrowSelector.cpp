@@ -15,7 +15,6 @@ const u32 AUTOFIRE_DELAY[] = {25, 15, 10, 5};
 const u32 AUTOFIRE_SPEEDS = 4;
 
 ArrowSelector::ArrowSelector(ArrowDirection direction,
-                             bool reuseTiles,
                              bool reactive,
                              bool canUseGBAStyle,
                              bool isVertical) {
@@ -49,9 +48,6 @@ ArrowSelector::ArrowSelector(ArrowDirection direction,
           .withLocation(0, 0)
           .buildPtr();
 
-  if (reuseTiles)
-    SPRITE_reuseTiles(sprite.get());
-
   ARROW_setUpOrientation(sprite.get(), flip);
 }
 
@@ -12,7 +12,6 @@ class ArrowSelector : public InputHandler {
   ArrowDirection direction;
 
   ArrowSelector(ArrowDirection direction,
-                bool reuseTiles,
                 bool reactive,
                 bool canUseGBAStyle = true,
                 bool isVertical = false);
@@ -25,7 +25,6 @@ ArrowTutorial::ArrowTutorial(ArrowDirection direction) {
           .withLocation(0, 0)
           .buildPtr();
 
-  SPRITE_reuseTiles(sprite.get());
   sprite->flipHorizontally(flip == ArrowFlip::FLIP_X ||
                            flip == ArrowFlip::FLIP_BOTH);
   sprite->flipVertically(flip == ArrowFlip::FLIP_Y ||
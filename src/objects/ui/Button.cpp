@@ -9,7 +9,7 @@
 
 const u32 SELECTED_START = 3;
 
-Button::Button(ButtonType type, u32 x, u32 y, bool reuseTiles) {
+Button::Button(ButtonType type, u32 x, u32 y) {
   SpriteBuilder<Sprite> builder;
   sprite = builder
                .withData(
@@ -29,9 +29,6 @@ Button::Button(ButtonType type, u32 x, u32 y, bool reuseTiles) {
   this->x = x;
   this->y = y;
 
-  if (reuseTiles)
-    SPRITE_reuseTiles(sprite.get());
-
   if (type != ButtonType::LEVEL_METER && type != ButtonType::SUB_BUTTON_GRAY &&
       type != ButtonType::SUB_BUTTON_ORANGE)
     SPRITE_goToFrame(sprite.get(), type);
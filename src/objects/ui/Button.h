@@ -15,7 +15,7 @@ enum ButtonType {
 
 class Button {
  public:
-  Button(ButtonType, u32 x, u32 y, bool reuseTiles);
+  Button(ButtonType, u32 x, u32 y);
 
   void setSelected(bool isSelected);
   void show();
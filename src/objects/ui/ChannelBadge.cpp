@@ -7,7 +7,7 @@
 
 #define ANIMATION_TIME 6
 
-ChannelBadge::ChannelBadge(u32 x, u32 y, bool reuseTiles) {
+ChannelBadge::ChannelBadge(u32 x, u32 y) {
   SpriteBuilder<Sprite> builder;
   sprite = builder.withData(spr_channelsTiles, sizeof(spr_channelsTiles))
                .withSize(SIZE_16_16)
@@ -18,9 +18,6 @@ ChannelBadge::ChannelBadge(u32 x, u32 y, bool reuseTiles) {
   this->y = y;
 
   SPRITE_goToFrame(sprite.get(), 0);
-
-  if (reuseTiles)
-    SPRITE_reuseTiles(sprite.get());
 }
 
 void ChannelBadge::tick() {
@@ -7,7 +7,7 @@
 
 class ChannelBadge {
  public:
-  ChannelBadge(u32 x, u32 y, bool reuseTiles);
+  ChannelBadge(u32 x, u32 y);
 
   void tick();
   void setType(Channel type);
@@ -14,17 +14,19 @@ const u32 OFFSET_X_HARD = 14;
 const u32 OFFSET_X_CRAZY = 10;
 
 Difficulty::Difficulty(u32 x, u32 y) {
-  SpriteBuilder<Sprite> builder1;
-  SpriteBuilder<Sprite> builder2;
+  SpriteBuilder<Sprite> builder;
 
   leftSprite =
-      builder1.withData(spr_difficultiesTiles, sizeof(spr_difficultiesTiles))
+      builder.withData(spr_difficultiesTiles, sizeof(spr_difficultiesTiles))
           .withSize(SIZE_64_32)
           .withLocation(x, y)
           .buildPtr();
 
-  rightSprite = builder2.withSize(SIZE_64_32).withLocation(x, y).buildPtr();
-  SPRITE_reuseTiles(rightSprite.get());
+  rightSprite =
+      builder.withData(spr_difficultiesTiles, sizeof(spr_difficultiesTiles))
+          .withSize(SIZE_64_32)
+          .withLocation(x, y)
+          .buildPtr();
   SPRITE_goToFrame(rightSprite.get(), FRAME_MAL);
 
   this->x = x;
@@ -19,7 +19,7 @@ const u8 ANIMATION_FRAMES[] = {
     EXPLOSION_ANIMATION_START + 2, EXPLOSION_ANIMATION_START + 1,
     EXPLOSION_ANIMATION_START + 1, EXPLOSION_ANIMATION_START + 1};
 
-Explosion::Explosion(u32 x, u32 y, bool reuseTiles) {
+Explosion::Explosion(u32 x, u32 y) {
   SpriteBuilder<Sprite> builder;
   sprite =
       builder
@@ -35,9 +35,6 @@ Explosion::Explosion(u32 x, u32 y, bool reuseTiles) {
   this->x = x;
   this->y = y;
   this->animationFrame = 0;
-
-  if (reuseTiles)
-    SPRITE_reuseTiles(sprite.get());
 }
 
 bool Explosion::isVisible() {
@@ -5,7 +5,7 @@
 
 class Explosion {
  public:
-  Explosion(u32 x, u32 y, bool reuseTiles);
+  Explosion(u32 x, u32 y);
 
   bool isVisible();
   void setVisible(bool isVisible);
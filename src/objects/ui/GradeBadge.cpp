@@ -9,7 +9,7 @@
 #define TILES_SELECTION spr_grades_miniTiles
 #define TILES_EVALUATION spr_grades_mini_evaluationTiles
 
-GradeBadge::GradeBadge(u32 x, u32 y, bool reuseTiles, bool isEvaluation) {
+GradeBadge::GradeBadge(u32 x, u32 y, bool isEvaluation) {
   SpriteBuilder<Sprite> builder;
   sprite = builder
                .withData(isEvaluation ? TILES_EVALUATION : TILES_SELECTION,
@@ -22,9 +22,6 @@ GradeBadge::GradeBadge(u32 x, u32 y, bool reuseTiles, bool isEvaluation) {
   this->y = y;
 
   SPRITE_goToFrame(sprite.get(), 0);
-
-  if (reuseTiles)
-    SPRITE_reuseTiles(sprite.get());
 }
 
 void GradeBadge::setType(GradeType type) {
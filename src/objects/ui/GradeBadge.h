@@ -7,7 +7,7 @@
 
 class GradeBadge {
  public:
-  GradeBadge(u32 x, u32 y, bool reuseTiles, bool isEvaluation);
+  GradeBadge(u32 x, u32 y, bool isEvaluation);
 
   inline GradeType getType() { return type; }
   void setType(GradeType type);
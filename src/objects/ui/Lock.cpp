@@ -5,7 +5,7 @@
 #include "data/content/_compiled_sprites/spr_lock.h"
 #include "utils/SpriteUtils.h"
 
-Lock::Lock(u32 x, u32 y, bool reuseTiles) {
+Lock::Lock(u32 x, u32 y) {
   SpriteBuilder<Sprite> builder;
   sprite = builder.withData(spr_lockTiles, sizeof(spr_lockTiles))
                .withSize(SIZE_16_16)
@@ -14,9 +14,6 @@ Lock::Lock(u32 x, u32 y, bool reuseTiles) {
 
   this->x = x;
   this->y = y;
-
-  if (reuseTiles)
-    SPRITE_reuseTiles(sprite.get());
 }
 
 bool Lock::isVisible() {
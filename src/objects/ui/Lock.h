@@ -5,7 +5,7 @@
 
 class Lock {
  public:
-  Lock(u32 x, u32 y, bool reuseTiles);
+  Lock(u32 x, u32 y);
 
   bool isVisible();
   void setVisible(bool isVisible);
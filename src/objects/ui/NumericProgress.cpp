@@ -10,16 +10,14 @@ const u32 DIGITS_TOTAL_POSITION_X = 58;
 
 NumericProgress::NumericProgress(u32 x, u32 y) {
   for (u32 i = 0; i < DIGITS; i++) {
-    auto digit =
-        std::unique_ptr<Digit>{new Digit(DigitSize::BIG, x, y, i, false)};
+    auto digit = std::unique_ptr<Digit>{new Digit(DigitSize::BIG, x, y, i)};
     digit->showAt(0);
     completedDigits.push_back(std::move(digit));
   }
 
   for (u32 i = 0; i < DIGITS; i++) {
     auto digit = std::unique_ptr<Digit>{
-        new Digit(DigitSize::BIG, x + DIGITS_TOTAL_POSITION_X, y, i, false)};
-    SPRITE_reuseTiles(digit->get());
+        new Digit(DigitSize::BIG, x + DIGITS_TOTAL_POSITION_X, y, i)};
     digit->showAt(0);
     totalDigits.push_back(std::move(digit));
   }
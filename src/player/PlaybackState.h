@@ -3,9 +3,11 @@
 
 typedef struct {
   unsigned int msecs;
+  unsigned int msecsFraction;  // (Q0.16, see `song_clock.h`)
   bool hasFinished;
   bool isLooping;
   bool isPCMDisabled;
+  bool isPCM;  // (the current file plays from the flash cart)
   void* fatfs;
 } Playback;
 
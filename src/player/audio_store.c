@@ -2,16 +2,29 @@
 
 #include <string.h>
 #include "PlaybackState.h"
+#include "io_scheduler.h"
 #include "utils/flashcartio/flashcartio.h"
 
 #define DATA_EWRAM __attribute__((section(".ewram")))
 #define CLMT_ENTRIES 256
 #define AUDIO_SIZE_FRAME 608
+#define RING_SECTORS 8
+#define REFILL_SECTORS 2
+#define RING_SIZE (RING_SECTORS * IO_SECTOR_SIZE)
+#define REFILL_SIZE (REFILL_SECTORS * IO_SECTOR_SIZE)
 
 DATA_EWRAM static unsigned int clmt[CLMT_ENTRIES];
 DATA_EWRAM static FIL file;
 DATA_EWRAM static bool hasLoaded = false;
 
+// Reads are done in whole, sector-aligned chunks into a ring buffer, so
+// FatFs can transfer straight to it and the card sees a steady pattern.
+DATA_EWRAM static unsigned char ring[RING_SIZE] __attribute__((aligned(4)));
+DATA_EWRAM static unsigned int ringHead = 0;
+DATA_EWRAM static unsigned int ringTail = 0;
+DATA_EWRAM static unsigned int ringCount = 0;
+DATA_EWRAM static bool isEOF = false;
+
 void unload() {
   if (!hasLoaded)
     return;
@@ -20,6 +33,38 @@ void unload() {
   hasLoaded = false;
 }
 
+static void clearRing() {
+  ringHead = 0;
+  ringTail = 0;
+  ringCount = 0;
+  isEOF = false;
+}
+
+static bool refill() {
+  if (isEOF || RING_SIZE - ringCount < REFILL_SIZE)
+    return true;
+
+  io_scheduler_request(IO_STREAM_AUDIO, REFILL_SECTORS);
+  unsigned int readBytes;
+  if (f_read(&file, ring + ringHead, REFILL_SIZE, &readBytes) > 0)
+    return false;
+
+  // (after a short read there are no more refills, so alignment is irrelevant)
+  isEOF = readBytes < REFILL_SIZE;
+  ringHead = (ringHead + readBytes) % RING_SIZE;
+  ringCount += readBytes;
+  return true;
+}
+
+static bool fillRing() {
+  while (!isEOF && RING_SIZE - ringCount >= REFILL_SIZE) {
+    if (!refill())
+      return false;
+  }
+
+  return true;
+}
+
 bool audio_store_load(char* audioPath) {
   if (PlaybackState.fatfs == NULL)
     return false;
@@ -42,6 +87,12 @@ bool audio_store_load(char* audioPath) {
     return false;
   }
 
+  clearRing();
+  if (!fillRing()) {
+    unload();
+    return false;
+  }
+
   return true;
 }
 
@@ -49,15 +100,53 @@ bool audio_store_read(void* buffer, int size) {
   if (!hasLoaded)
     return false;
 
-  unsigned int readBytes;
-  return f_read(&file, buffer, size, &readBytes) == 0;
+  // (one refill per call keeps the ring topped up in the steady state)
+  if (!refill())
+    return false;
+  if (ringCount < (unsigned int)size && !isEOF) {
+    io_stats[IO_STREAM_AUDIO].underruns++;
+    while (ringCount < (unsigned int)size && !isEOF) {
+      if (!refill())
+        return false;
+    }
+  }
+
+  unsigned char* target = (unsigned char*)buffer;
+  unsigned int pending = (unsigned int)size < ringCount ? size : ringCount;
+  unsigned int missing = size - pending;
+  while (pending > 0) {
+    unsigned int chunk = RING_SIZE - ringTail;
+    if (chunk > pending)
+      chunk = pending;
+
+    memcpy(target, ring + ringTail, chunk);
+    target += chunk;
+    ringTail = (ringTail + chunk) % RING_SIZE;
+    ringCount -= chunk;
+    pending -= chunk;
+  }
+  if (missing > 0)
+    memset(target, 0, missing);
+
+  return true;
 }
 
 bool audio_store_seek(unsigned int offset) {
   if (!hasLoaded)
     return false;
 
-  return f_lseek(&file, offset) == 0;
+  unsigned int skip = offset % IO_SECTOR_SIZE;
+  if (f_lseek(&file, offset - skip) > 0)
+    return false;
+
+  clearRing();
+  if (!fillRing())
+    return false;
+
+  skip = skip < ringCount ? skip : ringCount;
+  ringTail = skip;
+  ringCount -= skip;
+  return true;
 }
 
 unsigned int audio_store_len() {
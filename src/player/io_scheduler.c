@@ -0,0 +1,59 @@
+#include "io_scheduler.h"
+
+#include <string.h>
+
+#include "utils/flashcartio/flashcartio.h"
+
+// All flash cart reads go through FatFs, which calls `disk_read`, which calls
+// `io_scheduler_account`. Streams ask for a slice of the frame budget before
+// reading: audio always gets it (it's read first in the frame, and skipping
+// it is audible), other streams only if it's still available.
+
+IOStats io_stats[IO_STREAMS];
+
+static int budget = IO_FRAME_BUDGET_SECTORS;
+static IOStream current_stream = IO_STREAM_OTHER;
+static bool did_overrun = false;
+static unsigned int frame = 0;
+static void (*trace_callback)(const IOTraceEntry* entry) = NULL;
+
+void io_scheduler_begin_frame(void) {
+  budget = IO_FRAME_BUDGET_SECTORS;
+  current_stream = IO_STREAM_OTHER;
+  did_overrun = false;
+  frame++;
+}
+
+bool io_scheduler_request(IOStream stream, unsigned int sectors) {
+  if (stream != IO_STREAM_AUDIO && (int)sectors > budget) {
+    io_stats[stream].stalls++;
+    return false;
+  }
+
+  current_stream = stream;
+  return true;
+}
+
+void io_scheduler_account(unsigned int sectors) {
+  io_stats[current_stream].sectors += sectors;
+  budget -= sectors;
+
+  if (budget < 0 && !did_overrun) {
+    io_stats[current_stream].overruns++;
+    did_overrun = true;
+  }
+}
+
+void io_scheduler_reset_stats(void) {
+  memset(io_stats, 0, sizeof(io_stats));
+}
+
+static void trace(unsigned int sector, unsigned short count) {
+  IOTraceEntry entry = {frame, current_stream, sector, count};
+  trace_callback(&entry);
+}
+
+void io_scheduler_set_trace(void (*onRead)(const IOTraceEntry* entry)) {
+  trace_callback = onRead;
+  flashcartio_trace_callback = onRead != NULL ? trace : NULL;
+}
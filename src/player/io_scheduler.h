@@ -0,0 +1,39 @@
+#ifndef IO_SCHEDULER_H
+#define IO_SCHEDULER_H
+
+#include <stdbool.h>
+
+// Sectors that can be read from the SD card in a frame without blowing it.
+// (a video half frame is 43 sectors, PCM audio needs ~1.2 sectors per frame)
+#define IO_FRAME_BUDGET_SECTORS 48
+#define IO_SECTOR_SIZE 512
+
+typedef enum { IO_STREAM_OTHER, IO_STREAM_AUDIO, IO_STREAM_VIDEO } IOStream;
+#define IO_STREAMS 3
+
+typedef struct {
+  unsigned int sectors;    // (total sectors read)
+  unsigned int stalls;     // (batches deferred because the budget was spent)
+  unsigned int underruns;  // (reads that found their prefetch buffer empty)
+  unsigned int overruns;   // (frames that went over the budget)
+} IOStats;
+
+typedef struct {
+  unsigned int frame;  // (counted by `io_scheduler_begin_frame()`)
+  IOStream stream;
+  unsigned int sector;
+  unsigned int count;
+} IOTraceEntry;
+
+extern IOStats io_stats[IO_STREAMS];
+
+void io_scheduler_begin_frame(void);
+bool io_scheduler_request(IOStream stream, unsigned int sectors);
+void io_scheduler_account(unsigned int sectors);
+void io_scheduler_reset_stats(void);
+
+// Calls `onRead` on every sector request sent to the flash cart, including
+// the ones that bypass FatFs (streams). Pass NULL to stop tracing.
+void io_scheduler_set_trace(void (*onRead)(const IOTraceEntry* entry));
+
+#endif  // IO_SCHEDULER_H
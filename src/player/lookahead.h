@@ -0,0 +1,75 @@
+#ifndef LOOKAHEAD_H
+#define LOOKAHEAD_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>  // for memset
+
+#include "core/gsm.h"
+#include "core/private.h" /* for sizeof(struct gsm_state) */
+
+// GSM chunks are decoded ahead into a queue when a frame finishes early, so
+// busy frames play already decoded samples instead of running the codec.
+// The player decides when there's time to decode ahead.
+// (shared by `player.iwram.c` and the host tests)
+
+#define LOOKAHEAD_SLOTS 8  // (one is playing, the rest are ahead)
+#define LOOKAHEAD_CHUNK_SAMPLES 160
+#define LOOKAHEAD_INLINE static inline __attribute__((always_inline))
+
+typedef struct {
+  struct gsm_state* decoder;
+  signed short (*slots)[LOOKAHEAD_CHUNK_SAMPLES];
+  const unsigned char* src;
+  uint32_t src_len;
+  uint32_t played_slot;
+  uint32_t ahead_count;  // (decoded slots after `played_slot`)
+  uint32_t ahead_pos;    // (source position of the next slot to decode)
+} Lookahead;
+
+// Starts over at `src_pos` (when the source position jumps). The decoder
+// starts over too, or the audio would depend on how far ahead it was.
+LOOKAHEAD_INLINE void lookahead_flush(Lookahead* lookahead, uint32_t src_pos) {
+  memset((char*)lookahead->decoder, 0, sizeof(*lookahead->decoder));
+  lookahead->decoder->nrp = 40;
+  lookahead->ahead_count = 0;
+  lookahead->ahead_pos = src_pos;
+}
+
+LOOKAHEAD_INLINE void lookahead_start(Lookahead* lookahead,
+                                      const unsigned char* src,
+                                      uint32_t src_len) {
+  lookahead->src = src;
+  lookahead->src_len = src_len;
+  lookahead_flush(lookahead, 0);
+}
+
+LOOKAHEAD_INLINE bool lookahead_can_decode(Lookahead* lookahead) {
+  return lookahead->ahead_count < LOOKAHEAD_SLOTS - 1 &&
+         lookahead->ahead_pos < lookahead->src_len;
+}
+
+LOOKAHEAD_INLINE void lookahead_decode(Lookahead* lookahead) {
+  uint32_t slot =
+      (lookahead->played_slot + 1 + lookahead->ahead_count) % LOOKAHEAD_SLOTS;
+  gsm_decode(lookahead->decoder, lookahead->src + lookahead->ahead_pos,
+             lookahead->slots[slot]);
+  lookahead->ahead_pos += sizeof(gsm_frame);
+  lookahead->ahead_count++;
+}
+
+// Returns the samples of the chunk at `src_pos`, decoding it now if the
+// queue ran dry. (past the end, the last chunk is repeated)
+LOOKAHEAD_INLINE signed short* lookahead_next(Lookahead* lookahead,
+                                              uint32_t src_pos) {
+  if (lookahead->ahead_count == 0 && src_pos < lookahead->src_len)
+    lookahead_decode(lookahead);
+
+  if (lookahead->ahead_count > 0) {
+    lookahead->played_slot = (lookahead->played_slot + 1) % LOOKAHEAD_SLOTS;
+    lookahead->ahead_count--;
+  }
+  return lookahead->slots[lookahead->played_slot];
+}
+
+#endif  // LOOKAHEAD_H
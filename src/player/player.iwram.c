@@ -6,16 +6,19 @@
 #include <gba_sound.h>
 #include <gba_systemcalls.h>
 #include <gba_timers.h>
+#include <gba_video.h>
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>  // for memset
 
 #include "PlaybackState.h"
-#include "core/gsm.h"
-#include "core/private.h" /* for sizeof(struct gsm_state) */
 #include "utils/gbfs/gbfs.h"
 
 #include "audio_store.h"
+#include "io_scheduler.h"
+#include "lookahead.h"
+#include "resampler.h"
+#include "song_clock.h"
 #include "utils/flashcartio/flashcartio.h"
 
 #define TIMER_16MHZ 0
@@ -28,8 +31,6 @@
 #define AUDIO_CHUNK_SIZE_GSM 33
 #define AUDIO_CHUNK_SIZE_PCM 304
 #define FRACUMUL_PRECISION 0xFFFFFFFF
-#define AS_MSECS_GSM 1146880000
-#define AS_MSECS_PCM 118273043  // 0xffffffff * (1000/36314)
 #define AS_CURSOR_GSM 3201039125
 #define AS_CURSOR_PCM 1348619731
 #define REG_DMA2CNT_L *(vu16*)(REG_BASE + 0x0d0)
@@ -37,6 +38,7 @@
 
 #define CODE_ROM __attribute__((section(".code")))
 #define CODE_EWRAM __attribute__((section(".ewram")))
+#define DATA_EWRAM __attribute__((section(".ewram")))
 #define INLINE static inline __attribute__((always_inline))
 
 Playback PlaybackState;
@@ -44,8 +46,9 @@ Playback PlaybackState;
 // - In GSM mode:
 //   Audio is taken from the embedded GBFS file in ROM.
 //   The sample rate is 18157hz, linearly interpolated to 36314hz.
-//   Each GSM chunk is 33 bytes and represents 304 samples.
-//   Two chunks are copied per frame, filling the 608 entries of the buffer.
+//   Each GSM chunk is 33 bytes and represents 160 samples.
+//   Each frame fills the 608 entries of the buffer (~1.9 chunks).
+//   Chunks are decoded ahead when a frame finishes early (see `lookahead.h`).
 //   (This is one of the few combinations of sample rate / buffer size that
 //   time out perfectly in the 280896 cycles of a GBA frame)
 //   See: (JS code)
@@ -55,102 +58,72 @@ Playback PlaybackState;
 //           'timer =', 65536-(280896/i), '; buffer =',
 //           i, '; sample rate =', i*(1<<24)/280896, 'hz'
 //         );
-//   Playback rate can be changed by +/- 13%, 26%, or 53%.
 // - In PCM s8 mode:
 //   Audio is taken from the flash cart's SD card (gba-flashcartio).
 //   The sample rate is 36314hz.
 //   Each PCM chunk is 304 bytes and represents 304 samples.
 //   Two chunks are copied per frame.
-//   Playback rate can be either 1 or 1.13.
+// Playback rate can be changed by +/- 13%, 26%, or 53%. Both modes resample
+// the source (see `resampler.h`).
 
-static const int rate_delays[] = {1, 2, 4, 0, 4, 2, 1};
-static signed char rate_xfade[304];
+static signed char pcm_source[RESAMPLE_CARRY + RESAMPLE_MAX_SOURCE]
+    __attribute__((aligned(4)));
 
 static bool is_pcm = false;
 static int rate = 0;
-static u32 rate_counter = 0;
+static u32 rate_phase = 0;
 static u32 current_audio_chunk = 0;
 static bool did_run = false;
 
-#define AS_MSECS (is_pcm ? AS_MSECS_PCM : AS_MSECS_GSM)
-
-#define AUDIO_PROCESS(ON_STEP, ON_STOP, ON_ERROR)                        \
-  did_run = true;                                                        \
-  buffer = double_buffers[cur_buffer];                                   \
-                                                                         \
-  if (src != NULL) {                                                     \
-    if (is_pcm) {                                                        \
-      if (src_pos < src_len) {                                           \
-        bool skipSamples = is_pcm && rate != 0 && rate_counter == 0;     \
-        if (skipSamples) {                                               \
-          audio_store_read(rate_xfade, AUDIO_CHUNK_SIZE_PCM);            \
-          src_pos += AUDIO_CHUNK_SIZE_PCM;                               \
-        }                                                                \
-        if (!audio_store_read(buffer, 608)) {                            \
-          ON_ERROR;                                                      \
-        } else {                                                         \
-          src_pos += 608;                                                \
-        }                                                                \
-        if (skipSamples) {                                               \
-          const int FIXED_POINT_MULTIPLIER = 1024;                       \
-          const int FIXED_POINT_SHIFT = 10;                              \
-          for (int i = 0; i < 304; i++) {                                \
-            int lerp_weight = (304 - i) * FIXED_POINT_MULTIPLIER / 304;  \
-            int inv_lerp_weight = i * FIXED_POINT_MULTIPLIER / 304;      \
-            int sample_rate_xfade = (int)rate_xfade[i];                  \
-            int sample_buffer = (int)buffer[i];                          \
-            int crossfaded_sample = (sample_rate_xfade * lerp_weight +   \
-                                     sample_buffer * inv_lerp_weight) >> \
-                                    FIXED_POINT_SHIFT;                   \
-            buffer[i] = (signed char)crossfaded_sample;                  \
-          }                                                              \
-        }                                                                \
-        if (src_pos >= src_len) {                                        \
-          ON_STOP;                                                       \
-        }                                                                \
-      } else {                                                           \
-        ON_STOP;                                                         \
-      }                                                                  \
-    } else {                                                             \
-      if (src_pos < src_len) {                                           \
-        for (i = 304 / 4; i > 0; i--) {                                  \
-          int cur_sample;                                                \
-          if (decode_pos >= 160) {                                       \
-            if (src_pos < src_len)                                       \
-              gsm_decode(&decoder, (src + src_pos), out_samples);        \
-            src_pos += sizeof(gsm_frame);                                \
-            decode_pos = 0;                                              \
-            ON_STEP;                                                     \
-          }                                                              \
-                                                                         \
-          /* 2:1 linear interpolation */                                 \
-          cur_sample = out_samples[decode_pos++];                        \
-          *buffer++ = (last_sample + cur_sample) >> 9;                   \
-          *buffer++ = cur_sample >> 8;                                   \
-          last_sample = cur_sample;                                      \
-                                                                         \
-          cur_sample = out_samples[decode_pos++];                        \
-          *buffer++ = (last_sample + cur_sample) >> 9;                   \
-          *buffer++ = cur_sample >> 8;                                   \
-          last_sample = cur_sample;                                      \
-                                                                         \
-          cur_sample = out_samples[decode_pos++];                        \
-          *buffer++ = (last_sample + cur_sample) >> 9;                   \
-          *buffer++ = cur_sample >> 8;                                   \
-          last_sample = cur_sample;                                      \
-                                                                         \
-          cur_sample = out_samples[decode_pos++];                        \
-          *buffer++ = (last_sample + cur_sample) >> 9;                   \
-          *buffer++ = cur_sample >> 8;                                   \
-          last_sample = cur_sample;                                      \
-        }                                                                \
-        if (src_pos >= src_len) {                                        \
-          ON_STOP;                                                       \
-        }                                                                \
-      } else {                                                           \
-        ON_STOP;                                                         \
-      }                                                                  \
-    }                                                                    \
+#define ALIGNED_PHASE (is_pcm ? 0 : RESAMPLE_ONE / 2)
+
+#define GSM_READ_SAMPLE(TARGET, ON_STEP) \
+  if (decode_pos >= 160) {               \
+    next_gsm_frame();                    \
+    ON_STEP;                             \
+  }                                      \
+  TARGET = out_samples[decode_pos++];
+
+#define AUDIO_PROCESS(ON_STEP, ON_STOP, ON_ERROR)                           \
+  did_run = true;                                                           \
+  buffer = double_buffers[cur_buffer];                                      \
+                                                                            \
+  if (src != NULL) {                                                        \
+    u32 rate_step =                                                         \
+        resample_rate_steps[rate + RATE_LEVELS] >> (is_pcm ? 0 : 1);        \
+    if (is_pcm) {                                                           \
+      if (src_pos < src_len) {                                              \
+        u32 consumed = resample_consumed(rate_phase, rate_step);            \
+        if (!audio_store_read(pcm_source + RESAMPLE_CARRY, consumed)) {     \
+          ON_ERROR;                                                         \
+        } else {                                                            \
+          src_pos += consumed;                                              \
+          rate_phase = resample_pcm(buffer, pcm_source, rate_phase,         \
+                                    rate_step, consumed);                   \
+        }                                                                   \
+        if (src_pos >= src_len) {                                           \
+          ON_STOP;                                                          \
+        }                                                                   \
+      } else {                                                              \
+        ON_STOP;                                                            \
+      }                                                                     \
+    } else {                                                                \
+      if (src_pos < src_len) {                                              \
+        if (rate_step == RESAMPLE_ONE / 2 && rate_phase == ALIGNED_PHASE) { \
+          RESAMPLE_HALF(buffer, i, last_sample, next_sample,                \
+                        GSM_READ_SAMPLE(next_sample, ON_STEP));             \
+        } else {                                                            \
+          RESAMPLE_INTERPOLATE(buffer, i, rate_phase, rate_step,            \
+                               last_sample, next_sample,                    \
+                               GSM_READ_SAMPLE(next_sample, ON_STEP));      \
+        }                                                                   \
+        if (src_pos >= src_len) {                                           \
+          ON_STOP;                                                          \
+        }                                                                   \
+      } else {                                                              \
+        ON_STOP;                                                            \
+      }                                                                     \
+    }                                                                       \
   }
 
 uint32_t fracumul(uint32_t x, uint32_t frac) __attribute__((long_call));
@@ -159,16 +132,41 @@ static const unsigned char* src = NULL;
 static uint32_t src_len = 0;
 static uint32_t src_pos = 0;
 static struct gsm_state decoder;
-static signed short out_samples[160];
+#define LOOKAHEAD_LAST_LINE 128  // (decoding ahead stops here, before VBlank)
+DATA_EWRAM static signed short decoded[LOOKAHEAD_SLOTS]
+                                      [LOOKAHEAD_CHUNK_SAMPLES];
+static Lookahead lookahead = {&decoder, decoded, NULL, 0, 0, 0, 0};
+static signed short* out_samples = decoded[0];
+static volatile u32 vblank_count = 0;
 static signed char double_buffers[2][608] __attribute__((aligned(4)));
 static unsigned int decode_pos = 160, cur_buffer = 0;
 static signed char* buffer;
 static int last_sample = 0;
+static int next_sample = 0;
 static int i;
 
-INLINE void gsm_init(gsm r) {
-  memset((char*)r, 0, sizeof(*r));
-  r->nrp = 40;
+INLINE void next_gsm_frame() {
+  out_samples = lookahead_next(&lookahead, src_pos);
+  src_pos += sizeof(gsm_frame);
+  decode_pos = 0;
+}
+
+INLINE void flush_lookahead() {
+  lookahead_flush(&lookahead, src_pos);
+}
+
+INLINE void decode_ahead(u32 frame_vblank) {
+  // (`REG_VCOUNT` starts over if the frame overran, so it also checks that
+  // no VBlank happened since the frame started)
+  while (!is_pcm && src != NULL && lookahead_can_decode(&lookahead) &&
+         vblank_count == frame_vblank && REG_VCOUNT < LOOKAHEAD_LAST_LINE)
+    lookahead_decode(&lookahead);
+}
+
+INLINE void reset_resampler() {
+  rate_phase = ALIGNED_PHASE;
+  pcm_source[0] = 0;
+  pcm_source[1] = 0;
 }
 
 INLINE void mute() {
@@ -201,6 +199,9 @@ INLINE void stop() {
   decode_pos = 160;
   cur_buffer = 0;
   last_sample = 0;
+  next_sample = 0;
+  reset_resampler();
+  flush_lookahead();
   for (u32 i = 0; i < 2; i++) {
     u32* bufferPtr = (u32*)double_buffers[i];
     for (u32 j = 0; j < 608 / 4; j++)
@@ -216,9 +217,9 @@ INLINE void play(const char* name) {
     src_pos = 0;
     src_len = audio_store_len();
   } else {
-    gsm_init(&decoder);
     src = gbfs_get_obj(fs, name, &src_len);
     src_pos = 0;
+    lookahead_start(&lookahead, src, src_len);
   }
 }
 
@@ -261,10 +262,10 @@ INLINE void dsound_start_audio_copy(const void* source) {
 
 INLINE void load_file(const char* name, bool forceGSM) {
   PlaybackState.msecs = 0;
+  PlaybackState.msecsFraction = 0;
   PlaybackState.hasFinished = false;
   PlaybackState.isLooping = false;
   rate = 0;
-  rate_counter = 0;
   current_audio_chunk = 0;
 
   if (PlaybackState.fatfs != NULL && !PlaybackState.isPCMDisabled &&
@@ -277,6 +278,7 @@ INLINE void load_file(const char* name, bool forceGSM) {
     bool success = audio_store_load(fileName);
     if (success) {
       is_pcm = true;
+      PlaybackState.isPCM = true;
       play(fileName);
       return;
     }
@@ -286,6 +288,7 @@ INLINE void load_file(const char* name, bool forceGSM) {
   strcpy(fileName, name);
   strcat(fileName, ".gsm");
   is_pcm = false;
+  PlaybackState.isPCM = false;
   play(fileName);
 }
 
@@ -295,9 +298,11 @@ CODE_ROM void player_init() {
   init();
 
   PlaybackState.msecs = 0;
+  PlaybackState.msecsFraction = 0;
   PlaybackState.hasFinished = false;
   PlaybackState.isLooping = false;
   PlaybackState.isPCMDisabled = false;
+  PlaybackState.isPCM = false;
   PlaybackState.fatfs = NULL;
 }
 
@@ -330,12 +335,12 @@ CODE_ROM void player_seek(unsigned int msecs) {
     unsigned int cursor = msecs * 36 + fracumul(msecs, AS_CURSOR_PCM);
     cursor = (cursor / AUDIO_CHUNK_SIZE_PCM) * AUDIO_CHUNK_SIZE_PCM;
     src_pos = cursor;
-    rate_counter = 0;
     current_audio_chunk = 0;
+    reset_resampler();
     audio_store_seek(src_pos);
   } else {
     // msecs = cursor * msecsPerByte
-    // msecsPerByte = AS_MSECS / FRACUMUL_PRECISION ~= 0.267
+    // msecsPerByte = (160 samples / 33 bytes) / 18.157 ~= 0.267
     // => msecs = cursor * 0.267
     // => cursor = msecs / 0.267 = msecs * 3.7453
     // => cursor = msecs * (3 + 0.7453)
@@ -343,24 +348,25 @@ CODE_ROM void player_seek(unsigned int msecs) {
     unsigned int cursor = msecs * 3 + fracumul(msecs, AS_CURSOR_GSM);
     cursor = (cursor / AUDIO_CHUNK_SIZE_GSM) * AUDIO_CHUNK_SIZE_GSM;
     src_pos = cursor;
-    rate_counter = 0;
     current_audio_chunk = 0;
+    reset_resampler();
+    flush_lookahead();
   }
 }
 
 CODE_ROM void player_setRate(int newRate) {
   rate = newRate;
-  rate_counter = 0;
+  rate_phase = ALIGNED_PHASE;  // (so the normal rate doesn't interpolate)
 }
 
 CODE_ROM void player_stop() {
   stop();
 
   PlaybackState.msecs = 0;
+  PlaybackState.msecsFraction = 0;
   PlaybackState.hasFinished = false;
   PlaybackState.isLooping = false;
   rate = 0;
-  rate_counter = 0;
   current_audio_chunk = 0;
 }
 
@@ -369,6 +375,7 @@ CODE_ROM bool player_isPlaying() {
 }
 
 void player_onVBlank() {
+  vblank_count++;
   dsound_start_audio_copy(double_buffers[cur_buffer]);
 
   if (!did_run)
@@ -381,22 +388,16 @@ void player_onVBlank() {
   did_run = false;
 }
 
-CODE_ROM void update_rate() {
-  if (rate != 0) {
-    rate_counter++;
-    if (rate_counter == rate_delays[rate + RATE_LEVELS]) {
-      if (!is_pcm)
-        src_pos += AUDIO_CHUNK_SIZE_GSM * (rate < 0 ? -1 : 1);
-      rate_counter = 0;
-    }
-  }
-}
-
 void player_forever(int (*onUpdate)(),
                     void (*onRender)(),
                     void (*onAudioChunks)(unsigned int current),
                     void (*onError)()) {
+  u32 frame_vblank = vblank_count;
+
   while (1) {
+    // > reset flash cart I/O budget (audio reads first, video after VBlank)
+    io_scheduler_begin_frame();
+
     // > main game loop
     int expectedAudioChunk = onUpdate();
 
@@ -410,6 +411,7 @@ void player_forever(int (*onUpdate)(),
         unsigned int diff = availableAudioChunks - AUDIO_SYNC_LIMIT;
 
         src_pos += AUDIO_CHUNK_SIZE_GSM * diff;
+        flush_lookahead();
         current_audio_chunk += diff;
         availableAudioChunks = AUDIO_SYNC_LIMIT;
       } else if (availableAudioChunks < -AUDIO_SYNC_LIMIT) {
@@ -418,9 +420,6 @@ void player_forever(int (*onUpdate)(),
       }
     }
 
-    // > adjust position based on audio rate
-    update_rate();
-
     if (!skipped) {
       // > audio processing (back buffer)
       AUDIO_PROCESS(
@@ -440,14 +439,23 @@ void player_forever(int (*onUpdate)(),
           { onError(); });
     }
 
+    // > decode audio ahead if there's time left before VBlank
+    decode_ahead(frame_vblank);
+
     // > notify multiplayer audio sync cursor
     onAudioChunks(current_audio_chunk);
 
-    // > calculate played milliseconds
-    PlaybackState.msecs = fracumul(src_pos, AS_MSECS);
+    // > calculate played milliseconds (see `song_clock.h`)
+    u32 played_samples =
+        is_pcm ? src_pos
+               : song_clock_gsm_samples(src_pos, AUDIO_CHUNK_SIZE_GSM,
+                                        decode_pos);
+    PlaybackState.msecs = song_clock_msecs(played_samples, is_pcm);
+    PlaybackState.msecsFraction = song_clock_fraction(played_samples, is_pcm);
 
     // > wait for vertical blank
     VBlankIntrWait();
+    frame_vblank = vblank_count;
 
     // > draw
     onRender();
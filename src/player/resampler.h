@@ -0,0 +1,86 @@
+#ifndef RESAMPLER_H
+#define RESAMPLER_H
+
+#include <stdint.h>
+#include <string.h>  // for memcpy
+
+// Playback rates resample the source with a Q16 phase accumulator (the
+// position between the last and the next source sample) and linear
+// interpolation. At the normal rate, the phase stays aligned and the loops
+// don't need to interpolate.
+// (shared by `player.iwram.c` and the host tests)
+
+#define RESAMPLE_OUTPUT_SAMPLES 608  // (per frame)
+#define RESAMPLE_ONE 0x10000
+#define RESAMPLE_CARRY 2         // (PCM samples kept between frames)
+#define RESAMPLE_MAX_SOURCE 932  // (608 * 1.53, rounded up)
+#define RESAMPLE_INLINE static inline __attribute__((always_inline))
+
+// (Q16 source samples per output sample, matching `FRACUMUL_RATE_SCALE`:
+// 0.47, 0.74, 0.87, 1, 1.13, 1.26, 1.53; GSM uses half of it)
+static const uint32_t resample_rate_steps[] = {30802, 48497, 57016, 65536,
+                                               74056, 82575, 100270};
+
+// Source samples that the next frame consumes.
+RESAMPLE_INLINE uint32_t resample_consumed(uint32_t phase, uint32_t step) {
+  return (phase + RESAMPLE_OUTPUT_SAMPLES * step) >> 16;
+}
+
+// Fills a frame of 8-bit samples from `source` (the carried samples, then
+// the `consumed` new ones), keeps the last ones for the next frame, and
+// returns the new phase.
+RESAMPLE_INLINE uint32_t resample_pcm(signed char* target,
+                                      signed char* source,
+                                      uint32_t phase,
+                                      uint32_t step,
+                                      uint32_t consumed) {
+  if (step == RESAMPLE_ONE && phase == 0) {
+    memcpy(target, source, RESAMPLE_OUTPUT_SAMPLES);
+  } else {
+    for (uint32_t j = 0; j < RESAMPLE_OUTPUT_SAMPLES; j++) {
+      int a = source[phase >> 16];
+      int b = source[(phase >> 16) + 1];
+      *target++ = a + (((b - a) * (int)(phase & 0xffff)) >> 16);
+      phase += step;
+    }
+    phase &= 0xffff;
+  }
+
+  source[0] = source[consumed];
+  source[1] = source[consumed + 1];
+  return phase;
+}
+
+// 16-bit sources (GSM) read their samples one by one: `READ_NEXT` sets
+// `NEXT` to the next source sample, and `COUNTER` is the loop variable.
+
+/* 2:1 linear interpolation (step = 1/2, phase = 1/2) */
+#define RESAMPLE_WRITE_PAIR(TARGET, LAST, NEXT, READ_NEXT) \
+  *TARGET++ = (LAST + NEXT) >> 9;                          \
+  *TARGET++ = NEXT >> 8;                                   \
+  LAST = NEXT;                                             \
+  READ_NEXT;
+
+#define RESAMPLE_HALF(TARGET, COUNTER, LAST, NEXT, READ_NEXT)           \
+  for (COUNTER = RESAMPLE_OUTPUT_SAMPLES / 8; COUNTER > 0; COUNTER--) { \
+    RESAMPLE_WRITE_PAIR(TARGET, LAST, NEXT, READ_NEXT);                 \
+    RESAMPLE_WRITE_PAIR(TARGET, LAST, NEXT, READ_NEXT);                 \
+    RESAMPLE_WRITE_PAIR(TARGET, LAST, NEXT, READ_NEXT);                 \
+    RESAMPLE_WRITE_PAIR(TARGET, LAST, NEXT, READ_NEXT);                 \
+  }
+
+#define RESAMPLE_INTERPOLATE(TARGET, COUNTER, PHASE, STEP, LAST, NEXT, \
+                             READ_NEXT)                                \
+  for (COUNTER = RESAMPLE_OUTPUT_SAMPLES; COUNTER > 0; COUNTER--) {    \
+    while (PHASE >= RESAMPLE_ONE) {                                    \
+      PHASE -= RESAMPLE_ONE;                                           \
+      LAST = NEXT;                                                     \
+      READ_NEXT;                                                       \
+    }                                                                  \
+                                                                       \
+    int weight = PHASE >> 8;                                           \
+    *TARGET++ = (LAST + (((NEXT - LAST) * weight) >> 8)) >> 8;         \
+    PHASE += STEP;                                                     \
+  }
+
+#endif  // RESAMPLER_H
@@ -0,0 +1,47 @@
+#ifndef SONG_CLOCK_H
+#define SONG_CLOCK_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// The song clock is derived from the number of source samples the player has
+// consumed, so it doesn't accumulate rounding errors no matter how long the
+// song is.
+// The output rate is 2^24 / 462 Hz (608 samples per 280896-cycle frame) and
+// GSM sources play at half of it, so:
+//   1 PCM sample = 462 * 1000 / 2^24 ms = 28875 / 16 Q16.16 ms
+//   1 GSM sample = 28875 / 8 Q16.16 ms
+// (Q16.16 milliseconds overflow 32 bits after ~65s, so they're 64-bit)
+#define SONG_CLOCK_Q16_PER_PCM_SAMPLE_X16 28875
+#define SONG_CLOCK_GSM_CHUNK_SAMPLES 160
+
+// The chunk-based GSM clock used before ran ahead of the samples by 0-144
+// (72 on average), and audio lag calibrations depend on that average.
+#define SONG_CLOCK_GSM_LEAD_SAMPLES 72
+
+static inline uint64_t song_clock_q16(uint32_t samples, bool isPCM) {
+  return ((uint64_t)samples * SONG_CLOCK_Q16_PER_PCM_SAMPLE_X16) >>
+         (isPCM ? 4 : 3);
+}
+
+static inline uint32_t song_clock_msecs(uint32_t samples, bool isPCM) {
+  return (uint32_t)(song_clock_q16(samples, isPCM) >> 16);
+}
+
+// The sub-millisecond part (Q0.16) that `song_clock_msecs` drops.
+static inline uint32_t song_clock_fraction(uint32_t samples, bool isPCM) {
+  return (uint32_t)(song_clock_q16(samples, isPCM) & 0xffff);
+}
+
+// Source samples consumed by the GSM decoder, from the position after the
+// chunk being played (`srcPos`, in bytes) and the position inside it.
+static inline uint32_t song_clock_gsm_samples(uint32_t srcPos,
+                                              uint32_t chunkSize,
+                                              uint32_t decodePos) {
+  uint32_t chunkEnd = (srcPos / chunkSize) * SONG_CLOCK_GSM_CHUNK_SAMPLES;
+  uint32_t pending = SONG_CLOCK_GSM_CHUNK_SAMPLES - decodePos;
+  return chunkEnd > pending ? chunkEnd - pending + SONG_CLOCK_GSM_LEAD_SAMPLES
+                            : 0;
+}
+
+#endif  // SONG_CLOCK_H
@@ -1,24 +1,30 @@
 #include "AdminScene.h"
 
+#include "../libs/interrupt.h"
 #include "assets.h"
 #include "gameplay/Sequence.h"
+#include "gameplay/library/LibraryStore.h"
+#include "gameplay/video/VideoStore.h"
 #include "gameplay/multiplayer/PS2Keyboard.h"
 #include "gameplay/save/SaveFile.h"
 #include "player/PlaybackState.h"
 #include "scenes/StartScene.h"
+#include "utils/HeapStats.h"
 #include "utils/SceneUtils.h"
 
 #define TITLE "ADMIN MENU (v1.11.3)"
 #define SUBMENU_RUMBLE 0
 #define SUBMENU_OFFSETS 1
 #define SUBMENU_RESET 2
-#define SUBMENU_SURE_OFFSETS 3
-#define SUBMENU_SURE_ARCADE 4
-#define SUBMENU_SURE_ALL 5
-#define OPTION_COUNT_DEFAULT 10
+#define SUBMENU_BENCHMARK 3
+#define SUBMENU_SURE_OFFSETS 4
+#define SUBMENU_SURE_ARCADE 5
+#define SUBMENU_SURE_ALL 6
+#define OPTION_COUNT_DEFAULT 11
 #define OPTION_COUNT_RUMBLE 5
 #define OPTION_COUNT_OFFSETS 4
 #define OPTION_COUNT_RESET 3
+#define OPTION_COUNT_BENCHMARK 2
 #define OPTION_COUNT_ARE_YOU_SURE 2
 
 #define OPTION_NAVIGATION_STYLE 0
@@ -28,9 +34,10 @@
 #define OPTION_HQ_MODE 4
 #define OPTION_EWRAM_OVERCLOCK 5
 #define OPTION_PS2_INPUT 6
-#define OPTION_RUMBLE_OPTS 7
-#define OPTION_CUSTOM_OFFSETS 8
-#define OPTION_RESET_SAVE_FILE 9
+#define OPTION_SD_BENCHMARK 7
+#define OPTION_RUMBLE_OPTS 8
+#define OPTION_CUSTOM_OFFSETS 9
+#define OPTION_RESET_SAVE_FILE 10
 
 AdminScene::AdminScene(std::shared_ptr<GBAEngine> engine,
                        const GBFS_FILE* fs,
@@ -42,6 +49,7 @@ AdminScene::AdminScene(std::shared_ptr<GBAEngine> engine,
 u32 AdminScene::getOptionCount() {
   return submenu >= SUBMENU_SURE_OFFSETS ? OPTION_COUNT_ARE_YOU_SURE
          : submenu == SUBMENU_RESET      ? OPTION_COUNT_RESET
+         : submenu == SUBMENU_BENCHMARK  ? OPTION_COUNT_BENCHMARK
          : submenu == SUBMENU_RUMBLE     ? OPTION_COUNT_RUMBLE
          : submenu == SUBMENU_OFFSETS    ? OPTION_COUNT_OFFSETS
                                          : OPTION_COUNT_DEFAULT;
@@ -109,6 +117,57 @@ void AdminScene::printOptions() {
     printOption(1, "[DELETE ALL SAVED DATA]", "", 13);
     printOption(2, "[BACK]", "", 15);
 
+    PLAY_AND_END();
+  } else if (submenu == SUBMENU_BENCHMARK) {
+    SCENE_write("BENCHMARK / MEMORY", 1);
+
+    std::string flashcart = active_flashcart == EVERDRIVE_GBA_X5
+                                ? "EverDrive GBA X5"
+                            : active_flashcart == EZ_FLASH_OMEGA
+                                ? "EZ-Flash Omega"
+                                : "(HQ mode is off)";
+    if (libraryStore->isActive())
+      flashcart += " +SD (" +
+                   std::to_string(libraryStore->getRomFallbacks()) + " ROM)";
+    SCENE_write(flashcart, 4);
+    SCENE_write(
+        "IRQ: V" + std::to_string(interrupt_get_worst_latency(INTR_VBLANK)) +
+            " T" + std::to_string(interrupt_get_worst_latency(INTR_TIMER3)) +
+            " S" + std::to_string(interrupt_get_worst_latency(INTR_SERIAL)) +
+            "us max",
+        5);
+    if (didRunBenchmark && benchmarkResult.success) {
+      SCENE_write(
+          "Sequential: " + std::to_string(benchmarkResult.sequentialKBps) +
+              " KB/s",
+          6);
+      SCENE_write(
+          "Random: " + std::to_string(benchmarkResult.randomIOPS) + " IOPS",
+          7);
+      SCENE_write(
+          "Latency: " + std::to_string(benchmarkResult.randomAvgUs) + "us avg",
+          8);
+      SCENE_write(
+          "Latency: " + std::to_string(benchmarkResult.randomMaxUs) + "us max",
+          9);
+    } else if (didRunBenchmark)
+      SCENE_write("*Error* Read failed!", 6);
+
+    HeapStats heap = HEAP_STATS_get();
+    SCENE_write("Heap: " + std::to_string(heap.current / 1024) + "KB (" +
+                    std::to_string(heap.allocations) + " blocks)",
+                10);
+    SCENE_write("Peak: " + std::to_string(heap.peak / 1024) + "KB / " +
+                    std::to_string(heap.limit / 1024) + "KB",
+                11);
+    SpriteTilesStats tiles = SPRITE_TILES_getStats();
+    SCENE_write("Sprites: " + std::to_string(tiles.used / 1024) + "KB (+" +
+                    std::to_string(tiles.cached / 1024) + "KB cached)",
+                12);
+
+    printOption(0, "[RUN]", "", 13);
+    printOption(1, "[BACK]", "", 15);
+
     PLAY_AND_END();
   } else if (submenu >= SUBMENU_SURE_OFFSETS) {
     SCENE_write("ARE YOU SURE?!", 1);
@@ -159,6 +218,7 @@ void AdminScene::printOptions() {
   printOption(OPTION_PS2_INPUT, "PS/2 input",
               hqMode > 0 ? "---" : (ps2Input > 0 ? "ON" : "OFF"), 11);
 
+  printOption(OPTION_SD_BENCHMARK, "[BENCHMARK / MEMORY]", "", 12);
   printOption(OPTION_RUMBLE_OPTS, "[RUMBLE OPTIONS]", "", 13);
   printOption(OPTION_CUSTOM_OFFSETS, "[CUSTOM OFFSETS]", "", 14);
   printOption(OPTION_RESET_SAVE_FILE, "[DELETE SAVE FILE]", "", 15);
@@ -278,6 +338,25 @@ bool AdminScene::selectOption(u32 selected, int direction) {
     return true;
   }
 
+  if (submenu == SUBMENU_BENCHMARK) {
+    if (direction != 0)
+      return true;
+
+    if (selected == 0) {
+      if (!videoStore->isActive())
+        return true;
+
+      player_stop();
+      benchmarkResult = STORAGE_BENCHMARK_run();
+      didRunBenchmark = true;
+    } else {
+      submenu = -1;
+      this->selected = 0;
+    }
+
+    return true;
+  }
+
   if (submenu >= SUBMENU_SURE_OFFSETS) {
     if (direction != 0)
       return true;
@@ -391,6 +470,14 @@ bool AdminScene::selectOption(u32 selected, int direction) {
 
       return true;
     }
+    case OPTION_SD_BENCHMARK: {
+      if (direction != 0)
+        return true;
+
+      submenu = SUBMENU_BENCHMARK;
+      this->selected = 0;
+      return true;
+    }
     case OPTION_RUMBLE_OPTS: {
       if (direction != 0)
         return true;
@@ -2,6 +2,7 @@
 #define ADMIN_SCENE_H
 
 #include "base/MenuScene.h"
+#include "gameplay/video/StorageBenchmark.h"
 
 class AdminScene : public MenuScene {
  public:
@@ -20,6 +21,8 @@ class AdminScene : public MenuScene {
   int submenu = -1;
   u32 totalOffsets = 0;
   bool withSound;
+  StorageBenchmarkResult benchmarkResult;
+  bool didRunBenchmark = false;
 };
 
 #endif  // ADMIN_SCENE_H
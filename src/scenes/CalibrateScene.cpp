@@ -6,6 +6,7 @@
 #include "assets.h"
 #include "data/content/_compiled_sprites/palette_selection.h"
 #include "gameplay/Key.h"
+#include "gameplay/TimingProvider.h"
 #include "gameplay/save/SaveFile.h"
 #include "player/PlaybackState.h"
 #include "utils/SceneUtils.h"
@@ -17,15 +18,19 @@ extern "C" {
 #define TITLE "AUDIO LAG CALIBRATION"
 #define SUBTITLE1 "1) Press to start"
 #define SUBTITLE2 "2) Wait 4 beats"
-#define SUBTITLE3 "3) Press on beat 5"
+#define SUBTITLE3 "3) Press on every beat"
 #define MEASURE_TITLE "- Detected audio lag -"
+#define TAPS_TEXT "Taps: "
+#define INCONSISTENT_TEXT "Too inconsistent, try again"
 #define CANCEL_TEXT "BACK"
 #define RESET_TEXT "RESET"
 #define SAVE_TEXT "SAVE"
 
 const u32 BPM = 120;
 const u32 BEATS_TOTAL = 16;
+const u32 BEAT_MS = MINUTE / BPM;
 const u32 TARGET_BEAT_MS = 2000;
+const u32 TAPS_TOTAL = 24;
 
 const u32 ID_MAIN_BACKGROUND = 1;
 const u32 BANK_BACKGROUND_TILES = 0;
@@ -37,6 +42,7 @@ const u32 TEXT_ROW_SUBTITLE2 = 6;
 const u32 TEXT_ROW_SUBTITLE3 = 7;
 const u32 TEXT_ROW_MEASURE_TITLE = 12;
 const u32 TEXT_ROW_MEASURE_VALUE = 13;
+const u32 TEXT_ROW_MEASURE_WARNING = 15;
 const u32 TEXT_ROW_BUTTONS = 17;
 const u32 TEXT_COL_SUBTITLE = 3;
 const u32 TEXT_COL_RESET = 1;
@@ -65,6 +71,7 @@ std::vector<Sprite*> CalibrateScene::sprites() {
   sprites.push_back(resetButton->get());
   sprites.push_back(saveButton->get());
 
+  SPRITE_TILES_assign(sprites);
   return sprites;
 }
 
@@ -77,11 +84,11 @@ void CalibrateScene::load() {
   pixelBlink = std::unique_ptr<PixelBlink>{new PixelBlink(PIXEL_BLINK_LEVEL)};
 
   calibrateButton = std::unique_ptr<ArrowSelector>{
-      new ArrowSelector(ArrowDirection::CENTER, false, true)};
+      new ArrowSelector(ArrowDirection::CENTER, true)};
   resetButton = std::unique_ptr<ArrowSelector>{
-      new ArrowSelector(ArrowDirection::UPLEFT, true, true)};
+      new ArrowSelector(ArrowDirection::UPLEFT, true)};
   saveButton = std::unique_ptr<ArrowSelector>{
-      new ArrowSelector(ArrowDirection::UPRIGHT, true, true)};
+      new ArrowSelector(ArrowDirection::UPRIGHT, true)};
 
   calibrateButton->get()->moveTo(CALIBRATE_BUTTON_X, CALIBRATE_BUTTON_Y);
   resetButton->get()->moveTo(BUTTON_MARGIN,
@@ -89,7 +96,7 @@ void CalibrateScene::load() {
   SPRITE_hide(saveButton->get());
 
   printTitle();
-  TextStream::instance().setText(CANCEL_TEXT, TEXT_ROW_BUTTONS, TEXT_COL_RESET);
+  TEXT_write(CANCEL_TEXT, TEXT_ROW_BUTTONS, TEXT_COL_RESET);
 }
 
 void CalibrateScene::tick(u16 keys) {
@@ -105,6 +112,8 @@ void CalibrateScene::tick(u16 keys) {
       !SPRITE_isHidden(resetButton->get())) {
     if (hasDoneChanges) {
       measuredLag = 0;
+      measuredSpread = 0;
+      isReliable = true;
       printTitle();
       finish();
     } else
@@ -119,6 +128,12 @@ void CalibrateScene::tick(u16 keys) {
   resetButton->tick();
   saveButton->tick();
 
+  if (isMeasuring) {
+    if (PlaybackState.msecs < lastMsecs)
+      hasLooped = true;
+    lastMsecs = PlaybackState.msecs;
+  }
+
   if (isMeasuring && PlaybackState.hasFinished)
     finish();
 }
@@ -158,15 +173,12 @@ void CalibrateScene::processKeys(u16 keys) {
 void CalibrateScene::printTitle() {
   TextStream::instance().setFontColor(TEXT_COLOR);
   TextStream::instance().setFontSubcolor(text_bg_palette_default_subcolor);
-  TextStream::instance().clear();
+  TEXT_clear();
 
   SCENE_write(TITLE, TEXT_ROW_TITLE);
-  TextStream::instance().setText(SUBTITLE1, TEXT_ROW_SUBTITLE1,
-                                 TEXT_COL_SUBTITLE);
-  TextStream::instance().setText(SUBTITLE2, TEXT_ROW_SUBTITLE2,
-                                 TEXT_COL_SUBTITLE);
-  TextStream::instance().setText(SUBTITLE3, TEXT_ROW_SUBTITLE3,
-                                 TEXT_COL_SUBTITLE);
+  TEXT_write(SUBTITLE1, TEXT_ROW_SUBTITLE1, TEXT_COL_SUBTITLE);
+  TEXT_write(SUBTITLE2, TEXT_ROW_SUBTITLE2, TEXT_COL_SUBTITLE);
+  TEXT_write(SUBTITLE3, TEXT_ROW_SUBTITLE3, TEXT_COL_SUBTITLE);
 }
 
 void CalibrateScene::calibrate() {
@@ -177,18 +189,48 @@ void CalibrateScene::calibrate() {
     return;
   }
 
+  addTap();
+}
+
+void CalibrateScene::addTap() {
   u32 msecs = PlaybackState.msecs;
-  measuredLag = msecs - TARGET_BEAT_MS;
+  if (!hasLooped && msecs < TARGET_BEAT_MS - BEAT_MS / 2)
+    return;  // (count-in)
+
+  // (offset from the nearest beat, so lags beyond half a beat can't be told)
+  taps[tapCount++] =
+      (int)((msecs + BEAT_MS / 2) % BEAT_MS) - (int)(BEAT_MS / 2);
+  printTapCount();
+  if (tapCount < TAPS_TOTAL)
+    return;
+
+  auto result = CALIBRATION_estimate(taps, tapCount);
+  measuredLag = result.lag;
+  measuredSpread = result.spread;
+  isReliable = result.isReliable;
+  player_stop();
+  printTitle();
   finish();
 }
 
+void CalibrateScene::printTapCount() {
+  SCENE_write(TAPS_TEXT + std::to_string(tapCount) + "/" +
+                  std::to_string(TAPS_TOTAL),
+              TEXT_ROW_MEASURE_VALUE);
+}
+
 void CalibrateScene::start() {
   isMeasuring = true;
   hasDoneChanges = true;
+  tapCount = 0;
+  lastMsecs = 0;
+  hasLooped = false;
   SPRITE_hide(resetButton->get());
   SPRITE_hide(saveButton->get());
   printTitle();
+  printTapCount();
   player_playSfx(SOUND_CALIBRATE);
+  player_enableLoop();
 }
 
 void CalibrateScene::finish() {
@@ -196,16 +238,22 @@ void CalibrateScene::finish() {
 
   resetButton->get()->moveTo(BUTTON_MARGIN,
                              GBA_SCREEN_HEIGHT - ARROW_SIZE - BUTTON_MARGIN);
-  saveButton->get()->moveTo(GBA_SCREEN_WIDTH - ARROW_SIZE - BUTTON_MARGIN,
-                            GBA_SCREEN_HEIGHT - ARROW_SIZE - BUTTON_MARGIN);
+  TEXT_write(RESET_TEXT, TEXT_ROW_BUTTONS, TEXT_COL_RESET);
 
-  TextStream::instance().setText(RESET_TEXT, TEXT_ROW_BUTTONS, TEXT_COL_RESET);
-  TextStream::instance().setText(SAVE_TEXT, TEXT_ROW_BUTTONS, TEXT_COL_SAVE);
+  if (isReliable) {
+    saveButton->get()->moveTo(GBA_SCREEN_WIDTH - ARROW_SIZE - BUTTON_MARGIN,
+                              GBA_SCREEN_HEIGHT - ARROW_SIZE - BUTTON_MARGIN);
+    TEXT_write(SAVE_TEXT, TEXT_ROW_BUTTONS, TEXT_COL_SAVE);
+  }
 
   SCENE_write(MEASURE_TITLE, TEXT_ROW_MEASURE_TITLE);
 
   auto value = std::to_string(measuredLag);
+  if (measuredSpread > 0)
+    value += " (+/- " + std::to_string(measuredSpread) + ")";
   SCENE_write(value, TEXT_ROW_MEASURE_VALUE);
+  if (!isReliable)
+    SCENE_write(INCONSISTENT_TEXT, TEXT_ROW_MEASURE_WARNING);
 }
 
 void CalibrateScene::save() {
@@ -8,6 +8,7 @@
 
 #include <functional>
 
+#include "gameplay/Calibration.h"
 #include "objects/ui/ArrowSelector.h"
 #include "utils/PixelBlink.h"
 
@@ -41,6 +42,12 @@ class CalibrateScene : public Scene {
   bool isMeasuring = false;
   bool hasDoneChanges = false;
   int measuredLag = 0;
+  u32 measuredSpread = 0;
+  bool isReliable = true;
+  int taps[CALIBRATION_MAX_TAPS];
+  u32 tapCount = 0;
+  u32 lastMsecs = 0;
+  bool hasLooped = false;
 
   void setUpSpritesPalette();
   void setUpBackground();
@@ -48,6 +55,8 @@ class CalibrateScene : public Scene {
   void processKeys(u16 keys);
   void printTitle();
   void calibrate();
+  void addTap();
+  void printTapCount();
   void start();
   void finish();
   void save();
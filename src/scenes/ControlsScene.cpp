@@ -47,6 +47,7 @@ std::vector<Sprite*> ControlsScene::sprites() {
   for (u32 i = 0; i < START_COMBO_TOTAL; i++)
     sprites.push_back(comboArrows[i]->get());
 
+  SPRITE_TILES_assign(sprites);
   return sprites;
 }
 
@@ -123,11 +124,11 @@ void ControlsScene::setUpArrows() {
   for (u32 i = 0; i < ARROWS_TOTAL; i++) {
     auto direction = static_cast<ArrowDirection>(i);
     buttons.push_back(std::unique_ptr<ArrowSelector>{
-        new ArrowSelector(direction, direction > 0, true, false)});
+        new ArrowSelector(direction, true, false)});
   }
 
   buttons.push_back(std::unique_ptr<ArrowSelector>{new ArrowSelector(
-      static_cast<ArrowDirection>(ArrowDirection::CENTER), true, true, false)});
+      static_cast<ArrowDirection>(ArrowDirection::CENTER), true, false)});
 
   buttons[ArrowDirection::DOWNLEFT]->get()->moveTo(22, 67);
   buttons[ArrowDirection::UPLEFT]->get()->moveTo(29, 25);
@@ -4,6 +4,7 @@
 #include "data/content/_compiled_sprites/palette_grade.h"
 #include "data/content/_compiled_sprites/palette_grade_multi.h"
 #include "gameplay/Key.h"
+#include "gameplay/Replay.h"
 #include "gameplay/Sequence.h"
 #include "gameplay/multiplayer/Syncer.h"
 #include "objects/score/combo/Combo.h"
@@ -83,6 +84,7 @@ std::vector<Sprite*> DanceGradeScene::sprites() {
   else
     sprites.push_back(grade->get());
 
+  SPRITE_TILES_assign(sprites);
   return sprites;
 }
 
@@ -98,9 +100,8 @@ void DanceGradeScene::load() {
   printScore();
 
   SCENE_write(songTitle, 1);
-  TextStream::instance().setText(
-      "- " + songArtist + " -", 2,
-      TEXT_MIDDLE_COL - (songArtist.length() + 4) / 2);
+  TEXT_write(("- " + songArtist + " -").c_str(), 2,
+             TEXT_MIDDLE_COL - (songArtist.length() + 4) / 2);
   SCENE_write(songLevel, 3);
 
   bool has4Digits = evaluation->needs4Digits() ||
@@ -109,9 +110,9 @@ void DanceGradeScene::load() {
   u32 totalsX = TOTALS_X[!isVs() || syncer->getLocalPlayerId() == 1];
   for (u32 i = 0; i < totals.size(); i++)
     totals[i] = std::unique_ptr<Total>{
-        new Total(totalsX, TOTALS_Y[i], has4Digits, i == 0)};
+        new Total(totalsX, TOTALS_Y[i], has4Digits)};
   maxComboTotal = std::unique_ptr<Total>{
-      new Total(totalsX, TOTAL_MAX_COMBO_Y, has4Digits, false)};
+      new Total(totalsX, TOTAL_MAX_COMBO_Y, has4Digits)};
 
   totals[FeedbackType::PERFECT]->setValue(evaluation->perfects);
   totals[FeedbackType::GREAT]->setValue(evaluation->greats);
@@ -125,9 +126,9 @@ void DanceGradeScene::load() {
     u8 remoteId = syncer->getRemotePlayerId();
 
     miniGrades[0] = std::unique_ptr<GradeBadge>{
-        new GradeBadge(MINI_GRADE_X[localId], MINI_GRADE_Y, false, true)};
+        new GradeBadge(MINI_GRADE_X[localId], MINI_GRADE_Y, true)};
     miniGrades[1] = std::unique_ptr<GradeBadge>{
-        new GradeBadge(MINI_GRADE_X[remoteId], MINI_GRADE_Y, true, true)};
+        new GradeBadge(MINI_GRADE_X[remoteId], MINI_GRADE_Y, true)};
     miniGrades[0]->setType(evaluation->getGrade());
     miniGrades[1]->setType(remoteEvaluation->getGrade());
     miniGrades[0]->get()->setDoubleSize(true);
@@ -137,9 +138,9 @@ void DanceGradeScene::load() {
 
     for (u32 i = 0; i < remoteTotals.size(); i++)
       remoteTotals[i] = std::unique_ptr<Total>{
-          new Total(TOTALS_X[remoteId], TOTALS_Y[i], has4Digits, false)};
+          new Total(TOTALS_X[remoteId], TOTALS_Y[i], has4Digits)};
     remoteMaxComboTotal = std::unique_ptr<Total>{
-        new Total(TOTALS_X[remoteId], TOTAL_MAX_COMBO_Y, has4Digits, false)};
+        new Total(TOTALS_X[remoteId], TOTAL_MAX_COMBO_Y, has4Digits)};
 
     remoteTotals[FeedbackType::PERFECT]->setValue(remoteEvaluation->perfects);
     remoteTotals[FeedbackType::GREAT]->setValue(remoteEvaluation->greats);
@@ -173,6 +174,13 @@ void DanceGradeScene::tick(u16 keys) {
       return;
   }
 
+  if (ENV_DEVELOPMENT && PlaybackState.hasFinished && KEY_SEL(keys) &&
+      REPLAY_canPlay(GameState.mode)) {
+    player_stop();
+    SEQUENCE_goToReplay();
+    return;
+  }
+
   if (PlaybackState.hasFinished && KEY_ANYKEY(keys)) {
     if (isMultiplayer()) {
       if (syncer->isMaster())
@@ -53,6 +53,7 @@ std::vector<Sprite*> DeathMixScene::sprites() {
   }
   sprites.push_back(multiplier->get());
 
+  SPRITE_TILES_assign(sprites);
   return sprites;
 }
 
@@ -71,17 +72,17 @@ void DeathMixScene::load() {
     progress = std::unique_ptr<NumericProgress>{
         new NumericProgress(PROGRESS_X, PROGRESS_Y)};
     gradeBadge = std::unique_ptr<GradeBadge>{
-        new GradeBadge(GRADE_X, GRADE_Y, false, false)};
+        new GradeBadge(GRADE_X, GRADE_Y, false)};
     gradeBadge->setType(GradeType::UNPLAYED);
   } else {
     numericLevelBadge = std::unique_ptr<Button>{new Button(
-        ButtonType::LEVEL_METER, NUMERIC_LEVEL_X, NUMERIC_LEVEL_Y, false)};
+        ButtonType::LEVEL_METER, NUMERIC_LEVEL_X, NUMERIC_LEVEL_Y)};
     numericLevelBadge->get()->setPriority(1);
   }
   backButton = std::unique_ptr<ArrowSelector>{
-      new ArrowSelector(ArrowDirection::UPLEFT, true, true)};
+      new ArrowSelector(ArrowDirection::UPLEFT, true)};
   nextButton = std::unique_ptr<ArrowSelector>{
-      new ArrowSelector(ArrowDirection::UPRIGHT, true, true)};
+      new ArrowSelector(ArrowDirection::UPRIGHT, true)};
   backButton->get()->moveTo(BACK_X, BACK_Y);
   nextButton->get()->moveTo(NEXT_X, NEXT_Y);
   settingsMenuInput = std::unique_ptr<InputHandler>{new InputHandler()};
@@ -250,7 +251,7 @@ void DeathMixScene::printNumericLevel() {
   u32 lastNumericLevel = SAVEFILE_read32(SRAM->lastNumericLevel) & 0xff;
   std::string level = std::to_string(lastNumericLevel);
   STRING_padLeft(level, 2, '0');
-  TextStream::instance().setText(level, TEXT_ROW, TEXT_COL);
+  TEXT_write(level.c_str(), TEXT_ROW, TEXT_COL);
 }
 
 void DeathMixScene::confirm(u16 keys) {
@@ -273,13 +274,17 @@ void DeathMixScene::confirm(u16 keys) {
       return;
     }
     auto songChart = deathMix->getNextSongChart();
+    if (songChart.song == NULL) {
+      player_playSfx(SOUND_MOD);
+      pixelBlink->blink();
+      return;
+    }
 
     SAVEFILE_write8(SRAM->state.isPlaying, true);
     STATE_setup(songChart.song, songChart.chart);
     deathMix->multiplier = GameState.mods.multiplier;
-    engine->transitionIntoScene(
-        new SongScene(engine, fs, songChart.song, songChart.chart, NULL,
-                      std::move(deathMix)),
-        new PixelTransitionEffect());
+    auto songScene = new SongScene(engine, fs, songChart.song,
+                                   songChart.chart, NULL, std::move(deathMix));
+    engine->transitionIntoScene(songScene, songScene->createTransition());
   }
 }
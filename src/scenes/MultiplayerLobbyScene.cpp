@@ -26,6 +26,7 @@ std::vector<Sprite*> MultiplayerLobbyScene::sprites() {
 
   sprites.push_back(loadingIndicator->get());
 
+  SPRITE_TILES_assign(sprites);
   return sprites;
 }
 
@@ -33,7 +34,7 @@ void MultiplayerLobbyScene::load() {
   TextScene::load();
 
   loadingIndicator = std::unique_ptr<Explosion>{
-      new Explosion(LOADING_INDICATOR_X, LOADING_INDICATOR_Y, false)};
+      new Explosion(LOADING_INDICATOR_X, LOADING_INDICATOR_Y)};
 
   syncer->initialize(mode);
 #ifndef SENV_DEVELOPMENT
@@ -63,14 +64,15 @@ void MultiplayerLobbyScene::tick(u16 keys) {
 #ifndef SENV_DEVELOPMENT
   refresh(syncer->getLastError());
 #else
-  TextStream::instance().setText(
-      "P" + std::to_string(linkUniversal->currentPlayerId()) + "/" +
-          std::to_string(linkUniversal->playerCount()) + " [" +
-          std::to_string((int)linkUniversal->getState()) + "]<" +
-          std::to_string((int)linkUniversal->getMode()) + ">(" +
-          std::to_string((int)linkUniversal->getWirelessState()) + ") w(" +
-          std::to_string(linkUniversal->_getWaitCount()) + ") sw(" +
-          std::to_string(linkUniversal->_getSubWaitCount()) + ")",
+  TEXT_write(
+      ("P" + std::to_string(linkUniversal->currentPlayerId()) + "/" +
+       std::to_string(linkUniversal->playerCount()) + " [" +
+       std::to_string((int)linkUniversal->getState()) + "]<" +
+       std::to_string((int)linkUniversal->getMode()) + ">(" +
+       std::to_string((int)linkUniversal->getWirelessState()) + ") w(" +
+       std::to_string(linkUniversal->_getWaitCount()) + ") sw(" +
+       std::to_string(linkUniversal->_getSubWaitCount()) + ")")
+          .c_str(),
       2, 0);
 #endif
 
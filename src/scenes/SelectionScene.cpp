@@ -15,6 +15,7 @@
 #include "utils/SceneUtils.h"
 
 #define CONFIRM_MESSAGE "Press    to start!"
+#define UNLOADABLE_SONG_MESSAGE "can't be loaded"
 
 const u32 ID_HIGHLIGHTER = 1;
 const u32 ID_MAIN_BACKGROUND = 2;
@@ -100,6 +101,7 @@ std::vector<Sprite*> SelectionScene::sprites() {
       sprites.push_back(remoteNumericLevelBadge->get());
   }
 
+  SPRITE_TILES_assign(sprites);
   return sprites;
 }
 
@@ -136,13 +138,13 @@ void SelectionScene::load() {
     numericLevelBadge = std::unique_ptr<Button>{new Button(
         ButtonType::LEVEL_METER,
         NUMERIC_LEVEL_BADGE_X - (isVs() ? NUMERIC_LEVEL_BADGE_MARGIN : 0),
-        NUMERIC_LEVEL_BADGE_Y, false)};
+        NUMERIC_LEVEL_BADGE_Y)};
     numericLevelBadge->get()->setPriority(ID_HIGHLIGHTER);
     if (isVs()) {
       remoteNumericLevelBadge = std::unique_ptr<Button>{
           new Button(ButtonType::LEVEL_METER,
                      NUMERIC_LEVEL_BADGE_X + NUMERIC_LEVEL_BADGE_MARGIN,
-                     NUMERIC_LEVEL_BADGE_Y, true)};
+                     NUMERIC_LEVEL_BADGE_Y)};
       remoteNumericLevelBadge->get()->setPriority(ID_HIGHLIGHTER);
     }
 
@@ -271,7 +273,7 @@ void SelectionScene::setUpArrows() {
   for (u32 i = 0; i < ARROWS_TOTAL; i++) {
     auto direction = static_cast<ArrowDirection>(i);
     arrowSelectors.push_back(std::unique_ptr<ArrowSelector>{
-        new ArrowSelector(static_cast<ArrowDirection>(direction), direction > 0,
+        new ArrowSelector(static_cast<ArrowDirection>(direction),
                           direction != ArrowDirection::CENTER)});
   }
 
@@ -299,23 +301,23 @@ void SelectionScene::setUpArrows() {
   if (isMultiplayer()) {
     loadingIndicator1 = std::unique_ptr<Explosion>{
         new Explosion(LOADING_INDICATORS_X[syncer->isMaster() * 2],
-                      LOADING_INDICATORS_Y[syncer->isMaster()], true)};
+                      LOADING_INDICATORS_Y[syncer->isMaster()])};
     loadingIndicator2 = std::unique_ptr<Explosion>{
         new Explosion(LOADING_INDICATORS_X[syncer->isMaster() * 2 + 1],
-                      LOADING_INDICATORS_Y[syncer->isMaster()], true)};
+                      LOADING_INDICATORS_Y[syncer->isMaster()])};
   }
 }
 
 void SelectionScene::setUpChannelBadges() {
   for (u32 i = 0; i < PAGE_SIZE; i++)
     channelBadges.push_back(std::unique_ptr<ChannelBadge>{
-        new ChannelBadge(CHANNEL_BADGE_X[i], CHANNEL_BADGE_Y, i > 0)});
+        new ChannelBadge(CHANNEL_BADGE_X[i], CHANNEL_BADGE_Y)});
 }
 
 void SelectionScene::setUpGradeBadges() {
   for (u32 i = 0; i < PAGE_SIZE; i++) {
     gradeBadges.push_back(std::unique_ptr<GradeBadge>{
-        new GradeBadge(GRADE_BADGE_X[i], GRADE_BADGE_Y, i > 0, false)});
+        new GradeBadge(GRADE_BADGE_X[i], GRADE_BADGE_Y, false)});
     gradeBadges[i]->get()->setPriority(ID_MAIN_BACKGROUND);
     gradeBadges[i]->get()->setDoubleSize(true);
     gradeBadges[i]->get()->setAffineId(AFFINE_BASE + i);
@@ -324,7 +326,7 @@ void SelectionScene::setUpGradeBadges() {
 
 void SelectionScene::setUpLocks() {
   for (u32 i = 0; i < PAGE_SIZE; i++)
-    locks.push_back(std::unique_ptr<Lock>{new Lock(LOCK_X[i], LOCK_Y, i > 0)});
+    locks.push_back(std::unique_ptr<Lock>{new Lock(LOCK_X[i], LOCK_Y)});
 }
 
 void SelectionScene::setUpPager() {
@@ -381,6 +383,8 @@ void SelectionScene::goToSong() {
   std::vector<u8> chartIndexes;
 
   Song* tempSong = SONG_parse(fs, getSelectedSong());
+  if (tempSong == NULL)
+    return;  // (see `updateSelection`)
   if (isStory) {
     chartIndexes.push_back(
         SONG_findChartIndexByDifficultyLevel(tempSong, difficulty->getValue()));
@@ -665,6 +669,24 @@ void SelectionScene::onConfirmOrStart(bool isConfirmed) {
 
 void SelectionScene::updateSelection(bool isChangingLevel) {
   Song* song = SONG_parse(fs, getSelectedSong());
+  if (song == NULL) {
+    // (the song stays listed, but it has no levels, so it can't be played)
+    numericLevels.clear();
+    selectedSongId = SONG_ID_UNKNOWN;
+    progress->setValue(getSelectedSongIndex() + 1, count);
+    setNames(getSelectedSong()->name, UNLOADABLE_SONG_MESSAGE);
+    printNumericLevel(NULL, NULL);
+    if (!IS_STORY(SAVEFILE_getGameMode())) {
+      for (u32 i = 0; i < PAGE_SIZE; i++)
+        gradeBadges[i]->setType(GradeType::UNPLAYED);
+    }
+    stop();
+
+    SAVEFILE_write8(SRAM->memory.pageIndex, page);
+    SAVEFILE_write8(SRAM->memory.songIndex, selected);
+    highlighter->select(selected);
+    return;
+  }
   selectedSongId = song->id;
 
   updateLevel(song, isChangingLevel);
@@ -766,7 +788,7 @@ void SelectionScene::confirm() {
   confirmed = true;
   arrowSelectors[ArrowDirection::CENTER]->get()->moveTo(CENTER_X, CENTER_Y);
   TextStream::instance().scrollNow(0, TEXT_SCROLL_CONFIRMED);
-  TextStream::instance().clear();
+  TEXT_clear();
   printNumericLevel(NULL, NULL, NUMERIC_LEVEL_BADGE_OFFSET_ROW);
   SCENE_write(CONFIRM_MESSAGE, TEXT_ROW);
 }
@@ -820,7 +842,7 @@ void SelectionScene::stopPageCross2() {
 
 void SelectionScene::loadChannels() {
   for (u32 i = 0; i < songs.size(); i++) {
-    auto channel = SONG_getChannel(fs, SAVEFILE_getGameMode(), songs[i].get(),
+    auto channel = SONG_getChannel(fs, SAVEFILE_getGameMode(), &songs[i],
                                    getLibraryType());
     channelBadges[i]->setType(channel);
   }
@@ -847,10 +869,10 @@ void SelectionScene::loadProgress() {
 }
 
 void SelectionScene::setNames(std::string title, std::string artist) {
-  TextStream::instance().clear();
+  TEXT_clear();
   SCENE_write(title, TEXT_ROW);
-  TextStream::instance().setText("- " + artist + " -", TEXT_ROW + 1,
-                                 TEXT_MIDDLE_COL - (artist.length() + 4) / 2);
+  TEXT_write(("- " + artist + " -").c_str(), TEXT_ROW + 1,
+             TEXT_MIDDLE_COL - (artist.length() + 4) / 2);
 }
 
 void SelectionScene::printNumericLevel(Chart* chart,
@@ -868,9 +890,10 @@ void SelectionScene::printNumericLevel(Chart* chart,
   if (chart != NULL) {
     if (isCustomOffsetAdjustmentEnabled()) {
       int customOffset = getCustomOffset();
-      TextStream::instance().setText(
-          (customOffset >= 0 ? "[+" : "[") + std::to_string(customOffset) + "]",
-          TEXT_ROW - 1, -3);
+      TEXT_write(((customOffset >= 0 ? "[+" : "[") +
+                  std::to_string(customOffset) + "]")
+                     .c_str(),
+                 TEXT_ROW - 1, -3);
       SCENE_write(std::string("  ") + chart->offsetLabel,
                   NUMERIC_LEVEL_ROW + 2);
     } else {
@@ -59,7 +59,7 @@ class SelectionScene : public Scene {
   u32 animationFrame = 0;
 
   std::unique_ptr<Library> library;
-  std::vector<std::unique_ptr<SongFile>> songs;
+  std::vector<SongFile> songs;
   std::vector<std::unique_ptr<ArrowSelector>> arrowSelectors;
   std::vector<std::unique_ptr<ChannelBadge>> channelBadges;
   std::vector<std::unique_ptr<GradeBadge>> gradeBadges;
@@ -94,7 +94,7 @@ class SelectionScene : public Scene {
     syncer->pendingSeek = 0;
   }
 
-  inline SongFile* getSelectedSong() { return songs[selected].get(); }
+  inline SongFile* getSelectedSong() { return &songs[selected]; }
   inline u32 getSelectedSongIndex() { return getPageStart() + selected; }
   inline u32 getPageStart() { return page * PAGE_SIZE; }
 
@@ -10,6 +10,8 @@
 #include "TalkScene.h"
 #include "data/content/_compiled_sprites/palette_song.h"
 #include "gameplay/Key.h"
+#include "gameplay/Playfield.h"
+#include "gameplay/Replay.h"
 #include "gameplay/Sequence.h"
 #include "gameplay/SequenceMessages.h"
 #include "gameplay/save/SaveFile.h"
@@ -38,6 +40,8 @@ extern "C" {
   } while (0)
 
 #define CUSTOM_OFFSET_CORRECTION 8
+#define REPLAY_OK "Replay: OK"
+#define REPLAY_MISMATCH "Replay: MISMATCH!"
 
 const u32 ARROW_POOL_SIZE = 78;
 // (1 lifebar + 5 holders + 5 fake heads + 1 feedback + 1 combo + 4 numbers)
@@ -50,18 +54,21 @@ const u32 DARKENER_PRIORITY = 2;
 const u32 MAIN_BACKGROUND_ID = 1;
 const u32 MAIN_BACKGROUND_PRIORITY = 3;
 const u32 BANK_BACKGROUND_TILES = 0;
-const u32 BANK_BACKGROUND_MAP = 24;
+const u32 BANK_BACKGROUND_MAP = 24;  // (videos also use 25)
 const u32 ALPHA_BLINK_LEVEL = 10;
 const u32 PIXEL_BLINK_LEVEL = 2;
 const u32 PIXEL_BLINK_ACTION_LEVEL = 6;
 const u32 IO_BLINK_TIME = 6;
 const u32 LIFEBAR_CHARBLOCK = 4;
-const u32 LIFEBAR_TILE_START = 0;
-const u32 LIFEBAR_TILE_END = 15;
+const u32 LIFEBAR_EMPTY_TILES = 16;  // (blanked outside VS)
+const u32 CHARBLOCK_TILES = 256;     // (8bpp)
 const u32 SEEK_ANTICIPATION_LEVEL = 6;
 const u32 SEEK_SPEED_FRAMES = 5;
+const u32 SEEK_UPDATES_PER_SLICE = 48;
 const u32 BOUNCE_STEPS[] = {0, 1, 2, 4, 5,
                             8, 7, 5, 3, 0};  // <~>ALPHA_BLINK_LEVEL
+const int JUMP_VS_END_POSITION = 24;  // (the fields can't overlap)
+const u8 PLAYER_IDS[GAME_MAX_PLAYERS] = {0, 1};
 
 static std::unique_ptr<Darkener> darkener{
     new Darkener(DARKENER_ID, DARKENER_PRIORITY)};
@@ -86,8 +93,25 @@ SongScene::SongScene(std::shared_ptr<GBAEngine> engine,
   this->deathMix = std::move(deathMix);
   this->rewindState = rewindState;
   this->rewindState.isRewinding = false;
+
+  // (only uninterrupted single-player songs with keypad input are recorded)
+  bool canRecord = this->deathMix == NULL && rewindState.rewindPoint == 0 &&
+                   !isMultiplayer() &&
+                   !SAVEFILE_read8(SRAM->adminSettings.ps2Input);
+  if (canRecord)
+    REPLAY_begin(song, chart);
+  else
+    REPLAY_stop();
 }
 
+enum PreloadStep {
+  PRELOAD_CONFIG,
+  PRELOAD_ARROWS,
+  PRELOAD_GAME,
+  PRELOAD_SEEK,
+  PRELOAD_DONE
+};
+
 std::vector<Background*> SongScene::backgrounds() {
 #ifdef SENV_DEBUG
   return {};
@@ -100,39 +124,47 @@ std::vector<Background*> SongScene::backgrounds() {
 
 std::vector<Sprite*> SongScene::sprites() {
   std::vector<Sprite*> sprites;
+  PLAYFIELD_reset();
+  auto add = [&sprites](Sprite* sprite, PlayfieldLayer layer,
+                        const u8* playerId) {
+    PLAYFIELD_add(sprite, layer, playerId);
+    sprites.push_back(sprite);
+  };
 
   for (u32 playerId = 0; playerId < playerCount; playerId++)
-    sprites.push_back(lifeBars[playerId]->get());
+    add(lifeBars[playerId]->get(), PLAYFIELD_BASE, &PLAYER_IDS[playerId]);
 
   for (u32 playerId = 0; playerId < playerCount; playerId++)
-    sprites.push_back(scores[playerId]->getFeedback()->get());
+    add(scores[playerId]->getFeedback()->get(), PLAYFIELD_SCORE,
+        &PLAYER_IDS[playerId]);
   for (u32 playerId = 0; playerId < playerCount; playerId++)
-    sprites.push_back(scores[playerId]->getCombo()->getTitle()->get());
+    add(scores[playerId]->getCombo()->getTitle()->get(), PLAYFIELD_SCORE,
+        &PLAYER_IDS[playerId]);
   for (u32 i = 0; i < COMBO_DIGITS; i++) {
     for (u32 playerId = 0; playerId < playerCount; playerId++)
-      sprites.push_back(
-          scores[playerId]->getCombo()->getDigits()->at(i)->get());
+      add(scores[playerId]->getCombo()->getDigits()->at(i)->get(),
+          PLAYFIELD_SCORE, &PLAYER_IDS[playerId]);
   }
 
   for (u32 i = 0; i < fakeHeads.size(); i++) {
     fakeHeads[i]->index = sprites.size();
-    sprites.push_back(fakeHeads[i]->get());
+    add(fakeHeads[i]->get(), PLAYFIELD_BASE, &fakeHeads[i]->playerId);
   }
 
-  arrowPool->forEach([&sprites](Arrow* it) {
-    it->index = sprites.size();
-    sprites.push_back(it->get());
-  });
+  if (arrowPool != NULL)
+    arrowPool->forEach([&sprites, &add](Arrow* it) {
+      it->index = sprites.size();
+      add(it->get(), PLAYFIELD_ARROWS, &it->playerId);
+    });
 
   for (auto& it : arrowHolders)
-    sprites.push_back(it->get());
+    add(it->get(), PLAYFIELD_HOLDERS, &it->playerId);
 
+  SPRITE_TILES_assign(sprites);
   return sprites;
 }
 
 void SongScene::load() {
-  setUpGameConfig();
-
   if (isMultiplayer()) {
     syncer->resetSongState();
     syncer->$isPlayingSong = true;
@@ -142,40 +174,46 @@ void SongScene::load() {
 
   SCENE_init();
 
-  prepareVideo();
+  while (!preload())
+    ;
+
   setUpPalettes();
   setUpBackground();
-  setUpArrows();
-
-  pixelBlink = std::unique_ptr<PixelBlink>{new PixelBlink(PIXEL_BLINK_LEVEL)};
-
-  for (u32 playerId = 0; playerId < playerCount; playerId++)
-    lifeBars[playerId] = std::unique_ptr<LifeBar>{new LifeBar(playerId)};
-
-  for (u32 playerId = 0; playerId < playerCount; playerId++)
-    scores[playerId] = std::unique_ptr<Score>{new Score(
-        lifeBars[playerId].get(), playerId, $isVs, playerId == localPlayerId)};
-
-  judge = std::unique_ptr<Judge>{
-      new Judge(arrowPool.get(), &arrowHolders, &scores,
-                [this](u8 playerId) { onStageBreak(playerId); })};
+}
 
-  int audioLag = GameState.settings.audioLag;
-  int globalOffset = (int)SAVEFILE_read32(SRAM->globalOffset);
-  u32 multiplier =
-      deathMix != NULL ? deathMix->multiplier : GameState.mods.multiplier;
-  for (u32 playerId = 0; playerId < playerCount; playerId++)
-    chartReaders[playerId] = std::unique_ptr<ChartReader>{
-        new ChartReader(playerId == localPlayerId ? chart : remoteChart,
-                        playerId, arrowPool.get(), judge.get(),
-                        pixelBlink.get(), audioLag, globalOffset, multiplier)};
+bool SongScene::preload() {
+  switch (preloadStep) {
+    case PRELOAD_CONFIG: {
+      setUpGameConfig();
+      prepareVideo();
+      break;
+    }
+    case PRELOAD_ARROWS: {
+      setUpArrows();
+      break;
+    }
+    case PRELOAD_GAME: {
+      setUpGame();
+
+      if (rewindState.rewindPoint > 0)
+        startSeek(rewindState.rewindPoint);
+      else if (deathMix != NULL)
+        startSeek(song->sampleStart);
+      else
+        preloadStep++;  // (no seek needed)
+      break;
+    }
+    case PRELOAD_SEEK: {
+      if (!advanceSeek())
+        return false;
+      break;
+    }
+    default:
+      return true;
+  }
 
-  startInput = std::unique_ptr<InputHandler>{new InputHandler()};
-  selectInput = std::unique_ptr<InputHandler>{new InputHandler()};
-  aInput = std::unique_ptr<InputHandler>{new InputHandler()};
-  bInput = std::unique_ptr<InputHandler>{new InputHandler()};
-  rateDownPs2Input = std::unique_ptr<InputHandler>{new InputHandler()};
-  rateUpPs2Input = std::unique_ptr<InputHandler>{new InputHandler()};
+  preloadStep++;
+  return preloadStep == PRELOAD_DONE;
 }
 
 void SongScene::tick(u16 keys) {
@@ -193,13 +231,15 @@ void SongScene::tick(u16 keys) {
   }
 
   u32 songMsecs = PlaybackState.msecs;
+  u32 songMsecsFraction = PlaybackState.msecsFraction;
 
   if (PlaybackState.hasFinished || songMsecs >= song->lastMillisecond) {
     onStagePass();
     return;
   }
 
-  __qran_seed += (1 + keys) * REG_VCOUNT;
+  keys = REPLAY_process(keys);
+  __qran_seed += (1 + keys) * (1 + totalFrames);  // (replays need determinism)
   processKeys(keys);  // (*)
   if (engine->isTransitioning())
     return;  // (*) = (rewind => restart scene)
@@ -210,7 +250,8 @@ void SongScene::tick(u16 keys) {
       return;  // (*) = (onAbort, onStagePass, onStageBreak)
   }
 
-  bool isNewBeat = chartReaders[localPlayerId]->update((int)songMsecs);  // (*)
+  bool isNewBeat = chartReaders[localPlayerId]->update(
+      (int)songMsecs, songMsecsFraction);  // (*)
   if (engine->isTransitioning())
     return;  // (*) = (onStageBreak)
   if (isNewBeat) {
@@ -222,7 +263,8 @@ void SongScene::tick(u16 keys) {
     }
   }
   if ($isVs)
-    chartReaders[syncer->getRemotePlayerId()]->update((int)songMsecs);  // (*)
+    chartReaders[syncer->getRemotePlayerId()]->update(
+        (int)songMsecs, songMsecsFraction);  // (*)
   if (engine->isTransitioning())
     return;  // (*) = (onStageBreak)
 
@@ -238,6 +280,8 @@ void SongScene::tick(u16 keys) {
     return;  // (*) = (onStageBreak)
   updateScoresAndLifebars();
   updateRumble();
+  if (deathMix != NULL)
+    deathMix->prefetch();  // (so the next song starts without a gap)
 
   totalFrames++;
 
@@ -281,7 +325,15 @@ void SongScene::setUpPalettes() {
   foregroundPalette = std::unique_ptr<ForegroundPaletteManager>{
       new ForegroundPaletteManager(palette_songPal, sizeof(palette_songPal))};
 
-  if (!usesVideo)
+  if (usesVideo)
+    return;
+
+  auto staged = deathMix != NULL ? deathMix->getStagedBackground() : NULL;
+  if (staged != NULL)
+    backgroundPalette = std::unique_ptr<BackgroundPaletteManager>{
+        new BackgroundPaletteManager((COLOR*)staged[STAGED_PALETTE].data,
+                                     staged[STAGED_PALETTE].length)};
+  else
     backgroundPalette =
         BACKGROUND_loadPaletteFile(fs, song->backgroundPalettePath.c_str());
 }
@@ -293,9 +345,16 @@ void SongScene::setUpBackground() {
   if (usesVideo)
     return;
 
-  bg = BACKGROUND_loadBackgroundFiles(fs, song->backgroundTilesPath.c_str(),
-                                      song->backgroundMapPath.c_str(),
-                                      MAIN_BACKGROUND_ID);
+  auto staged = deathMix != NULL ? deathMix->getStagedBackground() : NULL;
+  if (staged != NULL)
+    bg = std::unique_ptr<Background>{new Background(
+        MAIN_BACKGROUND_ID, staged[STAGED_TILES].data,
+        staged[STAGED_TILES].length, staged[STAGED_MAP].data,
+        staged[STAGED_MAP].length, true)};
+  else
+    bg = BACKGROUND_loadBackgroundFiles(fs, song->backgroundTilesPath.c_str(),
+                                        song->backgroundMapPath.c_str(),
+                                        MAIN_BACKGROUND_ID);
   bg->useCharBlock(BANK_BACKGROUND_TILES);
   bg->useMapScreenBlock(BANK_BACKGROUND_MAP);
   bg->usePriority(MAIN_BACKGROUND_PRIORITY);
@@ -309,7 +368,7 @@ void SongScene::setUpArrows() {
   for (u32 i = 0; i < ARROWS_TOTAL * platformCount; i++) {
     auto direction = getDirectionFromIndex(i);
     auto arrowHolder = std::unique_ptr<ArrowHolder>{
-        new ArrowHolder(direction, getPlayerIdFromIndex(i), true)};
+        new ArrowHolder(direction, getPlayerIdFromIndex(i))};
     arrowHolder->get()->setPriority(ARROW_LAYER_BACK);
     arrowHolders.push_back(std::move(arrowHolder));
 
@@ -321,6 +380,40 @@ void SongScene::setUpArrows() {
   }
 }
 
+void SongScene::setUpGame() {
+  pixelBlink = std::unique_ptr<PixelBlink>{new PixelBlink(PIXEL_BLINK_LEVEL)};
+
+  for (u32 playerId = 0; playerId < playerCount; playerId++)
+    lifeBars[playerId] = std::unique_ptr<LifeBar>{new LifeBar(playerId)};
+
+  for (u32 playerId = 0; playerId < playerCount; playerId++)
+    scores[playerId] = std::unique_ptr<Score>{new Score(
+        lifeBars[playerId].get(), playerId, $isVs, playerId == localPlayerId)};
+
+  judge = std::unique_ptr<Judge>{
+      new Judge(arrowPool.get(), &arrowHolders, &scores,
+                [this](u8 playerId) { onStageBreak(playerId); })};
+
+  int audioLag = GameState.settings.audioLag;
+  int globalOffset = REPLAY_isPlaying()
+                         ? REPLAY_getHeader()->globalOffset
+                         : (int)SAVEFILE_read32(SRAM->globalOffset);
+  u32 multiplier =
+      deathMix != NULL ? deathMix->multiplier : GameState.mods.multiplier;
+  for (u32 playerId = 0; playerId < playerCount; playerId++)
+    chartReaders[playerId] = std::unique_ptr<ChartReader>{
+        new ChartReader(playerId == localPlayerId ? chart : remoteChart,
+                        playerId, arrowPool.get(), judge.get(),
+                        pixelBlink.get(), audioLag, globalOffset, multiplier)};
+
+  startInput = std::unique_ptr<InputHandler>{new InputHandler()};
+  selectInput = std::unique_ptr<InputHandler>{new InputHandler()};
+  aInput = std::unique_ptr<InputHandler>{new InputHandler()};
+  bInput = std::unique_ptr<InputHandler>{new InputHandler()};
+  rateDownPs2Input = std::unique_ptr<InputHandler>{new InputHandler()};
+  rateUpPs2Input = std::unique_ptr<InputHandler>{new InputHandler()};
+}
+
 void SongScene::initializeBackground() {
 #ifdef SENV_DEBUG
   BACKGROUND_setColor(0, 127);
@@ -328,7 +421,7 @@ void SongScene::initializeBackground() {
 #endif
 
   darkener->initialize(GameState.settings.backgroundType);
-  updateGameX();
+  updatePlayfield();
 
   if (GameState.mods.colorFilter != ColorFilter::NO_FILTER) {
     if (!usesVideo)
@@ -336,25 +429,20 @@ void SongScene::initializeBackground() {
     SCENE_applyColorFilter(pal_obj_bank, GameState.mods.colorFilter);
   }
 
-  if (!$isVs)
-    for (u32 i = LIFEBAR_TILE_START; i <= LIFEBAR_TILE_END; i++)
-      BACKGROUND_createSolidTile(LIFEBAR_CHARBLOCK, i, 0);
-}
-
-bool SongScene::initializeGame(u16 keys) {
-  if (rewindState.rewindPoint > 0) {
-    if (!rewindState.isInitializing) {
-      startSeek(rewindState.rewindPoint);
-      rewindState.isInitializing = true;
-      return false;
-    } else {
-      rewindState.isInitializing = false;
-      endSeek(rewindState.multiplier);
+  if (!$isVs) {
+    int tile = SPRITE_TILES_edit(lifeBars[0]->get());
+    for (u32 i = 0; tile >= 0 && i < LIFEBAR_EMPTY_TILES; i++) {
+      u32 id = tile + i;
+      BACKGROUND_createSolidTile(LIFEBAR_CHARBLOCK + id / CHARBLOCK_TILES,
+                                 id % CHARBLOCK_TILES, 0);
     }
   }
+}
 
-  if (deathMix != NULL && deathMix->didStartScroll)
-    goto initialized;
+bool SongScene::initializeGame(u16 keys) {
+  // (the seek replay has already been done by `preload()`)
+  if (rewindState.rewindPoint > 0)
+    endSeek(rewindState.multiplier);
 
   if (GameState.mods.autoMod) {
     EFFECT_setMosaic(MAX_MOSAIC);
@@ -370,27 +458,20 @@ bool SongScene::initializeGame(u16 keys) {
     VBlankIntrWait();
   }
 
-initialized:
   if (deathMix != NULL) {
-    if (!deathMix->didStartScroll) {
-      if (!deathMix->isInitialSong()) {
-        scores[0]->setLife(deathMix->life);
-        scores[0]->getCombo()->setValue(deathMix->combo);
-        scores[0]->setHasMissCombo(deathMix->hasMissCombo);
-        scores[0]->setHalfLifeBonus(deathMix->halfLifeBonus);
-        scores[0]->setMaxCombo(deathMix->maxCombo);
-        scores[0]->setCounters(deathMix->counters);
-        scores[0]->setPoints(deathMix->points);
-        scores[0]->setLongNotes(deathMix->longNotes);
-        lifeBars[0]->tick(foregroundPalette.get());
-      }
-
-      startSeek(song->sampleStart);
-      deathMix->didStartScroll = true;
-      return false;
-    } else {
-      endSeek(deathMix->multiplier);
+    if (!deathMix->isInitialSong()) {
+      scores[0]->setLife(deathMix->life);
+      scores[0]->getCombo()->setValue(deathMix->combo);
+      scores[0]->setHasMissCombo(deathMix->hasMissCombo);
+      scores[0]->setHalfLifeBonus(deathMix->halfLifeBonus);
+      scores[0]->setMaxCombo(deathMix->maxCombo);
+      scores[0]->setCounters(deathMix->counters);
+      scores[0]->setPoints(deathMix->points);
+      scores[0]->setLongNotes(deathMix->longNotes);
+      lifeBars[0]->tick(foregroundPalette.get());
     }
+
+    endSeek(deathMix->multiplier);
   }
 
   if (shouldForceGSM()) {
@@ -438,11 +519,8 @@ initialized:
 }
 
 void SongScene::updateArrowHolders() {
-  int bounceOffset = -bounceDirection * BOUNCE_STEPS[blinkFrame] *
-                     (GameState.mods.bounce == BounceOpts::bALL);
-
   for (auto& it : arrowHolders)
-    it->tick(bounceOffset);
+    it->tick();
 }
 
 void SongScene::updateArrows() {
@@ -450,9 +528,6 @@ void SongScene::updateArrows() {
   for (u32 i = 0; i < ARROWS_TOTAL * GAME_MAX_PLAYERS; i++)
     nextArrows[i] = NULL;
 
-  int bounceOffset =
-      bounceDirection * BOUNCE_STEPS[blinkFrame] * !!GameState.mods.bounce;
-
   // trackers
   int judgementOffset[GAME_MAX_PLAYERS];
   bool isStopped[GAME_MAX_PLAYERS];
@@ -473,7 +548,7 @@ void SongScene::updateArrows() {
   }
 
   // update sprites
-  arrowPool->forEachActive([&nextArrows, &baseIndex, &bounceOffset, &isStopped,
+  arrowPool->forEachActive([&nextArrows, &baseIndex, &isStopped,
                             &judgementOffset, this](Arrow* arrow) {
     ArrowDirection direction = arrow->direction;
     u32 playerId = arrow->playerId;
@@ -483,7 +558,7 @@ void SongScene::updateArrows() {
     bool isPressing =
         arrowHolders[arrowBaseIndex + direction]->getIsPressed() &&
         !isStopped[playerId];
-    bool isEnding = arrow->tick(newY, isPressing, bounceOffset);
+    bool isEnding = arrow->tick(newY, isPressing);
 
     if (isEnding && !isStopped[playerId] &&
         judge->endIfNeeded(arrow, chartReaders[playerId].get())) {
@@ -575,20 +650,25 @@ void SongScene::updateScoresAndLifebars() {
     animateWinnerLifeBar();
 }
 
-void SongScene::updateGameX() {
-  lifeBars[0]->relocate();
-  scores[0]->relocate();
+void SongScene::updatePlayfield() {
+  int bounce = bounceDirection * BOUNCE_STEPS[blinkFrame];
+  int arrowsBounce = bounce * !!GameState.mods.bounce;
+  int holdersBounce = -bounce * (GameState.mods.bounce == BounceOpts::bALL);
+
+  for (u32 playerId = 0; playerId < playerCount; playerId++) {
+    int x = (playerId == 0 ? 1 : -1) * (jumpX - GameState.positionX[0]);
+    int y = reduceY;
+
+    PLAYFIELD_setOffset(playerId, PLAYFIELD_BASE, x, y);
+    PLAYFIELD_setOffset(playerId, PLAYFIELD_SCORE, x, 0);
+    PLAYFIELD_setOffset(playerId, PLAYFIELD_HOLDERS, x + holdersBounce, y);
+    PLAYFIELD_setOffset(playerId, PLAYFIELD_ARROWS, x + arrowsBounce, y);
+    chartReaders[playerId]->setFieldOffsetY(y);
+  }
 
   auto backgroundType = GameState.settings.backgroundType;
   if (backgroundType == BackgroundType::HALF_BGA_DARK)
-    darkener->setX(-GameState.positionX[0]);
-}
-
-void SongScene::updateGameY() {
-  lifeBars[0]->get()->moveTo(lifeBars[0]->get()->getX(),
-                             GameState.positionY + LIFEBAR_POSITION_Y);
-  for (auto& it : arrowHolders)
-    it->get()->moveTo(it->get()->getX(), ARROW_FINAL_Y());
+    darkener->setX(-jumpX);
 }
 
 void SongScene::updateRumble() {
@@ -660,6 +740,10 @@ void SongScene::prepareVideo() {
 void SongScene::drawVideo() {
   if (!usesVideo)
     return;
+  if (!videoStore->isPreRead() && videoStore->hasPendingFlip())
+    return;  // (the last frame isn't on screen yet, so it waits a frame)
+  if (videoStore->canRead() && !videoStore->requestRead())
+    return;
 
   if (videoStore->isPreRead()) {
     if (videoStore->canRead() && !videoStore->preRead()) {
@@ -673,27 +757,10 @@ void SongScene::drawVideo() {
       return;
     }
 
-    auto c1 = pal_bg_mem[254];
-    auto c2 = pal_bg_mem[255];
-    if (!videoStore->endRead((u8*)pal_bg_mem, 1)) {
-      throwVideoError();
-      return;
-    }
-    pal_bg_mem[254] = c1;
-    pal_bg_mem[255] = c2;
-
-    u32 backgroundTilesLength = VIDEO_SIZE_TILES / VIDEO_SECTOR;
-    u32 backgroundMapLength = VIDEO_SIZE_MAP / VIDEO_SECTOR;
-    Background background(MAIN_BACKGROUND_ID, NULL, backgroundTilesLength, NULL,
-                          backgroundMapLength);
-    background.useCharBlock(BANK_BACKGROUND_TILES);
-    background.useMapScreenBlock(BANK_BACKGROUND_MAP);
-    background.usePriority(MAIN_BACKGROUND_PRIORITY);
-    background.setMosaic(true);
-    bool success = true;
-    background.persistNow([&success](void* dst, u32 size) {
-      success = success && videoStore->endRead((u8*)dst, size);
-    });
+    bool success =
+        videoStore->endRead() &&
+        videoStore->decode(MAIN_BACKGROUND_ID, BANK_BACKGROUND_TILES,
+                           BANK_BACKGROUND_MAP, MAIN_BACKGROUND_PRIORITY);
 
     if (success) {
       BACKGROUND_enable(true, !ENV_DEBUG, false, false);
@@ -920,18 +987,25 @@ void SongScene::finishAndGoToEvaluation() {
 
   auto evaluation = scores[localPlayerId]->evaluate();
   bool isLastSong = false;
-
-  if (!$isMultiplayer || !lifeBars[localPlayerId]->getIsDead())
-    isLastSong = SAVEFILE_setGradeOf(song->index, chart->difficulty, song->id,
-                                     chart->levelIndex, evaluation->getGrade());
-
-  updateHighestLevel();
+  bool isReplay = REPLAY_isPlaying();
+  bool isReplayValid = REPLAY_finish(evaluation.get());
+  auto artist = isReplay ? (isReplayValid ? REPLAY_OK : REPLAY_MISMATCH)
+                         : std::string(song->artist);
+
+  if (!isReplay) {
+    if (!$isMultiplayer || !lifeBars[localPlayerId]->getIsDead())
+      isLastSong =
+          SAVEFILE_setGradeOf(song->index, chart->difficulty, song->id,
+                              chart->levelIndex, evaluation->getGrade());
+
+    updateHighestLevel();
+  }
   engine->transitionIntoScene(
       new DanceGradeScene(
           engine, fs, std::move(evaluation),
           $isVs ? scores[syncer->getRemotePlayerId()]->evaluate() : NULL,
-          std::string(song->title), std::string(song->artist),
-          buildLevelString(), $isVsDifferentLevels, isLastSong),
+          std::string(song->title), artist, buildLevelString(),
+          $isVsDifferentLevels, isLastSong),
       new PixelTransitionEffect());
 }
 
@@ -951,7 +1025,6 @@ void SongScene::continueDeathMix() {
   auto songChart = deathMix->getNextSongChart();
 
   if (songChart.song != NULL) {
-    deathMix->didStartScroll = false;
     deathMix->multiplier = chartReaders[0]->getMultiplier();
     deathMix->life = scores[0]->getLife();
     deathMix->combo = scores[0]->getCombo()->getValue() *
@@ -977,10 +1050,11 @@ void SongScene::continueDeathMix() {
     GameState.mods.stageBreak = stageBreak;
 #endif
 
-    engine->transitionIntoScene(
-        new SongScene(engine, fs, songChart.song, songChart.chart, NULL,
-                      std::move(deathMix)),
-        new PixelTransitionEffect(MAX_MOSAIC));
+    releaseArrows();
+    auto nextScene = new SongScene(engine, fs, songChart.song,
+                                   songChart.chart, NULL, std::move(deathMix));
+    engine->transitionIntoScene(nextScene,
+                                nextScene->createTransition(MAX_MOSAIC));
   } else {
     auto evaluation = scores[localPlayerId]->evaluate();
     auto grade = evaluation->getGrade();
@@ -1008,24 +1082,20 @@ void SongScene::continueDeathMix() {
 }
 
 void SongScene::processModsLoad() {
-  if ($isMultiplayer)
-    return;
-
   if (GameState.mods.pixelate == PixelateOpts::pFIXED ||
       GameState.mods.pixelate == PixelateOpts::pBLINK_OUT)
     targetMosaic = 3;
   else if (GameState.mods.pixelate == PixelateOpts::pBLINK_IN)
     targetMosaic = 0;
 
-  if (SAVEFILE_getGameMode() == GameMode::IMPOSSIBLE)
+  // (the song rate can't change in multiplayer: both devices share the audio)
+  if (!$isMultiplayer && SAVEFILE_getGameMode() == GameMode::IMPOSSIBLE)
     setRate(1);
 }
 
 void SongScene::processModsBeat() {
-  if ($isMultiplayer)
-    return;
-
-  if (GameState.mods.autoMod) {
+  // (random mod changes and speeds would differ between devices)
+  if (GameState.mods.autoMod && !$isMultiplayer) {
     autoModCounter++;
     if (autoModCounter == autoModDuration) {
       autoModCounter = 0;
@@ -1054,8 +1124,6 @@ void SongScene::processModsBeat() {
 
       mosaic = targetMosaic = 0;
       processModsLoad();
-      updateGameX();
-      updateGameY();
 
       if (GameState.mods.colorFilter != previousColorFilter)
         reapplyFilter(usesVideo, GameState.mods.colorFilter);
@@ -1074,57 +1142,51 @@ void SongScene::processModsBeat() {
   }
 
   if (GameState.mods.jump == JumpOpts::jRANDOM) {
-    int random = qran_range(0, GAME_POSITION_X[GamePosition::RIGHT] + 1);
-    GameState.positionX[0] = random;
-    updateGameX();
+    jumpX = qran_range(0, getJumpEndPosition() + 1);
     pixelBlink->blink();
   }
 
   if (GameState.mods.reduce == ReduceOpts::rRANDOM) {
     int random = qran_range(0, REDUCE_MOD_POSITION_Y);
-    GameState.positionY = REDUCE_MOD_POSITION_Y - random;
-    updateGameY();
+    reduceY = REDUCE_MOD_POSITION_Y - random;
     pixelBlink->blink();
   }
 
   if (GameState.mods.bounce != BounceOpts::bOFF)
     bounceDirection *= -1;
 
-  if (GameState.mods.speedHack == SpeedHackOpts::hRANDOM)
+  if (GameState.mods.speedHack == SpeedHackOpts::hRANDOM && !$isMultiplayer)
     chartReaders[0]->setMultiplier(qran_range(3, 6));
 }
 
 void SongScene::processModsTick() {
-  if ($isMultiplayer)
-    return;
-
   if (GameState.mods.jump == JumpOpts::jLINEAR) {
-    GameState.positionX[0] += jumpDirection * (1 + (blinkFrame / 2));
+    jumpX += jumpDirection * (1 + (blinkFrame / 2));
 
-    int endPosition = GAME_POSITION_X[GamePosition::RIGHT];
-    if (GameState.positionX[0] >= (int)endPosition ||
-        GameState.positionX[0] <= 0) {
-      GameState.positionX[0] = GameState.positionX[0] <= 0 ? 0 : endPosition;
+    int endPosition = getJumpEndPosition();
+    if (jumpX >= endPosition || jumpX <= 0) {
+      jumpX = jumpX <= 0 ? 0 : endPosition;
       jumpDirection *= -1;
     }
-
-    updateGameX();
   }
 
   if (GameState.mods.reduce == ReduceOpts::rLINEAR) {
-    GameState.positionY += reduceDirection * (1 + (blinkFrame / 2));
+    reduceY += reduceDirection * (1 + (blinkFrame / 2));
 
-    if (GameState.positionY >= REDUCE_MOD_POSITION_Y ||
-        GameState.positionY <= 0) {
-      GameState.positionY =
-          GameState.positionY <= 0 ? 0 : REDUCE_MOD_POSITION_Y;
+    if (reduceY >= REDUCE_MOD_POSITION_Y || reduceY <= 0) {
+      reduceY = reduceY <= 0 ? 0 : REDUCE_MOD_POSITION_Y;
       reduceDirection *= -1;
     }
-    updateGameY();
-  } else if (GameState.mods.reduce == ReduceOpts::rMICRO) {
-    GameState.positionY = BOUNCE_STEPS[blinkFrame];
-    updateGameY();
-  }
+  } else if (GameState.mods.reduce == ReduceOpts::rMICRO)
+    reduceY = BOUNCE_STEPS[blinkFrame];
+
+  updatePlayfield();
+}
+
+int SongScene::getJumpEndPosition() {
+  return $isDouble ? GAME_COOP_POSITION_X * 2
+         : $isVs   ? JUMP_VS_END_POSITION
+                   : GAME_POSITION_X[GamePosition::RIGHT];
 }
 
 u8 SongScene::processPixelateMod() {
@@ -1205,18 +1267,16 @@ void SongScene::processTrainingModeMod() {
     if (rewindState.rewindPoint > 0 && !rewindState.isSavingPoint) {
       rewindState.multiplier = chartReaders[0]->getMultiplier();
       rewindState.rate = rate;
-      rewindState.isInitializing = false;
       rewindState.isRewinding = true;
 
       unload();
-      for (u32 i = 0; i < chart->rhythmEventCount; i++)
-        chart->rhythmEvents[i].handled[0] = false;
-      for (u32 i = 0; i < chart->eventCount; i++)
-        chart->events[i].handled[0] = false;
-
-      engine->transitionIntoScene(
-          new SongScene(engine, fs, song, chart, NULL, NULL, rewindState),
-          new PixelTransitionEffect());
+      chart->rhythmEvents.reset();
+      chart->events.reset();
+      releaseArrows();
+
+      auto nextScene =
+          new SongScene(engine, fs, song, chart, NULL, NULL, rewindState);
+      engine->transitionIntoScene(nextScene, nextScene->createTransition());
     } else if (!rewindState.isSavingPoint) {
       rewindState.rewindPoint = PlaybackState.msecs;
       rewindState.isSavingPoint = true;
@@ -1362,10 +1422,28 @@ void SongScene::startSeek(u32 msecs) {
   auto speedHack = GameState.mods.speedHack;
   GameState.mods.speedHack = SpeedHackOpts::hFIXED_VELOCITY;
   chartReaders[0]->setMultiplier(SEEK_ANTICIPATION_LEVEL);
-  for (u32 t = 0; t < msecs; t += FRAME_MS * SEEK_SPEED_FRAMES)
-    chartReaders[0]->update(t);
-  chartReaders[0]->update(msecs);
   GameState.mods.speedHack = speedHack;
+
+  seekCursor = 0;
+  seekFrame = 0;
+  seekTarget = msecs;
+}
+
+bool SongScene::advanceSeek() {
+  auto speedHack = GameState.mods.speedHack;
+  GameState.mods.speedHack = SpeedHackOpts::hFIXED_VELOCITY;
+
+  for (u32 i = 0; i < SEEK_UPDATES_PER_SLICE && seekCursor < seekTarget; i++) {
+    chartReaders[0]->update(seekCursor);
+    seekFrame += SEEK_SPEED_FRAMES;
+    seekCursor = TIMING_framesToMsecs(seekFrame);
+  }
+  bool isDone = seekCursor >= seekTarget;
+  if (isDone)
+    chartReaders[0]->update(seekTarget);
+
+  GameState.mods.speedHack = speedHack;
+  return isDone;
 }
 
 void SongScene::endSeek(u32 multiplier) {
@@ -1411,7 +1489,18 @@ void SongScene::unload() {
     IOPORT_low();
 }
 
+void SongScene::releaseArrows() {
+  // (SongScene -> SongScene transitions preload the next scene while this one
+  // is still alive, so its arrow pool, the largest allocation, goes first)
+  for (auto& it : chartReaders)
+    it.reset();
+  judge.reset();
+  arrowPool.reset();
+  engine->updateSpritesInScene();
+}
+
 SongScene::~SongScene() {
+  PLAYFIELD_reset();
   arrowHolders.clear();
   fakeHeads.clear();
   if (!rewindState.isRewinding)
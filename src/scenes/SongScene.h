@@ -18,6 +18,7 @@
 #include "objects/base/InputHandler.h"
 #include "objects/score/Score.h"
 #include "utils/PixelBlink.h"
+#include "utils/PixelTransitionEffect.h"
 #include "utils/pool/ObjectPool.h"
 
 extern "C" {
@@ -28,7 +29,6 @@ struct RewindState {
   u32 rewindPoint = 0;
   u32 multiplier = 3;
   u32 rate = 1;
-  bool isInitializing = false;
   bool isRewinding = false;
   bool isSavingPoint = false;
 };
@@ -50,6 +50,13 @@ class SongScene : public Scene {
   void tick(u16 keys) override;
   void render() override;
 
+  // Runs one slice of the loading work. Returns true when the scene is ready.
+  // (it's called during the outgoing transition, and completed by `load()`)
+  bool preload();
+  PixelTransitionEffect* createTransition(u32 target = TARGET_MOSAIC) {
+    return new PixelTransitionEffect(target, [this]() { return preload(); });
+  }
+
   ~SongScene();
 
  private:
@@ -85,6 +92,8 @@ class SongScene : public Scene {
   u8 targetMosaic = 0;
   u8 mosaic = 0;
   bool waitMosaic = true;
+  int jumpX = 0;
+  int reduceY = 0;
   int jumpDirection = 1;
   int reduceDirection = 1;
   int bounceDirection = -1;
@@ -97,6 +106,10 @@ class SongScene : public Scene {
   u32 lastCenterKeys = 0;
   u32 totalFrames = 0;
   RewindState rewindState;
+  u32 preloadStep = 0;
+  u32 seekCursor = 0;
+  u32 seekFrame = 0;
+  u32 seekTarget = 0;
 
   inline void setUpGameConfig() {
     $isMultiplayer = isMultiplayer();
@@ -114,6 +127,10 @@ class SongScene : public Scene {
                          : 0;
     remoteBaseIndex = getBaseIndexFromPlayerId(syncer->getRemotePlayerId());
     localPlayerId = isVs() ? syncer->getLocalPlayerId() : 0;
+    jumpX = GameState.positionX[0];
+    reduceY = GameState.mods.reduce == ReduceOpts::rRANDOM
+                  ? REDUCE_MOD_POSITION_Y
+                  : 0;
 
     u8 rumbleOpts = SAVEFILE_read8(SRAM->adminSettings.rumbleOpts);
     rumbleTotalFrames = SAVEFILE_read8(SRAM->adminSettings.rumbleFrames);
@@ -142,6 +159,7 @@ class SongScene : public Scene {
   void setUpPalettes();
   void setUpBackground();
   void setUpArrows();
+  void setUpGame();
   void initializeBackground();
   bool initializeGame(u16 keys);
 
@@ -150,8 +168,7 @@ class SongScene : public Scene {
   void updateBlink();
   void updateFakeHeads();
   void updateScoresAndLifebars();
-  void updateGameX();
-  void updateGameY();
+  void updatePlayfield();
   void updateRumble();
   void animateWinnerLifeBar();
   void prepareVideo();
@@ -167,15 +184,18 @@ class SongScene : public Scene {
   void updateHighestLevel();
   void finishAndGoToEvaluation();
   void continueDeathMix();
+  void releaseArrows();
 
   void processModsLoad();
   void processModsTick();
+  int getJumpEndPosition();
   void processModsBeat();
   u8 processPixelateMod();
   void processTrainingModeMod();
   void processMultiplayerUpdates();
   bool setRate(int rate);
   void startSeek(u32 msecs);
+  bool advanceSeek();
   void endSeek(u32 previousMultiplier);
   bool seek(u32 msecs);
 
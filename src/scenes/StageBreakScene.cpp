@@ -26,7 +26,7 @@ const u32 PIXEL_BLINK_LEVEL = 2;
 
 #define WRITE(MSECS, TEXT, ROW, COL, DX, DY, SCALE_X, SCALE_Y)   \
   if (msecs > MSECS && step == totalSteps) {                     \
-    TextStream::instance().setText(TEXT, ROW, COL);              \
+    TEXT_write(TEXT, ROW, COL);                                  \
     instructor->get()->moveTo(instructor->get()->getX() + (DX),  \
                               instructor->get()->getY() + (DY)); \
     EFFECT_setScale(0, SCALE_X, SCALE_Y);                        \
@@ -37,7 +37,7 @@ const u32 PIXEL_BLINK_LEVEL = 2;
 
 #define CLEAR(MSECS)                         \
   if (msecs > MSECS && step == totalSteps) { \
-    TextStream::instance().clear();          \
+    TEXT_clear();                            \
     step++;                                  \
   }                                          \
   totalSteps++;
@@ -57,6 +57,7 @@ std::vector<Sprite*> StageBreakScene::sprites() {
 
   sprites.push_back(instructor->get());
 
+  SPRITE_TILES_assign(sprites);
   return sprites;
 }
 
@@ -100,6 +100,7 @@ std::vector<Sprite*> StartScene::sprites() {
   for (auto& it : arrowHolders)
     sprites.push_back(it->get());
 
+  SPRITE_TILES_assign(sprites);
   return sprites;
 }
 
@@ -180,15 +181,15 @@ void StartScene::setUpBackground() {
 
 void StartScene::setUpInputs() {
   inputs.push_back(std::unique_ptr<ArrowSelector>{
-      new ArrowSelector(ArrowDirection::DOWNLEFT, false, true)});
+      new ArrowSelector(ArrowDirection::DOWNLEFT, true)});
   inputs.push_back(std::unique_ptr<ArrowSelector>{
-      new ArrowSelector(ArrowDirection::DOWNRIGHT, true, true)});
+      new ArrowSelector(ArrowDirection::DOWNRIGHT, true)});
   inputs.push_back(std::unique_ptr<ArrowSelector>{
-      new ArrowSelector(ArrowDirection::CENTER, true, true)});
+      new ArrowSelector(ArrowDirection::CENTER, true)});
   inputs.push_back(std::unique_ptr<ArrowSelector>{
-      new ArrowSelector(ArrowDirection::CENTER, true, true)});
+      new ArrowSelector(ArrowDirection::CENTER, true)});
   inputs.push_back(std::unique_ptr<ArrowSelector>{
-      new ArrowSelector(ArrowDirection::CENTER, true, true)});
+      new ArrowSelector(ArrowDirection::CENTER, true)});
 
   animateInputs(0);
 }
@@ -196,34 +197,34 @@ void StartScene::setUpInputs() {
 void StartScene::setUpButtons() {
   buttons.push_back(std::unique_ptr<Button>{
       new Button(ButtonType::BLUE, BUTTONS_X[BUTTON_PLAY],
-                 BUTTONS_Y[BUTTON_PLAY], false)});
+                 BUTTONS_Y[BUTTON_PLAY])});
   buttons.push_back(std::unique_ptr<Button>{
       new Button(ButtonType::SUB_BUTTON_BLUE, BUTTONS_X[SUBBUTTON_CAMPAIGN],
-                 BUTTONS_Y[SUBBUTTON_CAMPAIGN], false)});
+                 BUTTONS_Y[SUBBUTTON_CAMPAIGN])});
   buttons.push_back(std::unique_ptr<Button>{
       new Button(ButtonType::SUB_BUTTON_BLUE, BUTTONS_X[SUBBUTTON_STATS],
-                 BUTTONS_Y[SUBBUTTON_STATS], false)});
+                 BUTTONS_Y[SUBBUTTON_STATS])});
   buttons.push_back(std::unique_ptr<Button>{
       new Button(ButtonType::GRAY, BUTTONS_X[BUTTON_ARCADE],
-                 BUTTONS_Y[BUTTON_ARCADE], true)});
+                 BUTTONS_Y[BUTTON_ARCADE])});
   buttons.push_back(std::unique_ptr<Button>{
       new Button(ButtonType::SUB_BUTTON_GRAY, BUTTONS_X[SUBBUTTON_MULTI_VS],
-                 BUTTONS_Y[SUBBUTTON_MULTI_VS], false)});
+                 BUTTONS_Y[SUBBUTTON_MULTI_VS])});
   buttons.push_back(std::unique_ptr<Button>{
       new Button(ButtonType::SUB_BUTTON_GRAY, BUTTONS_X[SUBBUTTON_SINGLE],
-                 BUTTONS_Y[SUBBUTTON_SINGLE], true)});
+                 BUTTONS_Y[SUBBUTTON_SINGLE])});
   buttons.push_back(std::unique_ptr<Button>{
       new Button(ButtonType::SUB_BUTTON_GRAY, BUTTONS_X[SUBBUTTON_MULTI_COOP],
-                 BUTTONS_Y[SUBBUTTON_MULTI_COOP], true)});
+                 BUTTONS_Y[SUBBUTTON_MULTI_COOP])});
   buttons.push_back(std::unique_ptr<Button>{
       new Button(ButtonType::ORANGE, BUTTONS_X[BUTTON_CHALLENGES],
-                 BUTTONS_Y[BUTTON_CHALLENGES], true)});
+                 BUTTONS_Y[BUTTON_CHALLENGES])});
   buttons.push_back(std::unique_ptr<Button>{
       new Button(ButtonType::SUB_BUTTON_ORANGE, BUTTONS_X[SUBBUTTON_IMPOSSIBLE],
-                 BUTTONS_Y[SUBBUTTON_IMPOSSIBLE], true)});
+                 BUTTONS_Y[SUBBUTTON_IMPOSSIBLE])});
   buttons.push_back(std::unique_ptr<Button>{
       new Button(ButtonType::SUB_BUTTON_ORANGE, BUTTONS_X[SUBBUTTON_DEATHMIX],
-                 BUTTONS_Y[SUBBUTTON_DEATHMIX], true)});
+                 BUTTONS_Y[SUBBUTTON_DEATHMIX])});
 
   buttons[SUBBUTTON_CAMPAIGN]->hide();
   buttons[SUBBUTTON_STATS]->hide();
@@ -274,7 +275,7 @@ void StartScene::setUpGameAnimation() {
 
   for (u32 i = 0; i < ARROWS_TOTAL; i++) {
     arrowHolders.push_back(std::unique_ptr<ArrowHolder>{
-        new ArrowHolder(static_cast<ArrowDirection>(i), 0, true)});
+        new ArrowHolder(static_cast<ArrowDirection>(i), 0)});
     arrowHolders[i]->setIsPressed(false);
   }
 }
@@ -382,7 +383,7 @@ void StartScene::updateExpandedOrCollapsedButtons() {
 void StartScene::printTitle() {
   TextStream::instance().setFontColor(TEXT_COLOR);
   TextStream::instance().setFontSubcolor(text_bg_palette_default_subcolor);
-  TextStream::instance().clear();
+  TEXT_clear();
 
   SCENE_write(std::string((char*)gbfs_get_obj(fs, ROM_NAME_FILE, NULL)), 0);
   SCENE_write(ENV_ARCADE && selectedMode == SUBBUTTON_DEATHMIX
@@ -5,6 +5,7 @@
 #include "data/content/_compiled_sprites/palette_selection.h"
 #include "gameplay/Key.h"
 #include "gameplay/Library.h"
+#include "gameplay/LibraryStats.h"
 #include "gameplay/save/SaveFile.h"
 #include "scenes/StartScene.h"
 #include "utils/SceneUtils.h"
@@ -36,6 +37,7 @@ std::vector<Sprite*> StatsScene::sprites() {
 
   sprites.push_back(selectButton->get());
 
+  SPRITE_TILES_assign(sprites);
   return sprites;
 }
 
@@ -48,7 +50,7 @@ void StatsScene::load() {
   pixelBlink = std::unique_ptr<PixelBlink>{new PixelBlink(PIXEL_BLINK_LEVEL)};
 
   selectButton = std::unique_ptr<ArrowSelector>{
-      new ArrowSelector(ArrowDirection::CENTER, false, true, true, true)};
+      new ArrowSelector(ArrowDirection::CENTER, true, true, true)};
 
   selectButton->get()->moveTo(SELECT_BUTTON_X,
                               GBA_SCREEN_HEIGHT - ARROW_SIZE - BUTTON_MARGIN);
@@ -249,39 +251,48 @@ std::string StatsScene::getCampaignSClearProgress() {
 }
 
 StatsScene::ArcadePercentages StatsScene::getArcadeProgress() {
-  std::vector<std::unique_ptr<SongFile>> songFiles;
-  auto library = std::unique_ptr<Library>{new Library(fs)};
   u32 librarySize = SAVEFILE_getLibrarySize();
-  u32 pages =
-      Div(librarySize, PAGE_SIZE) + (DivMod(librarySize, PAGE_SIZE) > 0);
-  for (u32 i = 0; i < pages; i++)
-    library->loadSongs(songFiles, DifficultyLevel::CRAZY, i * PAGE_SIZE);
-
   u32 totalSingle = 0, completedSingle = 0;
   u32 totalDouble = 0, completedDouble = 0;
 
-  for (u32 i = 0; i < songFiles.size(); i++) {
-    Song* song = SONG_parse(fs, songFiles[i].get());
-
-    u32 songTotalSingle = 0;
-    u32 songTotalDouble = 0;
-
-    for (u32 j = 0; j < song->chartCount; j++) {
-      if (song->charts[j].type == ChartType::SINGLE_CHART) {
-        if (ARCADE_readSingle(song->id, songTotalSingle) < GradeType::UNPLAYED)
-          completedSingle++;
-        songTotalSingle++;
-      } else {
-        if (ARCADE_readDouble(song->id, songTotalDouble) < GradeType::UNPLAYED)
-          completedDouble++;
-        songTotalDouble++;
-      }
+  auto addSong = [&](u8 songId, u32 singleCount, u32 doubleCount) {
+    for (u32 j = 0; j < singleCount; j++)
+      if (ARCADE_readSingle(songId, j) < GradeType::UNPLAYED)
+        completedSingle++;
+    for (u32 j = 0; j < doubleCount; j++)
+      if (ARCADE_readDouble(songId, j) < GradeType::UNPLAYED)
+        completedDouble++;
+
+    totalSingle += singleCount;
+    totalDouble += doubleCount;
+  };
+
+  u32 statsCount;
+  auto stats = LIBRARY_STATS_load(fs, &statsCount);
+  if (stats != NULL && statsCount >= librarySize) {
+    for (u32 i = 0; i < librarySize; i++)
+      addSong(i, stats[i].singleCount, stats[i].doubleCount);
+  } else {
+    // (ROMs imported without stats: parse every song)
+    std::vector<SongFile> songFiles;
+    auto library = std::unique_ptr<Library>{new Library(fs)};
+    u32 pages =
+        Div(librarySize, PAGE_SIZE) + (DivMod(librarySize, PAGE_SIZE) > 0);
+    for (u32 i = 0; i < pages; i++)
+      library->loadSongs(songFiles, DifficultyLevel::CRAZY, i * PAGE_SIZE);
+
+    for (u32 i = 0; i < songFiles.size(); i++) {
+      Song* song = SONG_parse(fs, &songFiles[i]);
+      if (song == NULL)
+        continue;
+
+      u32 singleCount = 0;
+      for (u32 j = 0; j < song->chartCount; j++)
+        singleCount += song->charts[j].type == ChartType::SINGLE_CHART;
+      addSong(song->id, singleCount, song->chartCount - singleCount);
+
+      SONG_free(song);
     }
-
-    totalSingle += songTotalSingle;
-    totalDouble += songTotalDouble;
-
-    SONG_free(song);
   }
 
   StatsScene::ArcadePercentages percentages;
@@ -320,11 +331,10 @@ void StatsScene::printFixedLine(std::string name,
                                 std::string value,
                                 u32 row,
                                 u32 extraSpace) {
-  TextStream::instance().setText(name, row, TEXT_COL_UNSELECTED);
+  TEXT_write(name.c_str(), row, TEXT_COL_UNSELECTED);
 
   if (value.length() > 0) {
     STRING_padLeft(value, 14 - extraSpace);
-    TextStream::instance().setText(value, row,
-                                   TEXT_COL_VALUE_MIDDLE - 8 + extraSpace);
+    TEXT_write(value.c_str(), row, TEXT_COL_VALUE_MIDDLE - 8 + extraSpace);
   }
 }
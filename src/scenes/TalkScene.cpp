@@ -10,6 +10,7 @@ std::vector<Sprite*> TalkScene::sprites() {
 
   sprites.push_back(confirmButton->get());
 
+  SPRITE_TILES_assign(sprites);
   return sprites;
 }
 
@@ -18,7 +19,7 @@ void TalkScene::load() {
   write(message);
 
   confirmButton = std::unique_ptr<ArrowSelector>{
-      new ArrowSelector(ArrowDirection::CENTER, false, true)};
+      new ArrowSelector(ArrowDirection::CENTER, true)};
   confirmButton->get()->moveTo(GBA_SCREEN_WIDTH - ARROW_SIZE - BUTTON_MARGIN,
                                GBA_SCREEN_HEIGHT - ARROW_SIZE - BUTTON_MARGIN);
 
@@ -2,6 +2,8 @@
 
 #include <libgba-sprite-engine/background/text_stream.h>
 
+#include <stdio.h>
+
 #include "data/content/_compiled_sprites/palette_selection.h"
 #include "gameplay/Key.h"
 #include "player/PlaybackState.h"
@@ -42,6 +44,7 @@ std::vector<Sprite*> MenuScene::sprites() {
   sprites.push_back(changeLeftButton->get());
   sprites.push_back(changeRightButton->get());
 
+  SPRITE_TILES_assign(sprites);
   return sprites;
 }
 
@@ -54,15 +57,15 @@ void MenuScene::load() {
   pixelBlink = std::unique_ptr<PixelBlink>{new PixelBlink(PIXEL_BLINK_LEVEL)};
 
   selectButton = std::unique_ptr<ArrowSelector>{
-      new ArrowSelector(ArrowDirection::CENTER, false, true, true, true)};
+      new ArrowSelector(ArrowDirection::CENTER, true, true, true)};
   backButton = std::unique_ptr<ArrowSelector>{
-      new ArrowSelector(ArrowDirection::DOWNLEFT, true, true, true, true)};
+      new ArrowSelector(ArrowDirection::DOWNLEFT, true, true, true)};
   nextButton = std::unique_ptr<ArrowSelector>{
-      new ArrowSelector(ArrowDirection::DOWNRIGHT, true, true, true, true)};
+      new ArrowSelector(ArrowDirection::DOWNRIGHT, true, true, true)};
   changeLeftButton = std::unique_ptr<ArrowSelector>{
-      new ArrowSelector(ArrowDirection::UPLEFT, true, true, true, true)};
+      new ArrowSelector(ArrowDirection::UPLEFT, true, true, true)};
   changeRightButton = std::unique_ptr<ArrowSelector>{
-      new ArrowSelector(ArrowDirection::UPRIGHT, true, true, true, true)};
+      new ArrowSelector(ArrowDirection::UPRIGHT, true, true, true)};
   closeInput = std::unique_ptr<InputHandler>{new InputHandler()};
 
   selectButton->get()->moveTo(SELECT_BUTTON_X,
@@ -105,24 +108,34 @@ void MenuScene::render() {
 }
 
 void MenuScene::printOption(u32 id,
-                            std::string name,
-                            std::string value,
+                            const char* name,
+                            const char* value,
                             u32 row,
                             bool highlightChange,
-                            std::string defaultValue) {
+                            const char* defaultValue) {
   bool isActive = selected == id;
-  TextStream::instance().setText(
-      std::string(isActive ? ">" : "") +
-          (highlightChange && value != defaultValue ? "* " : "") + name,
-      row, isActive ? TEXT_COL_SELECTED : TEXT_COL_UNSELECTED);
-
-  if (value.length() > 0) {
-    auto valueString = "<" + value + ">";
-    TextStream::instance().setText(
-        valueString, row, TEXT_COL_VALUE_MIDDLE - valueString.length() / 2);
+  bool isChanged = highlightChange && strcmp(value, defaultValue) != 0;
+  char line[TEXT_LINE_CELLS + 1];
+
+  snprintf(line, sizeof(line), "%s%s%s", isActive ? ">" : "",
+           isChanged ? "* " : "", name);
+  TEXT_write(line, row, isActive ? TEXT_COL_SELECTED : TEXT_COL_UNSELECTED);
+
+  if (value[0] != '\0') {
+    u32 length = snprintf(line, sizeof(line), "<%s>", value);
+    TEXT_write(line, row, TEXT_COL_VALUE_MIDDLE - length / 2);
   }
 }
 
+void MenuScene::printOption(u32 id,
+                            const char* name,
+                            const std::string& value,
+                            u32 row,
+                            bool highlightChange,
+                            const char* defaultValue) {
+  printOption(id, name, value.c_str(), row, highlightChange, defaultValue);
+}
+
 u8 MenuScene::change(u8 value, u8 optionsCount, int direction) {
   return direction >= 0 ? increment(value, optionsCount)
                         : decrement(value, optionsCount);
@@ -191,7 +204,7 @@ void MenuScene::processSelection() {
 void MenuScene::printMenu() {
   TextStream::instance().setFontColor(TEXT_COLOR);
   TextStream::instance().setFontSubcolor(text_bg_palette_default_subcolor);
-  TextStream::instance().clear();
+  TEXT_clear();
 
   printOptions();
 }
@@ -39,11 +39,17 @@ class MenuScene : public Scene {
   virtual void close();
 
   void printOption(u32 id,
-                   std::string name,
-                   std::string value,
+                   const char* name,
+                   const char* value,
                    u32 row,
                    bool highlightChange = false,
-                   std::string defaultValue = "");
+                   const char* defaultValue = "");
+  void printOption(u32 id,
+                   const char* name,
+                   const std::string& value,
+                   u32 row,
+                   bool highlightChange = false,
+                   const char* defaultValue = "");
   u8 change(u8 value, u8 optionsCount, int direction);
 
  private:
@@ -29,6 +29,7 @@ std::vector<Background*> TextScene::backgrounds() {
 std::vector<Sprite*> TextScene::sprites() {
   std::vector<Sprite*> sprites;
 
+  SPRITE_TILES_assign(sprites);
   return sprites;
 }
 
@@ -92,7 +93,7 @@ void TextScene::alignText() {
 
 void TextScene::autoWrite() {
   if (col == 0 && row == 0)
-    TextStream::instance().clear();
+    TEXT_clear();
 
   wait = !wait;
   if (wait || hasFinished())
@@ -100,7 +101,7 @@ void TextScene::autoWrite() {
 
   auto character = lines[row].substr(col, 1);
   if (character != "") {
-    TextStream::instance().setText(character, 2 + row * 2, col);
+    TEXT_write(character.c_str(), 2 + row * 2, col);
     col++;
     if (character == " ")
       wait = true;
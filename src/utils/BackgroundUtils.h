@@ -8,6 +8,8 @@
 
 #include <memory>
 
+#include "gameplay/library/LibraryStore.h"
+
 extern "C" {
 #include "utils/gbfs/gbfs.h"
 }
@@ -33,7 +35,7 @@ inline std::unique_ptr<BackgroundPaletteManager> BACKGROUND_loadPaletteFile(
     const char* fileName) {
   u32 backgroundPaletteLength;
   auto backgroundPaletteData =
-      (COLOR*)gbfs_get_obj(fs, fileName, &backgroundPaletteLength);
+      (COLOR*)libraryStore->getFile(fs, fileName, &backgroundPaletteLength);
 
   return std::unique_ptr<BackgroundPaletteManager>{new BackgroundPaletteManager(
       backgroundPaletteData, backgroundPaletteLength)};
@@ -47,11 +49,12 @@ inline std::unique_ptr<Background> BACKGROUND_loadBackgroundFiles(
     bool compressed = true) {
   u32 backgroundTilesLength, backgroundMapLength;
   auto backgroundTilesData =
-      gbfs_get_obj(fs, tilesFileName, &backgroundTilesLength);
-  auto backgroundMapData = gbfs_get_obj(fs, mapFileName, &backgroundMapLength);
+      libraryStore->getFile(fs, tilesFileName, &backgroundTilesLength);
+  auto backgroundMapData =
+      libraryStore->getFile(fs, mapFileName, &backgroundMapLength);
   if (backgroundMapData == NULL)
     backgroundMapData =
-        gbfs_get_obj(fs, UNIQUE_MAP_FILE_NAME, &backgroundMapLength);
+        libraryStore->getFile(fs, UNIQUE_MAP_FILE_NAME, &backgroundMapLength);
 
   return std::unique_ptr<Background>{
       new Background(bgIndex, backgroundTilesData, backgroundTilesLength,
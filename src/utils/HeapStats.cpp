@@ -0,0 +1,65 @@
+#include "HeapStats.h"
+
+#include <malloc.h>
+
+extern "C" {
+extern char __eheap_start[], __eheap_end[];
+
+void* __real_malloc(size_t size);
+void __real_free(void* ptr);
+void* __real_realloc(void* ptr, size_t size);
+void* __real_calloc(size_t count, size_t size);
+}
+
+static u32 current = 0;
+static u32 peak = 0;
+static u32 allocations = 0;
+
+inline void track(void* ptr) {
+  if (ptr == NULL)
+    return;
+
+  current += malloc_usable_size(ptr);
+  allocations++;
+  if (current > peak)
+    peak = current;
+}
+
+inline void untrack(void* ptr) {
+  if (ptr == NULL)
+    return;
+
+  current -= malloc_usable_size(ptr);
+  allocations--;
+}
+
+extern "C" {
+void* __wrap_malloc(size_t size) {
+  void* ptr = __real_malloc(size);
+  track(ptr);
+  return ptr;
+}
+
+void __wrap_free(void* ptr) {
+  untrack(ptr);
+  __real_free(ptr);
+}
+
+void* __wrap_realloc(void* ptr, size_t size) {
+  untrack(ptr);
+  void* newPtr = __real_realloc(ptr, size);
+  track(newPtr != NULL || size == 0 ? newPtr : ptr);  // (failed => unchanged)
+  return newPtr;
+}
+
+void* __wrap_calloc(size_t count, size_t size) {
+  void* ptr = __real_calloc(count, size);
+  track(ptr);
+  return ptr;
+}
+}
+
+HeapStats HEAP_STATS_get() {
+  return HeapStats{current, peak, (u32)(__eheap_end - __eheap_start),
+                   allocations};
+}
@@ -0,0 +1,17 @@
+#ifndef HEAP_STATS_H
+#define HEAP_STATS_H
+
+#include <libgba-sprite-engine/gba/tonc_core.h>
+
+typedef struct {
+  u32 current;      // (bytes in use right now)
+  u32 peak;         // (high-water mark since boot)
+  u32 limit;        // (EWRAM left for the heap after static data)
+  u32 allocations;  // (live blocks)
+} HeapStats;
+
+// malloc/free/realloc/calloc are wrapped at link time (see `LDFLAGS`), so
+// every `new`, `std::string` and `std::vector` allocation is counted.
+HeapStats HEAP_STATS_get();
+
+#endif  // HEAP_STATS_H
@@ -0,0 +1,37 @@
+#ifndef LZ77_H
+#define LZ77_H
+
+#include <libgba-sprite-engine/gba/tonc_core.h>
+
+#define LZ77_MIN_MATCH 3
+
+// Decompresses data in the GBA BIOS LZ77 format (type 0x10) and returns the
+// decompressed size. Unlike `LZ77UnCompWram`, the source doesn't need to be
+// aligned, and `*sourceLength` receives the number of bytes read, so blocks
+// can be stored back-to-back.
+inline u32 LZ77_decompress(const u8* source, u8* target, u32* sourceLength) {
+  u32 size = source[1] | (source[2] << 8) | (source[3] << 16);
+  const u8* data = source + 4;
+  u32 written = 0;
+
+  while (written < size) {
+    u8 flags = *data++;
+
+    for (u32 i = 0; i < 8 && written < size; i++, flags <<= 1) {
+      if (flags & 0x80) {
+        u32 length = (data[0] >> 4) + LZ77_MIN_MATCH;
+        u32 distance = (((data[0] & 0xf) << 8) | data[1]) + 1;
+        data += 2;
+
+        for (u32 j = 0; j < length && written < size; j++, written++)
+          target[written] = target[written - distance];
+      } else
+        target[written++] = *data++;
+    }
+  }
+
+  *sourceLength = data - source;
+  return size;
+}
+
+#endif  // LZ77_H
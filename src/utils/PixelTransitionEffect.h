@@ -4,6 +4,8 @@
 #include <libgba-sprite-engine/effects/scene_effect.h>
 #include <libgba-sprite-engine/scene.h>
 
+#include <functional>
+
 #include "utils/EffectUtils.h"
 #include "utils/SceneUtils.h"
 
@@ -13,22 +15,38 @@ void SCENE_init();
 
 class PixelTransitionEffect : public SceneEffect {
  public:
-  PixelTransitionEffect(u32 target = TARGET_MOSAIC) { this->target = target; };
+  PixelTransitionEffect(u32 target = TARGET_MOSAIC,
+                        std::function<bool()> preload = NULL) {
+    this->target = target;
+    pendingPreload = preload;
+  };
+
+  // Runs one slice of the incoming scene's loading work, if any.
+  // (it's called from the update loop, so it stays out of the VBlank window)
+  static void update() {
+    if (pendingPreload != NULL && pendingPreload())
+      pendingPreload = NULL;
+  }
 
   void render() override {
     EFFECT_setMosaic(value);
 
-    value++;
+    if (value < target)
+      value++;
 
     if (isDone())
       SCENE_init();
   }
 
-  bool isDone() override { return value >= target; }
+  bool isDone() override { return value >= target && pendingPreload == NULL; }
 
  private:
   u32 value = 0;
   u32 target = TARGET_MOSAIC;
+
+  // (static because the engine deletes effects through `SceneEffect*`, which
+  // has no virtual destructor)
+  static inline std::function<bool()> pendingPreload = NULL;
 };
 
 #endif  // PIXEL_TRANSITION_EFFECT_H
@@ -4,12 +4,15 @@
 #include <libgba-sprite-engine/background/text_stream.h>
 #include <libgba-sprite-engine/gba/tonc_types.h>
 
+#include <string.h>
 #include <string>
 
 #include "BackgroundUtils.h"
 #include "EffectUtils.h"
 #include "PixelTransitionEffect.h"
+#include "SpriteTiles.h"
 #include "SpriteUtils.h"
+#include "TextUtils.h"
 #include "utils/IOPort.h"
 #include "utils/Rumble.h"
 
@@ -21,7 +24,7 @@ extern "C" {
 const u32 TEXT_MIDDLE_COL = 12;
 const u32 TEXT_TOTAL_COLS = 30;
 
-enum ColorFilter {
+enum ColorFilter : u8 {
   NO_FILTER,
   VIBRANT,
   CONTRAST,
@@ -51,11 +54,15 @@ inline void SCENE_init() {
   EFFECT_render();
   TextStream::instance().scrollNow(0, 0);
   TextStream::instance().setMosaic(false);
+  TEXT_reset();
 }
 
-inline void SCENE_write(std::string text, u32 row) {
-  TextStream::instance().setText(text, row,
-                                 TEXT_MIDDLE_COL - text.length() / 2);
+inline void SCENE_write(const char* text, u32 row) {
+  TEXT_write(text, row, TEXT_MIDDLE_COL - strlen(text) / 2);
+}
+
+inline void SCENE_write(const std::string& text, u32 row) {
+  SCENE_write(text.c_str(), row);
 }
 
 COLOR SCENE_transformColor(COLOR color, ColorFilter filter);
@@ -0,0 +1,278 @@
+#include "SpriteTiles.h"
+
+#include <libgba-sprite-engine/allocator.h>
+#include <libgba-sprite-engine/gba/tonc_core.h>
+
+#define TILE_SIZE 64  // (8bpp)
+#define TOTAL_TILES (32 * 1024 / TILE_SIZE)
+#define ENGINE_TILES_PER_TILE 2  // (the engine counts 4bpp tiles)
+#define NO_ENTRY 0xff
+
+typedef struct {
+  const void* data;  // (NULL = free entry)
+  u32 size;
+  u32 lastScene;
+  u16 tile;
+  u16 tiles;
+  u16 refs;
+  bool isEdited;  // (its tiles no longer match `data`)
+} SpriteTilesEntry;
+
+typedef struct {
+  Sprite* sprite;
+  const void* data;
+  u32 size;
+  u8 entry;
+} SpriteTilesAssignment;
+
+// (`tileIndex` is only written by `SpriteManager`, so it's reached from here)
+struct SpriteTileIndex : Sprite {
+  static constexpr u32 Sprite::*FIELD = &SpriteTileIndex::tileIndex;
+};
+
+static SpriteTilesEntry entries[SPRITE_TILES_MAX_ENTRIES];
+static SpriteTilesAssignment assignments[SPRITE_TILES_MAX_SPRITES];
+static u32 assignmentCount = 0;
+static bool isPending = false;
+static u32 scene = 0;
+
+inline u8* tileAddress(u32 tile) {
+  return (u8*)tile_mem[4] + tile * TILE_SIZE;
+}
+
+inline bool matches(SpriteTilesEntry& entry, const void* data, u32 size) {
+  return entry.data == data && entry.size == size && !entry.isEdited;
+}
+
+inline bool overlaps(SpriteTilesEntry& entry, u32 tile, u32 tiles) {
+  return entry.tile < tile + tiles && tile < entry.tile + entry.tiles;
+}
+
+static int findSpace(u32 tiles) {
+  u32 tile = 0;
+
+  while (tile + tiles <= TOTAL_TILES) {
+    int blocker = -1;
+    for (u32 i = 0; i < SPRITE_TILES_MAX_ENTRIES; i++) {
+      if (entries[i].data != NULL && overlaps(entries[i], tile, tiles)) {
+        blocker = i;
+        break;
+      }
+    }
+    if (blocker == -1)
+      return tile;
+
+    tile = entries[blocker].tile + entries[blocker].tiles;
+  }
+
+  return -1;
+}
+
+static bool compact() {
+  bool didMove = false;
+  u32 cursor = 0;
+
+  while (true) {
+    int next = -1;
+    for (u32 i = 0; i < SPRITE_TILES_MAX_ENTRIES; i++) {
+      if (entries[i].data != NULL && entries[i].tile >= cursor &&
+          (next == -1 || entries[i].tile < entries[next].tile))
+        next = i;
+    }
+    if (next == -1)
+      break;
+
+    auto& entry = entries[next];
+    if (entry.tile > cursor) {
+      // (moving down, so a forward copy is safe even if they overlap)
+      u32* target = (u32*)tileAddress(cursor);
+      u32* source = (u32*)tileAddress(entry.tile);
+      for (u32 i = 0; i < entry.tiles * TILE_SIZE / sizeof(u32); i++)
+        target[i] = source[i];
+      entry.tile = cursor;
+      didMove = true;
+    }
+    cursor += entry.tiles;
+  }
+
+  return didMove;
+}
+
+static int findOldestUnused() {
+  int oldest = -1;
+
+  for (u32 i = 0; i < SPRITE_TILES_MAX_ENTRIES; i++) {
+    // (entries claimed by the current scene are kept, see `assign`)
+    if (entries[i].data != NULL && entries[i].refs == 0 &&
+        entries[i].lastScene != scene &&
+        (oldest == -1 || entries[i].lastScene < entries[oldest].lastScene))
+      oldest = i;
+  }
+
+  return oldest;
+}
+
+static int findFreeEntry() {
+  for (u32 i = 0; i < SPRITE_TILES_MAX_ENTRIES; i++) {
+    if (entries[i].data == NULL)
+      return i;
+  }
+
+  int oldest = findOldestUnused();
+  if (oldest != -1)
+    entries[oldest].data = NULL;
+  return oldest;
+}
+
+static u8 acquire(const void* data, u32 size) {
+  if (data == NULL || size == 0)
+    return NO_ENTRY;
+
+  for (u32 i = 0; i < SPRITE_TILES_MAX_ENTRIES; i++) {
+    auto& entry = entries[i];
+    if (matches(entry, data, size)) {
+      entry.refs++;
+      entry.lastScene = scene;
+      return i;
+    }
+  }
+
+  int id = findFreeEntry();
+  if (id == -1)
+    return NO_ENTRY;
+
+  u32 tiles = (size + TILE_SIZE - 1) / TILE_SIZE;
+  int tile;
+  while ((tile = findSpace(tiles)) == -1) {
+    if (compact())
+      continue;
+
+    int oldest = findOldestUnused();
+    if (oldest == -1)
+      return NO_ENTRY;
+    entries[oldest].data = NULL;
+  }
+
+  dma3_cpy(tileAddress(tile), data, size);
+  entries[id] = SpriteTilesEntry{data, size, scene, (u16)tile, (u16)tiles, 1,
+                                  false};
+  return id;
+}
+
+static void restore() {
+  for (u32 i = 0; i < assignmentCount; i++) {
+    auto& assignment = assignments[i];
+    assignment.sprite->setData((void*)assignment.data);
+    assignment.sprite->setImageSize(assignment.size);
+  }
+
+  assignmentCount = 0;
+  isPending = false;
+}
+
+void SPRITE_TILES_assign(std::vector<Sprite*>& sprites) {
+  if (!isPending)
+    scene++;
+  restore();  // (nested `sprites()` calls assign more than once)
+  for (u32 i = 0; i < SPRITE_TILES_MAX_ENTRIES; i++) {
+    entries[i].refs = 0;
+    if (entries[i].isEdited)
+      entries[i].data = NULL;
+  }
+
+  // (tiles already in VRAM are claimed first, so uploads don't evict them)
+  for (auto sprite : sprites) {
+    for (u32 i = 0; i < SPRITE_TILES_MAX_ENTRIES; i++) {
+      if (matches(entries[i], sprite->getData(), sprite->getImageSize()))
+        entries[i].lastScene = scene;
+    }
+  }
+
+  const void* data = NULL;
+  u32 size = 0;
+  for (auto sprite : sprites) {
+    if (assignmentCount == SPRITE_TILES_MAX_SPRITES)
+      break;
+
+    if (sprite->getData() != NULL) {
+      data = sprite->getData();
+      size = sprite->getImageSize();
+    }
+
+    assignments[assignmentCount] = SpriteTilesAssignment{
+        sprite, sprite->getData(), sprite->getImageSize(), acquire(data, size)};
+
+    // (the engine can only reuse tiles after allocating something, so the
+    // first sprite reserves a tile without copying it)
+    sprite->setData(NULL);
+    sprite->setImageSize(assignmentCount == 0 ? TILE_SIZE : 0);
+    assignmentCount++;
+  }
+
+  isPending = assignmentCount > 0;
+}
+
+void SPRITE_TILES_commit() {
+  if (!isPending) {
+    if (Allocator::getAllocatedSprites() == 0)
+      return;
+
+    // (a scene was set without `SPRITE_TILES_assign(...)`, so the engine
+    // copied its tiles over ours)
+    for (u32 i = 0; i < SPRITE_TILES_MAX_ENTRIES; i++)
+      entries[i].data = NULL;
+    Allocator::free();
+    return;
+  }
+
+  for (u32 i = 0; i < assignmentCount; i++) {
+    auto& assignment = assignments[i];
+    if (assignment.entry == NO_ENTRY)
+      continue;
+
+    Sprite* sprite = assignment.sprite;
+    u32 tileIndex = entries[assignment.entry].tile * ENGINE_TILES_PER_TILE;
+    u32 frameTiles =
+        sprite->getWidth() * sprite->getHeight() * ENGINE_TILES_PER_TILE /
+        TILE_SIZE;
+    sprite->*SpriteTileIndex::FIELD = tileIndex;
+    sprite->oam.attr2 =
+        (sprite->oam.attr2 & OAM_TILE_OFFSET_CLEAR) |
+        ((tileIndex + sprite->getCurrentFrame() * frameTiles) &
+         OAM_TILE_OFFSET_NEW);
+  }
+
+  restore();
+  Allocator::free();
+}
+
+int SPRITE_TILES_edit(Sprite* sprite) {
+  u32 tile = sprite->getTileIndex() / ENGINE_TILES_PER_TILE;
+
+  for (u32 i = 0; i < SPRITE_TILES_MAX_ENTRIES; i++) {
+    auto& entry = entries[i];
+    if (entry.data != NULL && entry.refs > 0 && entry.tile == tile) {
+      entry.isEdited = true;
+      return tile;
+    }
+  }
+
+  return -1;
+}
+
+SpriteTilesStats SPRITE_TILES_getStats() {
+  SpriteTilesStats stats = {0, 0};
+
+  for (u32 i = 0; i < SPRITE_TILES_MAX_ENTRIES; i++) {
+    auto& entry = entries[i];
+    if (entry.data == NULL)
+      continue;
+
+    if (entry.refs > 0)
+      stats.used += entry.tiles * TILE_SIZE;
+    else
+      stats.cached += entry.tiles * TILE_SIZE;
+  }
+
+  return stats;
+}
@@ -0,0 +1,33 @@
+#ifndef SPRITE_TILES_H
+#define SPRITE_TILES_H
+
+#include <libgba-sprite-engine/sprites/sprite.h>
+
+#include <vector>
+
+const u32 SPRITE_TILES_MAX_ENTRIES = 64;
+const u32 SPRITE_TILES_MAX_SPRITES = 128;  // (OAM size)
+
+typedef struct {
+  u32 used;    // (bytes referenced by the current scene)
+  u32 cached;  // (bytes kept from previous scenes)
+} SpriteTilesStats;
+
+// Sprite tiles live in OBJ VRAM, keyed by tile data pointer and size, and stay
+// there across scenes. Sprites with the same data share them, and tiles that
+// the previous scene already uploaded aren't copied again.
+// Call `SPRITE_TILES_assign(...)` at the end of every `sprites()` and
+// `SPRITE_TILES_commit()` after the engine sets a scene. In between, sprites
+// are marked so the engine doesn't allocate or copy anything.
+// Sprites without data share the tiles of the previous one (like the engine).
+void SPRITE_TILES_assign(std::vector<Sprite*>& sprites);
+void SPRITE_TILES_commit();
+
+// Returns the first 8bpp tile of `sprite` in OBJ VRAM (`tile8_mem[4]`), after
+// `SPRITE_TILES_commit()`, so the scene can draw over it. Sprites sharing it
+// see the changes, and it's dropped on the next assign instead of being
+// reused as a copy of its data. Returns -1 if the sprite has no tiles.
+int SPRITE_TILES_edit(Sprite* sprite);
+SpriteTilesStats SPRITE_TILES_getStats();
+
+#endif  // SPRITE_TILES_H
@@ -29,9 +29,4 @@ inline void SPRITE_goToFrame(Sprite* sprite, int frame) {
   sprite->animateToFrame(frame);
 }
 
-inline void SPRITE_reuseTiles(Sprite* sprite) {
-  sprite->setData(NULL);
-  sprite->setImageSize(0);
-}
-
 #endif  // SPRITE_UTILS_H
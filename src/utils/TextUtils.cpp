@@ -0,0 +1,68 @@
+#include "TextUtils.h"
+
+#include <libgba-sprite-engine/background/text_stream.h>
+#include <libgba-sprite-engine/gba/tonc_math.h>
+#include <libgba-sprite-engine/gba/tonc_memmap.h>
+
+#include <string.h>
+
+#ifndef DATA_EWRAM
+#define DATA_EWRAM __attribute__((section(".ewram")))
+#endif
+
+const u32 TEXT_MAP_CELLS = TEXT_MAP_COLS * TEXT_MAP_ROWS;
+const int TEXT_COL_OFFSET = 3;  // (`TextStream` starts every row at cell 3)
+
+DATA_EWRAM static u16 cells[TEXT_MAP_CELLS];
+DATA_EWRAM static u16 screen[TEXT_MAP_CELLS];
+static u32 dirtyRows = 0;
+
+void TEXT_reset() {
+  memset(cells, 0, sizeof(cells));
+  memset(screen, 0, sizeof(screen));
+  dirtyRows = 0;
+}
+
+void TEXT_clear() {
+  memset(cells, 0, sizeof(cells));
+  dirtyRows = 0xffffffff;
+}
+
+void TEXT_write(const char* text, u32 row, int col) {
+  int start = (int)(row * TEXT_MAP_COLS) + col + TEXT_COL_OFFSET;
+  int length = strlen(text);
+  int end = start + max(length, (int)TEXT_LINE_CELLS);
+
+  for (int i = max(start, 0); i < min(end, (int)TEXT_MAP_CELLS); i++) {
+    u16 cell = i - start < length ? text[i - start] - CHAR_OFFSET_INDEX : 0;
+    if (cells[i] == cell)
+      continue;
+
+    cells[i] = cell;
+    dirtyRows |= 1u << (i / TEXT_MAP_COLS);
+  }
+}
+
+u32 TEXT_render() {
+  if (dirtyRows == 0)
+    return 0;
+
+  u16* map = (u16*)se_mem[TextStream::instance().getScreenBlock()];
+  u32 writtenCells = 0;
+
+  for (u32 row = 0; row < TEXT_MAP_ROWS; row++) {
+    if (!(dirtyRows & (1u << row)))
+      continue;
+
+    for (u32 i = row * TEXT_MAP_COLS; i < (row + 1) * TEXT_MAP_COLS; i++) {
+      if (cells[i] == screen[i])
+        continue;
+
+      map[i] = screen[i] = cells[i];
+      writtenCells++;
+    }
+  }
+
+  dirtyRows = 0;
+  return writtenCells;
+}
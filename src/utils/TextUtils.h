@@ -0,0 +1,19 @@
+#ifndef TEXT_UTILS_H
+#define TEXT_UTILS_H
+
+#include <libgba-sprite-engine/gba/tonc_core.h>
+
+const u32 TEXT_MAP_COLS = 32;
+const u32 TEXT_MAP_ROWS = 32;
+const u32 TEXT_LINE_CELLS = 32;  // (a write clears the rest of its 32 cells)
+
+// Scenes write into a copy of the text map and `TEXT_render()` uploads, on
+// VBlank, only the cells of the dirty rows that differ from the screen.
+// Reprinting a whole menu after each key press then costs a few cells.
+// Writes follow `TextStream::setText` (same rows, columns and padding).
+void TEXT_reset();  // (the engine clears the map when scenes change)
+void TEXT_clear();
+void TEXT_write(const char* text, u32 row, int col);
+u32 TEXT_render();  // (returns the number of written cells)
+
+#endif  // TEXT_UTILS_H
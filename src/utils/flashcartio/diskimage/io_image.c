@@ -0,0 +1,79 @@
+/*
+  io_image.c
+  Disk image backend for host builds
+*/
+
+#include "io_image.h"
+
+#ifdef FLASHCARTIO_DISK_IMAGE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "player/io_scheduler.h"
+
+#define SECTOR_SIZE 512
+
+typedef struct {
+  const char* name;
+  u32 commandUs;  // (per request)
+  u32 sectorUs;   // (per sector)
+} CardProfile;
+
+// (rough figures; refine them with the admin benchmark on real carts)
+static const CardProfile profiles[] = {{"everdrive", 250, 450},
+                                       {"ezflash", 1000, 1000}};
+
+static FILE* image = NULL;
+static FILE* trace = NULL;
+static const CardProfile* profile = NULL;
+static u32 elapsedUs = 0;
+
+static const char* const STREAM_NAMES[IO_STREAMS] = {"other", "audio",
+                                                     "video"};
+
+static u32 latencyOf(u32 count) {
+  return profile != NULL ? profile->commandUs + count * profile->sectorUs : 0;
+}
+
+static void onTrace(const IOTraceEntry* entry) {
+  fprintf(trace, "%u,%s,%u,%u,%u\n", entry->frame, STREAM_NAMES[entry->stream],
+          entry->sector, entry->count, latencyOf(entry->count));
+}
+
+bool _IMAGE_startUp(void) {
+  const char* path = getenv("FLASHCARTIO_IMAGE");
+  if (path == NULL || (image = fopen(path, "rb")) == NULL)
+    return false;
+
+  const char* card = getenv("FLASHCARTIO_IMAGE_CARD");
+  for (u32 i = 0; card != NULL && i < sizeof(profiles) / sizeof(*profiles);
+       i++) {
+    if (strcmp(card, profiles[i].name) == 0)
+      profile = &profiles[i];
+  }
+
+  const char* tracePath = getenv("FLASHCARTIO_TRACE");
+  if (tracePath != NULL && (trace = fopen(tracePath, "w")) != NULL) {
+    fprintf(trace, "frame,stream,sector,count,us\n");
+    io_scheduler_set_trace(onTrace);
+  }
+
+  return true;
+}
+
+bool _IMAGE_readSectors(u32 address, u32 count, void* buffer) {
+  elapsedUs += latencyOf(count);
+
+  if (fseek(image, (long)address * SECTOR_SIZE, SEEK_SET) != 0)
+    return false;
+
+  return fread(buffer, SECTOR_SIZE, count, image) == count;
+}
+
+u32 _IMAGE_getElapsedUs(void) {
+  return elapsedUs;
+}
+
+#endif
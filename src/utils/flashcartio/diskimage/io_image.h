@@ -0,0 +1,26 @@
+#ifndef IO_IMAGE_H
+#define IO_IMAGE_H
+
+#include <stdbool.h>
+
+// (the types of `../sys.h`, whose GBA registers host builds already have)
+#ifndef u8
+#define u8 unsigned char
+#define u16 unsigned short
+#define u32 unsigned int
+#endif
+
+// [!]
+// Serves sectors from a FAT disk image, for host builds
+// (-DFLASHCARTIO_DISK_IMAGE). Configured with environment variables:
+// - FLASHCARTIO_IMAGE: path of the image (required).
+// - FLASHCARTIO_IMAGE_CARD: `everdrive` or `ezflash`, to model its latency.
+// - FLASHCARTIO_TRACE: path of a CSV file that logs every sector request
+//   (frame, stream, sector, count, modeled microseconds).
+// Latency is only modeled (added up), not waited for.
+
+bool _IMAGE_startUp(void);
+bool _IMAGE_readSectors(u32 address, u32 count, void* buffer);
+u32 _IMAGE_getElapsedUs(void);
+
+#endif /* IO_IMAGE_H */
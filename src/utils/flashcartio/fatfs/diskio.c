@@ -3,6 +3,7 @@
 /*-----------------------------------------------------------------------*/
 
 #include "../flashcartio.h"
+#include "player/io_scheduler.h"  // [!]
 
 #include "ff.h" /* Obtains integer types */
 
@@ -29,5 +30,6 @@ DSTATUS disk_initialize(BYTE driveId) {
 /*-----------------------------------------------------------------------*/
 
 DRESULT disk_read(BYTE pdrv, BYTE* buff, LBA_t sector, UINT count) {
+  io_scheduler_account(count);  // [!]
   return flashcartio_read_sector(sector, buff, count) ? RES_OK : RES_ERROR;
 }
@@ -3911,7 +3911,13 @@ FRESULT f_open (
 /* Read File                                                             */
 /*-----------------------------------------------------------------------*/
 
-__attribute__((section(".iwram"), target("arm"), noinline)) FRESULT f_read (
+/* [!] (ARM code in IWRAM, except in host builds, see diskimage/io_image.h) */
+#ifdef FLASHCARTIO_DISK_IMAGE
+#define F_READ_ATTRIBUTES
+#else
+#define F_READ_ATTRIBUTES __attribute__((section(".iwram"), target("arm"), noinline))
+#endif
+F_READ_ATTRIBUTES FRESULT f_read (
 	FIL* fp, 	/* Open file to be read */
 	void* buff,	/* Data buffer to store the read data */
 	UINT btr,	/* Number of bytes to read */
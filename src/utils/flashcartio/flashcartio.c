@@ -1,16 +1,31 @@
 #include "flashcartio.h"
 
+#include <stdint.h>
+#include <string.h>
+
+#ifdef FLASHCARTIO_DISK_IMAGE
+#include "diskimage/io_image.h"  // [!]
+#else
 #include "everdrivegbax5/bios.h"
 #include "everdrivegbax5/disk.h"
 #include "ezflashomega/io_ezfo.h"
+#endif
 
 ActiveFlashcart active_flashcart = NO_FLASHCART;
 volatile bool flashcartio_is_reading = false;
 volatile bool flashcartio_needs_reset = false;  // [!]
 void (*flashcartio_reset_callback)(void) = 0;   // [!]
+void (*flashcartio_trace_callback)(u32 sector, u16 count) = 0;  // [!]
 
 // [!]
 ActivationResult flashcartio_activate(void) {
+#ifdef FLASHCARTIO_DISK_IMAGE
+  // Disk image (there's no cart to probe on the host)
+  if (_IMAGE_startUp()) {
+    active_flashcart = DISK_IMAGE;
+    return FLASHCART_ACTIVATED;
+  }
+#else
   // Everdrive GBA X5
   if (bi_init_sd_only()) {
     bi_init();
@@ -28,12 +43,21 @@ ActivationResult flashcartio_activate(void) {
     active_flashcart = EZ_FLASH_OMEGA;
     return FLASHCART_ACTIVATED;
   }
+#endif
 
   return NO_FLASHCART_FOUND;
 }
 
 bool flashcartio_read_sector(u32 sector, u8* destination, u16 count) {
+  if (flashcartio_trace_callback)  // [!]
+    flashcartio_trace_callback(sector, count);
+
   switch (active_flashcart) {
+#ifdef FLASHCARTIO_DISK_IMAGE
+    case DISK_IMAGE: {
+      return _IMAGE_readSectors(sector, count, destination);
+    }
+#else
     case EVERDRIVE_GBA_X5: {
       flashcartio_is_reading = true;
       bi_unlock_regs();
@@ -52,7 +76,52 @@ bool flashcartio_read_sector(u32 sector, u8* destination, u16 count) {
         flashcartio_reset_callback();
       return success;
     }
+#endif
     default:
       return false;
   }
 }
+
+// [!]
+// Multi-sector reads straight into the caller's buffer (both backends DMA in
+// 16-bit units, so VRAM works as long as it's 2-byte aligned). Misaligned
+// buffers are served one sector at a time through an aligned bounce buffer.
+// Consecutive reads on the same stream continue the open SD read command.
+static u8 bounce_buffer[FLASHCARTIO_SECTOR_SIZE]
+    __attribute__((section(".ewram"), aligned(4)));
+
+void flashcartio_stream_open(FlashcartStream* stream, unsigned int sector) {
+  stream->sector = sector;
+}
+
+bool flashcartio_stream_read(FlashcartStream* stream,
+                             void* destination,
+                             unsigned int count) {
+  u8* target = (u8*)destination;
+  bool isAligned = ((uintptr_t)target & 1) == 0;
+  bool isVRAM = ((uintptr_t)target & 0xFF000000) == 0x06000000;
+  if (!isAligned && isVRAM)
+    return false;  // (VRAM doesn't support byte writes)
+
+  while (count > 0) {
+    if (isAligned) {
+      u16 batch = count > FLASHCARTIO_MAX_BATCH ? FLASHCARTIO_MAX_BATCH : count;
+      if (!flashcartio_read_sector(stream->sector, target, batch))
+        return false;
+
+      stream->sector += batch;
+      target += batch * FLASHCARTIO_SECTOR_SIZE;
+      count -= batch;
+    } else {
+      if (!flashcartio_read_sector(stream->sector, bounce_buffer, 1))
+        return false;
+      memcpy(target, bounce_buffer, FLASHCARTIO_SECTOR_SIZE);
+
+      stream->sector++;
+      target += FLASHCARTIO_SECTOR_SIZE;
+      count--;
+    }
+  }
+
+  return true;
+}
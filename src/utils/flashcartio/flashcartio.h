@@ -4,21 +4,40 @@
 #include <stdbool.h>
 #include "fatfs/ff.h"
 
-typedef enum { NO_FLASHCART, EVERDRIVE_GBA_X5, EZ_FLASH_OMEGA } ActiveFlashcart;
+typedef enum {
+  NO_FLASHCART,
+  EVERDRIVE_GBA_X5,
+  EZ_FLASH_OMEGA,
+  DISK_IMAGE  // [!] (host builds, see diskimage/io_image.h)
+} ActiveFlashcart;
 typedef enum {
   FLASHCART_ACTIVATED,
   NO_FLASHCART_FOUND,
   FLASHCART_ACTIVATION_FAILED
 } ActivationResult;  // [!]
 
+// [!]
+#define FLASHCARTIO_SECTOR_SIZE 512
+#define FLASHCARTIO_MAX_BATCH 64
+typedef struct {
+  unsigned int sector;
+} FlashcartStream;
+
 extern ActiveFlashcart active_flashcart;
 extern volatile bool flashcartio_is_reading;
 extern volatile bool flashcartio_needs_reset;     // [!]
 extern void (*flashcartio_reset_callback)(void);  // [!]
+extern void (*flashcartio_trace_callback)(unsigned int sector,
+                                          unsigned short count);  // [!]
 
 ActivationResult flashcartio_activate(void);
 bool flashcartio_read_sector(unsigned int sector,
                              unsigned char* destination,
                              unsigned short count);
+void flashcartio_stream_open(FlashcartStream* stream,
+                             unsigned int sector);  // [!]
+bool flashcartio_stream_read(FlashcartStream* stream,
+                             void* destination,
+                             unsigned int count);  // [!]
 
 #endif  // FLASHCARTIO_H
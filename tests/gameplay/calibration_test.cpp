@@ -0,0 +1,143 @@
+#include <stdio.h>
+
+#include <vector>
+
+#include "gameplay/Calibration.h"
+#include "test.h"
+
+// Feeds synthetic tap sequences (ms, relative to each beat, like
+// `CalibrateScene` records them) to `CALIBRATION_estimate`:
+// - clean taps around a lag, with a few ms of jitter;
+// - the same with outliers (double taps, missed beats), which are rejected
+//   as long as most taps agree;
+// - taps spread wider than `CALIBRATION_MAX_SPREAD`;
+// - too few taps.
+
+#define TAPS 24  // (`TAPS_TOTAL` in `CalibrateScene`)
+
+static u32 seed = 1;
+
+static int nextRandom(int min, int max) {
+  seed = seed * 1103515245 + 12345;
+  return min + (int)((seed >> 16) % (u32)(max - min + 1));
+}
+
+static std::vector<int> createTaps(u32 count, int lag, int jitter) {
+  std::vector<int> taps;
+  for (u32 i = 0; i < count; i++)
+    taps.push_back(lag + nextRandom(-jitter, jitter));
+  return taps;
+}
+
+static CalibrationResult estimate(const std::vector<int>& taps) {
+  return CALIBRATION_estimate(taps.data(), taps.size());
+}
+
+static void testCleanTaps() {
+  const int lags[] = {-120, -25, 0, 40, 180};
+  for (int lag : lags) {
+    auto result = estimate(createTaps(TAPS, lag, 6));
+    CHECK_MSG(ABS(result.lag - lag) <= 3, "lag %d: got %d", lag, result.lag);
+    CHECK(result.spread <= 6);
+    CHECK(result.inliers == TAPS);
+    CHECK(result.isReliable);
+  }
+
+  // (identical taps)
+  auto result = estimate(std::vector<int>(TAPS, 33));
+  CHECK(result.lag == 33 && result.spread == 0 && result.isReliable);
+
+  printf("clean taps: %u lags, OK\n", (u32)(sizeof(lags) / sizeof(lags[0])));
+}
+
+static void testOutliers() {
+  const int outliers[] = {250, -240, 190, 120, -150, 230, -90, 160};
+
+  // (a quarter of the taps can be outliers)
+  auto taps = createTaps(TAPS - TAPS / 4, -25, 4);
+  for (u32 i = 0; i < TAPS / 4; i++)
+    taps.insert(taps.begin() + i * 3, outliers[i]);
+  auto result = estimate(taps);
+  CHECK_MSG(ABS(result.lag + 25) <= 2, "got %d", result.lag);
+  CHECK(result.spread <= 4);
+  CHECK(result.inliers == TAPS - TAPS / 4);
+  CHECK(result.isReliable);
+
+  // (a single outlier doesn't move the estimate)
+  auto clean = createTaps(TAPS, 60, 3);
+  auto withOutlier = clean;
+  withOutlier[TAPS / 2] = -250;
+  auto cleanResult = estimate(clean);
+  result = estimate(withOutlier);
+  CHECK(ABS(result.lag - cleanResult.lag) <= 1);
+  CHECK(result.inliers == TAPS - 1 && result.isReliable);
+
+  // (a third of the taps is too many)
+  taps = createTaps(TAPS - TAPS / 3, 10, 4);
+  for (u32 i = 0; i < TAPS / 3; i++)
+    taps.push_back(outliers[i]);
+  result = estimate(taps);
+  CHECK_MSG(ABS(result.lag - 10) <= 2, "got %d", result.lag);
+  CHECK(result.inliers == TAPS - TAPS / 3);
+  CHECK(!result.isReliable);
+
+  printf("outliers: %u rejected, OK\n", TAPS / 4);
+}
+
+static void testSpread() {
+  // (all taps agree with each other a bit, but not enough)
+  auto taps = createTaps(TAPS, 0, 60);
+  auto result = estimate(taps);
+  CHECK(result.inliers == TAPS);
+  CHECK_MSG(result.spread > CALIBRATION_MAX_SPREAD, "spread %u",
+            result.spread);
+  CHECK(!result.isReliable);
+
+  // (just inside the threshold)
+  taps.clear();
+  for (u32 i = 0; i < TAPS; i++)
+    taps.push_back(i % 2 == 0 ? 50 - (int)CALIBRATION_MAX_SPREAD
+                              : 50 + (int)CALIBRATION_MAX_SPREAD);
+  result = estimate(taps);
+  CHECK(result.lag == 50 && result.spread == CALIBRATION_MAX_SPREAD);
+  CHECK(result.isReliable);
+
+  // (and just outside)
+  for (u32 i = 0; i < TAPS; i++)
+    taps[i] += i % 2 == 0 ? -1 : 1;
+  result = estimate(taps);
+  CHECK(result.spread == CALIBRATION_MAX_SPREAD + 1 && !result.isReliable);
+
+  printf("spread: %u > %u, OK\n", estimate(createTaps(TAPS, 0, 60)).spread,
+         CALIBRATION_MAX_SPREAD);
+}
+
+static void testFewTaps() {
+  auto result = CALIBRATION_estimate(NULL, 0);
+  CHECK(result.lag == 0 && result.inliers == 0 && !result.isReliable);
+
+  for (u32 count = 1; count < CALIBRATION_MIN_TAPS; count++) {
+    result = estimate(std::vector<int>(count, 20));
+    CHECK(result.lag == 20 && result.spread == 0);
+    CHECK_MSG(!result.isReliable, "%u taps", count);
+  }
+  result = estimate(std::vector<int>(CALIBRATION_MIN_TAPS, 20));
+  CHECK(result.isReliable);
+
+  // (taps past `CALIBRATION_MAX_TAPS` are ignored)
+  auto taps = createTaps(CALIBRATION_MAX_TAPS, -40, 2);
+  for (u32 i = 0; i < CALIBRATION_MAX_TAPS; i++)
+    taps.push_back(300);
+  result = estimate(taps);
+  CHECK(ABS(result.lag + 40) <= 1 && result.inliers == CALIBRATION_MAX_TAPS);
+
+  printf("too few taps: fewer than %u, OK\n", CALIBRATION_MIN_TAPS);
+}
+
+int main() {
+  testCleanTaps();
+  testOutliers();
+  testSpread();
+  testFewTaps();
+  return 0;
+}
@@ -0,0 +1,203 @@
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gameplay/DifficultyLevelDeathMix.h"
+#include "gameplay/library/LibraryStore.h"
+#include "gameplay/models/Song.h"
+#include "gameplay/save/SaveFile.h"
+#include "gameplay/video/VideoStore.h"
+#include "host/fixture.h"
+#include "host/host.h"
+#include "test.h"
+
+extern "C" {
+#include "player/io_scheduler.h"
+}
+
+// Plays a two-song DeathMix from a host SD card library, only on the SD card:
+// while the first song plays, `DeathMix::prefetch` stages the second song's
+// background (tiles, map and palette) and metadata, a few sectors per frame.
+// Other library reads then churn through the whole cache, and the staged
+// files must still be resident: the transition (`getNextSongChart` and
+// `getStagedBackground`) reads nothing. The next song's `prefetch()` releases
+// them.
+
+#define SONGS_TOTAL 2
+#define SONG_EVENTS 8
+#define SONG_LAST_MILLISECOND 5000
+#define TILES_SIZE 24576
+#define MAP_SIZE 2048
+#define PALETTE_SIZE 512
+#define FILLERS 8  // (more than the cache, see `LIBRARY_CACHE_SIZE`)
+#define FILLER_SIZE 16384
+#define BIG_FILE "big.bin"  // (only fits in the cache without the background)
+#define BIG_FILE_SIZE 60000
+#define MAX_FRAMES 100
+
+static const char* SONGS[] = {"ALPHA", "BRAVO"};
+
+static u32 seed = 1;
+
+static u32 nextRandom(u32 max) {
+  seed = seed * 1103515245 + 12345;
+  return (seed >> 16) % max;
+}
+
+static std::vector<u8> createFile(std::string path, u32 size) {
+  std::vector<u8> data;
+  for (u32 i = 0; i < size; i++)
+    data.push_back(nextRandom(256));
+  FIXTURE_writeFile(path, data);
+  return data;
+}
+
+static u32 readSectors() {
+  return io_stats[IO_STREAM_OTHER].sectors;
+}
+
+static std::string fillerName(u32 i) {
+  return "filler" + std::to_string(i) + ".bin";
+}
+
+static void writeLibrary(std::string library) {
+  std::string list;
+  for (auto name : SONGS) {
+    if (!list.empty())
+      list += "\r\n";
+    u32 noteCount;
+    FIXTURE_writeSong(library, name, SONG_LAST_MILLISECOND,
+                      FIXTURE_createNotes(SONG_EVENTS, &noteCount));
+    createFile(library + name + BACKGROUND_TILES_EXTENSION, TILES_SIZE);
+    createFile(library + name + BACKGROUND_MAP_EXTENSION, MAP_SIZE);
+    createFile(library + name + BACKGROUND_PALETTE_EXTENSION, PALETTE_SIZE);
+    list += name;
+  }
+  FIXTURE_writeFile(library + PREFIX_CRAZY "0" SUFFIX_LIST,
+                    std::vector<u8>(list.begin(), list.end()));
+
+  for (u32 i = 0; i < FILLERS; i++)
+    createFile(library + fillerName(i), FILLER_SIZE);
+  createFile(library + BIG_FILE, BIG_FILE_SIZE);
+}
+
+static void checkFile(std::string library,
+                      std::string name,
+                      const void* data,
+                      u32 length) {
+  auto expected = FIXTURE_readFile(library + name);
+  CHECK_MSG(data != NULL, "%s isn't resident", name.c_str());
+  CHECK(length == expected.size());
+  CHECK_MSG(memcmp(data, expected.data(), length) == 0, "%s is corrupted",
+            name.c_str());
+}
+
+static void checkResident(std::string library, std::string name) {
+  u32 length = 0;
+  auto data = libraryStore->peekFile(find_first_gbfs_file(0), name.c_str(),
+                                     &length);
+  checkFile(library, name, data, length);
+}
+
+static void testStaging(std::string library) {
+  auto fs = find_first_gbfs_file(0);
+  auto deathMix = std::unique_ptr<DeathMix>{
+      new DifficultyLevelDeathMix(fs, DifficultyLevel::NORMAL)};
+
+  // (nothing was prefetched for the first song, so the scene reads it)
+  auto first = deathMix->getNextSongChart();
+  CHECK(first.song != NULL && deathMix->isInitialSong());
+  CHECK(deathMix->getStagedBackground() == NULL);
+  CHECK(libraryStore->getFile(fs, first.song->backgroundTilesPath.c_str(),
+                              NULL) != NULL);
+  CHECK(libraryStore->getFile(fs, first.song->backgroundMapPath.c_str(),
+                              NULL) != NULL);
+  CHECK(libraryStore->getFile(fs, first.song->backgroundPalettePath.c_str(),
+                              NULL) != NULL);
+  std::string nextName = first.song->audioPath == SONGS[0] ? SONGS[1]
+                                                           : SONGS[0];
+
+  // (the first song plays)
+  io_scheduler_reset_stats();
+  u32 frames = 0;
+  bool isDone = false;
+  while (!isDone && frames < MAX_FRAMES) {
+    io_scheduler_begin_frame();
+    u32 sectors = readSectors();
+    isDone = deathMix->prefetch();
+    CHECK_MSG(readSectors() - sectors <= LIBRARY_PRELOAD_SECTORS,
+              "frame %u read %u sectors", frames, readSectors() - sectors);
+    frames++;
+  }
+  CHECK(isDone);
+  u32 prefetchSectors = readSectors();
+  CHECK(prefetchSectors > 0);
+
+  // (other reads can't overwrite the staged files)
+  for (u32 i = 0; i < FILLERS; i++)
+    libraryStore->getFile(fs, fillerName(i).c_str(), NULL);
+  CHECK(readSectors() - prefetchSectors >=
+        LIBRARY_CACHE_SIZE / IO_SECTOR_SIZE);
+  checkResident(library, nextName + BACKGROUND_TILES_EXTENSION);
+  checkResident(library, nextName + BACKGROUND_MAP_EXTENSION);
+  checkResident(library, nextName + BACKGROUND_PALETTE_EXTENSION);
+  checkResident(library, nextName + METADATA_EXTENSION);
+
+  // (the transition: the next song's files are already in memory)
+  u32 sectors = readSectors();
+  auto second = deathMix->getNextSongChart();
+  CHECK(second.song != NULL && !deathMix->isInitialSong());
+  CHECK(second.song->audioPath == nextName);
+  auto staged = deathMix->getStagedBackground();
+  CHECK_MSG(staged != NULL, "the background wasn't staged");
+  checkFile(library, nextName + BACKGROUND_TILES_EXTENSION,
+            staged[STAGED_TILES].data, staged[STAGED_TILES].length);
+  checkFile(library, nextName + BACKGROUND_MAP_EXTENSION,
+            staged[STAGED_MAP].data, staged[STAGED_MAP].length);
+  checkFile(library, nextName + BACKGROUND_PALETTE_EXTENSION,
+            staged[STAGED_PALETTE].data, staged[STAGED_PALETTE].length);
+  CHECK_MSG(readSectors() == sectors, "the transition read %u sectors",
+            readSectors() - sectors);
+
+  // (the staged files are pinned until the next song starts prefetching)
+  SONG_free(first.song);
+  SONG_free(second.song);
+  CHECK(libraryStore->getFile(fs, BIG_FILE, NULL) == NULL);
+  CHECK(libraryStore->getLastError() == LibraryStore::Error::UNCACHEABLE);
+  io_scheduler_begin_frame();
+  deathMix->prefetch();
+  CHECK(deathMix->getStagedBackground() == NULL);
+  CHECK(libraryStore->getFile(fs, BIG_FILE, NULL) != NULL);
+  CHECK(deathMix->getNextSongChart().song == NULL);
+
+  printf("staging: %u sectors in %u frames, resident after %u filler reads, "
+         "OK\n",
+         prefetchSectors, frames, FILLERS);
+}
+
+int main() {
+  auto content = FIXTURE_createContent(SONGS_TOTAL);
+  auto sd = FIXTURE_createFolder();
+  auto library = sd + LIBRARY_FOLDER_NAME;
+  mkdir(library.c_str(), 0755);
+  FIXTURE_writeFile(library + ROM_ID_FILE,
+                    FIXTURE_readFile(content + "/" + ROM_ID_FILE));
+  writeLibrary(library);
+
+  HOST_init(content.c_str());
+  HOST_setSD(sd.c_str());
+  SAVEFILE_write8(SRAM->adminSettings.hqMode, HQModeOpts::dACTIVE);
+  CHECK(videoStore->activate() == VideoStore::State::ACTIVE);
+  CHECK(libraryStore->activate(find_first_gbfs_file(0)));
+
+  testStaging(library);
+
+  HOST_setSD(NULL);
+  FIXTURE_removeFolder(sd);
+  FIXTURE_removeFolder(content);
+  return 0;
+}
@@ -0,0 +1,134 @@
+#include <stdio.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "gameplay/models/EventStream.h"
+#include "host/fixture.h"
+#include "objects/score/combo/Combo.h"
+#include "test.h"
+
+// Streams a 50,000-event chart through `EventStream` rings:
+// - with two readers at different lags and a small ring, comparing every
+//   event with the in-memory list it was serialized from;
+// - in the game, where a bot that hits every note must clear it with no
+//   misses (like it would if the whole chart was parsed upfront).
+
+#define EVENT_COUNT 50000
+#define SMALL_RING_SIZE 64
+#define SONG_NAME "long"
+
+static u32 seed = 1;
+
+static u32 nextRandom(u32 max) {
+  seed = seed * 1103515245 + 12345;
+  return (seed >> 16) % max;
+}
+
+static std::vector<FixtureEvent> createRandomEvents(bool isDouble) {
+  std::vector<FixtureEvent> events;
+  int timestamp = 0;
+  for (u32 i = 0; i < EVENT_COUNT; i++) {
+    auto type = static_cast<EventType>(nextRandom(EventType::WARP + 1));
+    u8 arrows = nextRandom(32) << EVENT_TYPE_BITS;
+    FixtureEvent event = {timestamp, type, arrows};
+    if (isDouble)
+      event.data2 = nextRandom(32) << EVENT_TYPE_BITS;
+    u32 params = EVENT_HAS_PARAM(type) + EVENT_HAS_PARAM2(type) +
+                 EVENT_HAS_PARAM3(type);
+    for (u32 j = 0; j < params; j++)
+      event.params.push_back(nextRandom(0xffff) << 16 | nextRandom(0xffff));
+
+    events.push_back(event);
+    timestamp += nextRandom(100);
+  }
+  return events;
+}
+
+static void checkEvent(Event* event, const FixtureEvent& expected,
+                       bool isDouble) {
+  auto type = static_cast<EventType>(event->data() & EVENT_TYPE);
+  CHECK(event->timestamp() == expected.timestamp);
+  CHECK(type == expected.type);
+  CHECK((event->data() & ~EVENT_TYPE) == expected.arrows);
+  CHECK(event->data2 ==
+        (EVENT_HAS_DATA2(type, isDouble) ? expected.data2 : 0));
+  u32 params[] = {event->param, event->param2, event->param3};
+  for (u32 i = 0; i < expected.params.size(); i++)
+    CHECK(params[i] == expected.params[i]);
+}
+
+static void testSmallRing(bool isDouble) {
+  auto expected = createRandomEvents(isDouble);
+  auto data = FIXTURE_serializeEvents(expected, isDouble);
+  CHECK(EventStream::measure(data.data(), EVENT_COUNT, isDouble) ==
+        data.size());
+
+  Event ring[SMALL_RING_SIZE];
+  EventStream stream;
+  stream.initialize(data.data(), EVENT_COUNT, isDouble, ring, SMALL_RING_SIZE);
+  stream.attach(0);
+  stream.attach(1);
+
+  // (the leader reads ahead until the ring is full, the follower releases)
+  u32 leader = 0, follower = 0, fullRings = 0;
+  while (follower < EVENT_COUNT) {
+    u32 target =
+        std::min(leader + nextRandom(SMALL_RING_SIZE), (u32)EVENT_COUNT);
+    for (; leader < target; leader++) {
+      auto event = stream.at(leader);
+      if (event == NULL) {
+        CHECK(leader - follower >= SMALL_RING_SIZE);
+        fullRings++;
+        break;
+      }
+      checkEvent(event, expected[leader], isDouble);
+    }
+
+    // (unreleased events stay valid while newer ones are parsed)
+    if (follower < leader)
+      checkEvent(stream.at(follower), expected[follower], isDouble);
+
+    stream.release(0, leader);
+    follower = std::min(follower + nextRandom(SMALL_RING_SIZE), leader);
+    if (leader == EVENT_COUNT)
+      follower = EVENT_COUNT;
+    stream.release(1, follower);
+  }
+  CHECK(fullRings > 0);
+
+  // (after a reset, it streams again from the first event)
+  stream.reset();
+  stream.attach(0);
+  for (u32 i = 0; i < EVENT_COUNT; i++) {
+    checkEvent(stream.at(i), expected[i], isDouble);
+    stream.release(0, i);
+  }
+
+  printf("%s ring: %u events, %u times full\n", isDouble ? "double" : "single",
+         EVENT_COUNT, fullRings);
+}
+
+static void testLongChart() {
+  u32 noteCount;
+  auto events = FIXTURE_createNotes(EVENT_COUNT, &noteCount);
+  u32 lastMillisecond = events.back().timestamp + 1000;
+  auto content = FIXTURE_createContent(1);
+  FIXTURE_writeSong(content, SONG_NAME, lastMillisecond, events);
+
+  auto result = FIXTURE_playSong(content, SONG_NAME, lastMillisecond, events);
+  printf("long chart: %u events, %u notes, %u frames, max combo %u\n",
+         EVENT_COUNT, noteCount, result.frames, result.maxCombo);
+  CHECK_MSG(result.isFinished, "the song didn't finish");
+  CHECK_MSG(result.isSGrade, "a note was missed");
+  CHECK(result.maxCombo == std::min(noteCount, (u32)MAX_COMBO));
+
+  FIXTURE_removeFolder(content);
+}
+
+int main() {
+  testSmallRing(false);
+  testSmallRing(true);
+  testLongChart();
+  return 0;
+}
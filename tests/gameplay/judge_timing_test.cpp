@@ -0,0 +1,116 @@
+#include <math.h>
+#include <stdio.h>
+
+#include "gameplay/TimingProvider.h"
+#include "test.h"
+
+extern "C" {
+#include "player/song_clock.h"
+}
+
+// Replays a 10-minute chart against the song clock, with the display at the
+// GBA's 59.73 fps (608 samples per frame) and at 60.0 fps (like an emulator
+// synced to a 60Hz screen, so frames consume a varying number of samples).
+// Each note is pressed on the frame closest to it, and the distance that
+// `Judge` sees (`TimingProvider::getDistanceTo`) must match the ideal one:
+// no drift at the end of the song, and no truncation bias.
+
+#define SONG_MINUTES 10
+#define FIRST_NOTE 2000
+#define NOTE_INTERVAL 251  // (ms, so notes fall on every sub-frame phase)
+#define OUTPUT_RATE (16777216.0 / 462)
+#define GBA_FPS (16777216.0 / 280896)
+#define MAX_ROUNDING_ERROR (0.5 + 1.0 / 65536)
+
+// The song clock as `ChartReader::update` sees it (no offsets).
+class SongClock : public TimingProvider {
+ public:
+  void set(u32 samples) {
+    msecs = (int)song_clock_msecs(samples, true);
+    msecsFraction = song_clock_fraction(samples, true);
+  }
+
+  inline int getTruncatedDistanceTo(int timestamp) {
+    return msecs - timestamp;  // (what `Judge` used before, signed)
+  }
+};
+
+typedef struct {
+  u32 notes;
+  double maxError;    // (judged distance vs ideal distance, ms)
+  double bias;        // (average signed error, ms)
+  double oldBias;     // (same with the whole-millisecond clock, ms)
+  double lastMinute;  // (max ideal distance during the last minute, ms)
+} Result;
+
+static u32 samplesAt(u32 frame, double fps) {
+  return (u32)(frame * (OUTPUT_RATE / fps));
+}
+
+static double msecsOf(u32 samples) {
+  return samples * 1000.0 / OUTPUT_RATE;
+}
+
+static Result play(double fps) {
+  Result result = {0, 0, 0, 0, 0};
+  SongClock clock;
+  double frameMs = 1000.0 / fps;
+  u32 frames = (u32)(SONG_MINUTES * 60 * fps);
+  u32 frame = 0;
+
+  for (int note = FIRST_NOTE; msecsOf(samplesAt(frames, fps)) > note;
+       note += NOTE_INTERVAL) {
+    // (the first frame whose audio is past the note, or the one before)
+    while (msecsOf(samplesAt(frame + 1, fps)) <= note)
+      frame++;
+    double before = note - msecsOf(samplesAt(frame, fps));
+    double after = msecsOf(samplesAt(frame + 1, fps)) - note;
+    u32 pressFrame = after < before ? frame + 1 : frame;
+    u32 samples = samplesAt(pressFrame, fps);
+
+    clock.set(samples);
+    double signedIdeal = msecsOf(samples) - note;
+    double ideal = fabs(signedIdeal);
+    double judged = clock.getDistanceTo(note);
+    double error = fabs(judged - ideal);
+    CHECK_MSG(error <= MAX_ROUNDING_ERROR,
+              "%.2f fps, note at %dms: judged %.0fms, ideal %.4fms", fps, note,
+              judged, ideal);
+    CHECK_MSG(ideal <= frameMs / 2 + 0.001, "%.2f fps, note at %dms: %.4fms",
+              fps, note, ideal);
+
+    // (the judgement time itself is the audio position, to 1/65536 ms)
+    double judgedTime = clock.getMsecs() + clock.getMsecsFraction() / 65536.0;
+    CHECK(fabs(judgedTime - msecsOf(samples)) < 1.0 / 65536);
+
+    result.notes++;
+    result.maxError = fmax(result.maxError, error);
+    result.bias += (judgedTime - note) - signedIdeal;
+    result.oldBias += clock.getTruncatedDistanceTo(note) - signedIdeal;
+    if (note >= (SONG_MINUTES - 1) * 60000)
+      result.lastMinute = fmax(result.lastMinute, ideal);
+  }
+
+  result.bias /= result.notes;
+  result.oldBias /= result.notes;
+  return result;
+}
+
+int main() {
+  const double rates[] = {60.0, GBA_FPS};
+  for (double fps : rates) {
+    Result result = play(fps);
+    CHECK(result.notes > SONG_MINUTES * 60000 / NOTE_INTERVAL - 10);
+    CHECK(result.lastMinute <= 1000.0 / fps / 2 + 0.001);
+    CHECK_MSG(fabs(result.bias) < 0.001, "bias: %.4fms", result.bias);
+    CHECK_MSG(result.oldBias < -0.4, "old bias: %.4fms", result.oldBias);
+
+    printf(
+        "judge timing at %.2f fps: %u notes in %d minutes, max error %.2fms, "
+        "last minute within %.2fms (truncated clock: %.2fms early), OK\n",
+        fps, result.notes, SONG_MINUTES, result.maxError, result.lastMinute,
+        -result.oldBias);
+  }
+
+  return 0;
+}
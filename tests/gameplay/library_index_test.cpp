@@ -0,0 +1,109 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gameplay/Library.h"
+#include "gameplay/models/Song.h"
+#include "host/fixture.h"
+#include "host/host.h"
+#include "test.h"
+
+// Builds a `_library.idx` with the importer (`library_index_test.js`) for a
+// content folder with a hidden file, packs it like `make import` does, and
+// checks that every song's metadata comes from its own `.pius` entry. Then
+// packs it again with an extra file that the index didn't see (so every
+// entry number is off by one): songs must still get their own metadata.
+
+#define SONG_LAST_MILLISECOND 5000
+#define HIDDEN_FILE ".hidden"      // (sorted first, but `gbfs *` skips it)
+#define EXTRA_FILE "AAAA_extra.bin"  // (sorted before every song)
+#define INDEX_HEADER_SIZE 16
+#define INDEX_ROW_SIZE 20
+#define SCRIPT "gameplay/library_index_test.js"  // (tests run from `tests/`)
+
+static const std::vector<std::string> SONGS = {"ALPHA", "BRAVO", "CHARLIE"};
+
+static void writeContent(std::string content) {
+  for (u32 i = 0; i < SONGS.size(); i++) {
+    u32 noteCount;
+    // (a different size for each song, so the files can be told apart)
+    FIXTURE_writeSong(content, SONGS[i], SONG_LAST_MILLISECOND,
+                      FIXTURE_createNotes(4 + i * 4, &noteCount));
+  }
+  FIXTURE_writeFile(content + "/" HIDDEN_FILE, {1, 2, 3});
+
+  const char* node = getenv("NODE");
+  std::string command = std::string(node != NULL ? node : "node") +
+                        " " SCRIPT " " + content;
+  for (auto& name : SONGS)
+    command += " " + name;
+  CHECK_MSG(system(command.c_str()) == 0, "%s failed", command.c_str());
+}
+
+// Returns how many stored entries point at the right `.pius` file.
+static u32 checkIndex(std::string content) {
+  auto fs = find_first_gbfs_file(0);
+  auto index = FIXTURE_readFile(content + "/" LIBRARY_INDEX_FILE);
+  u32 firstCrazyRow = 2 * SONGS.size();
+
+  u32 matches = 0;
+  for (u32 i = 0; i < SONGS.size(); i++) {
+    auto row = index.data() + INDEX_HEADER_SIZE +
+               (firstCrazyRow + i) * INDEX_ROW_SIZE;
+    CHECK(std::string((const char*)row) == SONGS[i]);
+    u32 entry = row[SONG_NAME_LEN] | (row[SONG_NAME_LEN + 1] << 8);
+    char name[25];
+    CHECK(gbfs_get_nth_obj(fs, entry, name, NULL) != NULL);
+    matches += SONGS[i] + METADATA_EXTENSION == name;
+  }
+  return matches;
+}
+
+static void checkSongs() {
+  auto fs = find_first_gbfs_file(0);
+  std::vector<SongFile> files;
+  auto library = std::unique_ptr<Library>{new Library(fs)};
+  library->loadSongs(files, DifficultyLevel::CRAZY, 0);
+  CHECK(files.size() == SONGS.size());
+
+  for (u32 i = 0; i < SONGS.size(); i++) {
+    u32 expectedLength;
+    auto expected = gbfs_get_obj(
+        fs, (SONGS[i] + METADATA_EXTENSION).c_str(), &expectedLength);
+    CHECK(std::string(files[i].name) == SONGS[i]);
+    CHECK(files[i].id == i);
+    CHECK_MSG(files[i].metadata == expected, "%s has the wrong metadata",
+              SONGS[i].c_str());
+    CHECK(files[i].metadataLength == expectedLength);
+
+    Song* song = SONG_parse(fs, &files[i]);
+    CHECK(song != NULL);
+    CHECK(song->chartCount == 1);
+    SONG_free(song);
+  }
+}
+
+int main() {
+  auto content = FIXTURE_createContent(SONGS.size());
+  writeContent(content);
+
+  // (the importer skips the hidden file, like `gbfs *`)
+  HOST_init(content.c_str());
+  CHECK(gbfs_get_obj(find_first_gbfs_file(0), HIDDEN_FILE, NULL) == NULL);
+  CHECK_MSG(checkIndex(content) == SONGS.size(), "stale entries");
+  checkSongs();
+  printf("index with a hidden file: %u songs, OK\n", (u32)SONGS.size());
+
+  FIXTURE_writeFile(content + "/" EXTRA_FILE, {4, 5, 6});
+  HOST_loadRom(content.c_str());
+  CHECK(checkIndex(content) == 0);
+  checkSongs();
+  printf("index with an extra file: %u songs by name, OK\n",
+         (u32)SONGS.size());
+
+  FIXTURE_removeFolder(content);
+  return 0;
+}
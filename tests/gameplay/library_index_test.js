@@ -0,0 +1,15 @@
+const IMPORTER = "../../scripts/importer/src";
+const libraryIndex = require(`${IMPORTER}/importers/libraryIndex`);
+
+// Usage: node library_index_test.js <content dir> <song name>...
+// Writes the importer's `_library.idx` for the songs of `<content dir>`,
+// listed in this order (ids by position) at every difficulty level (see
+// `library_index_test.cpp`).
+
+const [outputPath, ...names] = process.argv.slice(2);
+const songs = names.map((outputName, id) => ({ song: { id, outputName } }));
+const sortedSongsByLevel = ["NORMAL", "HARD", "CRAZY"].map(
+  (difficultyLevel) => ({ difficultyLevel, songs })
+);
+
+libraryIndex(sortedSongsByLevel, outputPath);
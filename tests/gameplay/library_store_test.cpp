@@ -0,0 +1,218 @@
+#include <stdio.h>
+#include <sys/stat.h>
+
+#include <string>
+#include <vector>
+
+#include "gameplay/DifficultyLevelDeathMix.h"
+#include "gameplay/Library.h"
+#include "gameplay/library/LibraryStore.h"
+#include "gameplay/models/Song.h"
+#include "gameplay/save/SaveFile.h"
+#include "gameplay/video/VideoStore.h"
+#include "host/fixture.h"
+#include "host/host.h"
+#include "test.h"
+
+extern "C" {
+#include "player/io_scheduler.h"
+}
+
+// Preloads files from a host SD card library (`LibraryStore::preload`, used
+// by DeathMix while a song plays) and checks that they're read a few
+// sectors per frame, only when the frame's I/O budget allows it, and that
+// `getFile` then finds them without reading again.
+// Songs that only exist on the SD card and don't fit in the cache (too big,
+// or blocked by the pinned chart) can't be loaded: they must be skipped
+// instead of falling back to a ROM file that isn't there.
+
+#define TILES_NAME "bg.img.bin"
+#define TILES_SIZE 40000
+#define PALETTE_NAME "bg.pal.bin"
+#define PALETTE_SIZE 512
+#define MISSING_NAME "missing.map.bin"
+#define MAX_FRAMES 100
+#define SMALL_SONG "SMALL"
+#define BIG_SONG "BIG"  // (> `LIBRARY_CACHE_SIZE`)
+#define BIG_SONG_EVENTS 20000
+#define MEDIUM_SONG "MEDIUM"  // (two don't fit in the cache)
+#define MEDIUM_SONG_2 "MEDIUM2"
+#define MEDIUM_SONG_EVENTS 10000
+#define SONG_LAST_MILLISECOND 5000
+
+static u32 seed = 1;
+
+static u32 nextRandom(u32 max) {
+  seed = seed * 1103515245 + 12345;
+  return (seed >> 16) % max;
+}
+
+static std::vector<u8> createFile(std::string path, u32 size) {
+  std::vector<u8> data;
+  for (u32 i = 0; i < size; i++)
+    data.push_back(nextRandom(256));
+  FIXTURE_writeFile(path, data);
+  return data;
+}
+
+static u32 readSectors() {
+  return io_stats[IO_STREAM_OTHER].sectors;
+}
+
+// Returns the frames it took to preload `name`.
+static u32 preload(const char* name) {
+  u32 frames = 0;
+  bool isDone = false;
+  while (!isDone && frames < MAX_FRAMES) {
+    io_scheduler_begin_frame();
+    u32 sectors = readSectors();
+    isDone = libraryStore->preload(name);
+    CHECK_MSG(readSectors() - sectors <= LIBRARY_PRELOAD_SECTORS,
+              "frame %u read %u sectors", frames, readSectors() - sectors);
+    frames++;
+  }
+  CHECK(isDone);
+  return frames;
+}
+
+static void checkCached(const char* name, const std::vector<u8>& expected) {
+  u32 sectors = readSectors();
+  u32 length;
+  auto peeked = (const u8*)libraryStore->peekFile(find_first_gbfs_file(0),
+                                                  name, &length);
+  CHECK_MSG(peeked != NULL, "%s isn't cached", name);
+  CHECK(length == expected.size());
+  CHECK(memcmp(peeked, expected.data(), length) == 0);
+  CHECK(libraryStore->getFile(find_first_gbfs_file(0), name, NULL) == peeked);
+  CHECK_MSG(readSectors() == sectors, "%s was read again", name);
+}
+
+static void writeSong(std::string library, std::string name, u32 eventCount) {
+  u32 noteCount;
+  FIXTURE_writeSong(library, name, SONG_LAST_MILLISECOND,
+                    FIXTURE_createNotes(eventCount, &noteCount));
+}
+
+static void testPreload(std::string library) {
+  auto tiles = createFile(library + TILES_NAME, TILES_SIZE);
+  auto palette = createFile(library + PALETTE_NAME, PALETTE_SIZE);
+  io_scheduler_reset_stats();
+
+  // (nothing is read while the frame's budget is spent)
+  io_scheduler_begin_frame();
+  io_scheduler_account(IO_FRAME_BUDGET_SECTORS);
+  CHECK(!libraryStore->preload(TILES_NAME));
+  CHECK(readSectors() == IO_FRAME_BUDGET_SECTORS);
+  CHECK(io_stats[IO_STREAM_OTHER].stalls == 1);
+  CHECK(libraryStore->peekFile(find_first_gbfs_file(0), TILES_NAME, NULL) ==
+        NULL);
+  io_scheduler_reset_stats();
+
+  u32 tilesFrames = preload(TILES_NAME);
+  u32 chunkSize = LIBRARY_PRELOAD_SECTORS * IO_SECTOR_SIZE;
+  CHECK(tilesFrames == (TILES_SIZE + chunkSize - 1) / chunkSize);
+  u32 paletteFrames = preload(PALETTE_NAME);
+  CHECK(paletteFrames == 1);
+  checkCached(TILES_NAME, tiles);
+  checkCached(PALETTE_NAME, palette);
+
+  // (missing files are done right away, and not looked up again)
+  CHECK(preload(MISSING_NAME) == 1);
+  CHECK(libraryStore->peekFile(find_first_gbfs_file(0), MISSING_NAME, NULL) ==
+        NULL);
+  CHECK(libraryStore->preload(MISSING_NAME));
+
+  printf("preload: %u bytes in %u frames, %u bytes in %u, %u sectors, OK\n",
+         TILES_SIZE, tilesFrames, PALETTE_SIZE, paletteFrames, readSectors());
+}
+
+static Song* parse(const char* name, std::vector<u8> chartIndexes = {}) {
+  SongFile file(name, 0);
+  return SONG_parse(find_first_gbfs_file(0), &file, chartIndexes);
+}
+
+static void testUnloadableSongs(std::string library) {
+  auto fs = find_first_gbfs_file(0);
+  writeSong(library, SMALL_SONG, 8);
+  writeSong(library, BIG_SONG, BIG_SONG_EVENTS);
+  writeSong(library, MEDIUM_SONG, MEDIUM_SONG_EVENTS);
+  writeSong(library, MEDIUM_SONG_2, MEDIUM_SONG_EVENTS);
+  auto list = std::string(SMALL_SONG) + "\r\n" + BIG_SONG;
+  FIXTURE_writeFile(library + PREFIX_CRAZY "0" SUFFIX_LIST,
+                    std::vector<u8>(list.begin(), list.end()));
+  CHECK(FIXTURE_readFile(library + BIG_SONG ".pius").size() >
+        LIBRARY_CACHE_SIZE);
+  u32 romFallbacks = libraryStore->getRomFallbacks();
+
+  // (too big for the cache, and not in ROM)
+  CHECK(libraryStore->getFile(fs, BIG_SONG ".pius", NULL) == NULL);
+  CHECK(libraryStore->getLastError() == LibraryStore::Error::UNCACHEABLE);
+  CHECK(libraryStore->getFile(fs, "NOPE.pius", NULL) == NULL);
+  CHECK(libraryStore->getLastError() == LibraryStore::Error::NOT_FOUND);
+  CHECK(libraryStore->getFile(fs, SMALL_SONG ".pius", NULL) != NULL);
+  CHECK(libraryStore->getLastError() == LibraryStore::Error::NONE);
+  CHECK(libraryStore->getRomFallbacks() == romFallbacks);
+
+  std::vector<SongFile> songFiles;
+  auto songLibrary = std::unique_ptr<Library>{new Library(fs)};
+  songLibrary->loadSongs(songFiles, DifficultyLevel::CRAZY, 0);
+  CHECK(songFiles.size() == 2);
+  CHECK(SONG_parse(fs, &songFiles[1]) == NULL);
+  Song* song = SONG_parse(fs, &songFiles[0]);
+  CHECK(song != NULL && song->chartCount == 1);
+  SONG_free(song);
+  CHECK(SONG_getChannel(fs, GameMode::ARCADE, &songFiles[1],
+                        DifficultyLevel::CRAZY) == Channel::ORIGINAL);
+
+  // (lists that can't be loaded have no songs)
+  songFiles.clear();
+  songLibrary->loadSongs(songFiles, DifficultyLevel::HARD, 0);
+  CHECK(songFiles.empty());
+
+  // (the pinned chart leaves no room for another big one until it's freed)
+  Song* playing = parse(MEDIUM_SONG, {0});
+  CHECK(playing != NULL);
+  CHECK(parse(MEDIUM_SONG_2) == NULL);
+  CHECK(libraryStore->getLastError() == LibraryStore::Error::UNCACHEABLE);
+  SONG_free(playing);
+  song = parse(MEDIUM_SONG_2);
+  CHECK(song != NULL);
+  SONG_free(song);
+
+  // (mixes skip them)
+  for (u32 i = 0; i < 4; i++) {
+    auto deathMix = std::unique_ptr<DeathMix>{
+        new DifficultyLevelDeathMix(fs, DifficultyLevel::NORMAL)};
+    auto songChart = deathMix->getNextSongChart();
+    CHECK(songChart.song != NULL && songChart.chart != NULL);
+    CHECK(deathMix->isInitialSong());
+    CHECK(strcmp(songChart.song->audioPath.c_str(), SMALL_SONG) == 0);
+    SONG_free(songChart.song);
+    CHECK(deathMix->getNextSongChart().song == NULL);
+  }
+
+  printf("unloadable songs: skipped, OK\n");
+}
+
+int main() {
+  auto content = FIXTURE_createContent(2);
+  auto sd = FIXTURE_createFolder();
+  auto library = sd + LIBRARY_FOLDER_NAME;
+  mkdir(library.c_str(), 0755);
+  FIXTURE_writeFile(library + ROM_ID_FILE,
+                    FIXTURE_readFile(content + "/" + ROM_ID_FILE));
+
+  HOST_init(content.c_str());
+  HOST_setSD(sd.c_str());
+  SAVEFILE_write8(SRAM->adminSettings.hqMode, HQModeOpts::dACTIVE);
+  CHECK(videoStore->activate() == VideoStore::State::ACTIVE);
+  CHECK(libraryStore->activate(find_first_gbfs_file(0)));
+
+  testPreload(library);
+  testUnloadableSongs(library);
+
+  HOST_setSD(NULL);
+  FIXTURE_removeFolder(sd);
+  FIXTURE_removeFolder(content);
+  return 0;
+}
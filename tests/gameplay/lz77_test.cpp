@@ -0,0 +1,204 @@
+#include <stdio.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "gameplay/models/EventStream.h"
+#include "host/fixture.h"
+#include "test.h"
+#include "utils/LZ77.h"
+
+// Round-trips data through the importer's LZ77 encoder (`lz77.js`) and the
+// game's decoder (`LZ77_decompress`):
+// - edge cases, decoded back-to-back like event blocks;
+// - 50,000 events in `EVENT_STREAM_BLOCK_EVENTS`-event blocks, streamed
+//   through `EventStream` and compared with the uncompressed events;
+// - a chart played in the game, with the same results whether its events
+//   are compressed or not.
+
+#define EVENT_COUNT 50000
+#define SMALL_RING_SIZE 64
+#define WINDOW_SIZE 4096
+#define SONG_EVENT_COUNT 5000
+#define SONG_NAME "compressed"
+
+static u32 seed = 1;
+
+static u32 nextRandom(u32 max) {
+  seed = seed * 1103515245 + 12345;
+  return (seed >> 16) % max;
+}
+
+static std::vector<std::vector<u8>> createEdgeCases() {
+  std::vector<std::vector<u8>> blocks;
+  blocks.push_back({});
+  blocks.push_back({42});
+  blocks.push_back(std::vector<u8>(WINDOW_SIZE, 0));  // (overlapping matches)
+
+  std::vector<u8> pattern;
+  for (u32 i = 0; i < 1000; i++)
+    pattern.push_back("abc"[i % 3]);
+  blocks.push_back(pattern);
+
+  std::vector<u8> noise;
+  for (u32 i = 0; i < 3000; i++)
+    noise.push_back(nextRandom(256));
+  blocks.push_back(noise);
+
+  // (a repetition at the edge of the window)
+  std::vector<u8> far = noise;
+  far.resize(WINDOW_SIZE, 0);
+  far.insert(far.end(), noise.begin(), noise.begin() + 100);
+  blocks.push_back(far);
+
+  std::vector<u8> lowEntropy;
+  for (u32 i = 0; i < 40000; i++)
+    lowEntropy.push_back(nextRandom(4));
+  blocks.push_back(lowEntropy);
+
+  return blocks;
+}
+
+// Returns the shortest match distance in a compressed block.
+static u32 minDistanceOf(const u8* source, u32 length) {
+  u32 minDistance = WINDOW_SIZE;
+  const u8* data = source + 4;
+  while (data < source + length) {
+    u8 flags = *data++;
+    for (u32 i = 0; i < 8 && data < source + length; i++, flags <<= 1) {
+      if (flags & 0x80) {
+        minDistance =
+            std::min(minDistance, (u32)(((data[0] & 0xf) << 8) | data[1]) + 1);
+        data += 2;
+      } else
+        data++;
+    }
+  }
+  return minDistance;
+}
+
+static void testEdgeCases(bool isVram) {
+  auto blocks = createEdgeCases();
+  auto compressed = FIXTURE_compress(blocks, isVram);
+
+  u32 cursor = 0;
+  for (auto& block : blocks) {
+    std::vector<u8> output(block.size() + 1, 0xee);
+    u32 length;
+    u32 size = LZ77_decompress(compressed.data() + cursor, output.data(),
+                               &length);
+    CHECK(size == block.size());
+    CHECK(std::equal(block.begin(), block.end(), output.begin()));
+    CHECK(output[size] == 0xee);  // (nothing is written past the end)
+    if (isVram)
+      CHECK(minDistanceOf(compressed.data() + cursor, length) >= 2);
+
+    cursor += length;
+  }
+  CHECK(cursor == compressed.size());
+
+  printf("%s edge cases: %zu blocks, OK\n", isVram ? "vram" : "wram",
+         blocks.size());
+}
+
+static std::vector<FixtureEvent> createRandomEvents(bool isDouble) {
+  std::vector<FixtureEvent> events;
+  int timestamp = 0;
+  for (u32 i = 0; i < EVENT_COUNT; i++) {
+    // (mostly notes, like real charts)
+    auto type = nextRandom(4) > 0
+                    ? EventType::NOTE
+                    : static_cast<EventType>(nextRandom(EventType::WARP + 1));
+    u8 arrows = EVENT_ARROW_MASKS[nextRandom(5)];
+    FixtureEvent event = {timestamp, type, arrows};
+    if (isDouble)
+      event.data2 = EVENT_ARROW_MASKS[nextRandom(5)];
+    u32 params = EVENT_HAS_PARAM(type) + EVENT_HAS_PARAM2(type) +
+                 EVENT_HAS_PARAM3(type);
+    for (u32 j = 0; j < params; j++)
+      event.params.push_back(nextRandom(1000));
+
+    events.push_back(event);
+    timestamp += nextRandom(4) * 50;
+  }
+  return events;
+}
+
+static void testEventBlocks(bool isDouble) {
+  auto events = createRandomEvents(isDouble);
+  std::vector<std::vector<u8>> blocks;
+  for (u32 i = 0; i < EVENT_COUNT; i += EVENT_STREAM_BLOCK_EVENTS) {
+    auto end = events.begin() +
+               std::min(i + EVENT_STREAM_BLOCK_EVENTS, (u32)EVENT_COUNT);
+    blocks.push_back(FIXTURE_serializeEvents(
+        std::vector<FixtureEvent>(events.begin() + i, end), isDouble));
+    CHECK(blocks.back().size() <= EVENT_STREAM_BLOCK_SIZE);
+  }
+  auto compressed = FIXTURE_compress(blocks);
+  auto uncompressed = FIXTURE_serializeEvents(events, isDouble);
+
+  Event compressedRing[SMALL_RING_SIZE];
+  Event uncompressedRing[SMALL_RING_SIZE];
+  u8 block[EVENT_STREAM_BLOCK_SIZE];
+  EventStream compressedStream;
+  EventStream uncompressedStream;
+  compressedStream.initialize(compressed.data(), EVENT_COUNT, isDouble,
+                              compressedRing, SMALL_RING_SIZE, block);
+  uncompressedStream.initialize(uncompressed.data(), EVENT_COUNT, isDouble,
+                                uncompressedRing, SMALL_RING_SIZE);
+  compressedStream.attach(0);
+  uncompressedStream.attach(0);
+
+  for (u32 i = 0; i < EVENT_COUNT; i++) {
+    auto event = compressedStream.at(i);
+    auto expected = uncompressedStream.at(i);
+    CHECK(event != NULL && expected != NULL);
+    CHECK(event->timestampAndData == expected->timestampAndData);
+    CHECK(event->data2 == expected->data2);
+    auto type = static_cast<EventType>(event->data() & EVENT_TYPE);
+    if (EVENT_HAS_PARAM(type))
+      CHECK(event->param == expected->param);
+    if (EVENT_HAS_PARAM2(type))
+      CHECK(event->param2 == expected->param2);
+    if (EVENT_HAS_PARAM3(type))
+      CHECK(event->param3 == expected->param3);
+
+    compressedStream.release(0, i);
+    uncompressedStream.release(0, i);
+  }
+
+  printf("%s events: %u -> %zu bytes (%.1f%%)\n",
+         isDouble ? "double" : "single", EVENT_COUNT, compressed.size(),
+         compressed.size() * 100.0 / uncompressed.size());
+}
+
+static void testCompressedChart() {
+  u32 noteCount;
+  auto events = FIXTURE_createNotes(SONG_EVENT_COUNT, &noteCount);
+  u32 lastMillisecond = events.back().timestamp + 1000;
+  auto content = FIXTURE_createContent(1);
+  FIXTURE_writeSong(content, SONG_NAME, lastMillisecond, events, false);
+  auto expected =
+      FIXTURE_playSong(content, SONG_NAME, lastMillisecond, events);
+  FIXTURE_writeSong(content, SONG_NAME, lastMillisecond, events, true);
+  auto result = FIXTURE_playSong(content, SONG_NAME, lastMillisecond, events);
+
+  printf("compressed chart: %u events, %u notes, %u frames, max combo %u\n",
+         SONG_EVENT_COUNT, noteCount, result.frames, result.maxCombo);
+  CHECK_MSG(result.isFinished, "the song didn't finish");
+  CHECK_MSG(result.isSGrade, "a note was missed");
+  CHECK(result.frames == expected.frames);
+  CHECK(result.isSGrade == expected.isSGrade);
+  CHECK(result.maxCombo == expected.maxCombo);
+
+  FIXTURE_removeFolder(content);
+}
+
+int main() {
+  testEdgeCases(false);
+  testEdgeCases(true);
+  testEventBlocks(false);
+  testEventBlocks(true);
+  testCompressedChart();
+  return 0;
+}
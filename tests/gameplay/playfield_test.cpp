@@ -0,0 +1,265 @@
+#include <stdio.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <memory>
+#include <vector>
+
+#include "gameplay/Playfield.h"
+#include "gameplay/Sequence.h"
+#include "gameplay/save/SaveFile.h"
+#include "gameplay/save/State.h"
+#include "host/fixture.h"
+#include "host/host.h"
+#include "objects/ArrowInfo.h"
+#include "test.h"
+#include "utils/SpriteUtils.h"
+
+// Checks the OAM offsets of `PLAYFIELD` (per player and layer, skipping
+// hidden sprites and hiding disabled ones), then plays a chart with each reduce mod and compares the
+// screen with a run without mods: the holders and the life bar move down by
+// the mod's offset, and arrows keep entering from the bottom of the screen,
+// scrolling the shorter distance like with the fixed reduce mod.
+
+#define SONG_NAME "reduce"
+#define SONG_LAST_MILLISECOND 10000
+#define NOTE_COUNT 5
+#define NOTE_INTERVAL 1500  // (ms, so there's one arrow on screen at a time)
+#define COLUMN 2
+#define ARROW_POOL_SIZE 78  // (`SongScene`, the arrows go before the holders)
+#define MAX_FRAMES (SONG_LAST_MILLISECOND * 60 / 1000)
+#define NONE -1
+
+typedef struct {
+  s16 holderY;
+  s16 lifeBarY;
+  s16 arrowY;  // (the arrow coming to `COLUMN`'s holder, or `NONE`)
+} Frame;
+
+static int xOf(u32 i) {
+  return oam_mem[i].attr1 & ATTR1_X_MASK;
+}
+
+static int yOf(u32 i) {
+  return oam_mem[i].attr0 & ATTR0_Y_MASK;
+}
+
+static std::unique_ptr<Sprite> createSprite(int x, int y) {
+  return std::unique_ptr<Sprite>{new Sprite(NULL, 0, x, y, SIZE_16_16)};
+}
+
+static void testOffsets() {
+  u8 playerIds[] = {0, 1};
+  auto base = createSprite(10, 20);
+  auto score = createSprite(30, 40);
+  auto arrow = createSprite(50, 60);
+  auto hidden = createSprite(0, 0);
+  SPRITE_hide(hidden.get());
+  u8 arrowPlayerId = 0;
+  auto other = createSprite(70, 80);
+  Sprite* sprites[] = {base.get(), score.get(), arrow.get(), hidden.get(),
+                       other.get()};
+  auto copyOam = [&sprites]() {
+    for (u32 i = 0; i < 5; i++) {
+      sprites[i]->update();
+      oam_mem[i] = sprites[i]->oam;
+    }
+  };
+
+  PLAYFIELD_reset();
+  PLAYFIELD_add(base.get(), PLAYFIELD_BASE, &playerIds[0]);
+  PLAYFIELD_add(score.get(), PLAYFIELD_SCORE, &playerIds[0]);
+  PLAYFIELD_add(arrow.get(), PLAYFIELD_ARROWS, &arrowPlayerId);
+  PLAYFIELD_add(hidden.get(), PLAYFIELD_ARROWS, &playerIds[0]);
+  PLAYFIELD_add(other.get(), PLAYFIELD_BASE, &playerIds[1]);
+
+  // (no offsets: OAM stays as the engine wrote it)
+  copyOam();
+  PLAYFIELD_render();
+  CHECK(xOf(0) == 10 && yOf(0) == 20);
+  CHECK(xOf(2) == 50 && yOf(2) == 60);
+
+  PLAYFIELD_setOffset(0, PLAYFIELD_BASE, 5, 51);
+  PLAYFIELD_setOffset(0, PLAYFIELD_SCORE, 5, 0);
+  PLAYFIELD_setOffset(0, PLAYFIELD_ARROWS, -20, 51);
+  PLAYFIELD_setOffset(1, PLAYFIELD_BASE, -5, 0);
+  copyOam();
+  PLAYFIELD_render();
+  CHECK(xOf(0) == 15 && yOf(0) == 71);
+  CHECK(xOf(1) == 35 && yOf(1) == 40);
+  CHECK(xOf(2) == 30 && yOf(2) == 111);
+  CHECK_MSG(xOf(3) == HIDDEN_WIDTH && yOf(3) == HIDDEN_HEIGHT,
+            "a hidden sprite was moved");
+  CHECK(xOf(4) == 65 && yOf(4) == 80);
+
+  // (pooled sprites follow their current player; X wraps like OAM does)
+  arrowPlayerId = 1;
+  PLAYFIELD_setOffset(1, PLAYFIELD_ARROWS, -60, -70);
+  copyOam();
+  PLAYFIELD_render();
+  CHECK(xOf(2) == ((50 - 60) & ATTR1_X_MASK) && yOf(2) == 60 - 70 + 256);
+
+  // (disabled sprites aren't copied by the engine, so they're hidden)
+  arrow->enabled = false;
+  PLAYFIELD_render();
+  CHECK_MSG(oam_mem[2].attr0 == ATTR0_HIDE, "a disabled sprite stayed");
+
+  PLAYFIELD_reset();
+  printf("offsets: OK\n");
+}
+
+static std::vector<FixtureEvent> createEvents() {
+  std::vector<FixtureEvent> events;
+  for (u32 i = 0; i < NOTE_COUNT; i++)
+    events.push_back({(int)(3000 + i * NOTE_INTERVAL), EventType::NOTE,
+                      EVENT_ARROW_MASKS[COLUMN]});
+  return events;
+}
+
+// Plays the song (in a new process, since it calls `HOST_init`) and returns
+// where the holders, the life bar and the arrows were on every frame.
+static std::vector<Frame> play(std::string content, ReduceOpts reduce) {
+  int fds[2];
+  CHECK(pipe(fds) == 0);
+  fflush(stdout);
+
+  pid_t pid = fork();
+  if (pid == 0) {
+    HOST_init(content.c_str());
+    SAVEFILE_write8(SRAM->state.gameMode, GameMode::ARCADE);
+    SAVEFILE_write8(SRAM->mods.reduce, reduce);
+    SongFile file(SONG_NAME, 0);
+    Song* song = SONG_parse(find_first_gbfs_file(0), &file, {0});
+    SEQUENCE_goToMessageOrSong(song, song->charts);
+
+    std::vector<Frame> frames;
+    while (HOST_getFrame() < MAX_FRAMES) {
+      HOST_runFrame();
+
+      // (the last sprite is the last holder, see `SongScene::sprites`)
+      int columnX = ARROW_CORNER_MARGIN_X(0) + ARROW_MARGIN * COLUMN;
+      int lastX = ARROW_CORNER_MARGIN_X(0) + ARROW_MARGIN * (ARROWS_TOTAL - 1);
+      int lastHolder = NONE;
+      for (u32 i = 0; i < 128; i++) {
+        if (xOf(i) == lastX && !(oam_mem[i].attr0 & ATTR0_HIDE))
+          lastHolder = i;
+      }
+      if (lastHolder == NONE) {
+        frames.push_back({NONE, NONE, NONE});
+        continue;
+      }
+
+      int holder = lastHolder - (ARROWS_TOTAL - 1) + COLUMN;
+      Frame frame = {(s16)yOf(holder), (s16)yOf(0), NONE};
+      int firstArrow = lastHolder - (ARROWS_TOTAL - 1) - ARROW_POOL_SIZE;
+      for (int i = firstArrow; i < holder - COLUMN; i++) {
+        if (xOf(i) == columnX && yOf(i) >= frame.holderY &&
+            yOf(i) < GBA_SCREEN_HEIGHT)
+          frame.arrowY = yOf(i);  // (missed arrows go on, but aren't checked)
+      }
+      frames.push_back(frame);
+    }
+
+    u32 size = frames.size() * sizeof(Frame);
+    bool isSent = write(fds[1], &size, 4) == 4 &&
+                  write(fds[1], frames.data(), size) == (ssize_t)size;
+    _exit(isSent ? 0 : 1);
+  }
+
+  u32 size = 0;
+  std::vector<Frame> frames;
+  bool isRead = read(fds[0], &size, 4) == 4;
+  if (isRead) {
+    frames.resize(size / sizeof(Frame));
+    u32 readBytes = 0;
+    while (readBytes < size) {
+      ssize_t bytes = read(fds[0], (u8*)frames.data() + readBytes,
+                           size - readBytes);
+      if (bytes <= 0)
+        break;
+      readBytes += bytes;
+    }
+    isRead = readBytes == size;
+  }
+  close(fds[0]);
+  close(fds[1]);
+  int status;
+  CHECK(pid > 0 && waitpid(pid, &status, 0) == pid);
+  CHECK_MSG(isRead && WIFEXITED(status) && WEXITSTATUS(status) == 0,
+            "can't play with reduce mod %u", reduce);
+  return frames;
+}
+
+static void testReduce(std::string content,
+                       const std::vector<Frame>& normal,
+                       ReduceOpts reduce,
+                       const char* name) {
+  auto frames = play(content, reduce);
+  CHECK(frames.size() == normal.size());
+
+  u32 arrowFrames = 0;
+  int minOffset = 999;
+  int maxOffset = -999;
+  for (u32 i = 0; i < frames.size(); i++) {
+    auto& expected = normal[i];
+    auto& frame = frames[i];
+    if (expected.holderY == NONE) {
+      CHECK(frame.holderY == NONE);
+      continue;
+    }
+
+    // (the field moves down, up to the fixed mod's position)
+    int offset = frame.holderY - expected.holderY;
+    CHECK_MSG(offset >= 0 && offset <= REDUCE_MOD_POSITION_Y,
+              "%s, frame %u: holders moved %d px", name, i, offset);
+    CHECK(frame.lifeBarY == ((expected.lifeBarY + offset) & ATTR0_Y_MASK));
+    minOffset = min(minOffset, offset);
+    maxOffset = max(maxOffset, offset);
+
+    // (arrows are on screen on the same frames, scrolling a shorter distance;
+    // when they reach the holders, they can pass them a frame apart)
+    if ((frame.arrowY == NONE) != (expected.arrowY == NONE)) {
+      int distance = frame.arrowY != NONE ? frame.arrowY - frame.holderY
+                                          : expected.arrowY - expected.holderY;
+      CHECK_MSG(distance <= 1, "%s, frame %u: arrow at %d, expected at %d",
+                name, i, frame.arrowY, expected.arrowY);
+      continue;
+    }
+    if (frame.arrowY == NONE)
+      continue;
+    int distance = (int)ARROW_INITIAL_Y - expected.holderY;
+    int y = frame.holderY + (expected.arrowY - expected.holderY) *
+                                (distance - offset) / distance;
+    CHECK_MSG(ABS(frame.arrowY - y) <= 1,
+              "%s, frame %u: arrow at %d, expected at %d", name, i,
+              frame.arrowY, y);
+    CHECK(frame.arrowY <= (int)ARROW_INITIAL_Y);
+    arrowFrames++;
+  }
+  CHECK(arrowFrames > 0);
+
+  printf("%s: holders %d..%d px lower, %u arrow frames, OK\n", name,
+         minOffset, maxOffset, arrowFrames);
+}
+
+int main() {
+  testOffsets();
+
+  auto content = FIXTURE_createContent(1);
+  FIXTURE_writeSong(content, SONG_NAME, SONG_LAST_MILLISECOND, createEvents());
+
+  auto normal = play(content, ReduceOpts::rOFF);
+  u32 arrowFrames = 0;
+  for (auto& frame : normal) {
+    CHECK(frame.holderY == NONE || frame.holderY == (int)ARROW_FINAL_Y());
+    arrowFrames += frame.arrowY != NONE;
+  }
+  CHECK(arrowFrames > NOTE_COUNT);
+
+  testReduce(content, normal, ReduceOpts::rFIXED, "fixed reduce");
+  testReduce(content, normal, ReduceOpts::rLINEAR, "linear reduce");
+  testReduce(content, normal, ReduceOpts::rMICRO, "micro reduce");
+
+  FIXTURE_removeFolder(content);
+  return 0;
+}
@@ -0,0 +1,247 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <string>
+#include <vector>
+
+#include "gameplay/save/SaveFile.h"
+#include "gameplay/video/VideoStore.h"
+#include "host/fixture.h"
+#include "host/host.h"
+#include "test.h"
+
+// Encodes a synthetic video with the importer (`video_store_test.js`), plays
+// it with `VideoStore` from a host SD card, and compares the screen after
+// each frame with the frames that were encoded, with and without
+// compression and after seeking. A decoded frame must not reach the screen
+// (map, palette or visible tiles) until `onVBlank`, and `decode` must not
+// touch anything while a flip is pending. Videos with frame sizes over
+// `VIDEO_MAX_FRAME_SECTORS` must stop instead of overflowing the buffer.
+
+#define FRAME_COUNT 96
+#define KEYFRAME_INTERVAL 30  // (`VideoSerializer` for short videos)
+#define SEEK_FRAME 75
+#define BACKGROUND_ID 1
+#define BANK_BACKGROUND_TILES 0
+#define BANK_BACKGROUND_MAP 24  // (and 25, like in `SongScene`)
+#define VIDEO_NAME "test.vid"
+#define VIDEO_PATH VIDEOS_FOLDER_NAME VIDEO_NAME
+#define SCRIPT "gameplay/video_store_test.js"  // (tests run from `tests/`)
+
+static std::vector<u16> renderScreen() {
+  u16 control = REG_BGCNT[BACKGROUND_ID];
+  auto map = (const u16*)se_mem[(control >> 8) & 31];
+  auto tiles = (const u8*)tile_mem[(control >> 2) & 3];
+
+  std::vector<u16> screen;
+  for (u32 y = 0; y < GBA_SCREEN_HEIGHT; y++) {
+    for (u32 x = 0; x < GBA_SCREEN_WIDTH; x++) {
+      u32 tile = map[(y / 8) * 32 + x / 8] & 0x3ff;
+      u8 pixel = tiles[tile * VIDEO_TILE_SIZE + (y % 8) * 8 + x % 8];
+      screen.push_back(pal_bg_mem[pixel]);
+    }
+  }
+  return screen;
+}
+
+static bool isFrame(const std::vector<u8>& expected, u32 frame) {
+  auto screen = renderScreen();
+  u32 size = screen.size() * sizeof(u16);
+  return memcmp(expected.data() + frame * size, screen.data(), size) == 0;
+}
+
+static u32 msecsOf(u32 frame) {
+  return frame * 100 / 3 + 1;  // (30 fps)
+}
+
+// What the PPU reads: the control register, the front map and the palette.
+static std::vector<u8> captureFront() {
+  u16 control = REG_BGCNT[BACKGROUND_ID];
+  auto map = (const u8*)se_mem[(control >> 8) & 31];
+  auto palette = (const u8*)pal_bg_mem;
+
+  std::vector<u8> front((const u8*)&control, (const u8*)&control + 2);
+  front.insert(front.end(), map, map + VIDEO_SIZE_MAP);
+  front.insert(front.end(), palette, palette + VIDEO_SIZE_PALETTE);
+  return front;
+}
+
+// Everything `decode` writes: tiles, both maps and the palette.
+static std::vector<u8> captureVram() {
+  auto tiles = (const u8*)tile_mem[BANK_BACKGROUND_TILES];
+  auto maps = (const u8*)se_mem[BANK_BACKGROUND_MAP];
+  auto palette = (const u8*)pal_bg_mem;
+
+  std::vector<u8> vram(tiles, tiles + VIDEO_TILE_SLOTS * VIDEO_TILE_SIZE);
+  vram.insert(vram.end(), maps, maps + VIDEO_SIZE_MAP * 2);
+  vram.insert(vram.end(), palette, palette + VIDEO_SIZE_PALETTE);
+  return vram;
+}
+
+// (like `SongScene::drawVideo`, in one go, without the VBlank)
+static bool readAndDecodeFrame() {
+  if (!videoStore->canRead() || !videoStore->preRead())
+    return false;
+  videoStore->advance();
+
+  return videoStore->endRead() &&
+         videoStore->decode(BACKGROUND_ID, BANK_BACKGROUND_TILES,
+                            BANK_BACKGROUND_MAP, 0);
+}
+
+static bool readFrame() {
+  if (!readAndDecodeFrame())
+    return false;
+  videoStore->onVBlank();
+  return true;
+}
+
+static std::string encode(bool compress) {
+  auto sd = FIXTURE_createFolder();
+  const char* node = getenv("NODE");
+  std::string command = std::string(node != NULL ? node : "node") +
+                        " " SCRIPT " " + sd + " " +
+                        std::to_string(FRAME_COUNT) +
+                        (compress ? " --compress" : "");
+  CHECK_MSG(system(command.c_str()) == 0, "%s failed", command.c_str());
+  return sd;
+}
+
+static void load(std::string sd) {
+  HOST_setSD(sd.c_str());
+  SAVEFILE_write8(SRAM->adminSettings.hqMode, HQModeOpts::dACTIVE);
+  CHECK(videoStore->activate() == VideoStore::State::ACTIVE);
+  CHECK(videoStore->load(VIDEO_NAME, 0) == VideoStore::LoadResult::OK);
+}
+
+static void testPlayback(bool compress) {
+  auto sd = encode(compress);
+  auto expected = FIXTURE_readFile(sd + "/expected.bin");
+
+  load(sd);
+  for (u32 frame = 0; frame < FRAME_COUNT; frame++) {
+    CHECK(videoStore->seek(msecsOf(frame)));
+    auto front = captureFront();
+    CHECK_MSG(readAndDecodeFrame(), "can't read frame %u", frame);
+
+    // (decoded mid-display: the previous frame is still on screen)
+    CHECK(videoStore->hasPendingFlip());
+    if (frame > 0) {
+      CHECK_MSG(captureFront() == front, "frame %u changed the front buffers",
+                frame);
+      CHECK_MSG(isFrame(expected, frame - 1), "frame %u tore", frame);
+    }
+
+    videoStore->onVBlank();
+    CHECK(!videoStore->hasPendingFlip());
+    CHECK_MSG(isFrame(expected, frame), "frame %u doesn't match", frame);
+  }
+  CHECK(videoStore->seek(msecsOf(FRAME_COUNT)));
+  CHECK(!videoStore->canRead());  // (end of video)
+  videoStore->unload();
+
+  // (seeking jumps to the previous keyframe and reads up to the target)
+  load(sd);
+  CHECK(videoStore->seek(msecsOf(SEEK_FRAME)));
+  for (u32 i = 0; i <= SEEK_FRAME % KEYFRAME_INTERVAL; i++) {
+    CHECK(readFrame());
+    CHECK(videoStore->seek(msecsOf(SEEK_FRAME)));
+  }
+  CHECK_MSG(isFrame(expected, SEEK_FRAME), "seek doesn't match");
+  videoStore->unload();
+
+  printf("%s video: %u frames, OK\n", compress ? "compressed" : "raw",
+         FRAME_COUNT);
+  FIXTURE_removeFolder(sd);
+}
+
+static void testPendingFlip() {
+  auto sd = encode(true);
+  auto expected = FIXTURE_readFile(sd + "/expected.bin");
+
+  load(sd);
+  CHECK(videoStore->seek(msecsOf(0)));
+  CHECK(readFrame());
+  CHECK(videoStore->seek(msecsOf(1)));
+  CHECK(readAndDecodeFrame());
+
+  // (a second decode before VBlank returns without writing anything)
+  auto vram = captureVram();
+  CHECK(!videoStore->decode(BACKGROUND_ID, BANK_BACKGROUND_TILES,
+                            BANK_BACKGROUND_MAP, 0));
+  CHECK_MSG(captureVram() == vram, "decode wrote during a pending flip");
+  CHECK(videoStore->hasPendingFlip());
+  CHECK(isFrame(expected, 0));
+
+  // (the read frame stays in the buffer, so it can be decoded after VBlank)
+  videoStore->onVBlank();
+  CHECK(isFrame(expected, 1));
+  CHECK(videoStore->decode(BACKGROUND_ID, BANK_BACKGROUND_TILES,
+                           BANK_BACKGROUND_MAP, 0));
+  videoStore->onVBlank();
+  CHECK(isFrame(expected, 1));
+
+  // (and playback goes on)
+  for (u32 frame = 2; frame < KEYFRAME_INTERVAL; frame++) {
+    CHECK(videoStore->seek(msecsOf(frame)));
+    CHECK(readFrame());
+    CHECK_MSG(isFrame(expected, frame), "frame %u doesn't match", frame);
+  }
+  videoStore->unload();
+
+  printf("pending flip: decode skipped, OK\n");
+  FIXTURE_removeFolder(sd);
+}
+
+static void writeU32(std::vector<u8>& data, u32 offset, u32 value) {
+  for (u32 i = 0; i < 4; i++)
+    data[offset + i] = (value >> (i * 8)) & 0xff;
+}
+
+static u32 readU32(const std::vector<u8>& data, u32 offset) {
+  return data[offset] | (data[offset + 1] << 8) | (data[offset + 2] << 16) |
+         (data[offset + 3] << 24);
+}
+
+static void testOversizedFrames() {
+  auto sd = encode(true);
+  auto expected = FIXTURE_readFile(sd + "/expected.bin");
+  auto video = FIXTURE_readFile(sd + VIDEO_PATH);
+  u32 table = VIDEO_SECTOR;
+  u32 firstRecord = readU32(video, table) * VIDEO_SECTOR;
+
+  // (the first record says the next frame is too big)
+  auto corrupt = video;
+  corrupt[firstRecord] = VIDEO_MAX_FRAME_SECTORS + 1;
+  corrupt[firstRecord + 1] = 0;
+  FIXTURE_writeFile(sd + VIDEO_PATH, corrupt);
+  load(sd);
+  CHECK(videoStore->seek(msecsOf(0)));
+  CHECK(readFrame());
+  CHECK(isFrame(expected, 0));
+  CHECK(videoStore->seek(msecsOf(1)));
+  CHECK_MSG(!videoStore->canRead(), "an oversized frame was read");
+  CHECK(videoStore->seek(msecsOf(SEEK_FRAME)));  // (stopped, no jumps)
+  CHECK(!videoStore->canRead());
+
+  // (a keyframe in the table is too big)
+  corrupt = video;
+  writeU32(corrupt, table + (SEEK_FRAME / KEYFRAME_INTERVAL) * 8 + 4,
+           VIDEO_MAX_FRAME_SECTORS + 1);
+  FIXTURE_writeFile(sd + VIDEO_PATH, corrupt);
+  load(sd);
+  CHECK(videoStore->seek(msecsOf(SEEK_FRAME)));
+  CHECK_MSG(!videoStore->canRead(), "an oversized keyframe was read");
+
+  printf("oversized frames: stopped, OK\n");
+  HOST_setSD(NULL);
+  FIXTURE_removeFolder(sd);
+}
+
+int main() {
+  testPlayback(false);
+  testPlayback(true);
+  testPendingFlip();
+  testOversizedFrames();
+  return 0;
+}
@@ -0,0 +1,83 @@
+const fs = require("fs");
+const $path = require("path");
+const IMPORTER = "../../scripts/importer/src";
+const VideoSerializer = require(`${IMPORTER}/serializer/VideoSerializer`);
+
+// Usage: node video_store_test.js <output dir> <frame count> [--compress]
+// Encodes a synthetic video with the importer's `VideoSerializer` into
+// `<output dir>/piuGBA_videos/test.vid`, and writes what each frame should
+// look like (`SCREEN_WIDTH`x`SCREEN_HEIGHT` BGR555 colors) to
+// `<output dir>/expected.bin` (see `video_store_test.cpp`).
+
+const SCREEN_WIDTH = 240;
+const SCREEN_HEIGHT = 160;
+const MAP_SIZE = 32;
+const WORLD_SIZE = 64;
+const TILE_SIZE = 64;
+const TILE_COUNT = 300;
+const COLORS = 256;
+const FIRST_COLOR = 1;
+const LAST_COLOR = 253;
+const PALETTE_CHANGE_FRAMES = 16;
+
+const [outputPath, frameCountArg, flag] = process.argv.slice(2);
+const frameCount = parseInt(frameCountArg);
+
+let seed = 1;
+const random = (max) => {
+  seed = (seed * 1103515245 + 12345) >>> 0;
+  return (seed >>> 16) % max;
+};
+
+const tiles = Buffer.alloc(TILE_COUNT * TILE_SIZE);
+for (let i = 0; i < tiles.length; i++)
+  tiles[i] = FIRST_COLOR + random(LAST_COLOR - FIRST_COLOR + 1);
+const world = [];
+for (let i = 0; i < WORLD_SIZE * WORLD_SIZE; i++)
+  world.push(random(TILE_COUNT));
+const colors = [];
+for (let i = 0; i < COLORS; i++) colors.push(i === 0 ? 0 : random(0x8000));
+
+const serializer = new VideoSerializer(frameCount, {
+  compress: flag === "--compress",
+});
+const expected = [];
+for (let frame = 0; frame < frameCount; frame++) {
+  // (a few colors change now and then, and the map scrolls)
+  if (frame > 0 && frame % PALETTE_CHANGE_FRAMES === 0)
+    for (let i = 0; i < 8; i++)
+      colors[FIRST_COLOR + random(LAST_COLOR - FIRST_COLOR + 1)] =
+        random(0x8000);
+  const palette = Buffer.alloc(COLORS * 2);
+  colors.forEach((it, i) => palette.writeUInt16LE(it, i * 2));
+
+  const map = Buffer.alloc(MAP_SIZE * MAP_SIZE * 2);
+  const tileAt = (row, col) =>
+    world[
+      ((row + (frame >> 2)) % WORLD_SIZE) * WORLD_SIZE +
+        ((col + frame) % WORLD_SIZE)
+    ];
+  for (let row = 0; row < MAP_SIZE; row++)
+    for (let col = 0; col < MAP_SIZE; col++)
+      map.writeUInt16LE(tileAt(row, col), (row * MAP_SIZE + col) * 2);
+  serializer.addFrame(palette, map, tiles);
+
+  const screen = Buffer.alloc(SCREEN_WIDTH * SCREEN_HEIGHT * 2);
+  for (let y = 0; y < SCREEN_HEIGHT; y++)
+    for (let x = 0; x < SCREEN_WIDTH; x++) {
+      const tile = tileAt(y >> 3, x >> 3);
+      const pixel = tiles[tile * TILE_SIZE + (y & 7) * 8 + (x & 7)];
+      screen.writeUInt16LE(colors[pixel], (y * SCREEN_WIDTH + x) * 2);
+    }
+  expected.push(screen);
+}
+
+fs.mkdirSync($path.join(outputPath, "piuGBA_videos"), { recursive: true });
+fs.writeFileSync(
+  $path.join(outputPath, "piuGBA_videos", "test.vid"),
+  serializer.serialize()
+);
+fs.writeFileSync(
+  $path.join(outputPath, "expected.bin"),
+  Buffer.concat(expected)
+);
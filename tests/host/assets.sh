@@ -0,0 +1,47 @@
+#!/bin/bash
+
+# Writes placeholder sprite and palette headers for the host build (there's
+# no `grit` there). Tiles have the real sizes, so VRAM allocations match the
+# GBA, but they're blank.
+# Usage: assets.sh <data dir> <destination>
+
+SOURCE="$1"
+DESTINATION="$2/data/content/_compiled_sprites"
+PALETTES="song selection start controls break grade grade_multi"
+
+mkdir -p "$DESTINATION"
+DEFINITIONS="$DESTINATION/host_assets.c"
+echo "// (generated by tests/host/assets.sh)" > "$DEFINITIONS"
+
+for file in "$SOURCE"/spr_*.bmp; do
+  name=$(basename "$file" .bmp)
+  width=$(od -An -tu4 -j18 -N4 "$file" | tr -d ' ')
+  height=$(od -An -tu4 -j22 -N4 "$file" | tr -d ' ')
+  length=$((width * height))  # (8bpp)
+
+  cat > "$DESTINATION/$name.h" <<HEADER
+#ifndef GRIT_${name^^}_H
+#define GRIT_${name^^}_H
+
+#define ${name}TilesLen $length
+extern const unsigned int ${name}Tiles[$((length / 4))];
+
+#endif
+HEADER
+  echo "const unsigned int ${name}Tiles[$((length / 4))] = {0};" \
+    >> "$DEFINITIONS"
+done
+
+for palette in $PALETTES; do
+  name="palette_$palette"
+  cat > "$DESTINATION/$name.h" <<HEADER
+#ifndef GRIT_${name^^}_H
+#define GRIT_${name^^}_H
+
+#define ${name}PalLen 512
+extern const unsigned short ${name}Pal[256];
+
+#endif
+HEADER
+  echo "const unsigned short ${name}Pal[256] = {0};" >> "$DEFINITIONS"
+done
@@ -0,0 +1,330 @@
+#include <libgba-sprite-engine/allocator.h>
+#include <libgba-sprite-engine/background/background.h>
+#include <libgba-sprite-engine/background/text_stream.h>
+#include <libgba-sprite-engine/gba/tonc_bios.h>
+#include <libgba-sprite-engine/gba_engine.h>
+#include <libgba-sprite-engine/palette/palette_manager.h>
+#include <libgba-sprite-engine/sprites/sprite.h>
+#include <libgba-sprite-engine/sprites/sprite_manager.h>
+
+#include <stdio.h>
+#include <algorithm>
+
+// Host implementation of the parts of libgba-sprite-engine that the game
+// uses (the library is only shipped as an ARM archive). It follows the
+// library's behavior where the game depends on it: scene switching order,
+// OBJ tile allocation, palette and background uploads and the OAM copy.
+
+#define TEXT_SCREEN_BLOCK 24
+#define TEXT_CHAR_BLOCK 0
+
+static u16 toColor(u32 r, u32 g, u32 b) {
+  return (r & 31) | ((g & 31) << 5) | ((b & 31) << 10);
+}
+
+// --- Allocator ---
+
+std::vector<AllocatedData> Allocator::allocatedSprites;
+u32 Allocator::currentSpriteIndex = MEM_OBJ_VRAM_BASE;
+
+void Allocator::free() {
+  allocatedSprites.clear();
+  currentSpriteIndex = MEM_OBJ_VRAM_BASE;
+}
+
+AllocatedData& Allocator::allocateObjectTiles(u32 size) {
+  allocatedSprites.push_back(
+      AllocatedData(currentSpriteIndex, size, MEM_OBJ_VRAM_BASE));
+  currentSpriteIndex += size;
+  return allocatedSprites.back();
+}
+
+// --- Palettes ---
+
+int getBits(int number, int k, int p) {
+  return (((1 << k) - 1) & (number >> (p - 1)));
+}
+
+PaletteManager::PaletteManager() : data(NULL), size(0) {}
+
+PaletteManager::PaletteManager(const COLOR paletteData[], int size)
+    : data(paletteData), size(size) {}
+
+void PaletteManager::persist() {
+  if (data == NULL)
+    return;
+
+  // (sizes are given in bytes or in colors, so it copies at most a palette)
+  u32 colors = size < PALETTE_MAX_SIZE ? size : PALETTE_MAX_SIZE;
+  memcpy(paletteAddress(), data, colors * sizeof(COLOR));
+}
+
+void PaletteManager::persistToBank(int bank) {
+  if (data == NULL)
+    return;
+
+  memcpy(paletteBank()[bank], data, PALETTE_BANK_SIZE * sizeof(COLOR));
+}
+
+COLOR PaletteManager::change(int bank, int index, COLOR newColor) {
+  COLOR previous = paletteBank()[bank][index];
+  paletteBank()[bank][index] = newColor;
+  return previous;
+}
+
+COLOR PaletteManager::color(u32 r, u32 g, u32 b) {
+  return toColor(r, g, b);
+}
+
+// --- Backgrounds ---
+
+void Background::persist() {
+  if (data != NULL) {
+    if (lz77)
+      LZ77UnCompVram(data, char_block(charBlockIndex));
+    else
+      memcpy(char_block(charBlockIndex), data, size);
+  }
+  if (map != NULL)
+    memcpy(screen_block(screenBlockIndex), map, mapSize);
+  buildRegister();
+}
+
+void Background::render() {
+  scrollNow(scrollX, scrollY);
+}
+
+void Background::clearMap() {
+  memset(screen_block(screenBlockIndex), 0, mapSize);
+}
+
+void Background::clearData() {
+  memset(char_block(charBlockIndex), 0, size);
+}
+
+void Background::scroll(int x, int y) {
+  scrollX = x;
+  scrollY = y;
+}
+
+void Background::scrollNow(int x, int y) {
+  scroll(x, y);
+  REG_BG_OFS[bgIndex].x = x;
+  REG_BG_OFS[bgIndex].y = y;
+}
+
+void Background::buildRegister() {
+  REG_BGCNT[bgIndex] = BG_CBB(charBlockIndex) | BG_SBB(screenBlockIndex) |
+                       BG_8BPP | (mapLayout << 14) | (mosaicEnabled << 6) |
+                       priority;
+}
+
+u32 Background::getBgControlRegisterIndex() {
+  return 0x0008 + bgIndex * 2;
+}
+
+// --- Text ---
+
+TextStream* TextStream::inst = NULL;
+
+TextStream::TextStream()
+    : Background(0, NULL, 0, NULL, 0), currRow(0), currCol(0) {
+  useMapScreenBlock(TEXT_SCREEN_BLOCK);
+  useCharBlock(TEXT_CHAR_BLOCK);
+}
+
+TextStream& TextStream::instance() {
+  if (inst == NULL)
+    inst = new TextStream();
+  return *inst;
+}
+
+void TextStream::persist() {
+  REG_BGCNT[bgIndex] =
+      BG_CBB(charBlockIndex) | BG_SBB(screenBlockIndex) | priority;
+}
+
+void TextStream::clear() {
+  currRow = 0;
+  currCol = 0;
+  memset(se_mem[screenBlockIndex], 0, sizeof(SCREENBLOCK));
+}
+
+void TextStream::setText(std::string text, int row, int col) {
+  setText(text.c_str(), row, col);
+}
+
+void TextStream::setText(const char* text, int row, int col) {
+  // (every row starts at cell 3 and a write clears the rest of its 32 cells)
+  u16* map = (u16*)se_mem[screenBlockIndex];
+  int start = row * TILE_WIDTH + col + 3;
+  int length = strlen(text);
+  for (int i = 0; i < std::max(length, TILE_WIDTH); i++) {
+    if (start + i >= 0 && start + i < TILE_WIDTH * TILE_WIDTH)
+      map[start + i] = i < length ? text[i] - CHAR_OFFSET_INDEX : 0;
+  }
+}
+
+void TextStream::setFontColor(COLOR color) {
+  pal_bg_bank[PALETTE_TEXT_BANK][PALETTE_COLOR_INDEX] = color;
+}
+
+void TextStream::setFontSubcolor(COLOR color) {
+  pal_bg_bank[PALETTE_TEXT_BANK][PALETTE_COLOR_INDEX - 1] = color;
+}
+
+void TextStream::setFontStyle(const void* data, int size) {}
+
+TextStream& TextStream::operator<<(const char* s) {
+  setText(s, currRow, currCol);
+  currRow++;
+  return *this;
+}
+
+TextStream& TextStream::operator<<(const int s) {
+  return *this << std::to_string(s).c_str();
+}
+
+TextStream& TextStream::operator<<(const u32 s) {
+  return *this << std::to_string(s).c_str();
+}
+
+TextStream& TextStream::operator<<(const bool s) {
+  return *this << (s ? "true" : "false");
+}
+
+void log_text(const char* text) {
+  fprintf(stderr, "%s\n", text);
+}
+
+// --- Sprites ---
+
+Sprite::Sprite(const Sprite& other) : Sprite(NULL, 0, 0, 0, SIZE_8_8) {
+  *this = other;
+}
+
+Sprite::Sprite(const void* imageData,
+               int imageSize,
+               int x,
+               int y,
+               SpriteSize size)
+    : data(imageData),
+      x(x),
+      y(y),
+      priority(0),
+      affineId(0),
+      imageSize(imageSize),
+      tileIndex(0),
+      spriteSize(size),
+      animationDelay(0),
+      numberOfFrames(0),
+      beginFrame(0),
+      currentFrame(0),
+      previousFrame(-1),
+      animationCounter(0),
+      animating(false),
+      doubleSize(false) {
+  oam = OBJ_ATTR{0, 0, 0, 0};
+  setAttributesBasedOnSize(size);
+}
+
+void SpriteManager::hideAll() {
+  for (u32 i = 0; i < 128; i++)
+    oam_mem[i].attr0 = ATTR0_HIDE;
+}
+
+void SpriteManager::add(Sprite* sprite) {
+  sprites.push_back(sprite);
+}
+
+void SpriteManager::set(std::vector<Sprite*> sprites) {
+  initialized = false;
+  this->sprites = sprites;
+}
+
+void SpriteManager::persist() {
+  copyOverImageDataToVRAM();
+  initialized = true;
+}
+
+void SpriteManager::copyOverSpriteOAMToVRAM() {
+  u32 i = 0;
+  for (auto sprite : sprites) {
+    if (sprite->enabled) {
+      sprite->update();
+      oam_mem[i] = sprite->oam;
+    }
+    i++;
+  }
+}
+
+void SpriteManager::copyOverImageDataToVRAM(Sprite* sprite) {
+  // (sprites without data reuse the tiles of the previous allocation)
+  if (sprite->data == NULL && !Allocator::allocatedSprites.empty()) {
+    sprite->buildOam(Allocator::allocatedSprites.back().getTileLocation());
+    return;
+  }
+
+  auto& allocated = Allocator::allocateObjectTiles(sprite->imageSize);
+  if (sprite->data != NULL)
+    memcpy(allocated.pointer(), sprite->data, sprite->imageSize);
+  sprite->buildOam(allocated.getTileLocation());
+}
+
+void SpriteManager::copyOverImageDataToVRAM() {
+  for (auto sprite : sprites)
+    copyOverImageDataToVRAM(sprite);
+}
+
+// --- Engine ---
+
+GBAEngine::GBAEngine()
+    : currentScene(NULL),
+      sceneToTransitionTo(NULL),
+      currentEffectForTransition(NULL),
+      disableTextBg(false) {}
+
+void GBAEngine::setScene(Scene* scene) {
+  if (currentScene != NULL) {
+    cleanupPreviousScene();
+    if (!disableTextBg)
+      TextStream::instance().clear();
+  }
+
+  scene->load();
+  scene->getForegroundPalette()->persist();
+  scene->getBackgroundPalette()->persist();
+
+  Allocator::free();
+  spriteManager.set(scene->sprites());
+  spriteManager.persist();
+
+  if (!disableTextBg)
+    TextStream::instance().persist();
+  for (auto bg : scene->backgrounds())
+    bg->persist();
+
+  currentScene = scene;
+  updateSpritesInScene();
+}
+
+void GBAEngine::transitionIntoScene(Scene* scene, SceneEffect* effect) {
+  sceneToTransitionTo = scene;
+  currentEffectForTransition = effect;
+  currentEffectForTransition->setSceneToAffect(currentScene);
+}
+
+void GBAEngine::updateSpritesInScene() {
+  Allocator::free();
+  spriteManager.hideAll();
+  spriteManager.set(currentScene->sprites());
+  spriteManager.persist();
+}
+
+void GBAEngine::cleanupPreviousScene() {
+  delete currentScene;
+  currentScene = NULL;
+  sceneToTransitionTo = NULL;
+  delete currentEffectForTransition;
+  currentEffectForTransition = NULL;
+}
@@ -0,0 +1,515 @@
+#include "fixture.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+
+#include "gameplay/Sequence.h"
+#include "gameplay/models/Chart.h"
+#include "gameplay/save/SaveFile.h"
+#include "host.h"
+#include "player/PlaybackState.h"
+
+#define TITLE_LEN 31
+#define ARTIST_LEN 27
+#define MOD_BYTES 11  // (applyTo[3], isBoss, pixelate...speedHack, hasMessage)
+#define AUDIO_EXTRA_MSECS 3000
+#define GSM_SAMPLE_RATE 18157
+#define GSM_CHUNK_SIZE 33
+#define GSM_CHUNK_SAMPLES 160
+#define BEAT_FRAMES (60 * 60 / FIXTURE_BPM)
+#define EXTRA_FRAMES (60 * 30)  // (loading, transitions and song end)
+#define LZ77_SCRIPT "host/lz77_compress.js"
+#define FAT_SECTOR 512
+#define FAT_CLUSTER_SECTORS 4
+#define FAT_CLUSTER_SIZE (FAT_SECTOR * FAT_CLUSTER_SECTORS)
+#define FAT_ROOT_ENTRIES 512
+#define FAT_ENTRY_SIZE 32
+#define FAT_MIN_CLUSTERS 4200  // (FatFs takes 4085 clusters or less as FAT12)
+#define FAT_FRAGMENT_CLUSTERS 3
+#define FAT_LFN_CHARS 13
+#define FAT_DATE ((40 << 9) | (1 << 5) | 1)  // (2020-01-01)
+
+// (DOWNLEFT, UPLEFT, CENTER, UPRIGHT, DOWNRIGHT)
+static const u16 ARROW_KEYS[] = {KEY_DOWN, KEY_L, KEY_B, KEY_R, KEY_A};
+
+static void writeU32(std::vector<u8>& data, u32 value) {
+  for (u32 i = 0; i < 4; i++)
+    data.push_back((value >> (i * 8)) & 0xff);
+}
+
+void FIXTURE_writeFile(std::string path, const std::vector<u8>& data) {
+  FILE* file = fopen(path.c_str(), "wb");
+  if (file == NULL ||
+      fwrite(data.data(), 1, data.size(), file) != data.size()) {
+    fprintf(stderr, "[fixture] can't write %s\n", path.c_str());
+    exit(1);
+  }
+  fclose(file);
+}
+
+std::vector<u8> FIXTURE_readFile(std::string path) {
+  FILE* file = fopen(path.c_str(), "rb");
+  if (file == NULL) {
+    fprintf(stderr, "[fixture] can't read %s\n", path.c_str());
+    exit(1);
+  }
+
+  std::vector<u8> data;
+  u8 buffer[4096];
+  size_t read;
+  while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0)
+    data.insert(data.end(), buffer, buffer + read);
+  fclose(file);
+  return data;
+}
+
+std::string FIXTURE_createFolder() {
+  char path[] = "/tmp/piugba-test-XXXXXX";
+  if (mkdtemp(path) == NULL) {
+    perror("[fixture] mkdtemp");
+    exit(1);
+  }
+  return path;
+}
+
+std::string FIXTURE_createContent(u32 songCount) {
+  auto path = FIXTURE_createFolder();
+  std::vector<u8> romId;
+  writeU32(romId, 0x12345600 | songCount);
+  FIXTURE_writeFile(path + "/_rom_id.u32", romId);
+  return path;
+}
+
+void FIXTURE_removeFolder(std::string path) {
+  if (system(("rm -rf " + path).c_str()) != 0)
+    fprintf(stderr, "[fixture] can't remove %s\n", path.c_str());
+}
+
+std::vector<u8> FIXTURE_serializeEvents(const std::vector<FixtureEvent>& events,
+                                        bool isDouble) {
+  std::vector<u8> data;
+  for (auto& event : events) {
+    writeU32(data, ((event.timestamp & 0x7fffff) << 1) |
+                       ((event.type | (event.arrows & ~EVENT_TYPE)) << 24));
+    if (EVENT_HAS_DATA2(event.type, isDouble))
+      data.push_back(event.data2);
+    for (auto param : event.params)
+      writeU32(data, param);
+  }
+  return data;
+}
+
+std::vector<u8> FIXTURE_compress(const std::vector<std::vector<u8>>& blocks,
+                                 bool isVram) {
+  auto path = FIXTURE_createFolder();
+  std::string input = path + "/input.bin";
+  std::string output = path + "/output.bin";
+
+  std::vector<u8> data;
+  for (auto& block : blocks) {
+    writeU32(data, block.size());
+    data.insert(data.end(), block.begin(), block.end());
+  }
+  FIXTURE_writeFile(input, data);
+
+  const char* node = getenv("NODE");
+  std::string command = std::string(node != NULL ? node : "node") +
+                        " " LZ77_SCRIPT " " + input + " " + output +
+                        (isVram ? " --vram" : "");
+  if (system(command.c_str()) != 0) {
+    fprintf(stderr, "[fixture] %s failed\n", command.c_str());
+    exit(1);
+  }
+
+  auto compressed = FIXTURE_readFile(output);
+  FIXTURE_removeFolder(path);
+  return compressed;
+}
+
+static std::vector<u8> compressEvents(const std::vector<FixtureEvent>& events) {
+  std::vector<std::vector<u8>> blocks;
+  for (u32 i = 0; i < events.size(); i += EVENT_STREAM_BLOCK_EVENTS) {
+    auto end = events.begin() +
+               std::min(i + EVENT_STREAM_BLOCK_EVENTS, (u32)events.size());
+    blocks.push_back(FIXTURE_serializeEvents(
+        std::vector<FixtureEvent>(events.begin() + i, end), false));
+  }
+  return FIXTURE_compress(blocks);
+}
+
+void FIXTURE_writeSong(std::string content,
+                       std::string name,
+                       u32 lastMillisecond,
+                       const std::vector<FixtureEvent>& events,
+                       bool isCompressed) {
+  std::vector<FixtureEvent> rhythmEvents = {
+      {0, EventType::SET_TEMPO, 0,
+       {(BEAT_FRAMES << 20) | FIXTURE_BPM, FIXTURE_BPM << 16, 1}},
+      {0, EventType::SET_TICKCOUNT, 0, {4}}};
+  auto rhythmData = isCompressed ? compressEvents(rhythmEvents)
+                                 : FIXTURE_serializeEvents(rhythmEvents, false);
+  auto eventData = isCompressed ? compressEvents(events)
+                                : FIXTURE_serializeEvents(events, false);
+
+  std::vector<u8> metadata = {1 /* id */};
+  metadata.resize(metadata.size() + TITLE_LEN + ARTIST_LEN, 0);
+  metadata.push_back(0);  // (channel)
+  writeU32(metadata, lastMillisecond);
+  writeU32(metadata, 0);  // (sampleStart)
+  writeU32(metadata, 0);  // (sampleLength)
+  writeU32(metadata, 0);  // (videoOffset)
+  metadata.resize(metadata.size() + MOD_BYTES, 0);
+  metadata.push_back(1);  // (chartCount)
+
+  metadata.insert(metadata.end(),
+                  {0 /* NORMAL */, 5 /* level */, 0, 0,
+                   (u8)(isCompressed ? CHART_COMPRESSED_EVENTS : 0)});
+  writeU32(metadata, (isCompressed ? 16 : 8) + rhythmData.size() +
+                         eventData.size());
+  writeU32(metadata, rhythmEvents.size());
+  if (isCompressed)
+    writeU32(metadata, rhythmData.size());
+  metadata.insert(metadata.end(), rhythmData.begin(), rhythmData.end());
+  writeU32(metadata, events.size());
+  if (isCompressed)
+    writeU32(metadata, eventData.size());
+  metadata.insert(metadata.end(), eventData.begin(), eventData.end());
+  FIXTURE_writeFile(content + "/" + name + ".pius", metadata);
+
+  u64 samples =
+      (u64)(lastMillisecond + AUDIO_EXTRA_MSECS) * GSM_SAMPLE_RATE / 1000;
+  FIXTURE_writeFile(
+      content + "/" + name + ".gsm",
+      std::vector<u8>(samples / GSM_CHUNK_SAMPLES * GSM_CHUNK_SIZE, 0));
+}
+
+std::vector<FixtureEvent> FIXTURE_createNotes(u32 eventCount, u32* noteCount) {
+  std::vector<FixtureEvent> events;
+  *noteCount = 0;
+  for (u32 i = 0; events.size() < eventCount; i++) {
+    int timestamp = FIXTURE_FIRST_NOTE + i * FIXTURE_NOTE_INTERVAL;
+    u8 arrow = EVENT_ARROW_MASKS[i % 5];
+    if (i % FIXTURE_HOLD_EVERY == FIXTURE_HOLD_EVERY - 1 &&
+        events.size() < eventCount - 1) {
+      events.push_back(
+          {timestamp, EventType::HOLD_START, arrow, {FIXTURE_HOLD_LENGTH}});
+      events.push_back(
+          {timestamp + FIXTURE_HOLD_LENGTH, EventType::HOLD_END, arrow});
+    } else {
+      events.push_back({timestamp, EventType::NOTE, arrow});
+    }
+    (*noteCount)++;
+  }
+  std::stable_sort(events.begin(), events.end(),
+                   [](const FixtureEvent& a, const FixtureEvent& b) {
+                     return a.timestamp < b.timestamp;
+                   });
+  return events;
+}
+
+FixtureResult FIXTURE_playSong(std::string content,
+                               std::string name,
+                               u32 lastMillisecond,
+                               const std::vector<FixtureEvent>& events) {
+  int fds[2];
+  if (pipe(fds) != 0) {
+    perror("[fixture] pipe");
+    exit(1);
+  }
+  fflush(stdout);
+
+  pid_t pid = fork();
+  if (pid == 0) {
+    HOST_init(content.c_str());
+    SAVEFILE_write8(SRAM->state.gameMode, GameMode::ARCADE);
+    SongFile file(name.c_str(), 0);
+    Song* song = SONG_parse(find_first_gbfs_file(0), &file, {0});
+    SEQUENCE_goToMessageOrSong(song, song->charts);
+
+    FixturePlayer player(&events);
+    u32 maxFrames = lastMillisecond * 60 / 1000 + EXTRA_FRAMES;
+    while (SAVEFILE_read32(SRAM->stats.stagePasses) == 0 &&
+           HOST_getFrame() < maxFrames) {
+      HOST_setKeys(player.getKeys(PlaybackState.msecs));
+      HOST_runFrame();
+    }
+
+    FixtureResult result = {SAVEFILE_read32(SRAM->stats.stagePasses) > 0,
+                            HOST_getFrame(),
+                            SAVEFILE_read32(SRAM->stats.sGrades) > 0,
+                            SAVEFILE_read32(SRAM->stats.maxCombo)};
+    bool isSent = write(fds[1], &result, sizeof(result)) == sizeof(result);
+    _exit(isSent ? 0 : 1);
+  }
+
+  FixtureResult result = {};
+  int status;
+  bool isRead = read(fds[0], &result, sizeof(result)) == sizeof(result);
+  close(fds[0]);
+  close(fds[1]);
+  if (pid < 0 || waitpid(pid, &status, 0) != pid || !isRead) {
+    fprintf(stderr, "[fixture] can't play %s\n", name.c_str());
+    exit(1);
+  }
+  return result;
+}
+
+u16 FixturePlayer::getKeys(int msecs) {
+  auto onHoldStart = [this](const FixtureEvent& event) {
+    for (u32 i = 0; i < 5; i++) {
+      if ((event.arrows & EVENT_ARROW_MASKS[i]) &&
+          event.type == EventType::HOLD_START)
+        holdEnds[i] = event.timestamp + event.params[0];
+    }
+  };
+
+  while (cursor < events->size() &&
+         (*events)[cursor].timestamp < msecs - FIXTURE_PRESS_WINDOW) {
+    onHoldStart((*events)[cursor]);
+    cursor++;
+  }
+
+  u16 keys = 0;
+  for (u32 i = cursor; i < events->size(); i++) {
+    auto& event = (*events)[i];
+    if (event.timestamp > msecs + FIXTURE_PRESS_WINDOW)
+      break;
+    if (event.type != EventType::NOTE && event.type != EventType::HOLD_START)
+      continue;
+
+    onHoldStart(event);
+    for (u32 j = 0; j < 5; j++) {
+      if (event.arrows & EVENT_ARROW_MASKS[j])
+        keys |= ARROW_KEYS[j];
+    }
+  }
+  for (u32 i = 0; i < 5; i++) {
+    if (msecs <= holdEnds[i])
+      keys |= ARROW_KEYS[i];
+  }
+
+  return keys;
+}
+
+typedef struct {
+  std::string name;
+  bool isDirectory;
+  u32 parent;
+  std::vector<u32> children;
+  std::vector<u8> data;
+  std::vector<u32> clusters;
+} FatNode;
+
+static void writeU16At(std::vector<u8>& data, u32 offset, u32 value) {
+  data[offset] = value & 0xff;
+  data[offset + 1] = (value >> 8) & 0xff;
+}
+
+static void writeU32At(std::vector<u8>& data, u32 offset, u32 value) {
+  writeU16At(data, offset, value & 0xffff);
+  writeU16At(data, offset + 2, value >> 16);
+}
+
+static u32 findChild(const std::vector<FatNode>& nodes,
+                     u32 parent,
+                     std::string name) {
+  for (u32 child : nodes[parent].children) {
+    if (nodes[child].name == name)
+      return child;
+  }
+  return 0;
+}
+
+// Appends the long name entries (last part first) and the short name entry.
+static void writeFatEntry(std::vector<u8>& directory,
+                          std::string longName,
+                          std::string shortName,
+                          u8 attributes,
+                          u32 cluster,
+                          u32 size) {
+  const u32 CHAR_OFFSETS[FAT_LFN_CHARS] = {1,  3,  5,  7,  9,  14, 16,
+                                           18, 20, 22, 24, 28, 30};
+  u8 checksum = 0;
+  for (u32 i = 0; i < 11; i++)
+    checksum = ((checksum & 1) << 7) + (checksum >> 1) + (u8)shortName[i];
+
+  u32 parts = longName.empty()
+                  ? 0
+                  : (longName.size() + FAT_LFN_CHARS - 1) / FAT_LFN_CHARS;
+  for (u32 part = parts; part > 0; part--) {
+    std::vector<u8> entry(FAT_ENTRY_SIZE, 0);
+    entry[0] = part | (part == parts ? 0x40 : 0);
+    entry[11] = 0x0f;
+    entry[13] = checksum;
+    for (u32 i = 0; i < FAT_LFN_CHARS; i++) {
+      u32 position = (part - 1) * FAT_LFN_CHARS + i;
+      u32 character = position < longName.size() ? (u8)longName[position]
+                      : position == longName.size() ? 0
+                                                    : 0xffff;
+      writeU16At(entry, CHAR_OFFSETS[i], character);
+    }
+    directory.insert(directory.end(), entry.begin(), entry.end());
+  }
+
+  std::vector<u8> entry(FAT_ENTRY_SIZE, 0);
+  memcpy(entry.data(), shortName.data(), 11);
+  entry[11] = attributes;
+  writeU16At(entry, 20, cluster >> 16);
+  writeU16At(entry, 24, FAT_DATE);
+  writeU16At(entry, 26, cluster & 0xffff);
+  writeU32At(entry, 28, size);
+  directory.insert(directory.end(), entry.begin(), entry.end());
+}
+
+std::map<std::string, std::vector<u32>> FIXTURE_writeFatImage(
+    std::string image,
+    std::string folder,
+    const std::vector<std::string>& paths) {
+  // (node 0 is the root folder)
+  std::vector<FatNode> nodes = {{"", true, 0, {}, {}, {}}};
+  std::vector<u32> files;
+  for (auto& path : paths) {
+    u32 parent = 0;
+    size_t start = 1;
+    size_t end;
+    while ((end = path.find('/', start)) != std::string::npos) {
+      auto name = path.substr(start, end - start);
+      u32 child = findChild(nodes, parent, name);
+      if (child == 0) {
+        child = nodes.size();
+        nodes.push_back({name, true, parent, {}, {}, {}});
+        nodes[parent].children.push_back(child);
+      }
+      parent = child;
+      start = end + 1;
+    }
+    nodes.push_back({path.substr(start), false, parent, {},
+                     FIXTURE_readFile(folder + path), {}});
+    nodes[parent].children.push_back(nodes.size() - 1);
+    files.push_back(nodes.size() - 1);
+  }
+
+  // (folders take one cluster each, then files take turns)
+  u32 nextCluster = 2;
+  for (u32 i = 1; i < nodes.size(); i++) {
+    if (nodes[i].isDirectory)
+      nodes[i].clusters.push_back(nextCluster++);
+  }
+  bool isAllocating = true;
+  while (isAllocating) {
+    isAllocating = false;
+    for (u32 file : files) {
+      auto& node = nodes[file];
+      u32 clusters = (node.data.size() + FAT_CLUSTER_SIZE - 1) /
+                     FAT_CLUSTER_SIZE;
+      for (u32 i = 0; i < FAT_FRAGMENT_CLUSTERS &&
+                      node.clusters.size() < clusters;
+           i++)
+        node.clusters.push_back(nextCluster++);
+      isAllocating = isAllocating || node.clusters.size() < clusters;
+    }
+  }
+
+  u32 clusterCount = std::max((u32)FAT_MIN_CLUSTERS, nextCluster - 2);
+  u32 fatSectors = ((clusterCount + 2) * 2 + FAT_SECTOR - 1) / FAT_SECTOR;
+  u32 rootSector = 1 + fatSectors;
+  u32 dataSector = rootSector + FAT_ROOT_ENTRIES * FAT_ENTRY_SIZE / FAT_SECTOR;
+  u32 totalSectors = dataSector + clusterCount * FAT_CLUSTER_SECTORS;
+  std::vector<u8> disk(totalSectors * FAT_SECTOR, 0);
+  auto sectorOf = [dataSector](u32 cluster) {
+    return dataSector + (cluster - 2) * FAT_CLUSTER_SECTORS;
+  };
+
+  // (boot sector)
+  const u8 JUMP[] = {0xeb, 0x3c, 0x90};
+  memcpy(disk.data(), JUMP, sizeof(JUMP));
+  memcpy(disk.data() + 3, "MSWIN4.1", 8);
+  writeU16At(disk, 11, FAT_SECTOR);
+  disk[13] = FAT_CLUSTER_SECTORS;
+  writeU16At(disk, 14, 1);  // (reserved sectors)
+  disk[16] = 1;             // (FATs)
+  writeU16At(disk, 17, FAT_ROOT_ENTRIES);
+  if (totalSectors < 0x10000)
+    writeU16At(disk, 19, totalSectors);
+  else
+    writeU32At(disk, 32, totalSectors);
+  disk[21] = 0xf8;  // (fixed media)
+  writeU16At(disk, 22, fatSectors);
+  disk[38] = 0x29;  // (extended boot signature)
+  writeU32At(disk, 39, 0x12345678);
+  memcpy(disk.data() + 43, "PIUGBA     ", 11);
+  memcpy(disk.data() + 54, "FAT16   ", 8);
+  writeU16At(disk, 510, 0xaa55);
+
+  // (FAT)
+  u32 fat = FAT_SECTOR;
+  writeU16At(disk, fat, 0xfff8);
+  writeU16At(disk, fat + 2, 0xffff);
+  for (auto& node : nodes) {
+    for (u32 i = 0; i < node.clusters.size(); i++) {
+      u32 next = i + 1 < node.clusters.size() ? node.clusters[i + 1] : 0xffff;
+      writeU16At(disk, fat + node.clusters[i] * 2, next);
+    }
+  }
+
+  // (folders and file data)
+  u32 shortNames = 0;
+  for (auto& node : nodes) {
+    if (!node.isDirectory) {
+      for (u32 i = 0; i < node.clusters.size(); i++) {
+        u32 offset = i * FAT_CLUSTER_SIZE;
+        u32 size = std::min((u32)node.data.size() - offset,
+                            (u32)FAT_CLUSTER_SIZE);
+        memcpy(disk.data() + sectorOf(node.clusters[i]) * FAT_SECTOR,
+               node.data.data() + offset, size);
+      }
+      continue;
+    }
+
+    std::vector<u8> directory;
+    bool isRoot = node.clusters.empty();
+    if (!isRoot) {
+      u32 parentCluster = node.parent == 0 ? 0 : nodes[node.parent].clusters[0];
+      writeFatEntry(directory, "", ".          ", 0x10, node.clusters[0], 0);
+      writeFatEntry(directory, "", "..         ", 0x10, parentCluster, 0);
+    }
+    for (u32 child : node.children) {
+      auto& entry = nodes[child];
+      char shortName[12];
+      snprintf(shortName, sizeof(shortName), entry.isDirectory ? "D%07u   "
+                                                               : "F%07uBIN",
+               ++shortNames);
+      writeFatEntry(directory, entry.name, shortName,
+                    entry.isDirectory ? 0x10 : 0x20,
+                    entry.clusters.empty() ? 0 : entry.clusters[0],
+                    entry.isDirectory ? 0 : entry.data.size());
+    }
+
+    u32 maxSize = isRoot ? FAT_ROOT_ENTRIES * FAT_ENTRY_SIZE : FAT_CLUSTER_SIZE;
+    if (directory.size() > maxSize) {
+      fprintf(stderr, "[fixture] too many files in /%s\n", node.name.c_str());
+      exit(1);
+    }
+    u32 sector = isRoot ? rootSector : sectorOf(node.clusters[0]);
+    memcpy(disk.data() + sector * FAT_SECTOR, directory.data(),
+           directory.size());
+  }
+  FIXTURE_writeFile(image, disk);
+
+  std::map<std::string, std::vector<u32>> sectors;
+  for (u32 i = 0; i < paths.size(); i++) {
+    auto& node = nodes[files[i]];
+    u32 count = (node.data.size() + FAT_SECTOR - 1) / FAT_SECTOR;
+    for (u32 j = 0; j < count; j++) {
+      sectors[paths[i]].push_back(
+          sectorOf(node.clusters[j / FAT_CLUSTER_SECTORS]) +
+          j % FAT_CLUSTER_SECTORS);
+    }
+  }
+  return sectors;
+}
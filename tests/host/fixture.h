@@ -0,0 +1,101 @@
+#ifndef HOST_FIXTURE_H
+#define HOST_FIXTURE_H
+
+#include <libgba-sprite-engine/gba/tonc_core.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "gameplay/models/Event.h"
+
+// Content folders for host tests, in the importer's output format: a ROM id,
+// and songs with a `.pius` file (one uncompressed single chart) and a silent
+// `.gsm` file (the host player only counts samples).
+
+#define FIXTURE_BPM 120
+#define FIXTURE_PRESS_WINDOW 16  // (ms around each note, see `FixturePlayer`)
+#define FIXTURE_FIRST_NOTE 2000
+#define FIXTURE_NOTE_INTERVAL 40  // (ms, so each arrow repeats every 200ms)
+#define FIXTURE_HOLD_EVERY 25
+#define FIXTURE_HOLD_LENGTH 80
+
+typedef struct {
+  int timestamp;
+  EventType type;
+  u8 arrows;  // (`EVENT_ARROW_*` bits)
+  std::vector<u32> params;
+  u8 data2 = 0;  // (only serialized in double charts)
+} FixtureEvent;
+
+typedef struct {
+  bool isFinished;
+  u32 frames;
+  bool isSGrade;  // (no misses)
+  u32 maxCombo;   // (up to `MAX_COMBO`)
+} FixtureResult;
+
+// Creates an empty folder in /tmp.
+std::string FIXTURE_createFolder();
+void FIXTURE_removeFolder(std::string path);
+
+// Creates a folder with a `_rom_id.u32` for `songCount` songs.
+std::string FIXTURE_createContent(u32 songCount);
+
+// Writes `<name>.pius` and `<name>.gsm`. The chart starts with a
+// `FIXTURE_BPM` tempo, so `events` only need the notes. Compressed charts
+// store their events in LZ77 blocks, like `make import` does by default.
+void FIXTURE_writeSong(std::string content,
+                       std::string name,
+                       u32 lastMillisecond,
+                       const std::vector<FixtureEvent>& events,
+                       bool isCompressed = false);
+
+// Serializes events like the importer does (uncompressed).
+std::vector<u8> FIXTURE_serializeEvents(const std::vector<FixtureEvent>& events,
+                                        bool isDouble);
+
+// Single-arrow notes every `FIXTURE_NOTE_INTERVAL` ms, with a short hold
+// every `FIXTURE_HOLD_EVERY` notes, until there are `eventCount` events.
+std::vector<FixtureEvent> FIXTURE_createNotes(u32 eventCount, u32* noteCount);
+
+// Plays the song in arcade mode with a `FixturePlayer`, until the grade
+// scene updates the stats. (in a new process, since it calls `HOST_init`)
+FixtureResult FIXTURE_playSong(std::string content,
+                               std::string name,
+                               u32 lastMillisecond,
+                               const std::vector<FixtureEvent>& events);
+
+// Compresses each block with the importer's LZ77 encoder (`lz77.js`, needs
+// node) and returns them back-to-back. Tests run from the `tests/` folder.
+std::vector<u8> FIXTURE_compress(const std::vector<std::vector<u8>>& blocks,
+                                 bool isVram = false);
+
+// A player that presses every note `FIXTURE_PRESS_WINDOW` ms around its
+// timestamp and keeps holds pressed until they end. (`msecs` can't go back)
+class FixturePlayer {
+ public:
+  FixturePlayer(const std::vector<FixtureEvent>* events) : events(events) {}
+
+  u16 getKeys(int msecs);
+
+ private:
+  const std::vector<FixtureEvent>* events;
+  u32 cursor = 0;  // (first event that can still be pressed)
+  int holdEnds[5] = {-1, -1, -1, -1, -1};
+};
+
+// Packs the files at `paths` (like "/piuGBA_videos/a.vid", relative to
+// `folder`) into a FAT16 image without partitions, for the flash cart of
+// `IMAGE_LIB` (see `diskimage/io_image.h`). Clusters are handed out to each
+// file a few at a time, so every big enough file is fragmented. Returns the
+// data sectors of each path, in file order.
+std::map<std::string, std::vector<u32>> FIXTURE_writeFatImage(
+    std::string image,
+    std::string folder,
+    const std::vector<std::string>& paths);
+
+void FIXTURE_writeFile(std::string path, const std::vector<u8>& data);
+std::vector<u8> FIXTURE_readFile(std::string path);
+
+#endif  // HOST_FIXTURE_H
@@ -0,0 +1,130 @@
+#include "host.h"
+
+#include "gameplay/Playfield.h"
+#include "gameplay/Sequence.h"
+#include "gameplay/library/LibraryStore.h"
+#include "gameplay/multiplayer/PS2Keyboard.h"
+#include "gameplay/multiplayer/Syncer.h"
+#include "gameplay/save/SaveFile.h"
+#include "gameplay/video/VideoStore.h"
+#include "utils/SceneUtils.h"
+
+extern "C" {
+#include "player/io_scheduler.h"
+#include "player/player.h"
+}
+
+// Host version of `main.cpp`: the same globals, and a frame that runs the
+// `player_forever` steps in order, without interrupts. The link cable is the
+// link simulator's (see `link.h`), if there's one.
+
+VideoStore* videoStore = new VideoStore();
+LibraryStore* libraryStore = new LibraryStore();
+PS2Keyboard* ps2Keyboard = new PS2Keyboard();
+LinkUniversal* linkUniversal =
+    new LinkUniversal(LinkUniversal::Protocol::AUTODETECT,
+                      "piuGBA",
+                      (LinkUniversal::CableOptions){
+                          .baudRate = LinkCable::BaudRate::BAUD_RATE_1,
+                          .timeout = SYNC_CABLE_TIMEOUT,
+                          .interval = SYNC_SEND_INTERVAL,
+                          .sendTimerId = LINK_CABLE_DEFAULT_SEND_TIMER_ID},
+                      (LinkUniversal::WirelessOptions){
+                          .forwarding = true,
+                          .retransmission = true,
+                          .maxPlayers = 2,
+                          .timeout = SYNC_WIRELESS_TIMEOUT,
+                          .interval = SYNC_SEND_INTERVAL,
+                          .sendTimerId = LINK_WIRELESS_DEFAULT_SEND_TIMER_ID});
+Syncer* syncer = new Syncer();
+
+static std::shared_ptr<GBAEngine> engine{new GBAEngine()};
+static u32 frame = 0;
+static u32 textCells = 0;
+
+class HostScene : public Scene {
+ public:
+  HostScene(std::shared_ptr<GBAEngine> engine) : Scene(engine) {}
+
+  std::vector<Background*> backgrounds() override { return {}; }
+  std::vector<Sprite*> sprites() override { return {}; }
+  void load() override {}
+  void tick(u16 keys) override {}
+};
+
+void HOST_init(const char* contentPath) {
+  HOST_loadRom(contentPath);
+  player_init();
+  SEQUENCE_initialize(engine, find_first_gbfs_file(0));
+  SAVEFILE_initialize(find_first_gbfs_file(0));
+
+  engine->setScene(new HostScene(engine));
+  SPRITE_TILES_commit();
+}
+
+std::shared_ptr<GBAEngine> HOST_getEngine() {
+  return engine;
+}
+
+void HOST_runFrame() {
+  REG_VCOUNT = 0;
+  io_scheduler_begin_frame();
+
+  // (onUpdate)
+  syncer->update();
+  PixelTransitionEffect::update();
+  engine->update();
+  SPRITE_TILES_commit();
+  if (syncer->$isPlayingSong && !syncer->$hasStartedAudio)
+    syncer->synchronizeSongStart();
+  int expectedAudioChunk = syncer->$isPlayingSong && !syncer->isMaster()
+                               ? (int)syncer->$currentAudioChunk
+                               : 0;
+
+  syncer->onAudioChunk(HOST_processAudio(expectedAudioChunk));
+
+  // (VBlank)
+  VBlankIntrWait();
+  player_onVBlank();
+  videoStore->onVBlank();
+
+  // (onRender)
+  EFFECT_render();
+  engine->render();
+  PLAYFIELD_render();
+  textCells = TEXT_render();
+
+  if (syncer->pendingAudio != "") {
+    player_play(syncer->pendingAudio.c_str(), isMultiplayer());
+    syncer->pendingAudio = "";
+  }
+
+  if (syncer->pendingSeek > 0) {
+    player_seek(syncer->pendingSeek);
+    syncer->pendingSeek = 0;
+  }
+
+  frame++;
+}
+
+u32 HOST_getFrame() {
+  return frame;
+}
+
+u32 HOST_getTextCells() {
+  return textCells;
+}
+
+void HOST_setKeys(u16 keys) {
+  REG_KEYS = ~keys & KEY_ANY;
+}
+
+std::string HOST_getText(u32 row) {
+  auto map = (const u16*)se_mem[TextStream::instance().getScreenBlock()];
+  std::string text;
+  for (u32 col = 0; col < TILE_WIDTH; col++) {
+    u16 cell = map[row * TILE_WIDTH + col];
+    text += cell != 0 ? (char)(cell + CHAR_OFFSET_INDEX) : ' ';
+  }
+  return text.substr(0, text.find_last_not_of(' ') + 1);
+}
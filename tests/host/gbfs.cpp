@@ -0,0 +1,141 @@
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "host.h"
+
+extern "C" {
+#include "utils/gbfs/gbfs.h"
+}
+
+// GBFS for the host build. `libgbfs.c` assumes 32-bit longs, so the reader
+// is reimplemented here, next to a writer that packs a folder into ROM like
+// `gbfs ../files.gbfs *` does in `make import` (the shell skips hidden
+// files).
+
+#define GBFS_MAGIC "PinEightGBFS\r\n\x1a\n"
+#define GBFS_NAME_LEN 24
+#define GBFS_DATA_ALIGNMENT 16
+// (after the cartridge header and its GPIO port, which `Rumble.h` writes)
+#define GBFS_ROM_OFFSET 0x100
+
+static const GBFS_FILE* rom = NULL;
+
+void HOST_loadRom(const char* contentPath) {
+  std::vector<std::string> names;
+  DIR* dir = opendir(contentPath);
+  if (dir == NULL) {
+    fprintf(stderr, "[host] can't open %s\n", contentPath);
+    exit(1);
+  }
+  while (auto entry = readdir(dir)) {
+    std::string name = entry->d_name;
+    std::string path = std::string(contentPath) + "/" + name;
+    struct stat info;
+    if (stat(path.c_str(), &info) == 0 && S_ISREG(info.st_mode) &&
+        name[0] != '.' && name.size() < GBFS_NAME_LEN)
+      names.push_back(name);
+  }
+  closedir(dir);
+  std::sort(names.begin(), names.end());  // (lookups use a binary search)
+
+  u8* image = (u8*)MEM_ROM + GBFS_ROM_OFFSET;
+  auto header = (GBFS_FILE*)image;
+  auto entries = (GBFS_ENTRY*)(image + sizeof(GBFS_FILE));
+  memcpy(header->magic, GBFS_MAGIC, sizeof(header->magic));
+  header->dir_off = sizeof(GBFS_FILE);
+  header->dir_nmemb = names.size();
+
+  u32 cursor = sizeof(GBFS_FILE) + names.size() * sizeof(GBFS_ENTRY);
+  for (u32 i = 0; i < names.size(); i++) {
+    cursor = (cursor + GBFS_DATA_ALIGNMENT - 1) & ~(GBFS_DATA_ALIGNMENT - 1);
+    std::string path = std::string(contentPath) + "/" + names[i];
+    FILE* file = fopen(path.c_str(), "rb");
+    fseek(file, 0, SEEK_END);
+    u32 length = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    if (GBFS_ROM_OFFSET + cursor + length > HOST_ROM_SIZE) {
+      fprintf(stderr, "[host] %s doesn't fit in ROM\n", contentPath);
+      exit(1);
+    }
+    if (fread(image + cursor, 1, length, file) != length) {
+      fprintf(stderr, "[host] can't read %s\n", path.c_str());
+      exit(1);
+    }
+    fclose(file);
+
+    memset(entries[i].name, 0, GBFS_NAME_LEN);
+    memcpy(entries[i].name, names[i].c_str(), names[i].size());
+    entries[i].len = length;
+    entries[i].data_offset = cursor;
+    cursor += length;
+  }
+  header->total_len = cursor;
+  rom = header;
+}
+
+extern "C" {
+
+const GBFS_FILE* find_first_gbfs_file(const void* start) {
+  return rom;
+}
+
+const void* skip_gbfs_file(const GBFS_FILE* file) {
+  return (const char*)file + file->total_len;
+}
+
+static int compareNames(const void* a, const void* b) {
+  return memcmp(a, b, GBFS_NAME_LEN);
+}
+
+const void* gbfs_get_obj(const GBFS_FILE* file, const char* name, u32* len) {
+  char key[GBFS_NAME_LEN] = {0};
+  strncpy(key, name, GBFS_NAME_LEN);
+
+  auto entries = (const GBFS_ENTRY*)((const char*)file + file->dir_off);
+  auto entry = (const GBFS_ENTRY*)bsearch(key, entries, file->dir_nmemb,
+                                          sizeof(GBFS_ENTRY), compareNames);
+  if (entry == NULL)
+    return NULL;
+
+  if (len != NULL)
+    *len = entry->len;
+  return (const char*)file + entry->data_offset;
+}
+
+const void* gbfs_get_nth_obj(const GBFS_FILE* file,
+                             size_t n,
+                             char* name,
+                             u32* len) {
+  if (n >= file->dir_nmemb)
+    return NULL;
+
+  auto entry = (const GBFS_ENTRY*)((const char*)file + file->dir_off) + n;
+  if (name != NULL) {
+    strncpy(name, entry->name, GBFS_NAME_LEN);
+    name[GBFS_NAME_LEN] = 0;
+  }
+  if (len != NULL)
+    *len = entry->len;
+  return (const char*)file + entry->data_offset;
+}
+
+void* gbfs_copy_obj(void* dst, const GBFS_FILE* file, const char* name) {
+  u32 len;
+  const void* src = gbfs_get_obj(file, name, &len);
+  if (src == NULL)
+    return NULL;
+
+  memcpy(dst, src, len);
+  return dst;
+}
+
+size_t gbfs_count_objs(const GBFS_FILE* file) {
+  return file != NULL ? file->dir_nmemb : 0;
+}
+}
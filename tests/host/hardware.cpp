@@ -0,0 +1,148 @@
+#include <libgba-sprite-engine/gba/tonc_bios.h>
+
+#include <malloc.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "host.h"
+
+#include "../libs/interrupt.h"
+
+// Host replacements for the hardware: the memory map, the BIOS calls and
+// the assembly routines. (the flash cart slot is in `sd.cpp`)
+
+#define WATCHDOG_SECONDS 300  // (a BSOD spins forever)
+
+__attribute__((constructor(101))) static void mapMemory() {
+  void* start = (void*)HOST_MEMORY_START;
+  size_t size = HOST_MEMORY_END - HOST_MEMORY_START;
+  void* memory =
+      mmap(start, size, PROT_READ | PROT_WRITE,
+           MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE | MAP_NORESERVE,
+           -1, 0);
+  if (memory != start) {
+    perror("[host] can't map the GBA memory");
+    exit(1);
+  }
+
+  REG_KEYS = KEY_ANY;  // (active low, nothing is pressed)
+  alarm(WATCHDOG_SECONDS);
+}
+
+// --- Assembly routines (tonc declares them as C++) ---
+
+void memcpy32(void* dst, const void* src, uint wcount) {
+  memcpy(dst, src, wcount * 4);
+}
+
+void memset32(void* dst, u32 wd, uint wcount) {
+  for (u32 i = 0; i < wcount; i++)
+    ((u32*)dst)[i] = wd;
+}
+
+void memcpy16(void* dst, const void* src, uint hwcount) {
+  memcpy(dst, src, hwcount * 2);
+}
+
+void memset16(void* dst, u16 hw, uint hwcount) {
+  for (u32 i = 0; i < hwcount; i++)
+    ((u16*)dst)[i] = hw;
+}
+
+// --- BIOS ---
+
+int __qran_seed = 42;
+
+extern "C" {
+
+void SoftReset(void) {
+  fprintf(stderr, "[host] SoftReset\n");
+  exit(2);
+}
+
+void RegisterRamReset(u32 flags) {}
+
+void VBlankIntrWait(void) {
+  REG_VCOUNT = 160;  // (VBlank)
+  HOST_onVBlank();
+}
+
+s32 Div(s32 num, s32 den) {
+  return den != 0 ? num / den : 0;
+}
+
+int Mod(int num, int den) {
+  return den != 0 ? num % den : 0;
+}
+
+u32 Sqrt(u32 num) {
+  u32 result = 0;
+  while ((result + 1) * (result + 1) <= num)
+    result++;
+  return result;
+}
+
+void LZ77UnCompWram(const void* src, void* dst) {
+  const u8* source = (const u8*)src;
+  u8* target = (u8*)dst;
+  u32 size = source[1] | (source[2] << 8) | (source[3] << 16);
+  source += 4;
+
+  u32 written = 0;
+  while (written < size) {
+    u8 flags = *source++;
+    for (u32 i = 0; i < 8 && written < size; i++, flags <<= 1) {
+      if (!(flags & 0x80)) {
+        target[written++] = *source++;
+        continue;
+      }
+
+      u32 length = (source[0] >> 4) + 3;
+      u32 distance = (((source[0] & 0xf) << 8) | source[1]) + 1;
+      source += 2;
+      for (u32 j = 0; j < length && written < size; j++, written++)
+        target[written] = target[written - distance];
+    }
+  }
+}
+
+void LZ77UnCompVram(const void* src, void* dst) {
+  LZ77UnCompWram(src, dst);
+}
+
+// (`player/core/asm.S`)
+uint32_t fracumul(uint32_t x, uint32_t frac) {
+  return (uint32_t)(((uint64_t)x * frac) >> 32);
+}
+
+// --- Heap (see `HeapStats.cpp`, the host build doesn't wrap malloc) ---
+
+char __eheap_start[1], __eheap_end[1];  // (the host heap has no fixed size)
+
+void* __real_malloc(size_t size) {
+  return malloc(size);
+}
+
+void __real_free(void* ptr) {
+  free(ptr);
+}
+
+void* __real_realloc(void* ptr, size_t size) {
+  return realloc(ptr, size);
+}
+
+void* __real_calloc(size_t count, size_t size) {
+  return calloc(count, size);
+}
+
+}
+
+// --- Interrupts (there are none) ---
+
+unsigned int interrupt_get_worst_latency(interrupt_index index) {
+  return 0;
+}
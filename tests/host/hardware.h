@@ -0,0 +1,20 @@
+#ifndef HOST_HARDWARE_H
+#define HOST_HARDWARE_H
+
+// Force-included (`-include`) in every game source of the host build.
+// The GBA memory map (EWRAM to SRAM) is mapped at its real addresses by
+// `hardware.cpp`, so registers, VRAM, OAM and SRAM are plain memory. DMA
+// doesn't run on the host, so `dma3_cpy` becomes a `memcpy`.
+
+#include <string.h>
+
+#define dma3_cpy tonc_dma3_cpy
+#include <libgba-sprite-engine/gba/tonc_core.h>
+#undef dma3_cpy
+#define dma3_cpy(DST, SRC, SIZE) memcpy((DST), (SRC), (SIZE))
+
+#define HOST_MEMORY_START MEM_EWRAM
+#define HOST_MEMORY_END (MEM_SRAM + 0x10000)
+#define HOST_ROM_SIZE 0x2000000
+
+#endif  // HOST_HARDWARE_H
@@ -0,0 +1,48 @@
+#ifndef HOST_H
+#define HOST_H
+
+#include <libgba-sprite-engine/gba_engine.h>
+
+#include <memory>
+#include <string>
+
+// Host platform: runs the game code frame by frame, like `player_forever`
+// does on the GBA, against a fake engine, player and flash cart.
+// Tests drive it with the keypad and read the screen text.
+
+// Packs the files of `contentPath` (an importer output folder) into a GBFS
+// image in ROM, then sets up the player, the save file (like a first boot)
+// and an empty scene.
+void HOST_init(const char* contentPath);
+std::shared_ptr<GBAEngine> HOST_getEngine();
+
+// Runs one frame: update, audio, VBlank and render.
+void HOST_runFrame();
+u32 HOST_getFrame();
+
+void HOST_setKeys(u16 keys);  // (pressed keys, `KEY_*` bits)
+std::string HOST_getText(u32 row);
+u32 HOST_getTextCells();  // (cells written by `TEXT_render` in the last frame)
+
+// The player uses the GSM clock (ROM audio) unless PCM is enabled, which
+// models the flash cart audio with the same source samples.
+void HOST_setPCM(bool isPCM);
+
+// Makes `path` the SD card of a flash cart (for `VideoStore`), or removes the
+// cart with NULL (the default).
+void HOST_setSD(const char* path);
+
+// Multiplayer audio sync corrections since the start (see `player_forever`).
+typedef struct {
+  u32 underruns;  // (the slave skipped chunks to catch up with the master)
+  u32 skippedChunks;
+  u32 overruns;  // (the slave waited for the master)
+} HostAudioSync;
+HostAudioSync HOST_getAudioSync();
+
+// (platform internals)
+void HOST_loadRom(const char* contentPath);
+u32 HOST_processAudio(int expectedAudioChunk);  // (returns the audio chunk)
+void HOST_onVBlank();  // (waits for the other game, see `link.h`)
+
+#endif  // HOST_H
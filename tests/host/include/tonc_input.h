@@ -0,0 +1,2 @@
+// (libtonc's input module isn't used by the game; the engine headers include
+// it, so the host build finds this empty one instead)
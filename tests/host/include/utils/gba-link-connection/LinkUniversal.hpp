@@ -0,0 +1,219 @@
+#ifndef LINK_UNIVERSAL_H
+#define LINK_UNIVERSAL_H
+
+// Host version of `LinkUniversal` (the game headers include it by path, and
+// the host build finds this one first). It has the same API, but the other
+// end is the link simulator (see `host/link.h`) instead of the serial port:
+// - `send(...)` queues messages until the simulator's next transfer, and
+//   waits for it when the queue is full (so `Syncer::directSend` returns);
+// - `sync()` collects the messages that arrived, and the link times out after
+//   `timeout` frames without transfers, like `LinkCable` and `LinkWireless`.
+// Queues are `Link::Queue`s with the sizes of the GBA build.
+// Without a simulator, it never connects.
+
+#include "utils/gba-link-connection/LinkCable.hpp"
+#include "utils/gba-link-connection/LinkWireless.hpp"
+
+#ifndef LINK_UNIVERSAL_MAX_PLAYERS
+#define LINK_UNIVERSAL_MAX_PLAYERS LINK_WIRELESS_MAX_PLAYERS
+#endif
+
+#define LINK_UNIVERSAL_DISCONNECTED LINK_CABLE_DISCONNECTED
+#define LINK_UNIVERSAL_NO_DATA LINK_CABLE_NO_DATA
+
+// (the simulator's end, see `host/link.cpp`)
+bool HOST_isWirelessLink();
+u8 HOST_getLinkPlayerId();
+void HOST_setLinkEnabled(bool isEnabled);
+bool HOST_sendLink(u16 data);  // (false when full, after the next transfer)
+bool HOST_receiveLink(u16* data);
+bool HOST_didReceiveLink();  // (since the last call)
+void HOST_resetLink(bool didTimeout);  // (clears the queues)
+void HOST_onLinkOverflow();
+
+class LinkUniversal {
+ private:
+  using u32 = Link::u32;
+  using u16 = Link::u16;
+  using u8 = Link::u8;
+  using U16Queue = Link::Queue<u16, LINK_CABLE_QUEUE_SIZE>;
+
+ public:
+  enum class State { INITIALIZING = 0, WAITING = 1, CONNECTED = 2 };
+  enum class Mode { LINK_CABLE, LINK_WIRELESS };
+  enum class Protocol {
+    AUTODETECT,
+    CABLE,
+    WIRELESS_AUTO,
+    WIRELESS_SERVER,
+    WIRELESS_CLIENT,
+    WIRELESS_RESTORE_EXISTING
+  };
+
+  struct CableOptions {
+    LinkCable::BaudRate baudRate;
+    u32 timeout;
+    u16 interval;
+    u8 sendTimerId;
+  };
+
+  struct WirelessOptions {
+    bool forwarding;
+    bool retransmission;
+    u32 maxPlayers;
+    u32 timeout;
+    u16 interval;
+    u8 sendTimerId;
+  };
+
+  explicit LinkUniversal(Protocol protocol,
+                         const char* gameName,
+                         CableOptions cableOptions,
+                         WirelessOptions wirelessOptions)
+      : protocol(protocol),
+        cableTimeout(cableOptions.timeout),
+        wirelessTimeout(wirelessOptions.timeout) {}
+
+  [[nodiscard]] bool isActive() { return isEnabled; }
+
+  void activate() {
+    reset(false);
+    isEnabled = true;
+    HOST_setLinkEnabled(true);
+  }
+
+  bool deactivate(bool turnOffWireless = true) {
+    isEnabled = false;
+    HOST_setLinkEnabled(false);
+    reset(false);
+    return true;
+  }
+
+  [[nodiscard]] bool isConnected() { return state == State::CONNECTED; }
+
+  [[nodiscard]] u8 playerCount() { return isConnectedNow() ? 2 : 1; }
+
+  [[nodiscard]] u8 currentPlayerId() {
+    return isConnectedNow() ? HOST_getLinkPlayerId() : 0;
+  }
+
+  void sync() {
+    if (!isEnabled)
+      return;
+
+    if (!isConnectedNow()) {
+      state = State::WAITING;
+      return;
+    }
+
+    state = State::CONNECTED;
+    u8 remoteId = !HOST_getLinkPlayerId();
+    u16 data;
+    while (HOST_receiveLink(&data)) {
+      if (incomingMessages[remoteId].isFull())
+        HOST_onLinkOverflow();
+      incomingMessages[remoteId].push(data);
+    }
+  }
+
+  [[nodiscard]] bool canRead(u8 playerId) {
+    return !incomingMessages[playerId].isEmpty();
+  }
+
+  u16 read(u8 playerId) { return incomingMessages[playerId].pop(); }
+
+  [[nodiscard]] u16 peek(u8 playerId) {
+    return incomingMessages[playerId].peek();
+  }
+
+  bool send(u16 data) {
+    if (!isConnectedNow() || data == LINK_CABLE_DISCONNECTED ||
+        data == LINK_CABLE_NO_DATA)
+      return false;
+
+    return HOST_sendLink(data);
+  }
+
+  bool didQueueOverflow(bool clear = true) {
+    bool overflow = false;
+    for (u32 i = 0; i < LINK_UNIVERSAL_MAX_PLAYERS; i++) {
+      overflow = overflow || incomingMessages[i].overflow;
+      if (clear)
+        incomingMessages[i].overflow = false;
+    }
+    return overflow;
+  }
+
+  void resetTimeout() { timeoutCount = 0; }
+  void resetTimer() {}
+
+  [[nodiscard]] State getState() { return state; }
+
+  [[nodiscard]] Mode getMode() {
+    return HOST_isWirelessLink() ? Mode::LINK_WIRELESS : Mode::LINK_CABLE;
+  }
+
+  [[nodiscard]] Protocol getProtocol() { return protocol; }
+  void setProtocol(Protocol protocol) { this->protocol = protocol; }
+
+  [[nodiscard]] bool isConnectedNow() {
+    return isEnabled && hasReceived && timeoutCount < getTimeout();
+  }
+
+  [[nodiscard]] LinkWireless::State getWirelessState() {
+    return isConnectedNow() && HOST_isWirelessLink()
+               ? (HOST_getLinkPlayerId() == 0 ? LinkWireless::State::SERVING
+                                              : LinkWireless::State::CONNECTED)
+               : LinkWireless::State::AUTHENTICATED;
+  }
+
+  [[nodiscard]] u32 _getWaitCount() { return timeoutCount; }
+  [[nodiscard]] u32 _getSubWaitCount() { return 0; }
+
+  // (the host's VBlank, see `LINK_UNIVERSAL_ISR_VBLANK`)
+  void _onVBlank() {
+    if (!isEnabled)
+      return;
+
+    if (HOST_didReceiveLink()) {
+      hasReceived = true;
+      timeoutCount = 0;
+    } else if (hasReceived && ++timeoutCount >= getTimeout()) {
+      reset(true);
+    }
+  }
+
+  void _onSerial() {}
+  void _onTimer() {}
+
+ private:
+  U16Queue incomingMessages[LINK_UNIVERSAL_MAX_PLAYERS];
+  Protocol protocol;
+  u32 cableTimeout;
+  u32 wirelessTimeout;
+  State state = State::INITIALIZING;
+  u32 timeoutCount = 0;
+  bool hasReceived = false;
+  bool isEnabled = false;
+
+  u32 getTimeout() {
+    return HOST_isWirelessLink() ? wirelessTimeout : cableTimeout;
+  }
+
+  void reset(bool didTimeout) {
+    state = State::INITIALIZING;
+    timeoutCount = 0;
+    hasReceived = false;
+    for (u32 i = 0; i < LINK_UNIVERSAL_MAX_PLAYERS; i++)
+      incomingMessages[i].clear();
+    HOST_resetLink(didTimeout);
+  }
+};
+
+extern LinkUniversal* linkUniversal;
+
+void LINK_UNIVERSAL_ISR_VBLANK();
+void LINK_UNIVERSAL_ISR_SERIAL();
+void LINK_UNIVERSAL_ISR_TIMER();
+
+#endif  // LINK_UNIVERSAL_H
@@ -0,0 +1,534 @@
+#include "link.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <memory>
+#include <new>
+#include <string>
+
+#include "assets.h"
+#include "fixture.h"
+#include "gameplay/Sequence.h"
+#include "gameplay/multiplayer/Syncer.h"
+#include "gameplay/save/SaveFile.h"
+#include "host.h"
+#include "player/PlaybackState.h"
+
+// Host version of the link's interrupts and hardware (see `link.h`).
+// The simulator talks to each game through a socket: a game asks to wait
+// for its next VBlank or for the next transfer (when its send queue is
+// full), and gets back whether a VBlank happened meanwhile. The queues and
+// the stats are in memory shared by the three processes, and only one of
+// them runs at a time.
+
+#define FRAME_CYCLES 280896
+#define TIMER_TICK_CYCLES 1024  // (send timers count at 16.78MHz / 1024)
+#define CYCLES_PER_MS (16777216 / 1000.0)
+// (words minus the header: a word for servers, a halfword for clients)
+#define WIRELESS_SERVER_MESSAGES (LINK_WIRELESS_MAX_SERVER_TRANSFER_LENGTH - 1) * 2
+#define WIRELESS_CLIENT_MESSAGES LINK_WIRELESS_MAX_CLIENT_TRANSFER_LENGTH * 2 - 1
+#define CONFIRM_FRAMES 30  // (presses of B outside of songs, to move on)
+#define EXTRA_SECONDS 60   // (per song: lobby, selection and grades)
+#define SONG_NAME "link"
+#define LIBRARY_LISTS {"_snm_0_list.txt", "_shd_0_list.txt", "_scz_0_list.txt"}
+#define RANK_SOUNDS                                                      \
+  {SOUND_RANK_S, SOUND_RANK_A, SOUND_RANK_B, SOUND_RANK_C, SOUND_RANK_D, \
+   SOUND_RANK_F}
+#define RANK_SOUND_SIZE (18157 / 160 * 33)  // (a second of silent GSM)
+
+#define WAIT_VBLANK 'V'
+#define WAIT_TRANSFER 'T'
+#define QUIT 'Q'
+
+template <u32 SIZE>
+struct LinkQueues {
+  Link::Queue<u16, SIZE> outgoing;
+  Link::Queue<u16, SIZE> incoming;
+};
+
+// (written by the game)
+typedef struct {
+  bool isPlaying;  // (a song, after `synchronizeSongStart`)
+  bool isOnline;   // (`Syncer` is playing)
+  u32 songs;       // (started)
+  u32 finishedSongs;
+  u32 abortedSongs;
+  u32 msecs;
+  HostAudioSync audioSync;
+  u32 resets;
+  u32 linkTimeouts;
+  u32 sendWaits;
+  u32 overflows;
+} LinkSimState;
+
+struct LinkSimPort {
+  u8 playerId = 0;
+  bool isWireless = false;
+  bool isEnabled = false;  // (`LinkUniversal` is active)
+  bool didReceive = false;
+  LinkQueues<LINK_CABLE_QUEUE_SIZE> cable;
+  LinkQueues<LINK_WIRELESS_QUEUE_SIZE> wireless;
+  LinkSimState state = {};
+};
+
+static LinkSimPort* port = NULL;  // (in the games)
+static int channel = -1;
+static u32 seed = 1;
+
+template <typename F>
+static void withQueues(LinkSimPort* port, F action) {
+  if (port->isWireless)
+    action(port->wireless);
+  else
+    action(port->cable);
+}
+
+static u32 nextRandom(u32 max) {
+  seed = seed * 1103515245 + 12345;
+  return (seed >> 16) % max;
+}
+
+// --- Game side ---
+
+static void wait(char request) {
+  char reply;
+  if (write(channel, &request, 1) != 1 || read(channel, &reply, 1) != 1 ||
+      reply == QUIT)
+    _exit(0);
+
+  if (reply == WAIT_VBLANK)
+    LINK_UNIVERSAL_ISR_VBLANK();
+}
+
+static void updateState() {
+  auto& state = port->state;
+  bool isPlaying = syncer->$isPlayingSong && syncer->$hasStartedAudio;
+  bool isOnline = syncer->isPlaying();
+
+  if (isPlaying && !state.isPlaying)
+    state.songs++;
+  if (!isPlaying && state.isPlaying)
+    (isOnline ? state.finishedSongs : state.abortedSongs)++;
+  if (!isOnline && state.isOnline)
+    state.resets++;
+
+  state.isPlaying = isPlaying;
+  state.isOnline = isOnline;
+  state.msecs = PlaybackState.msecs;
+  state.audioSync = HOST_getAudioSync();
+}
+
+void HOST_onVBlank() {
+  if (port == NULL)
+    return;
+
+  updateState();
+  wait(WAIT_VBLANK);
+}
+
+bool HOST_isWirelessLink() {
+  return port != NULL && port->isWireless;
+}
+
+u8 HOST_getLinkPlayerId() {
+  return port != NULL ? port->playerId : 0;
+}
+
+void HOST_setLinkEnabled(bool isEnabled) {
+  if (port != NULL)
+    port->isEnabled = isEnabled;
+}
+
+bool HOST_sendLink(u16 data) {
+  if (port == NULL)
+    return false;
+
+  bool isSent = false;
+  withQueues(port, [&isSent, data](auto& queues) {
+    if (!queues.outgoing.isFull()) {
+      queues.outgoing.push(data);
+      isSent = true;
+    }
+  });
+  if (!isSent) {
+    port->state.sendWaits++;
+    wait(WAIT_TRANSFER);
+  }
+  return isSent;
+}
+
+bool HOST_receiveLink(u16* data) {
+  if (port == NULL)
+    return false;
+
+  bool isReceived = false;
+  withQueues(port, [&isReceived, data](auto& queues) {
+    if (!queues.incoming.isEmpty()) {
+      *data = queues.incoming.pop();
+      isReceived = true;
+    }
+  });
+  return isReceived;
+}
+
+bool HOST_didReceiveLink() {
+  if (port == NULL)
+    return false;
+
+  bool didReceive = port->didReceive;
+  port->didReceive = false;
+  return didReceive;
+}
+
+void HOST_resetLink(bool didTimeout) {
+  if (port == NULL)
+    return;
+
+  withQueues(port, [](auto& queues) {
+    queues.outgoing.clear();
+    queues.incoming.clear();
+  });
+  if (didTimeout)
+    port->state.linkTimeouts++;
+}
+
+void HOST_onLinkOverflow() {
+  if (port != NULL)
+    port->state.overflows++;
+}
+
+void LINK_UNIVERSAL_ISR_VBLANK() {
+  linkUniversal->_onVBlank();
+}
+
+void LINK_UNIVERSAL_ISR_SERIAL() {
+  linkUniversal->_onSerial();
+}
+
+void LINK_UNIVERSAL_ISR_TIMER() {
+  linkUniversal->_onTimer();
+}
+
+[[noreturn]] static void play(LinkSimPort* linkPort,
+                              int linkChannel,
+                              std::string content,
+                              const std::vector<FixtureEvent>& events) {
+  port = linkPort;
+  channel = linkChannel;
+  HOST_init(content.c_str());
+  SAVEFILE_write8(SRAM->state.gameMode, GameMode::MULTI_VS);
+  SEQUENCE_goToMultiplayerGameMode(GameMode::MULTI_VS);
+
+  std::unique_ptr<FixturePlayer> player;
+  u32 songs = 0;
+  while (true) {
+    u16 keys = 0;
+    if (port->state.isPlaying) {
+      if (port->state.songs != songs) {
+        player.reset(new FixturePlayer(&events));
+        songs = port->state.songs;
+      }
+      keys = player->getKeys(PlaybackState.msecs);
+    } else if (HOST_getFrame() % CONFIRM_FRAMES == 0) {
+      keys = KEY_B;  // (center: confirm, start and continue)
+    }
+
+    HOST_setKeys(keys);
+    HOST_runFrame();
+  }
+}
+
+// --- Simulator side ---
+
+typedef struct {
+  double time;
+  u8 to;
+  std::vector<u16> messages;
+} LinkSimPacket;
+
+class LinkSimulator {
+ public:
+  LinkSimulator(LinkSimOptions options, LinkSimPort* ports, int* channels)
+      : options(options), ports(ports), channels(channels) {
+    frameCycles[0] = FRAME_CYCLES;
+    frameCycles[1] = FRAME_CYCLES * (1 + options.drift / 1000000.0);
+    nextVBlank[0] = nextVBlank[1] = 0;
+    lastArrival[0] = lastArrival[1] = 0;
+    frameTime[0] = frameTime[1] = 0;
+    received[0] = received[1] = 0;
+  }
+
+  LinkSimResult run() {
+    double transferCycles = SYNC_SEND_INTERVAL * TIMER_TICK_CYCLES;
+    u32 maxFrames = options.songs * (options.seconds + EXTRA_SECONDS) * 60;
+    double nextTransfer = transferCycles;
+
+    for (u32 i = 0; i < 2; i++)
+      waits[i] = receive(i);
+
+    while (result.frames < maxFrames && !isDone()) {
+      double time = nextTransfer;
+      for (auto& packet : inFlight)
+        time = std::min(time, packet.time);
+      for (u32 i = 0; i < 2; i++) {
+        if (waits[i] == WAIT_VBLANK)
+          time = std::min(time, nextVBlank[i]);
+      }
+
+      deliver(time);
+      if (time == nextTransfer) {
+        transfer(time);
+        nextTransfer += transferCycles;
+
+        for (u32 i = 0; i < 2; i++) {
+          if (waits[i] != WAIT_TRANSFER)
+            continue;
+
+          bool isVBlank = false;
+          while (nextVBlank[i] <= time) {
+            nextVBlank[i] += frameCycles[i];
+            isVBlank = true;
+          }
+          resume(i, isVBlank ? WAIT_VBLANK : WAIT_TRANSFER, time);
+        }
+      }
+      for (u32 i = 0; i < 2; i++) {
+        if (waits[i] == WAIT_VBLANK && nextVBlank[i] == time) {
+          nextVBlank[i] += frameCycles[i];
+          resume(i, WAIT_VBLANK, time);
+        }
+      }
+    }
+
+    return result;
+  }
+
+ private:
+  LinkSimOptions options;
+  LinkSimPort* ports;
+  int* channels;
+  LinkSimResult result = {};
+  LinkSimState states[2] = {};  // (at the last frame)
+  char waits[2];
+  double frameCycles[2];
+  double nextVBlank[2];
+  double lastArrival[2];
+  double frameTime[2];
+  u32 received[2];  // (in the current frame)
+  std::vector<u32> finishes;  // (players that finished each song)
+  std::vector<LinkSimPacket> inFlight;
+
+  bool isDone() {
+    auto& master = ports[0].state;
+    auto& slave = ports[1].state;
+    return master.finishedSongs + master.abortedSongs >= options.songs &&
+           !slave.isPlaying;
+  }
+
+  char receive(u32 playerId) {
+    char request;
+    if (read(channels[playerId], &request, 1) != 1) {
+      fprintf(stderr, "[link] player %u crashed\n", playerId);
+      exit(1);
+    }
+    return request;
+  }
+
+  void resume(u32 playerId, char reply, double time) {
+    if (write(channels[playerId], &reply, 1) != 1) {
+      fprintf(stderr, "[link] player %u crashed\n", playerId);
+      exit(1);
+    }
+
+    waits[playerId] = receive(playerId);
+    if (waits[playerId] == WAIT_VBLANK)
+      onFrame(playerId, time);
+  }
+
+  void transfer(double time) {
+    if (!ports[0].isEnabled || !ports[1].isEnabled)
+      return;
+
+    result.transfers++;
+    bool isLost = nextRandom(1000) < options.loss;
+    if (isLost)
+      result.lostTransfers++;
+
+    for (u32 from = 0; from < 2; from++) {
+      u32 length = !options.isWireless ? 1
+                   : from == 0         ? WIRELESS_SERVER_MESSAGES
+                                       : WIRELESS_CLIENT_MESSAGES;
+      if (isLost) {
+        // (cable messages are gone, wireless ones are sent again)
+        if (!options.isWireless)
+          ports[from].cable.outgoing.pop();
+        continue;
+      }
+
+      std::vector<u16> messages;
+      withQueues(&ports[from], [&messages, length](auto& queues) {
+        for (u32 i = 0; i < length && !queues.outgoing.isEmpty(); i++)
+          messages.push_back(queues.outgoing.pop());
+      });
+
+      u32 to = !from;
+      double delay = (options.latency + jitter()) * CYCLES_PER_MS;
+      double arrival = std::max(lastArrival[to], time + std::max(delay, 0.0));
+      lastArrival[to] = arrival;
+      inFlight.push_back({arrival, (u8)to, messages});
+    }
+  }
+
+  double jitter() {
+    if (options.jitter == 0)
+      return 0;
+    return (double)nextRandom(options.jitter * 2000 + 1) / 1000 -
+           options.jitter;
+  }
+
+  void deliver(double time) {
+    for (auto& packet : inFlight) {
+      if (packet.time > time)
+        continue;
+
+      auto& port = ports[packet.to];
+      port.didReceive = true;
+      withQueues(&port, [this, &packet](auto& queues) {
+        for (auto message : packet.messages) {
+          if (queues.incoming.isFull())
+            result.overflows[packet.to]++;
+          queues.incoming.push(message);
+        }
+      });
+      received[packet.to] += packet.messages.size();
+    }
+    inFlight.erase(std::remove_if(inFlight.begin(), inFlight.end(),
+                                  [time](const LinkSimPacket& packet) {
+                                    return packet.time <= time;
+                                  }),
+                   inFlight.end());
+  }
+
+  void onFrame(u32 playerId, double time) {
+    auto& state = ports[playerId].state;
+    auto& last = states[playerId];
+    frameTime[playerId] = time;
+    if (playerId == 0)
+      result.frames++;
+
+    result.received[playerId] += received[playerId];
+    result.maxReceived[playerId] =
+        std::max(result.maxReceived[playerId], received[playerId]);
+    received[playerId] = 0;
+    result.sendWaits[playerId] = state.sendWaits;
+    result.overflows[playerId] += state.overflows - last.overflows;
+
+    // (songs are the master's; later resets and timeouts count for them)
+    u32 songs = ports[0].state.songs;
+    while (result.songs.size() < songs) {
+      result.songs.push_back({});
+      finishes.push_back(0);
+    }
+    if (songs > 0) {
+      auto& song = result.songs[songs - 1];
+      song.underruns += state.audioSync.underruns - last.audioSync.underruns;
+      song.skippedChunks +=
+          state.audioSync.skippedChunks - last.audioSync.skippedChunks;
+      song.overruns += state.audioSync.overruns - last.audioSync.overruns;
+      song.resets += state.resets - last.resets;
+      song.linkTimeouts += state.linkTimeouts - last.linkTimeouts;
+      finishes[songs - 1] += state.finishedSongs - last.finishedSongs;
+      song.isFinished = finishes[songs - 1] == 2;
+    }
+    if (playerId == 1)
+      measureDesync(time);
+
+    last = state;
+  }
+
+  void measureDesync(double time) {
+    auto& master = ports[0].state;
+    auto& slave = ports[1].state;
+    if (!master.isPlaying || !slave.isPlaying)
+      return;
+
+    double masterMsecs =
+        master.msecs + (time - frameTime[0]) / CYCLES_PER_MS;
+    double desync = slave.msecs - masterMsecs;
+    auto& song = result.songs[master.songs - 1];
+    song.maxDesync = song.frames > 0 ? std::max(song.maxDesync, desync) : desync;
+    song.minDesync = song.frames > 0 ? std::min(song.minDesync, desync) : desync;
+    song.totalDesync += desync;
+    song.frames++;
+  }
+};
+
+LinkSimResult LINK_SIM_run(LinkSimOptions options) {
+  seed = options.seed;
+  u32 lastMillisecond = options.seconds * 1000;
+  u32 noteCount;
+  auto events = FIXTURE_createNotes(
+      (lastMillisecond - FIXTURE_FIRST_NOTE) / FIXTURE_NOTE_INTERVAL,
+      &noteCount);
+  auto content = FIXTURE_createContent(1);
+  FIXTURE_writeSong(content, SONG_NAME, lastMillisecond, events);
+  std::string list = SONG_NAME;
+  for (auto name : LIBRARY_LISTS)
+    FIXTURE_writeFile(content + "/" + name,
+                      std::vector<u8>(list.begin(), list.end() + 1));
+  // (the grade scene waits for its sound to end)
+  for (auto name : RANK_SOUNDS)
+    FIXTURE_writeFile(content + "/" + name + ".gsm",
+                      std::vector<u8>(RANK_SOUND_SIZE, 0));
+
+  auto ports = (LinkSimPort*)mmap(NULL, sizeof(LinkSimPort) * 2,
+                                  PROT_READ | PROT_WRITE,
+                                  MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  if (ports == MAP_FAILED) {
+    perror("[link] mmap");
+    exit(1);
+  }
+  int channels[2];
+  pid_t pids[2];
+  fflush(stdout);
+  for (u32 i = 0; i < 2; i++) {
+    new (&ports[i]) LinkSimPort();
+    ports[i].playerId = i;
+    ports[i].isWireless = options.isWireless;
+
+    int fds[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+      perror("[link] socketpair");
+      exit(1);
+    }
+    pids[i] = fork();
+    if (pids[i] == 0) {
+      for (u32 j = 0; j < i; j++)
+        close(channels[j]);
+      close(fds[0]);
+      play(&ports[i], fds[1], content, events);
+    }
+    close(fds[1]);
+    channels[i] = fds[0];
+  }
+
+  LinkSimulator simulator(options, ports, channels);
+  auto result = simulator.run();
+
+  for (u32 i = 0; i < 2; i++) {
+    char quit = QUIT;
+    int status;
+    if (write(channels[i], &quit, 1) != 1 || waitpid(pids[i], &status, 0) < 0)
+      fprintf(stderr, "[link] can't stop player %u\n", i);
+    close(channels[i]);
+  }
+  munmap(ports, sizeof(LinkSimPort) * 2);
+  FIXTURE_removeFolder(content);
+  return result;
+}
@@ -0,0 +1,62 @@
+#ifndef HOST_LINK_H
+#define HOST_LINK_H
+
+#include <libgba-sprite-engine/gba/tonc_core.h>
+
+#include <vector>
+
+// Link simulator: plays VS sessions between two host games connected by a
+// simulated Link Cable or Wireless Adapter, with latency, jitter and lost
+// transfers, and measures how the audio sync and the messages hold up.
+// Both games run the real multiplayer code (`Syncer`, the lobby, selection,
+// song and grade scenes) against the host `LinkUniversal` (see
+// `include/utils/gba-link-connection/LinkUniversal.hpp`), each one in its
+// own process (the GBA memory is mapped at fixed addresses).
+// The simulator owns the clock: games run their frames in lockstep with the
+// send timer's transfers (`SYNC_SEND_INTERVAL` ticks), which move messages
+// between the queues:
+// - cable transfers carry one message per side, and lost ones are gone;
+// - wireless ones carry up to a full server/client transfer
+//   (`LINK_WIRELESS_MAX_*_TRANSFER_LENGTH`), and lost ones are sent again.
+// Player 0 (the master) confirms the first song of a fixture library, and
+// both players hit every note (see `FixturePlayer`).
+
+typedef struct {
+  bool isWireless;
+  u32 songs;    // (played one after the other, aborted ones count)
+  u32 seconds;  // (of the fixture song)
+  u32 latency;  // (ms)
+  u32 jitter;   // (ms, added or subtracted at random)
+  u32 loss;     // (lost transfers per 1000)
+  int drift;    // (ppm, how much longer player 1's frames are)
+  u32 seed;
+} LinkSimOptions;
+
+typedef struct {
+  bool isFinished;  // (by both players, otherwise it was aborted)
+  u32 frames;       // (of the slave, while both play it)
+  double maxDesync;  // (ms, slave's audio position - master's)
+  double minDesync;
+  double totalDesync;
+  u32 underruns;  // (`AUDIO_SYNC_LIMIT` corrections, see `HostAudioSync`)
+  u32 skippedChunks;
+  u32 overruns;
+  u32 resets;        // (sessions dropped by `Syncer`, during or after it)
+  u32 linkTimeouts;  // (links reset by `LinkUniversal`, during or after it)
+} LinkSimSong;
+
+typedef struct {
+  std::vector<LinkSimSong> songs;
+  u32 frames;  // (of player 0)
+  u32 transfers;
+  u32 lostTransfers;
+  u32 received[2];     // (messages)
+  u32 maxReceived[2];  // (in a frame)
+  u32 sendWaits[2];    // (`send(...)` found the queue full and waited)
+  u32 overflows[2];    // (messages dropped from full incoming queues)
+} LinkSimResult;
+
+// Runs a session until player 0 ended `options.songs` songs (or a time limit).
+LinkSimResult LINK_SIM_run(LinkSimOptions options);
+
+#endif  // HOST_LINK_H
@@ -0,0 +1,20 @@
+const fs = require("fs");
+const lz77 = require("../../scripts/importer/src/serializer/lz77");
+
+// Usage: node lz77_compress.js <input> <output> [--vram]
+// Compresses each block of <input> (u32 size, then its bytes) with the
+// importer's encoder and writes the results back-to-back, like
+// `SongSerializer` does with event blocks (see `FIXTURE_compress`).
+
+const [input, output, flag] = process.argv.slice(2);
+const data = fs.readFileSync(input);
+const blocks = [];
+for (let cursor = 0; cursor < data.length; ) {
+  const size = data.readUInt32LE(cursor);
+  cursor += 4;
+  blocks.push(
+    lz77(data.slice(cursor, cursor + size), { vram: flag === "--vram" })
+  );
+  cursor += size;
+}
+fs.writeFileSync(output, Buffer.concat(blocks));
@@ -0,0 +1,214 @@
+#include "host.h"
+
+extern "C" {
+#include "player/PlaybackState.h"
+#include "player/player.h"
+#include "player/song_clock.h"
+#include "utils/gbfs/gbfs.h"
+}
+
+// Host player: it follows `player.iwram.c` sample by sample (resampler
+// phase, GSM frames, seeks and the multiplayer sync), but counts samples
+// instead of decoding them, so the song clock matches the GBA's exactly.
+// PCM sources are modeled from the GSM file (same length in samples).
+
+#define AUDIO_CHUNK_SIZE_GSM 33
+#define AUDIO_CHUNK_SIZE_PCM 304
+#define GSM_CHUNK_SAMPLES 160
+#define AS_CURSOR_GSM 3201039125
+#define AS_CURSOR_PCM 1348619731
+#define RESAMPLE_ONE 0x10000
+#define ALIGNED_PHASE (isPCM ? 0 : RESAMPLE_ONE / 2)
+
+extern "C" uint32_t fracumul(uint32_t x, uint32_t frac);
+
+Playback PlaybackState;
+
+static const u32 rate_steps[] = {30802, 48497, 57016, 65536,
+                                 74056, 82575, 100270};
+static const GBFS_FILE* fs = NULL;
+static bool isPCMEnabled = false;
+static bool isPCM = false;
+static bool isPlaying = false;
+static int rate = 0;
+static u32 ratePhase = 0;
+static u32 srcLen = 0;
+static u32 srcPos = 0;
+static u32 decodePos = GSM_CHUNK_SAMPLES;
+static u32 currentAudioChunk = 0;
+static HostAudioSync audioSync = {0, 0, 0};
+
+static void resetResampler() {
+  ratePhase = ALIGNED_PHASE;
+}
+
+static void stop() {
+  isPlaying = false;
+  decodePos = GSM_CHUNK_SAMPLES;
+  resetResampler();
+}
+
+static void loadFile(const char* name, bool forceGSM) {
+  PlaybackState.msecs = 0;
+  PlaybackState.msecsFraction = 0;
+  PlaybackState.hasFinished = false;
+  PlaybackState.isLooping = false;
+  rate = 0;
+  currentAudioChunk = 0;
+  stop();
+
+  std::string fileName = std::string(name) + ".gsm";
+  u32 length = 0;
+  bool exists = gbfs_get_obj(fs, fileName.c_str(), &length) != NULL;
+  isPCM = isPCMEnabled && !PlaybackState.isPCMDisabled && !forceGSM && exists;
+  PlaybackState.isPCM = isPCM;
+  isPlaying = exists;
+  srcPos = 0;
+  srcLen = isPCM ? length / AUDIO_CHUNK_SIZE_GSM * GSM_CHUNK_SAMPLES * 2
+                 : length;
+}
+
+static void readSample(int& availableAudioChunks, bool isSynchronized) {
+  if (decodePos >= GSM_CHUNK_SAMPLES) {
+    srcPos += AUDIO_CHUNK_SIZE_GSM;
+    decodePos = 0;
+    if (isSynchronized)
+      availableAudioChunks--;
+    currentAudioChunk++;
+  }
+  decodePos++;
+}
+
+static void onStop() {
+  if (PlaybackState.isLooping)
+    player_seek(0);
+  else {
+    player_stop();
+    PlaybackState.hasFinished = true;
+  }
+}
+
+u32 HOST_processAudio(int expectedAudioChunk) {
+  bool isSynchronized = expectedAudioChunk > 0;
+  int availableAudioChunks = expectedAudioChunk - currentAudioChunk;
+  bool skipped = false;
+  if (isSynchronized) {
+    if (availableAudioChunks > AUDIO_SYNC_LIMIT) {
+      u32 diff = availableAudioChunks - AUDIO_SYNC_LIMIT;
+      srcPos += AUDIO_CHUNK_SIZE_GSM * diff;
+      currentAudioChunk += diff;
+      availableAudioChunks = AUDIO_SYNC_LIMIT;
+      audioSync.underruns++;
+      audioSync.skippedChunks += diff;
+    } else if (availableAudioChunks < -AUDIO_SYNC_LIMIT) {
+      skipped = true;
+      audioSync.overruns++;
+    }
+  }
+
+  if (!skipped && isPlaying) {
+    u32 rateStep = rate_steps[rate + RATE_LEVELS] >> (isPCM ? 0 : 1);
+    if (srcPos >= srcLen)
+      onStop();
+    else if (isPCM) {
+      srcPos += (ratePhase + 608 * rateStep) >> 16;
+      ratePhase = (ratePhase + 608 * rateStep) & 0xffff;
+      if (srcPos >= srcLen)
+        onStop();
+    } else {
+      if (rateStep == RESAMPLE_ONE / 2 && ratePhase == ALIGNED_PHASE) {
+        for (u32 i = 0; i < 608 / 2; i++)
+          readSample(availableAudioChunks, isSynchronized);
+      } else {
+        for (u32 i = 0; i < 608; i++) {
+          while (ratePhase >= RESAMPLE_ONE) {
+            ratePhase -= RESAMPLE_ONE;
+            readSample(availableAudioChunks, isSynchronized);
+          }
+          ratePhase += rateStep;
+        }
+      }
+      if (srcPos >= srcLen)
+        onStop();
+    }
+  }
+
+  u32 samples =
+      isPCM ? srcPos
+            : song_clock_gsm_samples(srcPos, AUDIO_CHUNK_SIZE_GSM, decodePos);
+  PlaybackState.msecs = song_clock_msecs(samples, isPCM);
+  PlaybackState.msecsFraction = song_clock_fraction(samples, isPCM);
+  return currentAudioChunk;
+}
+
+void HOST_setPCM(bool isPCM) {
+  isPCMEnabled = isPCM;
+}
+
+HostAudioSync HOST_getAudioSync() {
+  return audioSync;
+}
+
+extern "C" {
+
+void player_init() {
+  fs = find_first_gbfs_file(0);
+  PlaybackState.msecs = 0;
+  PlaybackState.msecsFraction = 0;
+  PlaybackState.hasFinished = false;
+  PlaybackState.isLooping = false;
+  PlaybackState.isPCMDisabled = false;
+  PlaybackState.isPCM = false;
+  PlaybackState.fatfs = NULL;
+}
+
+void player_unload() {}
+
+bool player_playSfx(const char* name) {
+  loadFile(name, false);
+  return isPCM;
+}
+
+bool player_play(const char* name, bool forceGSM) {
+  loadFile(name, forceGSM);
+  return isPCM;
+}
+
+void player_enableLoop() {
+  PlaybackState.isLooping = true;
+}
+
+void player_seek(unsigned int msecs) {
+  if (isPCM) {
+    u32 cursor = msecs * 36 + fracumul(msecs, AS_CURSOR_PCM);
+    srcPos = (cursor / AUDIO_CHUNK_SIZE_PCM) * AUDIO_CHUNK_SIZE_PCM;
+  } else {
+    u32 cursor = msecs * 3 + fracumul(msecs, AS_CURSOR_GSM);
+    srcPos = (cursor / AUDIO_CHUNK_SIZE_GSM) * AUDIO_CHUNK_SIZE_GSM;
+  }
+  currentAudioChunk = 0;
+  resetResampler();
+}
+
+void player_setRate(int newRate) {
+  rate = newRate;
+  ratePhase = ALIGNED_PHASE;
+}
+
+void player_stop() {
+  stop();
+
+  PlaybackState.msecs = 0;
+  PlaybackState.msecsFraction = 0;
+  PlaybackState.hasFinished = false;
+  PlaybackState.isLooping = false;
+  rate = 0;
+  currentAudioChunk = 0;
+}
+
+bool player_isPlaying() {
+  return isPlaying;
+}
+
+void player_onVBlank() {}
+}
@@ -0,0 +1,111 @@
+#include <stdio.h>
+
+#include <map>
+#include <string>
+
+#include "host.h"
+
+extern "C" {
+#include "player/io_scheduler.h"
+#include "utils/flashcartio/flashcartio.h"
+}
+
+// A flash cart slot without a cart (the game then reads everything from the
+// GBFS image in ROM, see `gbfs.cpp`) unless a test gives it an SD card: a
+// folder, read with the host's files instead of FatFs. (tests that need the
+// real FatFs and flashcartio read a FAT image instead, see `IMAGE_LIB` in
+// the Makefile)
+
+static std::string sdPath;
+static std::map<FIL*, FILE*> openFiles;
+
+void HOST_setSD(const char* path) {
+  sdPath = path != NULL ? path : "";
+}
+
+extern "C" {
+
+ActiveFlashcart active_flashcart = NO_FLASHCART;
+volatile bool flashcartio_is_reading = false;
+volatile bool flashcartio_needs_reset = false;
+void (*flashcartio_reset_callback)(void) = NULL;
+void (*flashcartio_trace_callback)(unsigned int sector,
+                                   unsigned short count) = NULL;
+
+ActivationResult flashcartio_activate(void) {
+  return sdPath.empty() ? NO_FLASHCART_FOUND : FLASHCART_ACTIVATED;
+}
+
+bool flashcartio_read_sector(unsigned int sector,
+                             unsigned char* destination,
+                             unsigned short count) {
+  return false;
+}
+
+void flashcartio_stream_open(FlashcartStream* stream, unsigned int sector) {
+  stream->sector = sector;
+}
+
+bool flashcartio_stream_read(FlashcartStream* stream,
+                             void* destination,
+                             unsigned int count) {
+  return false;
+}
+
+FRESULT f_mount(FATFS* fs, const TCHAR* path, BYTE opt) {
+  return sdPath.empty() ? FR_NOT_READY : FR_OK;
+}
+
+FRESULT f_open(FIL* fp, const TCHAR* path, BYTE mode) {
+  if (sdPath.empty())
+    return FR_NOT_READY;
+
+  FILE* file = fopen((sdPath + path).c_str(), "rb");
+  if (file == NULL)
+    return FR_NO_FILE;
+
+  openFiles[fp] = file;
+  fseek(file, 0, SEEK_END);
+  fp->obj.objsize = ftell(file);
+  fseek(file, 0, SEEK_SET);
+  fp->fptr = 0;
+  return FR_OK;
+}
+
+FRESULT f_close(FIL* fp) {
+  auto it = openFiles.find(fp);
+  if (it != openFiles.end()) {
+    fclose(it->second);
+    openFiles.erase(it);
+  }
+  return FR_OK;
+}
+
+FRESULT f_read(FIL* fp, void* buff, UINT btr, UINT* br) {
+  *br = 0;
+  auto it = openFiles.find(fp);
+  if (it == openFiles.end())
+    return FR_INVALID_OBJECT;
+
+  // (`disk_read` accounts the sectors it reads, see `io_scheduler.c`)
+  u32 firstSector = fp->fptr / IO_SECTOR_SIZE;
+  *br = fread(buff, 1, btr, it->second);
+  fp->fptr += *br;
+  if (*br > 0)
+    io_scheduler_account((fp->fptr - 1) / IO_SECTOR_SIZE - firstSector + 1);
+  return ferror(it->second) ? FR_DISK_ERR : FR_OK;
+}
+
+FRESULT f_lseek(FIL* fp, FSIZE_t ofs) {
+  auto it = openFiles.find(fp);
+  if (it == openFiles.end())
+    return FR_INVALID_OBJECT;
+  if (ofs == CREATE_LINKMAP)
+    return FR_OK;  // (no clusters here)
+
+  if (fseek(it->second, ofs, SEEK_SET) != 0)
+    return FR_DISK_ERR;
+  fp->fptr = ofs;
+  return FR_OK;
+}
+}
@@ -0,0 +1,185 @@
+const assert = require("assert");
+const childProcess = require("child_process");
+const fs = require("fs");
+const os = require("os");
+const $path = require("path");
+const IMPORTER = $path.resolve(__dirname, "../../scripts/importer/src");
+
+// Imports a small fixture library twice with the importer's cache (see
+// `cache.js`) and checks that the second import doesn't convert anything and
+// produces the same GBFS, and that changing a song's audio only converts that
+// audio again. The converters (ffmpeg, ImageMagick and grit) are replaced by
+// scripts that log each call and write outputs derived from their inputs.
+// (without `gbfs` in the PATH, the output folders are compared instead)
+
+const SONGS = ["ALPHA", "BRAVO", "CHARLIE", "DELTA", "ECHO"]; // (2 selectors)
+const CONVERTERS = ["ffmpeg", "magick", "grit", "pngfix"];
+
+// (`$0 <args>` is logged, and the last argument is the output, except for
+// `magick conjure` that writes `output.bmp` and `grit` that writes its files
+// next to the input)
+const FAKE_CONVERTER = (name) => `#!/bin/sh
+echo "${name} $*" >> "$CONVERTER_LOG"
+for last; do :; done
+digest() { { cat "$@"; echo "$ARGS"; } | md5sum | cut -d " " -f 1; }
+ARGS="${name} $*"
+case "${name}:$1" in
+  magick:conjure) digest selector.msl selector.bmp song*.png > output.bmp ;;
+  grit:*)
+    base=$(basename "$1"); base=\${base%.*}
+    for it in img pal map; do digest "$1" > "$base.$it.bin"; done
+    echo "// $base" > "$base.h" ;;
+  ffmpeg:*) digest "$3" > "$last" ;;
+  *) output=$(digest "$1"); echo "$output" > "$last" ;;
+esac
+`;
+
+const SSC = (name) => `#TITLE:${name};
+#ARTIST:Fixture;
+#SAMPLESTART:10.000000;
+#SAMPLELENGTH:12.000000;
+#OFFSET:0.000000;
+#BPMS:0.000000=120.000000;
+${[4, 9, 15]
+  .map(
+    (level) => `#NOTEDATA:;
+#STEPSTYPE:pump-single;
+#DIFFICULTY:Edit;
+#METER:${level};
+#NOTES:
+${"10000\n01000\n00100\n00010\n,\n".repeat(8)}00001
+00000
+00000
+00000
+;`
+  )
+  .join("\n")}
+`;
+
+const seedOf = (string) =>
+  [...string].reduce((seed, it) => seed * 31 + it.charCodeAt(0), 7);
+
+const randomBytes = (seed, size) => {
+  const buffer = Buffer.alloc(size);
+  for (let i = 0; i < size; i++) {
+    seed = (seed * 1103515245 + 12345) >>> 0;
+    buffer[i] = (seed >>> 16) % 256;
+  }
+  return buffer;
+};
+
+const createFixture = () => {
+  const root = fs.mkdtempSync($path.join(os.tmpdir(), "import-cache-"));
+  const bin = $path.join(root, "bin");
+  fs.mkdirSync(bin);
+  CONVERTERS.forEach((name) => {
+    const path = $path.join(bin, name);
+    fs.writeFileSync(path, FAKE_CONVERTER(name));
+    fs.chmodSync(path, 0o755);
+  });
+
+  const songs = $path.join(root, "songs");
+  SONGS.forEach((name) => {
+    const path = $path.join(songs, name);
+    fs.mkdirSync(path, { recursive: true });
+    fs.writeFileSync($path.join(path, `${name}.ssc`), SSC(name));
+    fs.writeFileSync(
+      $path.join(path, `${name}.mp3`),
+      randomBytes(seedOf(name), 4096)
+    );
+    fs.writeFileSync(
+      $path.join(path, `${name}.png`),
+      randomBytes(seedOf(name) + 1, 1024)
+    );
+  });
+
+  return { root, bin, songs };
+};
+
+const hasGbfs = () => {
+  try {
+    childProcess.execSync("command -v gbfs", { stdio: "ignore" });
+    return true;
+  } catch (e) {
+    return false;
+  }
+};
+
+// Imports the library and returns the converter calls and the output files.
+const runImport = ({ root, bin, songs }, run, options = []) => {
+  const log = $path.join(root, `converters${run}.log`);
+  const output = $path.join(root, `output${run}`);
+  fs.writeFileSync(log, "");
+  childProcess.execFileSync(
+    process.execPath,
+    [
+      $path.join(IMPORTER, "importer.js"),
+      `--directory=${songs}`,
+      `--output=${output}`,
+      `--cachedir=${$path.join(root, "cache")}`,
+      ...options,
+    ],
+    {
+      env: {
+        ...process.env,
+        PATH: `${bin}:${process.env.PATH}`,
+        CONVERTER_LOG: log,
+        IMPORTER_NODE_CHECK: "false",
+      },
+      stdio: ["ignore", "ignore", "inherit"],
+    }
+  );
+
+  const calls = fs.readFileSync(log).toString().split("\n").filter((it) => it);
+  const files = {};
+  for (let name of fs.readdirSync(output).sort())
+    files[name] = fs.readFileSync($path.join(output, name));
+  if (hasGbfs()) {
+    childProcess.execSync(`cd "${output}" && gbfs ../files${run}.gbfs *`, {
+      stdio: "ignore",
+    });
+    files[".gbfs"] = fs.readFileSync($path.join(root, `files${run}.gbfs`));
+  }
+  return { calls, files };
+};
+
+const assertSameFiles = (actual, expected, except = []) => {
+  assert.deepStrictEqual(Object.keys(actual), Object.keys(expected));
+  for (let name in expected) {
+    if (except.includes(name) || name === ".gbfs") continue;
+    assert.ok(actual[name].equals(expected[name]), `${name} changed`);
+  }
+};
+
+const fixture = createFixture();
+try {
+  const first = runImport(fixture, 1);
+  const encodes = first.calls.filter((it) => !it.startsWith("pngfix")).length;
+  assert.ok(first.files["ALPHA.gsm"] != null);
+  assert.ok(first.files["_snm_4.img.bin"] != null);
+  assert.ok(encodes > 0);
+
+  // (the second import is fast, so the pool also builds the same output)
+  const second = runImport(fixture, 2, ["--fast=true"]);
+  assert.deepStrictEqual(second.calls, []);
+  assertSameFiles(second.files, first.files);
+  if (first.files[".gbfs"] != null)
+    assert.ok(second.files[".gbfs"].equals(first.files[".gbfs"]));
+
+  const audio = $path.join(fixture.songs, "CHARLIE", "CHARLIE.mp3");
+  fs.writeFileSync(audio, randomBytes(seedOf("CHARLIE") + 2, 4096));
+  const third = runImport(fixture, 3);
+  assert.strictEqual(third.calls.length, 1);
+  assert.ok(third.calls[0].startsWith("ffmpeg"));
+  assert.ok(third.calls[0].includes("CHARLIE.mp3"));
+  assert.ok(!third.files["CHARLIE.gsm"].equals(first.files["CHARLIE.gsm"]));
+  assertSameFiles(third.files, first.files, ["CHARLIE.gsm"]);
+
+  console.log(
+    `importCache: ${encodes} conversions, then 0 (${
+      first.files[".gbfs"] != null ? "same GBFS" : "same files"
+    }), then 1, OK`
+  );
+} finally {
+  fs.rmSync(fixture.root, { recursive: true, force: true });
+}
@@ -0,0 +1,77 @@
+const assert = require("assert");
+const fs = require("fs");
+const os = require("os");
+const $path = require("path");
+const IMPORTER = "../../scripts/importer/src";
+const libraryStats = require(`${IMPORTER}/importers/libraryStats`);
+
+// Checks the `_library_stats.bin` layout against `src/gameplay/LibraryStats.h`.
+
+const HEADER_SIZE = 4;
+const ROW_SIZE = 32;
+const COUNTS = 16;
+const LEVELS = 18;
+
+const chart = (level, { isDouble = false, isMultiplayer = false } = {}) => ({
+  header: { level, isDouble, isMultiplayer },
+});
+const songs = [
+  {
+    song: { id: 1, outputName: "A_VERY_LONG_SONG_NAME" },
+    simfile: { charts: [chart(5), chart(5), chart(22, { isDouble: true })] },
+  },
+  {
+    song: { id: 0, outputName: "CARMEN BUS" },
+    simfile: {
+      charts: [
+        chart(3),
+        chart(17),
+        chart(120),
+        chart(99, { isMultiplayer: true }),
+      ],
+    },
+  },
+];
+
+const generate = (songs) => {
+  const outputPath = fs.mkdtempSync($path.join(os.tmpdir(), "library-stats-"));
+  libraryStats(songs, outputPath);
+  const buffer = fs.readFileSync($path.join(outputPath, "_library_stats.bin"));
+  fs.rmSync(outputPath, { recursive: true, force: true });
+  return buffer;
+};
+
+const buffer = generate(songs);
+const rowOf = (id) => buffer.slice(HEADER_SIZE + id * ROW_SIZE);
+const nameOf = (row) => row.slice(0, COUNTS).toString("ascii");
+const levelsOf = (row) => {
+  const levels = [];
+  for (let level = 0; level <= 103; level++)
+    if ((row[LEVELS + Math.floor(level / 8)] >> level % 8) & 1)
+      levels.push(level);
+  return levels;
+};
+
+assert.strictEqual(buffer.readUInt32LE(0), 2);
+assert.strictEqual(buffer.length, HEADER_SIZE + 2 * ROW_SIZE);
+
+// (rows are placed by id, names are cut like `SongFile` names)
+const carmen = rowOf(0);
+assert.strictEqual(nameOf(carmen), "CARMEN BUS\0\0\0\0\0\0");
+assert.strictEqual(carmen[COUNTS], 3);
+assert.strictEqual(carmen[COUNTS + 1], 1);
+assert.deepStrictEqual(levelsOf(carmen), [3, 17, 103]);
+
+const long = rowOf(1);
+assert.strictEqual(nameOf(long), "A_VERY_LONG_SON\0");
+assert.strictEqual(long[COUNTS], 2);
+assert.strictEqual(long[COUNTS + 1], 1);
+assert.deepStrictEqual(levelsOf(long), [5]);
+assert.strictEqual(long[ROW_SIZE - 1], 0);
+
+// (ids without songs get empty rows)
+const sparse = generate([songs[0]]);
+assert.strictEqual(sparse.readUInt32LE(0), 2);
+assert.ok(sparse.slice(HEADER_SIZE, HEADER_SIZE + ROW_SIZE).every((it) => !it));
+
+console.log("libraryStats: OK");
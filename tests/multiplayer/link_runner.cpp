@@ -0,0 +1,79 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "host/link.h"
+
+// Usage: link_runner [--mode=cable|wireless] [--songs=N] [--seconds=N]
+//   [--latency=MS] [--jitter=MS] [--loss=PER_1000] [--drift=PPM] [--seed=N]
+// Plays a VS session over the link simulator (see `host/link.h`) and prints
+// the desync, the audio sync corrections and the timeouts of each song, and
+// the bandwidth of the session.
+// Exits with 0 if every song was finished by both players, 1 if not, and 2
+// on errors.
+
+static bool parseOption(const char* arg, const char* name, u32* value) {
+  u32 length = strlen(name);
+  if (strncmp(arg, name, length) != 0 || arg[length] != '=')
+    return false;
+
+  *value = strtol(arg + length + 1, NULL, 10);
+  return true;
+}
+
+int main(int argc, char* argv[]) {
+  LinkSimOptions options = {false, 3, 60, 0, 0, 0, 0, 1};
+  for (int i = 1; i < argc; i++) {
+    u32 drift;
+    if (strcmp(argv[i], "--mode=cable") == 0)
+      options.isWireless = false;
+    else if (strcmp(argv[i], "--mode=wireless") == 0)
+      options.isWireless = true;
+    else if (parseOption(argv[i], "--drift", &drift))
+      options.drift = (int)drift;
+    else if (!parseOption(argv[i], "--songs", &options.songs) &&
+             !parseOption(argv[i], "--seconds", &options.seconds) &&
+             !parseOption(argv[i], "--latency", &options.latency) &&
+             !parseOption(argv[i], "--jitter", &options.jitter) &&
+             !parseOption(argv[i], "--loss", &options.loss) &&
+             !parseOption(argv[i], "--seed", &options.seed)) {
+      fprintf(stderr, "Unknown option: %s\n", argv[i]);
+      return 2;
+    }
+  }
+  if (options.songs == 0 || options.seconds * 1000 <= 2000 ||
+      options.loss > 1000) {
+    fprintf(stderr, "Invalid options\n");
+    return 2;
+  }
+
+  printf("%s, %u songs of %us, latency %ums +- %ums, %u/1000 lost, %dppm\n",
+         options.isWireless ? "wireless" : "cable", options.songs,
+         options.seconds, options.latency, options.jitter, options.loss,
+         options.drift);
+  auto result = LINK_SIM_run(options);
+
+  bool isOK = result.songs.size() >= options.songs;
+  printf("song  result    frames  desync (ms)           underruns  overruns  "
+         "resets  timeouts\n");
+  for (u32 i = 0; i < result.songs.size(); i++) {
+    auto& song = result.songs[i];
+    isOK = isOK && song.isFinished;
+    printf("%4u  %-8s  %6u  %6.1f..%6.1f (%6.1f)  %4u (%4u)  %8u  %6u  %8u\n",
+           i + 1, song.isFinished ? "finished" : "aborted", song.frames,
+           song.minDesync, song.maxDesync,
+           song.frames > 0 ? song.totalDesync / song.frames : 0,
+           song.underruns, song.skippedChunks, song.overruns, song.resets,
+           song.linkTimeouts);
+  }
+  printf("%u frames, %u transfers (%u lost)\n", result.frames,
+         result.transfers, result.lostTransfers);
+  for (u32 i = 0; i < 2; i++)
+    printf(
+        "player %u: %.2f messages/frame received (max %u), %u send waits, "
+        "%u overflows\n",
+        i, (double)result.received[i] / result.frames, result.maxReceived[i],
+        result.sendWaits[i], result.overflows[i]);
+
+  return isOK ? 0 : 1;
+}
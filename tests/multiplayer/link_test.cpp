@@ -0,0 +1,95 @@
+#include <math.h>
+#include <stdio.h>
+
+#include "host/link.h"
+#include "test.h"
+
+// Plays VS sessions between two host games over the link simulator (see
+// `host/link.h`), which run the real `Syncer` and scenes, and checks that:
+// - over clean cable and wireless links, every song is finished by both
+//   players, without resets or link timeouts, and the slave's audio stays
+//   close to the master's;
+// - over a slow, lossy link, songs still end (finished or aborted by the
+//   timeouts), and the desync stays bounded while they play.
+// Each scenario prints the audio sync corrections and the bandwidth.
+
+#define SONGS 2
+#define SECONDS 20
+#define MAX_CLEAN_DESYNC 60  // (ms, `AUDIO_SYNC_LIMIT` chunks and a frame)
+#define MAX_LOSSY_DESYNC 250
+
+static LinkSimResult play(const char* name, LinkSimOptions options) {
+  auto result = LINK_SIM_run(options);
+  CHECK_MSG(result.songs.size() >= options.songs, "%s: %zu songs of %u", name,
+            result.songs.size(), options.songs);
+
+  for (u32 i = 0; i < result.songs.size(); i++) {
+    auto& song = result.songs[i];
+    printf("  %s, song %u: %s, %u frames, desync %.1f..%.1f (avg %.1f) ms, "
+           "%u underruns (%u chunks), %u overruns, %u resets, %u timeouts\n",
+           name, i + 1, song.isFinished ? "finished" : "aborted", song.frames,
+           song.minDesync, song.maxDesync,
+           song.frames > 0 ? song.totalDesync / song.frames : 0,
+           song.underruns, song.skippedChunks, song.overruns, song.resets,
+           song.linkTimeouts);
+  }
+  return result;
+}
+
+static void printSummary(const char* name, const LinkSimResult& result) {
+  printf(
+      "%s: %u frames, %u transfers (%u lost), %.2f/%.2f messages/frame "
+      "(max %u/%u), %u/%u send waits, %u/%u overflows, OK\n",
+      name, result.frames, result.transfers, result.lostTransfers,
+      (double)result.received[0] / result.frames,
+      (double)result.received[1] / result.frames, result.maxReceived[0],
+      result.maxReceived[1], result.sendWaits[0], result.sendWaits[1],
+      result.overflows[0], result.overflows[1]);
+}
+
+static void testClean(const char* name, bool isWireless) {
+  LinkSimOptions options = {isWireless, SONGS, SECONDS, 0, 0, 0, 0, 1};
+  auto result = play(name, options);
+
+  for (u32 i = 0; i < options.songs; i++) {
+    auto& song = result.songs[i];
+    CHECK_MSG(song.isFinished, "%s: song %u was aborted", name, i + 1);
+    CHECK_MSG(song.frames > SECONDS * 60 / 2, "%s: song %u played %u frames",
+              name, i + 1, song.frames);
+    CHECK_MSG(song.resets == 0 && song.linkTimeouts == 0,
+              "%s: song %u: %u resets, %u timeouts", name, i + 1, song.resets,
+              song.linkTimeouts);
+    CHECK_MSG(fabs(song.minDesync) <= MAX_CLEAN_DESYNC &&
+                  fabs(song.maxDesync) <= MAX_CLEAN_DESYNC,
+              "%s: song %u desync %.1f..%.1f ms", name, i + 1, song.minDesync,
+              song.maxDesync);
+  }
+  CHECK(result.lostTransfers == 0);
+  CHECK(result.overflows[0] == 0 && result.overflows[1] == 0);
+  printSummary(name, result);
+}
+
+static void testLossy(const char* name, bool isWireless) {
+  // (40ms +- 20ms, 5% of the transfers are lost, player 1 runs 100ppm slow)
+  LinkSimOptions options = {isWireless, SONGS, SECONDS, 40, 20, 50, 100, 7};
+  auto result = play(name, options);
+
+  CHECK(result.lostTransfers > 0);
+  for (u32 i = 0; i < options.songs; i++) {
+    auto& song = result.songs[i];
+    if (song.frames > 0)
+      CHECK_MSG(fabs(song.minDesync) <= MAX_LOSSY_DESYNC &&
+                    fabs(song.maxDesync) <= MAX_LOSSY_DESYNC,
+                "%s: song %u desync %.1f..%.1f ms", name, i + 1,
+                song.minDesync, song.maxDesync);
+  }
+  printSummary(name, result);
+}
+
+int main() {
+  testClean("cable", false);
+  testClean("wireless", true);
+  testLossy("lossy cable", false);
+  testLossy("lossy wireless", true);
+  return 0;
+}
@@ -0,0 +1,166 @@
+#include <stdio.h>
+#include <time.h>
+
+#include "player/lookahead.h"
+#include "player/resampler.h"
+#include "test.h"
+
+// Plays a GSM stream through the real decoder frame by frame, like
+// `player_forever` does, with a chart that has bursts of busy frames (no
+// time to spare), and benchmarks the decode time that lands in the audio
+// path of each frame, with and without decoding ahead (`lookahead.h`).
+// Checks that:
+// - the audio is the same either way, also after a seek;
+// - with the lookahead, busy bursts that fit in the queue never run the
+//   codec (only the first frames after starting or seeking do), and
+//   without it, every frame does.
+// (the stream is random GSM frames: any bits after the magic number are a
+// valid frame, and the decoder does the same work for them)
+
+#define SECONDS 60
+#define CHUNK_SIZE 33
+#define CHUNK_SAMPLES LOOKAHEAD_CHUNK_SAMPLES
+#define CHUNKS (SECONDS * 18157 / CHUNK_SAMPLES)
+#define FRAMES (SECONDS * 30)  // (x1.53 plays 46 seconds)
+#define BURST_PERIOD 12  // (every 12 frames...)
+#define BURST_FRAMES 3   // (...3 of them are busy)
+#define FAST_BURST_FRAMES 2
+#define SPARE_DECODES 6  // (chunks an idle frame has time for)
+#define SEEK_FRAME 1000
+#define SEEK_CHUNK 100
+#define NORMAL_RATE 3
+#define FASTEST_RATE 6
+
+static unsigned char stream[CHUNKS * CHUNK_SIZE];
+static struct gsm_state decoder;
+static signed short decoded[LOOKAHEAD_SLOTS][CHUNK_SAMPLES];
+
+typedef struct {
+  double maxNsecs;  // (decoding in the audio path of a frame)
+  double maxBusyNsecs;
+  double totalNsecs;
+  double aheadNsecs;  // (decoding ahead, in spare time)
+  uint32_t maxDecodes;
+  uint32_t busyDecodes;  // (in busy frames)
+  uint32_t decodes;
+  uint32_t hash;  // (of the audio)
+} Result;
+
+static uint32_t seed = 1;
+
+static uint32_t nextRandom(uint32_t max) {
+  seed = seed * 1103515245 + 12345;
+  return (seed >> 16) % max;
+}
+
+static double nowNsecs() {
+  struct timespec time;
+  clock_gettime(CLOCK_MONOTONIC, &time);
+  return time.tv_sec * 1e9 + time.tv_nsec;
+}
+
+static bool isBusy(uint32_t frame, uint32_t burstFrames) {
+  return frame % BURST_PERIOD >= BURST_PERIOD - burstFrames;
+}
+
+static Result play(uint32_t rate, bool useLookahead, uint32_t burstFrames) {
+  Result result = {0, 0, 0, 0, 0, 0, 0, 2166136261u};
+  Lookahead lookahead = {&decoder, decoded, NULL, 0, 0, 0, 0};
+  lookahead_start(&lookahead, stream, sizeof(stream));
+  uint32_t step = resample_rate_steps[rate] >> 1;
+  uint32_t phase = RESAMPLE_ONE / 2;
+  uint32_t srcPos = 0, decodePos = CHUNK_SAMPLES, i;
+  int lastSample = 0, nextSample = 0;
+  signed short* samples = decoded[0];
+  signed char output[RESAMPLE_OUTPUT_SAMPLES];
+
+  for (uint32_t frame = 0; frame < FRAMES; frame++) {
+    double nsecs = 0;
+    uint32_t decodes = 0;
+    signed char* buffer = output;
+
+    if (frame == SEEK_FRAME) {
+      srcPos = SEEK_CHUNK * CHUNK_SIZE;
+      phase = RESAMPLE_ONE / 2;
+      lookahead_flush(&lookahead, srcPos);
+    }
+
+// (like `GSM_READ_SAMPLE` and `next_gsm_frame`)
+#define READ_SAMPLE                                              \
+  if (decodePos >= CHUNK_SAMPLES) {                              \
+    if (lookahead.ahead_count == 0 && srcPos < sizeof(stream))   \
+      decodes++;                                                 \
+    double start = nowNsecs();                                   \
+    samples = lookahead_next(&lookahead, srcPos);                \
+    nsecs += nowNsecs() - start;                                 \
+    srcPos += CHUNK_SIZE;                                        \
+    decodePos = 0;                                               \
+  }                                                              \
+  nextSample = samples[decodePos++];
+
+    if (step == RESAMPLE_ONE / 2 && phase == RESAMPLE_ONE / 2) {
+      RESAMPLE_HALF(buffer, i, lastSample, nextSample, READ_SAMPLE);
+    } else {
+      RESAMPLE_INTERPOLATE(buffer, i, phase, step, lastSample, nextSample,
+                           READ_SAMPLE);
+    }
+
+    // (like `decode_ahead`, while the frame has time to spare)
+    if (useLookahead && !isBusy(frame, burstFrames)) {
+      double start = nowNsecs();
+      for (uint32_t j = 0;
+           j < SPARE_DECODES && lookahead_can_decode(&lookahead); j++)
+        lookahead_decode(&lookahead);
+      result.aheadNsecs += nowNsecs() - start;
+    }
+
+    for (uint32_t j = 0; j < RESAMPLE_OUTPUT_SAMPLES; j++)
+      result.hash = (result.hash ^ (uint8_t)output[j]) * 16777619u;
+    result.maxNsecs = nsecs > result.maxNsecs ? nsecs : result.maxNsecs;
+    result.totalNsecs += nsecs;
+    result.maxDecodes =
+        decodes > result.maxDecodes ? decodes : result.maxDecodes;
+    result.decodes += decodes;
+    if (isBusy(frame, burstFrames)) {
+      result.busyDecodes += decodes;
+      if (nsecs > result.maxBusyNsecs)
+        result.maxBusyNsecs = nsecs;
+    }
+  }
+
+  return result;
+}
+
+static void benchmark(uint32_t rate, uint32_t burstFrames) {
+  Result without = play(rate, false, burstFrames);
+  Result with = play(rate, true, burstFrames);
+
+  CHECK_MSG(with.hash == without.hash, "the lookahead changed the audio");
+  CHECK_MSG(with.busyDecodes == 0, "%u decodes in busy frames",
+            with.busyDecodes);
+  CHECK(without.maxDecodes > 0 && without.busyDecodes > 0);
+
+  printf("x%.2f, %u busy frames every %u:\n",
+         resample_rate_steps[rate] / 65536.0, burstFrames, BURST_PERIOD);
+  printf(
+      "  without lookahead: worst %.0f ns/frame (%u decodes), busy %.0f, "
+      "avg %.0f, %u decodes\n",
+      without.maxNsecs, without.maxDecodes, without.maxBusyNsecs,
+      without.totalNsecs / FRAMES, without.decodes);
+  printf(
+      "  with lookahead: worst %.0f ns/frame (%u decodes), busy %.0f, "
+      "avg %.0f, %u decodes, %.0f ns/frame ahead, OK\n",
+      with.maxNsecs, with.maxDecodes, with.maxBusyNsecs,
+      with.totalNsecs / FRAMES, with.decodes, with.aheadNsecs / FRAMES);
+}
+
+int main() {
+  for (uint32_t i = 0; i < sizeof(stream); i++)
+    stream[i] = nextRandom(256);
+  for (uint32_t i = 0; i < CHUNKS; i++)
+    stream[i * CHUNK_SIZE] = (GSM_MAGIC << 4) | (stream[i * CHUNK_SIZE] & 15);
+
+  benchmark(NORMAL_RATE, BURST_FRAMES);
+  benchmark(FASTEST_RATE, FAST_BURST_FRAMES);
+  return 0;
+}
@@ -0,0 +1,314 @@
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "player/resampler.h"
+#include "test.h"
+
+// Plays sine waves through the player's resampler (`resampler.h`) frame by
+// frame, like `AUDIO_PROCESS` does, and checks:
+// - continuity: every output sample is the source interpolated at the ideal
+//   position, at every rate, across frame boundaries and rate changes;
+// - accounting: each frame consumes exactly the source samples the phase
+//   accumulator advanced, and PCM never reads past its window;
+// - cost: the work per frame is even (no frames that skip or decode more
+//   than the others), and the host time of the interpolating loops is
+//   reported against the aligned ones used at the normal rate and against
+//   the length of a frame.
+
+#define FRAMES 600
+#define RATE_CHANGE_FRAMES 7
+#define BENCHMARK_FRAMES 20000
+#define PCM_AMPLITUDE 100
+#define PCM_PERIOD 50
+#define GSM_AMPLITUDE 20000
+#define GSM_PERIOD 80
+#define GSM_CHUNK_SAMPLES 160
+#define GSM_MAX_CHUNKS_PER_FRAME 3  // (608 * 1.53 / 2 = 465 samples)
+#define PCM_MAX_ERROR 1              // (outputs are floored)
+#define GSM_MAX_ERROR 1.05           // (floored, and weights are 8-bit)
+#define MAX_JUMP_ERROR 2            // (two floored outputs)
+#define NORMAL_RATE 3
+#define FASTEST_RATE 6
+#define RATE_COUNT (sizeof(resample_rate_steps) / sizeof(uint32_t))
+#define FRAME_NSECS (280896 * 1e9 / 16777216)
+#define POISON 127
+
+typedef struct {
+  bool isPCM;
+  uint32_t phase;
+  uint64_t position;  // (Q16, ideal source position of the next output)
+  int64_t readPos;    // (source samples read)
+  signed char output[RESAMPLE_OUTPUT_SAMPLES];
+
+  // (PCM)
+  signed char source[RESAMPLE_CARRY + RESAMPLE_MAX_SOURCE + 2];
+
+  // (GSM)
+  int lastSample;
+  int nextSample;
+  uint32_t chunks;  // (GSM frames started, like `next_gsm_frame` calls)
+} Player;
+
+typedef struct {
+  double maxError;  // (output vs ideal)
+  int maxJump;      // (between consecutive outputs)
+  double maxIdealJump;
+  uint32_t minRead;  // (source samples per frame)
+  uint32_t maxRead;
+  uint32_t maxChunks;  // (GSM frames per frame)
+} Result;
+
+// (the player starts with two silent samples: the PCM carry, or GSM's
+// `last_sample` and `next_sample`)
+static int sampleAt(bool isPCM, int64_t index) {
+  if (index < 0)
+    return 0;
+  return isPCM ? (signed char)lround(PCM_AMPLITUDE *
+                                     sin(2 * M_PI * index / PCM_PERIOD))
+               : (short)lround(GSM_AMPLITUDE *
+                               sin(2 * M_PI * index / GSM_PERIOD));
+}
+
+// (the source linearly interpolated at `position`, in output units)
+static double idealAt(bool isPCM, uint64_t position) {
+  int64_t index = (int64_t)(position >> 16) - RESAMPLE_CARRY;
+  double weight = (position & 0xffff) / 65536.0;
+  double a = sampleAt(isPCM, index);
+  double b = sampleAt(isPCM, index + 1);
+  return (a + (b - a) * weight) / (isPCM ? 1 : 256);
+}
+
+static uint32_t alignedPhase(bool isPCM) {
+  return isPCM ? 0 : RESAMPLE_ONE / 2;
+}
+
+static void init(Player* player, bool isPCM) {
+  memset(player, 0, sizeof(*player));
+  player->isPCM = isPCM;
+  player->phase = alignedPhase(isPCM);
+  player->position = player->phase;
+}
+
+// (like `player_setRate`)
+static void resetPhase(Player* player) {
+  player->position -= player->phase;
+  player->phase = alignedPhase(player->isPCM);
+  player->position += player->phase;
+}
+
+static int readGSM(Player* player) {
+  if (player->readPos % GSM_CHUNK_SAMPLES == 0)
+    player->chunks++;
+  return sampleAt(false, player->readPos++);
+}
+
+// Plays a frame like `AUDIO_PROCESS`, and returns the source samples read.
+static uint32_t playFrame(Player* player, uint32_t rate) {
+  uint32_t step = resample_rate_steps[rate] >> (player->isPCM ? 0 : 1);
+  int64_t readPos = player->readPos;
+  signed char* buffer = player->output;
+
+  if (player->isPCM) {
+    uint32_t consumed = resample_consumed(player->phase, step);
+    CHECK_MSG(consumed <= RESAMPLE_MAX_SOURCE, "%u samples don't fit",
+              consumed);
+    memset(player->source + RESAMPLE_CARRY, POISON,
+           sizeof(player->source) - RESAMPLE_CARRY);
+    for (uint32_t i = 0; i < consumed; i++)
+      player->source[RESAMPLE_CARRY + i] = sampleAt(true, readPos + i);
+    player->readPos += consumed;
+    player->phase = resample_pcm(buffer, player->source, player->phase, step,
+                                 consumed);
+  } else {
+    int i;
+    if (step == RESAMPLE_ONE / 2 && player->phase == RESAMPLE_ONE / 2) {
+      RESAMPLE_HALF(buffer, i, player->lastSample, player->nextSample,
+                    player->nextSample = readGSM(player));
+    } else {
+      RESAMPLE_INTERPOLATE(buffer, i, player->phase, step, player->lastSample,
+                           player->nextSample,
+                           player->nextSample = readGSM(player));
+    }
+  }
+
+  return (uint32_t)(player->readPos - readPos);
+}
+
+static void checkFrame(Player* player,
+                       uint32_t rate,
+                       Result* result,
+                       int* previous) {
+  uint32_t step = resample_rate_steps[rate] >> (player->isPCM ? 0 : 1);
+  uint32_t chunks = player->chunks;
+  uint32_t read = playFrame(player, rate);
+
+  for (uint32_t i = 0; i < RESAMPLE_OUTPUT_SAMPLES; i++) {
+    double ideal = idealAt(player->isPCM, player->position);
+    double error = ideal - player->output[i];
+    int jump = abs(player->output[i] - *previous);
+    double idealJump =
+        player->position >= step
+            ? fabs(ideal - idealAt(player->isPCM, player->position - step))
+            : 0;
+    double maxError = player->isPCM ? PCM_MAX_ERROR : GSM_MAX_ERROR;
+    CHECK_MSG(error >= 1 - maxError && error < maxError,
+              "%s output %d isn't %f", player->isPCM ? "PCM" : "GSM",
+              player->output[i], ideal);
+    result->maxError = fmax(result->maxError, fabs(error));
+    result->maxJump = jump > result->maxJump ? jump : result->maxJump;
+    result->maxIdealJump = fmax(result->maxIdealJump, idealJump);
+    *previous = player->output[i];
+    player->position += step;
+  }
+
+  result->minRead = read < result->minRead ? read : result->minRead;
+  result->maxRead = read > result->maxRead ? read : result->maxRead;
+  chunks = player->chunks - chunks;
+  result->maxChunks = chunks > result->maxChunks ? chunks : result->maxChunks;
+}
+
+static Result play(bool isPCM, uint32_t rate) {
+  Result result = {0, 0, 0, UINT32_MAX, 0, 0};
+  Player player;
+  init(&player, isPCM);
+  int previous = 0;
+
+  // (GSM starts half a sample in, so its first frame may read one less)
+  checkFrame(&player, rate, &result, &previous);
+  result.minRead = UINT32_MAX;
+  result.maxRead = 0;
+  for (uint32_t frame = 1; frame < FRAMES; frame++)
+    checkFrame(&player, rate, &result, &previous);
+
+  // (no samples are skipped or repeated)
+  uint32_t step = resample_rate_steps[rate] >> (isPCM ? 0 : 1);
+  uint64_t advanced = (uint64_t)FRAMES * RESAMPLE_OUTPUT_SAMPLES * step;
+  uint64_t expected = isPCM
+                          ? advanced >> 16
+                          // (GSM reads a sample when an output needs it)
+                          : (advanced - step + alignedPhase(false)) >> 16;
+  CHECK_MSG((uint64_t)player.readPos == expected, "read %ld instead of %lu",
+            (long)player.readPos, (unsigned long)expected);
+  CHECK_MSG(result.maxRead - result.minRead <= 1, "uneven frames: %u-%u",
+            result.minRead, result.maxRead);
+  CHECK(result.maxJump <= result.maxIdealJump + MAX_JUMP_ERROR);
+  return result;
+}
+
+static void testRates(bool isPCM) {
+  for (uint32_t rate = 0; rate < RATE_COUNT; rate++) {
+    Result result = play(isPCM, rate);
+    if (!isPCM)
+      CHECK_MSG(result.maxChunks <= GSM_MAX_CHUNKS_PER_FRAME,
+                "%u GSM frames in a frame", result.maxChunks);
+    printf("%s x%.2f: %u-%u samples/frame", isPCM ? "PCM" : "GSM",
+           resample_rate_steps[rate] / 65536.0, result.minRead,
+           result.maxRead);
+    if (!isPCM)
+      printf(", %u GSM frames max", result.maxChunks);
+    printf(", error %.2f, jump %d, OK\n", result.maxError, result.maxJump);
+  }
+}
+
+static void testRateChanges(bool isPCM) {
+  Result result = {0, 0, 0, UINT32_MAX, 0, 0};
+  Player player;
+  init(&player, isPCM);
+  int previous = 0;
+
+  for (uint32_t frame = 0; frame < FRAMES; frame++) {
+    uint32_t rate = (frame / RATE_CHANGE_FRAMES) % RATE_COUNT;
+    if (frame > 0 && frame % RATE_CHANGE_FRAMES == 0)
+      resetPhase(&player);
+    checkFrame(&player, rate, &result, &previous);
+  }
+
+  // (a step, plus the phase reset, which moves less than a source sample)
+  double maxSourceJump =
+      (isPCM ? PCM_AMPLITUDE * 2 * M_PI / PCM_PERIOD
+             : GSM_AMPLITUDE * 2 * M_PI / GSM_PERIOD / 256);
+  CHECK_MSG(result.maxJump <= maxSourceJump * 3 + MAX_JUMP_ERROR,
+            "rate changes jump %d", result.maxJump);
+  printf("%s rate changes: error %.2f, jump %d, OK\n", isPCM ? "PCM" : "GSM",
+         result.maxError, result.maxJump);
+}
+
+// --- Cost ---
+
+static double nowNsecs() {
+  struct timespec time;
+  clock_gettime(CLOCK_MONOTONIC, &time);
+  return time.tv_sec * 1e9 + time.tv_nsec;
+}
+
+static signed char pcmTable[PCM_PERIOD * 20];
+static short gsmTable[GSM_CHUNK_SAMPLES];
+
+// Returns host nanoseconds per frame, without producing the source (PCM
+// copies it like `audio_store_read`, GSM reads it like `GSM_READ_SAMPLE`).
+static double benchmark(bool isPCM, uint32_t rate, uint32_t* checksum) {
+  uint32_t step = resample_rate_steps[rate] >> (isPCM ? 0 : 1);
+  static signed char source[RESAMPLE_CARRY + RESAMPLE_MAX_SOURCE];
+  signed char output[RESAMPLE_OUTPUT_SAMPLES];
+  uint32_t phase = alignedPhase(isPCM);
+  int lastSample = 0, nextSample = 0, decodePos = 0, i;
+
+  double start = nowNsecs();
+  for (uint32_t frame = 0; frame < BENCHMARK_FRAMES; frame++) {
+    signed char* buffer = output;
+    if (isPCM) {
+      uint32_t consumed = resample_consumed(phase, step);
+      for (uint32_t j = 0; j < consumed; j += sizeof(pcmTable)) {
+        uint32_t size = consumed - j;
+        memcpy(source + RESAMPLE_CARRY + j, pcmTable,
+               size < sizeof(pcmTable) ? size : sizeof(pcmTable));
+      }
+      phase = resample_pcm(buffer, source, phase, step, consumed);
+    } else if (step == RESAMPLE_ONE / 2 && phase == RESAMPLE_ONE / 2) {
+      RESAMPLE_HALF(buffer, i, lastSample, nextSample,
+                    nextSample = gsmTable[decodePos++ % GSM_CHUNK_SAMPLES]);
+    } else {
+      RESAMPLE_INTERPOLATE(
+          buffer, i, phase, step, lastSample, nextSample,
+          nextSample = gsmTable[decodePos++ % GSM_CHUNK_SAMPLES]);
+    }
+    *checksum += output[frame % RESAMPLE_OUTPUT_SAMPLES];
+  }
+  return (nowNsecs() - start) / BENCHMARK_FRAMES;
+}
+
+static void testCost(bool isPCM) {
+  uint32_t checksum = 0;
+  double aligned = benchmark(isPCM, NORMAL_RATE, &checksum);
+  double slowest = 0;
+  for (uint32_t rate = 0; rate < RATE_COUNT; rate++) {
+    if (rate == NORMAL_RATE)
+      continue;
+    double nsecs = benchmark(isPCM, rate, &checksum);
+    slowest = fmax(slowest, nsecs);
+  }
+  double fastest = benchmark(isPCM, FASTEST_RATE, &checksum);
+
+  printf(
+      "%s cost (host): aligned %.0f ns/frame, interpolated %.0f (x%.1f, "
+      "%.3f%% of a frame's time), x1.53 %.0f [%u]\n",
+      isPCM ? "PCM" : "GSM", aligned, slowest, slowest / aligned,
+      slowest * 100 / FRAME_NSECS, fastest, checksum & 0xff);
+}
+
+int main() {
+  for (uint32_t i = 0; i < sizeof(pcmTable); i++)
+    pcmTable[i] = sampleAt(true, i);
+  for (uint32_t i = 0; i < GSM_CHUNK_SAMPLES; i++)
+    gsmTable[i] = sampleAt(false, i);
+
+  testRates(true);
+  testRates(false);
+  testRateChanges(true);
+  testRateChanges(false);
+  testCost(true);
+  testCost(false);
+  return 0;
+}
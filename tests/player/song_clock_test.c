@@ -0,0 +1,135 @@
+#include <math.h>
+#include <stdio.h>
+
+#include "player/song_clock.h"
+#include "test.h"
+
+// Plays a 10-minute song frame by frame, consuming source samples like
+// `player_forever` does, and checks that the song clock stays within a
+// fraction of a millisecond of the ideal time at every frame.
+
+#define FRAMES (10 * 60 * 60)
+#define OUTPUT_SAMPLES 608
+#define OUTPUT_RATE (16777216.0 / 462)
+#define GSM_CHUNK_SIZE 33
+#define RESAMPLE_ONE 0x10000
+#define AS_MSECS_GSM 1146880000ull  // (the chunk-based clock used before)
+
+// (Q16 source samples per output sample, see `rate_steps` in the player)
+static const uint32_t RATE_STEPS[] = {30802, 48497, 57016, 65536,
+                                      74056, 82575, 100270};
+#define RATE_COUNT (sizeof(RATE_STEPS) / sizeof(RATE_STEPS[0]))
+
+typedef struct {
+  double maxError;      // (Q16 clock vs ideal, ms)
+  double maxMsecError;  // (integer clock vs ideal, ms)
+  double firstMinute;   // (max error during the first minute, ms)
+  double lastMinute;    // (max error during the last minute, ms)
+  double leadDiff;      // (average old clock - new clock, ms)
+} Result;
+
+static void track(Result* result, uint32_t frame, double clock, double msecs,
+                  double ideal) {
+  double error = fabs(clock - ideal);
+  double msecError = fabs(msecs - ideal);
+  if (error > result->maxError)
+    result->maxError = error;
+  if (msecError > result->maxMsecError)
+    result->maxMsecError = msecError;
+  if (frame < 3600 && error > result->firstMinute)
+    result->firstMinute = error;
+  if (frame >= FRAMES - 3600 && error > result->lastMinute)
+    result->lastMinute = error;
+}
+
+static Result playPCM(uint32_t step) {
+  Result result = {0, 0, 0, 0, 0};
+  uint32_t phase = 0;
+  uint32_t srcPos = 0;
+  double sourceRate = OUTPUT_RATE;
+
+  for (uint32_t frame = 1; frame <= FRAMES; frame++) {
+    uint32_t consumed = (phase + OUTPUT_SAMPLES * step) >> 16;
+    phase = (phase + OUTPUT_SAMPLES * step) & 0xffff;
+    srcPos += consumed;
+
+    double played = (double)frame * OUTPUT_SAMPLES * step / RESAMPLE_ONE;
+    double ideal = played * 1000 / sourceRate;
+    double clock = song_clock_q16(srcPos, true) / 65536.0;
+    track(&result, frame, clock, song_clock_msecs(srcPos, true), ideal);
+  }
+
+  return result;
+}
+
+static Result playGSM(uint32_t step) {
+  Result result = {0, 0, 0, 0, 0};
+  uint32_t phase = step == RESAMPLE_ONE / 2 ? RESAMPLE_ONE / 2 : 0;
+  uint32_t srcPos = 0;
+  uint32_t decodePos = SONG_CLOCK_GSM_CHUNK_SAMPLES;
+  double sourceRate = OUTPUT_RATE / 2;
+  double leadSum = 0;
+
+  for (uint32_t frame = 1; frame <= FRAMES; frame++) {
+    // (each read is a `GSM_READ_SAMPLE`)
+    uint32_t reads = (phase + OUTPUT_SAMPLES * step) >> 16;
+    phase = (phase + OUTPUT_SAMPLES * step) & 0xffff;
+    for (uint32_t i = 0; i < reads; i++) {
+      if (decodePos >= SONG_CLOCK_GSM_CHUNK_SAMPLES) {
+        srcPos += GSM_CHUNK_SIZE;
+        decodePos = 0;
+      }
+      decodePos++;
+    }
+
+    uint32_t samples =
+        song_clock_gsm_samples(srcPos, GSM_CHUNK_SIZE, decodePos);
+    double played = (double)frame * OUTPUT_SAMPLES * step / RESAMPLE_ONE;
+    double ideal = (played + SONG_CLOCK_GSM_LEAD_SAMPLES) * 1000 / sourceRate;
+    double clock = song_clock_q16(samples, false) / 65536.0;
+    track(&result, frame, clock, song_clock_msecs(samples, false), ideal);
+
+    double oldClock = (double)((srcPos * AS_MSECS_GSM) >> 32);
+    leadSum += oldClock - song_clock_msecs(samples, false);
+  }
+
+  result.leadDiff = leadSum / FRAMES;
+  return result;
+}
+
+static void check(const char* name, uint32_t step, Result result) {
+  printf("  %s x%.2f: max %.4fms (first minute %.4fms, last minute %.4fms)",
+         name, step / (double)RESAMPLE_ONE, result.maxError,
+         result.firstMinute, result.lastMinute);
+  if (result.leadDiff != 0)
+    printf(", old clock %+.2fms", result.leadDiff);
+  printf("\n");
+
+  // (one source sample is 0.055ms in GSM, so the Q16 clock is exact up to the
+  // resampler's sub-sample phase, and the integer clock truncates)
+  CHECK_MSG(result.maxError < 0.1, "Q16 clock off by %.4fms",
+            result.maxError);
+  CHECK_MSG(result.maxMsecError < 1.1, "msecs off by %.4fms",
+            result.maxMsecError);
+  CHECK_MSG(result.lastMinute <= result.firstMinute + 0.06,
+            "the clock drifts (%.4fms -> %.4fms)", result.firstMinute,
+            result.lastMinute);
+}
+
+int main() {
+  printf("song_clock (%d frames):\n", FRAMES);
+
+  for (uint32_t i = 0; i < RATE_COUNT; i++) {
+    check("PCM", RATE_STEPS[i], playPCM(RATE_STEPS[i]));
+    check("GSM", RATE_STEPS[i], playGSM(RATE_STEPS[i] >> 1));
+  }
+
+  // (the GSM lead keeps the average timing of the old chunk-based clock, so
+  // audio lag calibrations stay valid)
+  Result normal = playGSM(RESAMPLE_ONE / 2);
+  CHECK_MSG(fabs(normal.leadDiff) < 0.5, "the GSM clock moved %.2fms",
+            normal.leadDiff);
+
+  printf("song_clock: OK\n");
+  return 0;
+}
@@ -0,0 +1,83 @@
+#include <stdio.h>
+
+#include <vector>
+
+#include "gameplay/Replay.h"
+#include "gameplay/Sequence.h"
+#include "gameplay/save/SaveFile.h"
+#include "host/host.h"
+
+// Usage: replay_runner <content dir> <file.rpl>
+// Plays a replay (see `scripts/replay_extract.js`) on the host build of the
+// game, with the importer output it was recorded with, and compares the
+// frame count and the evaluation with the recorded ones.
+// Exits with 0 if they match, 1 if they don't, and 2 on errors.
+
+#define EXTRA_FRAMES (60 * 30)  // (loading, transitions and song end)
+
+static void printMismatch(const char* field, u32 expected, u32 actual) {
+  if (expected != actual)
+    printf("  %s: %u (recorded) != %u (replayed)\n", field, expected, actual);
+}
+
+int main(int argc, char* argv[]) {
+  if (argc != 3) {
+    fprintf(stderr, "Usage: %s <content dir> <file.rpl>\n", argv[0]);
+    return 2;
+  }
+
+  FILE* file = fopen(argv[2], "rb");
+  if (file == NULL) {
+    fprintf(stderr, "Can't open %s\n", argv[2]);
+    return 2;
+  }
+  std::vector<u8> data;
+  u8 buffer[4096];
+  size_t read;
+  while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0)
+    data.insert(data.end(), buffer, buffer + read);
+  fclose(file);
+
+  HOST_init(argv[1]);
+  if (!REPLAY_load(data.data(), data.size())) {
+    fprintf(stderr, "%s: not a complete replay\n", argv[2]);
+    return 2;
+  }
+
+  // (the settings that the recording depends on, besides its mods)
+  auto header = REPLAY_getHeader();
+  SAVEFILE_write8(SRAM->state.gameMode, header->gameMode);
+  SAVEFILE_write8(SRAM->adminSettings.arcadeCharts, header->arcadeCharts);
+  SAVEFILE_write32(SRAM->globalOffset, header->globalOffset);
+  HOST_setPCM(header->isPCM);
+
+  SEQUENCE_goToReplay();
+  u32 maxFrames = header->frameCount + EXTRA_FRAMES;
+  auto playback = REPLAY_getPlayback();
+  while (!playback->isFinished && HOST_getFrame() < maxFrames)
+    HOST_runFrame();
+
+  if (playback->isValid) {
+    printf("OK %s (%s, %u frames)\n", argv[2], header->songName,
+           header->frameCount);
+    return 0;
+  }
+
+  printf("MISMATCH %s (%s)\n", argv[2], header->songName);
+  if (!playback->isFinished) {
+    printf("  the song didn't finish in %u frames\n", maxFrames);
+    return 1;
+  }
+  auto& expected = header->result;
+  auto& actual = playback->result;
+  printMismatch("frames", header->frameCount, playback->frameCount);
+  printMismatch("perfects", expected.perfects, actual.perfects);
+  printMismatch("greats", expected.greats, actual.greats);
+  printMismatch("goods", expected.goods, actual.goods);
+  printMismatch("bads", expected.bads, actual.bads);
+  printMismatch("misses", expected.misses, actual.misses);
+  printMismatch("maxCombo", expected.maxCombo, actual.maxCombo);
+  printMismatch("points", expected.points, actual.points);
+  printMismatch("longNotes", expected.longNotes, actual.longNotes);
+  return 1;
+}
@@ -0,0 +1,109 @@
+#include <libgen.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "gameplay/Replay.h"
+#include "gameplay/Sequence.h"
+#include "gameplay/save/SaveFile.h"
+#include "gameplay/save/State.h"
+#include "host/fixture.h"
+#include "host/host.h"
+#include "player/PlaybackState.h"
+#include "test.h"
+
+// Records a song played by a scripted player on the host build, then runs
+// the `.rpl` file through `replay_runner` in a new process (like `make
+// replay` does) and checks that it matches. A copy with different keys must
+// not match.
+
+#define SONG_NAME "replay"
+#define SONG_LAST_MILLISECOND 9000
+#define NOTE_COUNT 12
+#define HOLD_TIMESTAMP 7000
+#define HOLD_LENGTH 800
+#define MAX_FRAMES (60 * 60)
+
+static std::vector<FixtureEvent> createEvents() {
+  std::vector<FixtureEvent> events;
+  for (u32 i = 0; i < NOTE_COUNT; i++)
+    events.push_back(
+        {(int)(2000 + i * 400), EventType::NOTE, EVENT_ARROW_MASKS[i % 5]});
+  events.push_back({HOLD_TIMESTAMP, EventType::HOLD_START,
+                    EVENT_ARROW_MASKS[2], {HOLD_LENGTH}});
+  events.push_back({HOLD_TIMESTAMP + HOLD_LENGTH, EventType::HOLD_END,
+                    EVENT_ARROW_MASKS[2]});
+  std::stable_sort(events.begin(), events.end(),
+                   [](const FixtureEvent& a, const FixtureEvent& b) {
+                     return a.timestamp < b.timestamp;
+                   });
+  return events;
+}
+
+static void record(const char* content,
+                   const std::vector<FixtureEvent>& events) {
+  HOST_init(content);
+  SAVEFILE_write8(SRAM->state.gameMode, GameMode::ARCADE);
+
+  SongFile file(SONG_NAME, 0);
+  Song* song = SONG_parse(find_first_gbfs_file(0), &file, {0});
+  Chart* chart = song->charts;
+  SEQUENCE_goToMessageOrSong(song, chart);
+
+  FixturePlayer player(&events);
+  while (!REPLAY_getHeader()->isComplete && HOST_getFrame() < MAX_FRAMES) {
+    HOST_setKeys(player.getKeys(PlaybackState.msecs));
+    HOST_runFrame();
+  }
+  CHECK_MSG(REPLAY_getHeader()->isComplete, "the song didn't finish");
+}
+
+static int run(std::string runner, std::string content, std::string replay) {
+  fflush(stdout);
+  int status = system((runner + " " + content + " " + replay).c_str());
+  CHECK(WIFEXITED(status));
+  return WEXITSTATUS(status);
+}
+
+int main(int argc, char* argv[]) {
+  auto events = createEvents();
+  auto content = FIXTURE_createContent(1);
+  FIXTURE_writeSong(content, SONG_NAME, SONG_LAST_MILLISECOND, events);
+  record(content.c_str(), events);
+
+  auto header = REPLAY_getHeader();
+  printf("recorded: %u frames, %u events, %u perfects, %u misses\n",
+         header->frameCount, header->eventCount, header->result.perfects,
+         header->result.misses);
+  CHECK(header->eventCount > NOTE_COUNT);
+  CHECK(header->result.perfects + header->result.greats > 0);
+
+  std::vector<u8> replay(sizeof(ReplayHeader) +
+                         REPLAY_MAX_EVENTS * sizeof(ReplayEvent));
+  u32 size = REPLAY_save(replay.data(), replay.size());
+  CHECK(size == sizeof(ReplayHeader) + header->eventCount * 2);
+  replay.resize(size);
+  FIXTURE_writeFile(content + "/test.rpl", replay);
+
+  // (a copy where the player doesn't press anything)
+  auto tampered = replay;
+  for (u32 i = sizeof(ReplayHeader); i < size; i += sizeof(ReplayEvent)) {
+    tampered[i] = 0;
+    tampered[i + 1] &= ~(KEY_ANY >> 8);
+  }
+  FIXTURE_writeFile(content + "/tampered.rpl", tampered);
+
+  std::string runner = std::string(dirname(argv[0])) + "/replay_runner";
+  CHECK_MSG(run(runner, content, content + "/test.rpl") == 0,
+            "the replay doesn't match");
+  CHECK_MSG(run(runner, content, content + "/tampered.rpl") == 1,
+            "a tampered replay matches");
+
+  FIXTURE_removeFolder(content);
+  return 0;
+}
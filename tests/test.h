@@ -0,0 +1,28 @@
+#ifndef TEST_H
+#define TEST_H
+
+#include <stdio.h>
+#include <stdlib.h>
+
+// Minimal assertions for the host tests: a failed check prints the
+// expression and exits with an error.
+#define CHECK(CONDITION)                                                \
+  do {                                                                  \
+    if (!(CONDITION)) {                                                 \
+      fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, \
+              #CONDITION);                                              \
+      exit(1);                                                          \
+    }                                                                   \
+  } while (0)
+
+#define CHECK_MSG(CONDITION, ...)                            \
+  do {                                                       \
+    if (!(CONDITION)) {                                      \
+      fprintf(stderr, "%s:%d: ", __FILE__, __LINE__);        \
+      fprintf(stderr, __VA_ARGS__);                          \
+      fprintf(stderr, "\n");                                 \
+      exit(1);                                               \
+    }                                                        \
+  } while (0)
+
+#endif  // TEST_H
@@ -0,0 +1,273 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "gameplay/save/SaveFile.h"
+#include "gameplay/video/VideoStore.h"
+#include "host/fixture.h"
+#include "test.h"
+
+extern "C" {
+#include "player/audio_store.h"
+#include "player/io_scheduler.h"
+}
+
+// Runs the real FatFs and flashcartio over a FAT image (`IMAGE_LIB`, see
+// `diskimage/io_image.h`) with fragmented files: streams a PCM song with
+// `audio_store` and a video with `VideoStore` (like `SongScene::drawVideo`,
+// half a frame per frame), comparing what they read with the files, then
+// seeks the song near its end. The sector trace must show that, once the
+// files are open, streams only read their own sectors (the link maps
+// replace the FAT), audio in file order and two sectors at a time, within
+// the frame budget, with the EverDrive's latency.
+
+#define FRAME_COUNT 96
+#define BACKGROUND_ID 1
+#define BANK_BACKGROUND_TILES 0
+#define BANK_BACKGROUND_MAP 24  // (and 25, like in `SongScene`)
+#define VIDEO_NAME "test.vid"
+#define AUDIO_NAME "test.aud.bin"
+#define AUDIO_SIZE 140001  // (not a whole sector)
+#define AUDIO_FRAME_SIZE 608
+#define AUDIO_SEEK (AUDIO_SIZE - 3000)
+#define AUDIO_REFILL_SECTORS 2  // (`REFILL_SECTORS` in `audio_store.c`)
+#define CARD "everdrive"
+#define CARD_COMMAND_US 250  // (`io_image.c`'s profile)
+#define CARD_SECTOR_US 450
+#define SCRIPT "gameplay/video_store_test.js"  // (tests run from `tests/`)
+
+typedef struct {
+  u32 frame;
+  std::string stream;
+  u32 sector;
+  u32 count;
+  u32 us;
+} TraceRow;
+
+static u32 seed = 1;
+
+static u32 nextRandom(u32 max) {
+  seed = seed * 1103515245 + 12345;
+  return (seed >> 16) % max;
+}
+
+static std::vector<u16> renderScreen() {
+  u16 control = REG_BGCNT[BACKGROUND_ID];
+  auto map = (const u16*)se_mem[(control >> 8) & 31];
+  auto tiles = (const u8*)tile_mem[(control >> 2) & 3];
+
+  std::vector<u16> screen;
+  for (u32 y = 0; y < GBA_SCREEN_HEIGHT; y++) {
+    for (u32 x = 0; x < GBA_SCREEN_WIDTH; x++) {
+      u32 tile = map[(y / 8) * 32 + x / 8] & 0x3ff;
+      u8 pixel = tiles[tile * VIDEO_TILE_SIZE + (y % 8) * 8 + x % 8];
+      screen.push_back(pal_bg_mem[pixel]);
+    }
+  }
+  return screen;
+}
+
+static bool isFrame(const std::vector<u8>& expected, u32 frame) {
+  auto screen = renderScreen();
+  u32 size = screen.size() * sizeof(u16);
+  return memcmp(expected.data() + frame * size, screen.data(), size) == 0;
+}
+
+static u32 msecsOf(u32 frame) {
+  return frame * 100 / 3 + 1;  // (30 fps)
+}
+
+static std::vector<TraceRow> readTrace(std::string path) {
+  fflush(NULL);  // (`io_image.c` doesn't flush the trace)
+  FILE* file = fopen(path.c_str(), "r");
+  CHECK(file != NULL);
+
+  char line[128];
+  CHECK(fgets(line, sizeof(line), file) != NULL);
+  CHECK(strcmp(line, "frame,stream,sector,count,us\n") == 0);
+  std::vector<TraceRow> rows;
+  while (fgets(line, sizeof(line), file) != NULL) {
+    TraceRow row;
+    char stream[16];
+    CHECK_MSG(sscanf(line, "%u,%15[^,],%u,%u,%u", &row.frame, stream,
+                     &row.sector, &row.count, &row.us) == 5,
+              "bad trace line: %s", line);
+    row.stream = stream;
+    rows.push_back(row);
+  }
+  fclose(file);
+  return rows;
+}
+
+// Reads a frame of audio, which must continue the file at `position`.
+static void readAudio(const std::vector<u8>& audio, u32& position) {
+  u8 buffer[AUDIO_FRAME_SIZE];
+  CHECK(audio_store_read(buffer, AUDIO_FRAME_SIZE));
+  for (u32 i = 0; i < AUDIO_FRAME_SIZE; i++, position++) {
+    u8 expected = position < audio.size() ? audio[position] : 0;
+    CHECK_MSG(buffer[i] == expected, "audio byte %u doesn't match", position);
+  }
+}
+
+// (like `SongScene::drawVideo`: the first half of the frame, then the rest)
+static void readVideo(const std::vector<u8>& expected, u32 frame) {
+  bool isPreRead = frame % 2 == 0;
+  u32 videoFrame = frame / 2;
+  if (isPreRead)
+    CHECK(videoStore->seek(msecsOf(videoFrame)));
+  CHECK(videoStore->canRead() && videoStore->isPreRead() == isPreRead);
+  CHECK_MSG(videoStore->requestRead(), "frame %u is over the budget", frame);
+
+  if (isPreRead) {
+    CHECK(videoStore->preRead());
+    videoStore->advance();
+  } else {
+    CHECK(videoStore->endRead());
+    CHECK(videoStore->decode(BACKGROUND_ID, BANK_BACKGROUND_TILES,
+                             BANK_BACKGROUND_MAP, 0));
+    videoStore->onVBlank();
+    CHECK_MSG(isFrame(expected, videoFrame), "video frame %u doesn't match",
+              videoFrame);
+  }
+}
+
+static std::string createSD(std::vector<u8>& audio) {
+  auto sd = FIXTURE_createFolder();
+  const char* node = getenv("NODE");
+  std::string command = std::string(node != NULL ? node : "node") +
+                        " " SCRIPT " " + sd + " " +
+                        std::to_string(FRAME_COUNT) + " --compress";
+  CHECK_MSG(system(command.c_str()) == 0, "%s failed", command.c_str());
+
+  mkdir((sd + AUDIOS_FOLDER_NAME).c_str(), 0755);
+  for (u32 i = 0; i < AUDIO_SIZE; i++)
+    audio.push_back(nextRandom(256));
+  FIXTURE_writeFile(sd + AUDIOS_FOLDER_NAME AUDIO_NAME, audio);
+  return sd;
+}
+
+static void testStreaming() {
+  std::vector<u8> audio;
+  auto sd = createSD(audio);
+  auto expected = FIXTURE_readFile(sd + "/expected.bin");
+  auto image = sd + "/sd.img";
+  auto tracePath = sd + "/trace.csv";
+  auto files = FIXTURE_writeFatImage(
+      image, sd, {VIDEOS_FOLDER_NAME VIDEO_NAME, AUDIOS_FOLDER_NAME AUDIO_NAME});
+
+  // (physical sector -> file and sector within the file)
+  std::map<u32, std::pair<std::string, u32>> owners;
+  for (auto& it : files) {
+    for (u32 i = 0; i < it.second.size(); i++)
+      owners[it.second[i]] = {it.first, i};
+    CHECK_MSG(it.second.back() - it.second.front() + 1 > it.second.size(),
+              "%s isn't fragmented", it.first.c_str());
+  }
+
+  setenv("FLASHCARTIO_IMAGE", image.c_str(), 1);
+  setenv("FLASHCARTIO_IMAGE_CARD", CARD, 1);
+  setenv("FLASHCARTIO_TRACE", tracePath.c_str(), 1);
+  SAVEFILE_write8(SRAM->adminSettings.hqMode, HQModeOpts::dACTIVE);
+  io_scheduler_begin_frame();
+  CHECK(videoStore->activate() == VideoStore::State::ACTIVE);
+  char audioName[] = AUDIO_NAME;
+  CHECK(audio_store_load(audioName));
+  CHECK(audio_store_len() == AUDIO_SIZE);
+  io_scheduler_begin_frame();
+  CHECK(videoStore->load(VIDEO_NAME, 0) == VideoStore::LoadResult::OK);
+  auto setup = readTrace(tracePath);
+  CHECK_MSG(!setup.empty() && setup.front().stream == "other",
+            "mounting didn't read the card");
+
+  u32 audioPosition = 0;
+  for (u32 frame = 0; frame < FRAME_COUNT * 2; frame++) {
+    io_scheduler_begin_frame();
+    readAudio(audio, audioPosition);
+    readVideo(expected, frame);
+  }
+
+  // (seeking near the end, then reading past it)
+  io_scheduler_begin_frame();
+  CHECK(audio_store_seek(AUDIO_SEEK));
+  audioPosition = AUDIO_SEEK;
+  while (audioPosition < AUDIO_SIZE + AUDIO_FRAME_SIZE) {
+    readAudio(audio, audioPosition);
+    io_scheduler_begin_frame();
+  }
+
+  auto trace = readTrace(tracePath);
+  std::map<u32, u32> frameSectors;
+  std::map<u32, u32> frameAudioSectors;
+  u32 nextAudioSector = 0;  // (after the ring was filled on load)
+  for (auto& row : setup) {
+    if (row.stream == "audio")
+      nextAudioSector += row.count;
+  }
+  CHECK(nextAudioSector > 0);
+  u32 audioJumps = 0;
+  u32 jumpFrame = 0;
+  u32 audioSectors = 0;
+  u32 audioReads = 0;
+  u32 videoSectors = 0;
+  for (u32 i = setup.size(); i < trace.size(); i++) {
+    auto& row = trace[i];
+    CHECK_MSG(row.stream == "audio" || row.stream == "video",
+              "frame %u read sector %u for %s", row.frame, row.sector,
+              row.stream.c_str());
+    CHECK(row.count > 0 &&
+          row.us == CARD_COMMAND_US + row.count * CARD_SECTOR_US);
+    auto path = row.stream == "audio" ? AUDIOS_FOLDER_NAME AUDIO_NAME
+                                      : VIDEOS_FOLDER_NAME VIDEO_NAME;
+    for (u32 sector = row.sector; sector < row.sector + row.count; sector++) {
+      auto owner = owners.find(sector);
+      CHECK_MSG(owner != owners.end() && owner->second.first == path,
+                "frame %u: %s read sector %u", row.frame, row.stream.c_str(),
+                sector);
+    }
+    frameSectors[row.frame] += row.count;
+
+    if (row.stream == "audio") {
+      u32 first = owners[row.sector].second;
+      if (first != nextAudioSector) {
+        audioJumps++;
+        jumpFrame = row.frame;
+      }
+      nextAudioSector = first + row.count;
+      frameAudioSectors[row.frame] += row.count;
+      audioSectors += row.count;
+      audioReads++;
+    } else {
+      videoSectors += row.count;
+    }
+  }
+  CHECK_MSG(audioJumps == 1, "audio was read out of order (%u jumps)",
+            audioJumps);
+  CHECK(nextAudioSector == files[AUDIOS_FOLDER_NAME AUDIO_NAME].size());
+  u32 maxSectors = 0;
+  for (auto& it : frameSectors) {
+    CHECK_MSG(it.second <= IO_FRAME_BUDGET_SECTORS,
+              "frame %u read %u sectors", it.first, it.second);
+    maxSectors = std::max(maxSectors, it.second);
+  }
+  for (auto& it : frameAudioSectors) {
+    CHECK_MSG(it.first == jumpFrame || it.second <= AUDIO_REFILL_SECTORS,
+              "frame %u read %u audio sectors", it.first, it.second);
+  }
+  CHECK(videoSectors > 0);
+
+  videoStore->unload();
+  printf("streaming: %u audio sectors in %u reads, %u video sectors, "
+         "up to %u sectors per frame, OK\n",
+         audioSectors, audioReads, videoSectors, maxSectors);
+  FIXTURE_removeFolder(sd);
+}
+
+int main() {
+  testStreaming();
+  return 0;
+}
@@ -0,0 +1,182 @@
+#include <stdio.h>
+
+#include <libgba-sprite-engine/sprites/sprite_builder.h>
+
+#include <memory>
+#include <vector>
+
+#include "test.h"
+#include "utils/SpriteTiles.h"
+
+// Assigns sprite lists like consecutive scenes do and checks `SpriteTiles`:
+// - allocation: every entry gets its own tiles, with a copy of its data;
+// - sharing: sprites with the same data (or without data) share tiles, and
+//   tiles kept from the previous scene aren't copied again;
+// - free/compaction: unused entries are evicted (oldest first, never the
+//   ones the new scene uses) and live ones move down to make room, with
+//   their sprites following them;
+// - edits: edited tiles aren't reused as copies of their data.
+
+#define TILE_SIZE 64
+#define TOTAL_TILES 512
+#define ENGINE_TILES_PER_TILE 2
+
+static u8 dataA[200 * TILE_SIZE];
+static u8 dataB[100 * TILE_SIZE];
+static u8 dataC[200 * TILE_SIZE];
+static u8 dataD[205 * TILE_SIZE];
+static u8 dataSmall[4 * TILE_SIZE];
+
+static void fill(u8* data, u32 size, u8 seed) {
+  for (u32 i = 0; i < size; i++)
+    data[i] = seed + i * 7 + (i >> 8);
+}
+
+static std::unique_ptr<Sprite> createSprite(const u8* data, u32 size) {
+  SpriteBuilder<Sprite> builder;
+  return std::unique_ptr<Sprite>{
+      builder.withData(data, size).withSize(SIZE_64_64).buildPtr()};
+}
+
+static void assign(std::vector<Sprite*> sprites) {
+  SPRITE_TILES_assign(sprites);
+  SPRITE_TILES_commit();
+}
+
+static u32 tileOf(Sprite* sprite) {
+  return sprite->getTileIndex() / ENGINE_TILES_PER_TILE;
+}
+
+static const u8* vramOf(Sprite* sprite) {
+  return (const u8*)tile_mem[4] + tileOf(sprite) * TILE_SIZE;
+}
+
+static bool hasData(Sprite* sprite, const u8* data, u32 size) {
+  return memcmp(vramOf(sprite), data, size) == 0 &&
+         (sprite->oam.attr2 & ~OAM_TILE_OFFSET_CLEAR) == sprite->getTileIndex();
+}
+
+static bool overlaps(Sprite* a, u32 sizeA, Sprite* b, u32 sizeB) {
+  u32 startA = tileOf(a), endA = startA + sizeA / TILE_SIZE;
+  u32 startB = tileOf(b), endB = startB + sizeB / TILE_SIZE;
+  return startA < endB && startB < endA;
+}
+
+static void testAllocation() {
+  auto a = createSprite(dataA, sizeof(dataA));
+  auto b = createSprite(dataB, sizeof(dataB));
+  auto c = createSprite(dataC, sizeof(dataC));
+  assign({a.get(), b.get(), c.get()});
+
+  CHECK(hasData(a.get(), dataA, sizeof(dataA)));
+  CHECK(hasData(b.get(), dataB, sizeof(dataB)));
+  CHECK(hasData(c.get(), dataC, sizeof(dataC)));
+  CHECK(!overlaps(a.get(), sizeof(dataA), b.get(), sizeof(dataB)));
+  CHECK(!overlaps(a.get(), sizeof(dataA), c.get(), sizeof(dataC)));
+  CHECK(!overlaps(b.get(), sizeof(dataB), c.get(), sizeof(dataC)));
+  CHECK(a->getData() == dataA);  // (restored after the commit)
+
+  auto stats = SPRITE_TILES_getStats();
+  CHECK(stats.used == sizeof(dataA) + sizeof(dataB) + sizeof(dataC));
+  CHECK(stats.cached == 0);
+
+  printf("allocation: %u tiles used, OK\n", stats.used / TILE_SIZE);
+}
+
+static void testSharing() {
+  auto small1 = createSprite(dataSmall, sizeof(dataSmall));
+  auto small2 = createSprite(dataSmall, sizeof(dataSmall));
+  auto noData = createSprite(NULL, 0);
+  auto b = createSprite(dataB, sizeof(dataB));
+  assign({small1.get(), b.get(), small2.get(), noData.get()});
+
+  CHECK(tileOf(small1.get()) == tileOf(small2.get()));
+  CHECK(tileOf(noData.get()) == tileOf(small2.get()));
+  CHECK(hasData(small1.get(), dataSmall, sizeof(dataSmall)));
+
+  // (B was uploaded by the previous scene, so its tiles aren't copied again)
+  CHECK(hasData(b.get(), dataB, sizeof(dataB)));
+  u8* vram = (u8*)vramOf(b.get());
+  vram[0] ^= 0xff;
+  auto b2 = createSprite(dataB, sizeof(dataB));
+  assign({b2.get(), small1.get()});
+  CHECK(tileOf(b2.get()) == tileOf(b.get()));
+  CHECK_MSG(vramOf(b2.get())[0] != dataB[0], "cached tiles were copied");
+  vram[0] ^= 0xff;
+
+  auto stats = SPRITE_TILES_getStats();
+  CHECK(stats.used == sizeof(dataB) + sizeof(dataSmall));
+  CHECK(stats.cached == sizeof(dataA) + sizeof(dataC));
+
+  printf("sharing: %u tiles used, %u cached, OK\n", stats.used / TILE_SIZE,
+         stats.cached / TILE_SIZE);
+}
+
+static void testCompaction() {
+  // (A, B, C and the small sprite are in VRAM; only B and C stay, and D
+  // doesn't fit until A is evicted and B and C move down)
+  auto b = createSprite(dataB, sizeof(dataB));
+  auto c = createSprite(dataC, sizeof(dataC));
+  auto d = createSprite(dataD, sizeof(dataD));
+  assign({b.get(), c.get(), d.get()});
+
+  CHECK(hasData(b.get(), dataB, sizeof(dataB)));
+  CHECK(hasData(c.get(), dataC, sizeof(dataC)));
+  CHECK(hasData(d.get(), dataD, sizeof(dataD)));
+  CHECK(!overlaps(b.get(), sizeof(dataB), d.get(), sizeof(dataD)));
+  CHECK(!overlaps(c.get(), sizeof(dataC), d.get(), sizeof(dataD)));
+  CHECK(tileOf(d.get()) + sizeof(dataD) / TILE_SIZE <= TOTAL_TILES);
+
+  // (A was the oldest unused entry; the small one is still cached)
+  auto stats = SPRITE_TILES_getStats();
+  CHECK(stats.used == sizeof(dataB) + sizeof(dataC) + sizeof(dataD));
+  CHECK(stats.cached == sizeof(dataSmall));
+
+  // (A doesn't fit anymore: the small entry is evicted, but not the ones
+  // that come after A in the list)
+  auto a = createSprite(dataA, sizeof(dataA));
+  assign({a.get(), b.get(), c.get(), d.get()});
+  CHECK(hasData(b.get(), dataB, sizeof(dataB)));
+  CHECK(hasData(c.get(), dataC, sizeof(dataC)));
+  CHECK(hasData(d.get(), dataD, sizeof(dataD)));
+  stats = SPRITE_TILES_getStats();
+  CHECK(stats.used == sizeof(dataB) + sizeof(dataC) + sizeof(dataD));
+  CHECK(stats.cached == 0);
+
+  printf("compaction: %u tiles used, OK\n", stats.used / TILE_SIZE);
+}
+
+static void testEdits() {
+  auto small = createSprite(dataSmall, sizeof(dataSmall));
+  assign({small.get()});
+  int tile = SPRITE_TILES_edit(small.get());
+  CHECK(tile == (int)tileOf(small.get()));
+  memset((u8*)tile_mem[4] + tile * TILE_SIZE, 0, TILE_SIZE);
+
+  // (the next scene gets a clean copy)
+  auto small2 = createSprite(dataSmall, sizeof(dataSmall));
+  assign({small2.get()});
+  CHECK_MSG(hasData(small2.get(), dataSmall, sizeof(dataSmall)),
+            "edited tiles were reused");
+  CHECK(SPRITE_TILES_getStats().used == sizeof(dataSmall));
+
+  auto noTiles = createSprite(NULL, 0);
+  assign({noTiles.get()});
+  CHECK(SPRITE_TILES_edit(noTiles.get()) == -1);
+
+  printf("edits: OK\n");
+}
+
+int main() {
+  fill(dataA, sizeof(dataA), 1);
+  fill(dataB, sizeof(dataB), 2);
+  fill(dataC, sizeof(dataC), 3);
+  fill(dataD, sizeof(dataD), 4);
+  fill(dataSmall, sizeof(dataSmall), 5);
+
+  testAllocation();
+  testSharing();
+  testCompaction();
+  testEdits();
+  return 0;
+}
@@ -0,0 +1,132 @@
+#include <stdio.h>
+
+#include <string>
+#include <vector>
+
+#include "gameplay/save/SaveFile.h"
+#include "host/fixture.h"
+#include "host/host.h"
+#include "scenes/SettingsScene.h"
+#include "test.h"
+#include "utils/TextUtils.h"
+
+// Checks the text layer (`TEXT_write` + `TEXT_render`):
+// - random writes leave the same map as `TextStream::setText` would;
+// - in `SettingsScene`, changing an option or moving the cursor uploads
+//   only the cells that changed, and idle frames upload nothing.
+
+#define WRITE_COUNT 2000
+#define OPTION_GAME_POSITION 2  // (see `SettingsScene.cpp`)
+#define ROW_GAME_POSITION 7
+#define ROW_BACKGROUND_TYPE 9
+#define IDLE_FRAMES 10
+
+static u32 seed = 1;
+
+static u32 nextRandom(u32 max) {
+  seed = seed * 1103515245 + 12345;
+  return (seed >> 16) % max;
+}
+
+static std::vector<u16> readMap() {
+  auto map = (const u16*)se_mem[TextStream::instance().getScreenBlock()];
+  return std::vector<u16>(map, map + TEXT_MAP_COLS * TEXT_MAP_ROWS);
+}
+
+static void testLayout() {
+  TextStream::instance().clear();
+  TEXT_reset();
+
+  for (u32 i = 0; i < WRITE_COUNT; i++) {
+    char text[TEXT_MAP_COLS * 2 + 1];
+    u32 length = nextRandom(sizeof(text));
+    for (u32 j = 0; j < length; j++)
+      text[j] = 'A' + nextRandom(26);
+    text[length] = '\0';
+    u32 row = nextRandom(TEXT_MAP_ROWS);
+    int col = (int)nextRandom(TEXT_MAP_COLS + 8) - 8;
+
+    TEXT_write(text, row, col);
+    TEXT_render();
+    auto map = readMap();
+    TextStream::instance().setText(text, row, col);
+    CHECK_MSG(readMap() == map, "write %u differs from `setText`", i);
+  }
+
+  printf("layout: %u writes, OK\n", WRITE_COUNT);
+}
+
+static std::vector<std::string> readScreen() {
+  std::vector<std::string> rows;
+  for (u32 row = 0; row < TEXT_MAP_ROWS; row++)
+    rows.push_back(HOST_getText(row));
+  return rows;
+}
+
+static void press(u16 keys) {
+  HOST_setKeys(keys);
+  HOST_runFrame();
+  HOST_setKeys(0);
+}
+
+// Returns the cells written by the frame after a key press, and checks that
+// only `rows` changed on screen.
+static u32 pressAndCount(u16 keys, std::vector<u32> rows) {
+  auto before = readScreen();
+  press(keys);
+  u32 cells = HOST_getTextCells();
+  auto after = readScreen();
+
+  for (u32 row = 0; row < TEXT_MAP_ROWS; row++) {
+    bool isExpected = false;
+    for (auto it : rows)
+      isExpected = isExpected || it == row;
+    CHECK_MSG(isExpected || before[row] == after[row], "row %u changed", row);
+  }
+  return cells;
+}
+
+static void expectIdle() {
+  for (u32 i = 0; i < IDLE_FRAMES; i++) {
+    HOST_runFrame();
+    CHECK_MSG(HOST_getTextCells() == 0, "an idle frame wrote text");
+  }
+}
+
+static void testSettingsScene() {
+  auto content = FIXTURE_createContent(1);
+  HOST_init(content.c_str());
+  SAVEFILE_write8(SRAM->settings.gamePosition, 0);  // (LEFT)
+
+  auto engine = HOST_getEngine();
+  engine->setScene(
+      new SettingsScene(engine, find_first_gbfs_file(0), OPTION_GAME_POSITION));
+  HOST_runFrame();
+  u32 screenCells = HOST_getTextCells();
+  CHECK(screenCells > 0);
+  CHECK(HOST_getText(ROW_GAME_POSITION).find("<LEFT>") != std::string::npos);
+  expectIdle();
+
+  // (a value changes: only the cells of "<LEFT>" -> "<CENTER>")
+  u32 changeCells = pressAndCount(KEY_R, {ROW_GAME_POSITION});
+  CHECK(HOST_getText(ROW_GAME_POSITION).find("<CENTER>") != std::string::npos);
+  CHECK(changeCells > 0 && changeCells <= TEXT_MAP_COLS);
+  expectIdle();
+
+  // (the cursor moves: only the ">" marks change)
+  u32 moveCells =
+      pressAndCount(KEY_A, {ROW_GAME_POSITION, ROW_BACKGROUND_TYPE});
+  CHECK(HOST_getText(ROW_BACKGROUND_TYPE).find(">") != std::string::npos);
+  CHECK(moveCells == 2);  // (one per row)
+  expectIdle();
+
+  printf("settings: screen %u cells, option change %u, cursor move %u\n",
+         screenCells, changeCells, moveCells);
+  FIXTURE_removeFolder(content);
+}
+
+int main() {
+  testLayout();
+  testSettingsScene();
+  return 0;
+}